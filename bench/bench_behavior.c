@@ -0,0 +1,191 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../include/gameobjects/npc.h"
+#include "../include/utils/ai_manager.h"
+#include "../include/utils/behavior_vm.h"
+#include "../include/utils/constants.h"
+#include "../include/utils/influence_map.h"
+#include "../include/utils/timer_wheel.h"
+
+// Random NPC states decided by both PollAI and the shipped behavior
+#define BENCH_STATES 10000
+
+// Times every state is decided per measurement, and measurements per decider
+#define BENCH_ROUNDS 100
+#define BENCH_REPEATS 5
+
+// Ticks the influence map spreads the random deposits before deciding
+#define BENCH_INFLUENCE_TICKS 8
+
+// One NPC state, with the target its perception picked
+typedef struct
+{
+    NPC npc;
+    GameObject target;
+    bool targetVisible;
+} BenchState;
+
+// Uniform float in [0, max)
+static float RandomFloat(float max)
+{
+    return (float)rand() / ((float)RAND_MAX + 1.0f) * max;
+}
+
+// Milliseconds of CPU time since start
+static double ElapsedMs(clock_t start)
+{
+    return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/**
+ * RandomStates - Fills NPC states covering every branch of PollAI.
+ *
+ * @states:    The states to fill.
+ * @count:     Number of states.
+ * @influence: Receives crowds and threat around random spots.
+ *
+ * Targets stand within twice the attack range, half the NPCs are still in
+ * their fire cooldown and a few are dead or already attacking.
+ */
+static void RandomStates(BenchState *states, int count, InfluenceMap *influence)
+{
+    static const State bodyStates[] = {STATE_IDLE, STATE_MOVING, STATE_MOVING, STATE_ATTACKING, STATE_DEAD};
+    float world = LEVEL_WIDTH_TILES * PERCEPTION_TILE;
+
+    srand(1);
+    memset(states, 0, sizeof(BenchState) * count);
+
+    for (int i = 0; i < count; i++)
+    {
+        GameObject *obj = &states[i].npc.base;
+
+        obj->position = (Vector2){RandomFloat(world), RandomFloat(world)};
+        obj->health = 1 + rand() % 100;
+        obj->currentState = bodyStates[rand() % (int)(sizeof(bodyStates) / sizeof(bodyStates[0]))];
+
+        if (rand() % 2 == 0)
+        {
+            states[i].npc.fireCooldown = ScheduleTimer(GetTimerService(), obj, EVENT_NONE, 1000);
+        }
+
+        states[i].target.position = (Vector2){obj->position.x + RandomFloat(4.0f * NPC_ATTACK_RANGE) - 2.0f * NPC_ATTACK_RANGE,
+                                              obj->position.y + RandomFloat(4.0f * NPC_ATTACK_RANGE) - 2.0f * NPC_ATTACK_RANGE};
+        states[i].targetVisible = rand() % 4 != 0;
+
+        ResetBehaviorState(&states[i].npc.behavior);
+    }
+
+    for (int tick = 0; tick < BENCH_INFLUENCE_TICKS; tick++)
+    {
+        for (int i = 0; i < count; i += 2)
+        {
+            DepositInfluence(influence, INFLUENCE_ALLIES, states[i].npc.base.position, 4.0f);
+        }
+        for (int i = 0; i < count; i += 16)
+        {
+            DepositInfluence(influence, INFLUENCE_THREAT, states[i].target.position, 2.0f);
+        }
+        UpdateInfluenceMap(influence);
+    }
+}
+
+/**
+ * TimeDecider - Times one way of deciding NPC commands.
+ *
+ * @states:    The NPC states.
+ * @count:     Number of states.
+ * @influence: The influence map the NPCs read.
+ * @program:   The behavior to run, NULL for PollAI.
+ *
+ * Return: Nanoseconds per decision, the fastest of BENCH_REPEATS runs.
+ */
+static double TimeDecider(BenchState *states, int count, const InfluenceMap *influence, const BehaviorProgram *program)
+{
+    double best = 0.0;
+    unsigned int checksum = 0;
+
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        clock_t start = clock();
+
+        for (int round = 0; round < BENCH_ROUNDS; round++)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                BenchState *state = &states[i];
+                Command command = program != NULL
+                                      ? RunBehavior(program, &state->npc.behavior, &state->npc.base, &state->target,
+                                                    state->targetVisible, influence)
+                                      : PollAI(&state->npc.base, &state->target, state->targetVisible, influence);
+                checksum += (unsigned int)command;
+            }
+        }
+
+        double ns = ElapsedMs(start) * 1e6 / ((double)BENCH_ROUNDS * count);
+        best = r == 0 || ns < best ? ns : best;
+    }
+
+    // Keeps the decisions from being optimised away
+    if (checksum == 0)
+    {
+        printf("  (no commands)\n");
+    }
+
+    return best;
+}
+
+/**
+ * main - Benchmarks the behavior VM against the native PollAI.
+ *
+ * Run from the project root, where the game finds assets/behaviors/npc.bvm.
+ *
+ * Return: 0 when the shipped behavior decided like PollAI on every state, 1 otherwise.
+ */
+int main(void)
+{
+    BehaviorProgram program;
+    if (!LoadBehaviorProgram(&program, "./assets/behaviors/npc.bvm"))
+    {
+        fprintf(stderr, "Failed to load ./assets/behaviors/npc.bvm, run from the project root\n");
+        return 1;
+    }
+
+    InitTimerWheel(GetTimerService(), NULL, NULL);
+
+    InfluenceMap influence;
+    InitInfluenceMap(&influence, LEVEL_WIDTH_TILES, LEVEL_HEIGHT_TILES);
+
+    BenchState *states = (BenchState *)malloc(sizeof(BenchState) * BENCH_STATES);
+    if (!states)
+    {
+        fprintf(stderr, "Failed to allocate benchmark states\n");
+        exit(1);
+    }
+    RandomStates(states, BENCH_STATES, &influence);
+
+    int mismatches = 0;
+    for (int i = 0; i < BENCH_STATES; i++)
+    {
+        BenchState *state = &states[i];
+        Command native = PollAI(&state->npc.base, &state->target, state->targetVisible, &influence);
+        Command behavior = RunBehavior(&program, &state->npc.behavior, &state->npc.base, &state->target,
+                                       state->targetVisible, &influence);
+        mismatches += native != behavior;
+    }
+
+    double nativeNs = TimeDecider(states, BENCH_STATES, &influence, NULL);
+    double behaviorNs = TimeDecider(states, BENCH_STATES, &influence, &program);
+
+    printf("Behavior: %d random NPC states, %d rounds\n", BENCH_STATES, BENCH_ROUNDS);
+    printf("  PollAI             %8.1f ns per call\n", nativeNs);
+    printf("  behavior VM        %8.1f ns per call\n", behaviorNs);
+    printf("  %d of %d decisions differ from PollAI\n", mismatches, BENCH_STATES);
+
+    free(states);
+    FreeInfluenceMap(&influence);
+    FreeTimerWheel(GetTimerService());
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../include/gameobjects/npc.h"
+#include "../include/gameobjects/prefab.h"
+#include "../include/utils/asset_cache.h"
+#include "../include/utils/constants.h"
+#include "../include/utils/timer_wheel.h"
+
+// NPCs spawned per measurement, and measurements per way of spawning
+#define BENCH_NPCS 10000
+#define BENCH_REPEATS 5
+
+// Milliseconds of CPU time since start
+static double ElapsedMs(clock_t start)
+{
+    return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/**
+ * TimeInitNPC - Times spawning NPCs one InitNPC at a time.
+ *
+ * @npcs:  Receives the NPCs, deleted again before returning.
+ * @count: Number of NPCs.
+ *
+ * Runs once, every InitNPC builds its own FSM tables and goes through the
+ * asset cache for the sprite sheet.
+ *
+ * Return: Milliseconds.
+ */
+static double TimeInitNPC(NPC **npcs, int count)
+{
+    clock_t start = clock();
+    for (int i = 0; i < count; i++)
+    {
+        npcs[i] = InitNPC("Skynet");
+    }
+    double ms = ElapsedMs(start);
+
+    for (int i = 0; i < count; i++)
+    {
+        DeleteNPC(&npcs[i]->base);
+    }
+
+    return ms;
+}
+
+/**
+ * TimePrefab - Times spawning NPCs as copies of the NPC prefab.
+ *
+ * @prefab:    The NPC prefab.
+ * @positions: Where each NPC spawns.
+ * @count:     Number of NPCs.
+ * @poolMs:    Receives the milliseconds creating the pool took.
+ *
+ * Every run spawns into a new pool, as the game does once per InitGame.
+ *
+ * Return: Milliseconds SpawnPrefabs took, the fastest of BENCH_REPEATS runs,
+ *         or a negative value when an instance is not where it was spawned.
+ */
+static double TimePrefab(const Prefab *prefab, const Vector2 *positions, int count, double *poolMs)
+{
+    GameObject **spawned = (GameObject **)malloc(sizeof(GameObject *) * count);
+    if (!spawned)
+    {
+        fprintf(stderr, "Failed to allocate benchmark NPCs\n");
+        exit(1);
+    }
+
+    double best = 0.0;
+    bool placed = true;
+
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        PrefabPool pool;
+
+        clock_t start = clock();
+        InitPrefabPool(&pool, prefab, count);
+        double ms = ElapsedMs(start);
+        *poolMs = r == 0 || ms < *poolMs ? ms : *poolMs;
+
+        start = clock();
+        int spawnedCount = SpawnPrefabs(&pool, positions, count, spawned);
+        ms = ElapsedMs(start);
+        best = r == 0 || ms < best ? ms : best;
+
+        for (int i = 0; i < count; i++)
+        {
+            placed = placed && i < spawnedCount && spawned[i]->position.x == positions[i].x &&
+                     spawned[i]->position.y == positions[i].y &&
+                     spawned[i]->stateConfigs == prefab->archetype->stateConfigs;
+        }
+
+        FreePrefabPool(&pool);
+    }
+
+    free(spawned);
+
+    return placed ? best : -1.0;
+}
+
+/**
+ * main - Benchmarks spawning NPCs from the prefab against InitNPC.
+ *
+ * Opens a hidden window since InitNPC loads the NPC sprite sheet, so run it
+ * from the project root where the game finds its assets.
+ *
+ * Return: 0 when every prefab instance spawned where it was asked to, 1 otherwise.
+ */
+int main(void)
+{
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "bench_prefab");
+
+    InitTimerWheel(GetTimerService(), NULL, NULL);
+
+    NPC **npcs = (NPC **)malloc(sizeof(NPC *) * BENCH_NPCS);
+    Vector2 *positions = (Vector2 *)malloc(sizeof(Vector2) * BENCH_NPCS);
+    if (!npcs || !positions)
+    {
+        fprintf(stderr, "Failed to allocate benchmark NPCs\n");
+        exit(1);
+    }
+
+    for (int i = 0; i < BENCH_NPCS; i++)
+    {
+        positions[i] = (Vector2){(float)(i % 100) * 40.0f, (float)(i / 100) * 40.0f};
+    }
+
+    Prefab prefab;
+    InitNPCPrefab(&prefab);
+
+    double initMs = TimeInitNPC(npcs, BENCH_NPCS);
+    double poolMs = 0.0;
+    double spawnMs = TimePrefab(&prefab, positions, BENCH_NPCS, &poolMs);
+
+    printf("Prefab: %d NPCs of %d bytes\n", BENCH_NPCS, (int)prefab.size);
+    printf("  InitNPC            %8.2f ms\n", initMs);
+    printf("  pool creation      %8.2f ms\n", poolMs);
+    printf("  SpawnPrefabs       %8.2f ms\n", spawnMs);
+    if (spawnMs < 0.0)
+    {
+        printf("  instances were not spawned where asked\n");
+    }
+
+    FreePrefab(&prefab);
+    free(positions);
+    free(npcs);
+    FreeTimerWheel(GetTimerService());
+    FreeAssetCache(GetAssetCache());
+    CloseWindow();
+
+    return spawnMs < 0.0 ? 1 : 0;
+}
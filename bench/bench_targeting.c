@@ -0,0 +1,244 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../include/utils/spatial_grid.h"
+
+// Agents per faction, nearest hostiles per query and their range, as squad leaders ask
+#define BENCH_AGENTS_PER_FACTION 10000
+#define BENCH_K 4
+#define BENCH_RANGE 300.0f
+
+// One squad leader query per this many agents
+#define BENCH_LEADER_STRIDE 8
+
+// Side of the square both armies stand in
+#define BENCH_FIELD 4000.0f
+
+// Times a measurement is repeated, the fastest run is reported
+#define BENCH_REPEATS 5
+
+typedef enum
+{
+    LAYOUT_FRONT_LINE, // Each faction holds one half of the field
+    LAYOUT_INTERMIXED  // Both factions scattered over the whole field
+} BenchLayout;
+
+// Uniform float in [0, max)
+static float RandomFloat(float max)
+{
+    return (float)rand() / ((float)RAND_MAX + 1.0f) * max;
+}
+
+// Milliseconds of CPU time since start
+static double ElapsedMs(clock_t start)
+{
+    return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+// Places both factions on the field, alternating so entity order mixes them
+static void PlaceAgents(SpatialAgent *agents, int count, BenchLayout layout)
+{
+    srand(1);
+
+    for (int i = 0; i < count; i++)
+    {
+        uint8_t faction = (uint8_t)(1 + i % 2);
+        float x = RandomFloat(BENCH_FIELD);
+
+        if (layout == LAYOUT_FRONT_LINE)
+        {
+            x = faction == 1 ? x * 0.5f : BENCH_FIELD * 0.5f + x * 0.5f;
+        }
+
+        agents[i] = (SpatialAgent){{x, RandomFloat(BENCH_FIELD)}, 16.0f, i, faction};
+    }
+}
+
+/**
+ * BruteForceHostiles - Finds the nearest hostiles by testing every agent.
+ *
+ * @agents:     Every agent.
+ * @count:      Number of agents.
+ * @queries:    Indices of the agents asking.
+ * @queryCount: Number of queries.
+ * @results:    Receives BENCH_K agent indices per query, nearest first.
+ * @counts:     Receives the number found per query.
+ *
+ * Keeps the same order as FindNearestHostiles, ties going to the lower
+ * entity, so the two can be compared entry by entry.
+ */
+static void BruteForceHostiles(const SpatialAgent *agents, int count, const int *queries, int queryCount,
+                               int *results, int *counts)
+{
+    for (int q = 0; q < queryCount; q++)
+    {
+        const SpatialAgent *self = &agents[queries[q]];
+        int *best = &results[q * BENCH_K];
+        float bestDistance[BENCH_K];
+        int found = 0;
+
+        for (int i = 0; i < count; i++)
+        {
+            if (agents[i].faction == self->faction)
+            {
+                continue;
+            }
+
+            float dx = agents[i].position.x - self->position.x;
+            float dy = agents[i].position.y - self->position.y;
+            float distanceSquared = dx * dx + dy * dy;
+
+            if (distanceSquared > BENCH_RANGE * BENCH_RANGE ||
+                (found == BENCH_K && distanceSquared >= bestDistance[BENCH_K - 1]))
+            {
+                continue;
+            }
+
+            // Agents are visited by entity, so an equal distance never displaces an earlier one
+            int slot = found < BENCH_K ? found++ : BENCH_K - 1;
+            while (slot > 0 && bestDistance[slot - 1] > distanceSquared)
+            {
+                best[slot] = best[slot - 1];
+                bestDistance[slot] = bestDistance[slot - 1];
+                slot--;
+            }
+
+            best[slot] = i;
+            bestDistance[slot] = distanceSquared;
+        }
+
+        counts[q] = found;
+    }
+}
+
+// Whether two sets of query results are identical
+static bool SameResults(const int *results, const int *counts, const int *expected, const int *expectedCounts,
+                        int queryCount)
+{
+    for (int q = 0; q < queryCount; q++)
+    {
+        if (counts[q] != expectedCounts[q])
+        {
+            return false;
+        }
+
+        for (int i = 0; i < counts[q]; i++)
+        {
+            if (results[q * BENCH_K + i] != expected[q * BENCH_K + i])
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * RunLayout - Times the grid against brute force on one layout.
+ *
+ * @name:   Printed with the timings.
+ * @layout: Where the agents stand.
+ *
+ * Return: true when the grid found exactly what brute force found.
+ */
+static bool RunLayout(const char *name, BenchLayout layout)
+{
+    int count = BENCH_AGENTS_PER_FACTION * 2;
+    int leaderCount = count / BENCH_LEADER_STRIDE;
+
+    SpatialAgent *agents = (SpatialAgent *)malloc(sizeof(SpatialAgent) * count);
+    int *queries = (int *)malloc(sizeof(int) * count);
+    int *results = (int *)malloc(sizeof(int) * count * BENCH_K);
+    int *counts = (int *)malloc(sizeof(int) * count);
+    int *expected = (int *)malloc(sizeof(int) * count * BENCH_K);
+    int *expectedCounts = (int *)malloc(sizeof(int) * count);
+    if (!agents || !queries || !results || !counts || !expected || !expectedCounts)
+    {
+        fprintf(stderr, "Failed to allocate benchmark agents\n");
+        exit(1);
+    }
+
+    PlaceAgents(agents, count, layout);
+    for (int i = 0; i < count; i++)
+    {
+        queries[i] = i;
+    }
+
+    SpatialGrid grid = {0};
+    double buildMs = 0.0, allMs = 0.0, leaderMs = 0.0;
+
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        clock_t start = clock();
+        BuildSpatialGrid(&grid, agents, count, 0.0f);
+        double ms = ElapsedMs(start);
+        buildMs = r == 0 || ms < buildMs ? ms : buildMs;
+
+        start = clock();
+        FindNearestHostiles(&grid, agents, queries, count, BENCH_K, BENCH_RANGE, results, counts);
+        ms = ElapsedMs(start);
+        allMs = r == 0 || ms < allMs ? ms : allMs;
+    }
+
+    // Leaders are every BENCH_LEADER_STRIDE-th agent, as squads would pick them
+    int *leaders = (int *)malloc(sizeof(int) * leaderCount);
+    if (!leaders)
+    {
+        fprintf(stderr, "Failed to allocate benchmark leaders\n");
+        exit(1);
+    }
+    for (int i = 0; i < leaderCount; i++)
+    {
+        leaders[i] = i * BENCH_LEADER_STRIDE;
+    }
+
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        clock_t start = clock();
+        FindNearestHostiles(&grid, agents, leaders, leaderCount, BENCH_K, BENCH_RANGE, results, counts);
+        double ms = ElapsedMs(start);
+        leaderMs = r == 0 || ms < leaderMs ? ms : leaderMs;
+    }
+
+    // Compare every query against brute force, timed once
+    FindNearestHostiles(&grid, agents, queries, count, BENCH_K, BENCH_RANGE, results, counts);
+    clock_t start = clock();
+    BruteForceHostiles(agents, count, queries, count, expected, expectedCounts);
+    double bruteMs = ElapsedMs(start);
+
+    bool same = SameResults(results, counts, expected, expectedCounts, count);
+
+    printf("%s: %d vs %d agents, k=%d, range %.0f\n", name, BENCH_AGENTS_PER_FACTION, BENCH_AGENTS_PER_FACTION,
+           BENCH_K, BENCH_RANGE);
+    printf("  grid build             %8.2f ms\n", buildMs);
+    printf("  %5d queries          %8.2f ms\n", count, allMs);
+    printf("  %5d leader queries   %8.2f ms\n", leaderCount, leaderMs);
+    printf("  %5d brute force      %8.2f ms\n", count, bruteMs);
+    printf("  results %s brute force\n", same ? "match" : "DIFFER from");
+
+    FreeSpatialGrid(&grid);
+    free(leaders);
+    free(expectedCounts);
+    free(expected);
+    free(counts);
+    free(results);
+    free(queries);
+    free(agents);
+
+    return same;
+}
+
+/**
+ * main - Benchmarks the nearest hostile queries of NPC targeting.
+ *
+ * Return: 0 when the grid matched brute force on every layout, 1 otherwise.
+ */
+int main(void)
+{
+    bool same = RunLayout("Front line", LAYOUT_FRONT_LINE);
+    same = RunLayout("Intermixed", LAYOUT_INTERMIXED) && same;
+
+    return same ? 0 : 1;
+}
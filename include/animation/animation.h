@@ -3,6 +3,8 @@
 
 #include <raylib.h>
 
+#include "../render/render_list.h"
+
 typedef struct
 {
     Texture2D texture;   // Animated Sprite Sheet Texture
@@ -13,15 +15,21 @@ typedef struct
     float frameTimer;    // Timer to track frame duration
     bool active;         // Is the animation active?
     bool loop;           // Should the animation loop?
+    int updateStride;    // Updates per frame timer advance (1 = every update, 0 = hold the frame)
+    int skippedUpdates;  // Updates held back by the stride so far
+    float skippedTime;   // Their time, added when the timer next advances
 } AnimationData;
 
 // Init Animation
 void InitAnimation(AnimationData *animationData, Texture2D texture, Rectangle *frames, int frameCount, float frameDuration, bool loop);
 
+// Init Animation playing frames owned by the caller, nothing is copied
+void InitSharedAnimation(AnimationData *animationData, Texture2D texture, Rectangle *frames, int frameCount, float frameDuration, bool loop);
+
 // Update Animation
 void UpdateAnimation(AnimationData *animationData);
 
-// Render Animation
-void RenderAnimation(const AnimationData *animationData, Vector2 position, Color tint);
+// Render Animation, recorded into the frame's render list
+void RenderAnimation(RenderList *list, const AnimationData *animationData, Vector2 position, Color tint);
 
 #endif // ANIMATION_H
@@ -1,6 +1,11 @@
 #ifndef COMMAND_H
 #define COMMAND_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../events/events.h"
+
 // Forward declaration of the Mediator struct
 typedef struct Mediator Mediator;
 
@@ -20,7 +25,30 @@ typedef enum
     COMMAND_COUNT            // Total number of commands, useful for looping or limits
 } Command;
 
+// Both commands of an input share a byte on the wire, a nibble each
+_Static_assert(COMMAND_COUNT <= 16, "Command must fit in a nibble");
+
+// A player's input for one tick. Movement and action are separate, so the
+// player can walk and attack in the same tick.
+typedef struct
+{
+    Command move;   // A COMMAND_MOVE_*, or COMMAND_NONE to stand still
+    Command action; // Roll, attack and the debug commands, or COMMAND_NONE
+} PlayerInput;
+
 // Function to execute a command
 void ExecuteCommand(Command command, Mediator *mediator);
 
+// Execute a player's input of a tick, the movement first, then the action
+void ExecutePlayerInput(PlayerInput input, Mediator *mediator);
+
+// Pack an input into the byte lockstep and the client's input packet carry
+uint8_t PackPlayerInput(PlayerInput input);
+
+// Unpack an input, commands out of range read as COMMAND_NONE
+PlayerInput UnpackPlayerInput(uint8_t packed);
+
+// The event a command sends, with its payload (false for commands without one)
+bool CommandToEvent(Command command, EntityHandle source, EventData *event);
+
 #endif // COMMAND_H
\ No newline at end of file
@@ -1,6 +1,10 @@
 #ifndef EVENTS_H
 #define EVENTS_H
 
+#include <raylib.h>
+
+#include "../utils/entity_handle.h"
+
 // Define an enumeration for different event types
 typedef enum
 {
@@ -36,6 +40,10 @@ typedef enum
     EVENT_COLLISION_START, // Represents the start of a collision (e.g., player colliding with a wall, enemy, or object).
     EVENT_COLLISION_END,   // Represents the end of a collision (e.g., player moving away from a colliding object or enemy).
 
+    // Timer Events (delivered by the timer service):
+    EVENT_ROLL_END,   // Represents the end of a roll, scheduled when the roll starts.
+    EVENT_ATTACK_END, // Represents the end of an attack, scheduled when the attack starts.
+
     // Player Actions:
     // EVENT_PICKUP, // Represents the player picking up an item (e.g., collecting weapons, coins, health potions, etc.).
 
@@ -51,4 +59,20 @@ typedef enum
     EVENT_COUNT // Represents the total number of events (for counting purposes, typically used for array size).
 } Event;        // Define 'Event' as the type of the enum
 
+// An event with its payload. Events are passed and queued by value so sending
+// one never allocates, fields the event has no use for are left zero.
+typedef struct
+{
+    Event type;          // What happened
+    EntityHandle source; // Game object that caused it (empty for none)
+    Vector2 direction;   // Unit direction of a move event
+    float magnitude;     // Strength of a move from 0 to 1 (1 for keys, less for a half pushed stick)
+    int damage;          // Damage dealt by the hit behind the event
+} EventData;
+
+// 28 bytes: the type, an 8 byte handle, the direction, magnitude and damage.
+// Several events share a cache line, queues of them stay cheap to copy
+_Static_assert(sizeof(EventData) == 28, "EventData changed size, update the size noted above");
+_Static_assert(sizeof(EventData) <= 32, "EventData should stay within half a cache line");
+
 #endif
@@ -11,7 +11,7 @@
 typedef struct GameObject GameObject;
 
 // Define function pointer types for event handling and state management
-typedef void (*EventFunction)(GameObject *, Event); // Function type for event handlers
+typedef void (*EventFunction)(GameObject *, const EventData *); // Function type for event handlers
 typedef void (*StateFunction)(GameObject *);        // Function type for state entry, update, and exit handlers
 
 // Define an enumeration for different states of the game object
@@ -19,19 +19,14 @@ typedef enum
 {
     STATE_IDLE,      // Represents the idle state (no action)
     STATE_WALKING,   // Represents the walking state
-    
-    STATE_MOVING_UP,    // Represents the state when the player is moving upwards
-    STATE_MOVING_DOWN,  // Represents the state when the player is moving downwards
-    STATE_MOVING_LEFT,  // Represents the state when the player is moving to the left
-    STATE_MOVING_RIGHT, // Represents the state when the player is moving to the right
-
+    STATE_MOVING,    // Represents moving in any direction, the direction comes with the move event
     STATE_ROLLING,
     STATE_ATTACKING, // Represents the attacking state
     STATE_SHIELD,    // Represents the shield state (defensive posture)
     STATE_DEAD,      // Represents the dead state (game over or defeated)
     STATE_RESPAWN,   // Represents the respawn state (respawns the player)
     STATE_COLLISION, // Represents the state when a collision is detected (e.g., with an enemy or obstacle)
-    STATE_COUNT      // Represents the total number of states (for counting purposes)
+    STATE_COUNT      // Represents the total number of states (for counting purposes), at most 16 (snapshots pack two states per byte)
 } State;             // Define 'State' as the type of the enum
 
 /** 
@@ -39,10 +34,6 @@ STATES TO BE IMPLEMENTED
 Define an enumeration for different states of the game object
 typedef enum
 {
-    STATE_MOVING_UP,    // Represents the state when the player is moving upwards
-    STATE_MOVING_DOWN,  // Represents the state when the player is moving downwards
-    STATE_MOVING_LEFT,  // Represents the state when the player is moving to the left
-    STATE_MOVING_RIGHT, // Represents the state when the player is moving to the right
     STATE_FIRING,       // Represents the state when the player is firing a weapon or projectile
     STATE_COUNT         // Represents the total number of states (used for validation or array sizing)
 } State;                // Define 'State' as the type of the enum, making it easier to refer to in the code
@@ -60,15 +51,68 @@ typedef struct StateConfig
     int nextStatesCount;       // Number of possible next states
 } StateConfig;                 // Define 'StateConfig' as a structure that holds all state-related configurations
 
-// Handles an event for the given game object, triggering changes in state
+// State machines running side by side on one game object, each with its own
+// current state and all receiving the same events. A change in one layer runs
+// only that layer's Exit and Entry, so walking and attacking need no combined
+// states. The locomotion layer is the game object's currentState.
+typedef enum
+{
+    FSM_LAYER_LOCOMOTION, // How the game object moves (idle, walking, rolling, dead)
+    FSM_LAYER_ACTION,     // What it does meanwhile (attacking, shielding)
+    FSM_LAYER_STATUS,     // Conditions over both (e.g. stunned), unused unless configured
+    FSM_LAYER_COUNT
+} FsmLayer;
+
+// Current state of a layer beside the locomotion one
+typedef struct
+{
+    State previousState;
+    State currentState;
+    StateConfig *stateConfigs; // STATE_COUNT configs, NULL while the layer is unused
+} FsmLayerState;
+
+// An event without a payload beyond the unit direction of EVENT_MOVE_UP/DOWN/LEFT/RIGHT
+EventData MakeEvent(Event type);
+
+// An EVENT_MOVE in any direction, the direction need not be normalized
+EventData MakeMoveEvent(Vector2 direction, float magnitude);
+
+// An event caused by a hit from another game object
+EventData MakeHitEvent(Event type, EntityHandle source, int damage);
+
+// Handles an event and its payload for the given game object, triggering changes in state
+void HandleEventData(GameObject *obj, const EventData *event);
+
+// Handles an event without payload (see MakeEvent)
 void HandleEvent(GameObject *obj, Event event);
 
+// Handles an EVENT_MOVE carrying a direction (see MakeMoveEvent)
+void HandleMoveEvent(GameObject *obj, Vector2 direction);
+
 // Checks if the game object can enter a new state based on the current context
 bool CanEnterState(GameObject *obj, State newState);
 
 // Changes the state of the game object to the new state if possible
 bool ChangeState(GameObject *obj, State newState);
 
+// Forces the game object into a state received from an authoritative host (no validation)
+void ApplyReplicatedState(GameObject *obj, State newState);
+
+// Gives a game object a layer with its own state configs, starting in initialState (no Entry)
+void InitFsmLayer(GameObject *obj, FsmLayer layer, StateConfig *stateConfigs, State initialState);
+
+// Current state of a layer (STATE_IDLE for unused layers)
+State GetLayerState(const GameObject *obj, FsmLayer layer);
+
+// Changes the state of one layer if that layer allows the transition
+bool ChangeLayerState(GameObject *obj, FsmLayer layer, State newState);
+
+// Forces one layer into a state received from an authoritative host (no validation)
+void ApplyReplicatedLayerState(GameObject *obj, FsmLayer layer, State newState);
+
+// Frees the state configs of every layer beside the locomotion one
+void FreeFsmLayers(GameObject *obj);
+
 // Updates the current state of the game object (for example, animations, actions)
 void UpdateState(GameObject *obj);
 
@@ -4,26 +4,106 @@
 #include "../utils/mediator.h"
 #include "../gameobjects/player.h"
 #include "../gameobjects/npc.h"
+#include "../gameobjects/projectile.h"
 #include "../utils/ai_manager.h"
 #include "../utils/input_manager.h"
+#include "../utils/state_hash.h"
+#include "../utils/sleep_system.h"
+#include "../utils/entity_table.h"
+#include "../utils/combat.h"
+#include "../utils/status_effects.h"
+#include "../utils/script_system.h"
+#include "../utils/trigger_volumes.h"
+#include "../utils/perception.h"
+#include "../utils/influence_map.h"
+#include "../utils/squads.h"
+#include "../utils/spatial_grid.h"
+#include "../utils/behavior_vm.h"
+#include "../utils/constants.h"
+#include "../network/lockstep.h"
+#include "../network/client_server.h"
+#include "../network/lag_compensation.h"
+#include "../render/detail_levels.h"
+
+// Maximum number of players in the world (one per lockstep peer or client)
+#define MAX_PLAYERS LOCKSTEP_MAX_PEERS
+
+// Maximum number of NPCs, --npcs is clamped to it
+#define MAX_NPCS 65536
+
+// NPCs spawned per InitGameStep, a scene preload step stays within its frame budget
+#define GAME_INIT_NPCS_PER_STEP 1024
+
+// Maximum number of NPCs of a host or client, players and NPCs together fit in a snapshot
+#define MAX_NETWORKED_NPCS (CLIENT_SERVER_MAX_ENTITIES - MAX_PLAYERS)
+
+// Scratch arrays the tick fills and forgets, objectCapacity long (allocated by InitGame)
+typedef struct
+{
+    GameObject **objects;      // Every game object, or the ones that moved (see GatherGameObjects)
+    GameObject **awake;        // Awake NPCs the squads decide for
+    SpatialAgent *agents;      // Targets of nearest hostile queries and projectiles
+    GameObject **agentObjects; // The game object of each agent
+    int *queries;              // Agents asking for their nearest hostiles, or sleepers near projectiles
+    int *candidates;           // NPC_TARGET_CANDIDATES nearest hostiles per query
+    int *candidateCounts;      // Hostiles found per query
+    GameObject **leaders;      // Squad leaders
+    GameObject **targets;      // Target of each leader
+} GameScratch;
 
 // Define the GameData struct to store the main game components (player, npc, and mediator)
 typedef struct
 {
-    Player *player;     // Pointer to the Player object
-    NPC *npc;           // Pointer to the NPC object
+    Player *player;     // Pointer to the local Player object
     Mediator *mediator; // Pointer to the Mediator object for managing interactions
                         // Mediator between command and FSM
+
+    Player *players[MAX_PLAYERS];     // Every player in the world, player points at the local one
+    Mediator *mediators[MAX_PLAYERS]; // One mediator per player
+    int playerCount;                  // Number of players in the world
+
+    NPC **npcs;               // Every NPC in the world, spawned into npcPool
+    int npcCapacity;          // Most NPCs the world holds, set by InitGame from npcCount
+    int objectCapacity;       // Players and NPCs together, entity indices stay below it
+    GameScratch scratch;      // Per-tick arrays of objectCapacity
+    Prefab npcPrefab;         // What every NPC is a copy of
+    PrefabPool npcPool;       // Storage of the NPCs
+    int npcCount;             // Number of NPCs in the world (set before InitGame to spawn more)
+    int npcSpawnCount;        // NPCs InitGameStep spawns in all, set from npcCount
+    CombatQueue combat;       // Damage gathered during the tick, applied in one pass
+    TriggerVolumes triggers;  // Zones reporting entities entering and leaving them
+    Perception perception;    // Walls and what each NPC can see of the player
+    InfluenceMap influence;   // Threat, NPC density and player proximity for tactical AI
+    SquadSystem squads;       // Nearby NPCs grouped under leaders that decide for them
+    SpatialGrid targeting;    // Players and awake NPCs by grid cell, for nearest hostile queries
+    BehaviorProgram behavior; // Designer NPC behavior, PollAI decides when none is loaded
+    Sound secretSound;        // Played when a player finds a secret area
+    DetailLevels detail;      // How much of each NPC is animated and drawn, by distance (set before InitGame)
+
+    LockstepSession lockstep;         // Peer to peer lockstep session (inactive in single player)
+    ClientServerSession clientServer; // Host or client session (inactive in single player)
+    ColliderHistory colliderHistory;  // Past colliders the host rewinds remote players' hits against
+
+    unsigned int tick;         // Simulation tick counter
+    const char *hashLogPath;   // Where per-tick state hashes are logged (debug builds)
+    bool hashEntities;         // Log every entity's hash too, not just the world's
+    StateHasher stateHasher;   // Per-tick world state hash for desync detection
 } GameData;
 
 // Initialises the game components (player, npc, mediator)
 void InitGame(GameData *gameData);
 
+// Builds the world a bounded step at a time (step counts from 0), true once it is complete
+bool InitGameStep(GameData *gameData, int step);
+
 // Updates the game state each frame (handles game logic)
 void UpdateGame(GameData *gameData);
 
-// Draws or renders the current game state (e.g., player, npc, environment)
-void DrawGame(GameData *gameData);
+// Records the draws of the current game state (e.g., player, npc, environment)
+void DrawGame(GameData *gameData, RenderList *list);
+
+// Collects all game objects in a stable order (players first, then NPCs)
+int GatherGameObjects(GameData *gameData, GameObject **objects, int maxObjects);
 
 // Closes the game, performing necessary cleanup and freeing resources
 void CloseGame(GameData *gameData);
@@ -0,0 +1,81 @@
+#ifndef SCENE_MANAGER_H
+#define SCENE_MANAGER_H
+
+#include <stdbool.h>
+
+#include "../render/render_list.h"
+
+// Seconds per frame spent preparing the next scene while the current one runs
+#define SCENE_PRELOAD_BUDGET 0.004
+
+typedef enum
+{
+    SCENE_NONE = -1,
+    SCENE_TITLE,
+    SCENE_GAMEPLAY,
+    SCENE_ARENA,
+    SCENE_GAME_OVER,
+    SCENE_COUNT
+} SceneId;
+
+typedef struct Scene Scene;
+
+// Prepares the next piece of a scene (an asset, the world), true once ready
+typedef bool (*ScenePreloadFunction)(Scene *scene);
+
+// Runs or unloads a scene
+typedef void (*SceneFunction)(Scene *scene);
+
+// Records the frame of a scene
+typedef void (*SceneDrawFunction)(Scene *scene, RenderList *list);
+
+// A screen of the game. Everything it needs is prepared by Preload, one
+// small step per call, so it can be spread over the frames of the scene
+// running before it. Unload frees whatever Preload got to.
+struct Scene
+{
+    const char *name;
+    ScenePreloadFunction Preload;
+    SceneFunction Update; // One frame of the scene while it is current
+    SceneDrawFunction Draw; // Records that frame, submitted by the window's thread
+    SceneFunction Unload; // Also called on a scene whose preload was cancelled
+    void *data;           // Scene specific state
+    int step;             // Preload steps done, Preload reads it to know what is next
+    bool ready;           // Preload finished, switching to the scene is a pointer swap
+};
+
+// Runs the current scene and prepares the next one in the time left of each frame
+typedef struct
+{
+    Scene scenes[SCENE_COUNT];
+    Scene *current;    // The scene updated and drawn every frame
+    Scene *preloading; // The scene prepared between frames (NULL when none)
+    SceneId requested; // Becomes current at the next frame boundary (SCENE_NONE when none)
+
+    double requestTime;    // When the pending switch was requested (GetTime)
+    double lastTransition; // Seconds from the last switch request to the swap
+    double lastStall;      // Part of it spent finishing a preload in one go
+} SceneManager;
+
+// Start without any scene
+void InitSceneManager(SceneManager *manager);
+
+// Add a scene, it is not prepared until preloaded or switched to
+void RegisterScene(SceneManager *manager, SceneId id, Scene scene);
+
+// Prepare a scene between frames, cancelling any other scene being prepared
+void PreloadScene(SceneManager *manager, SceneId id);
+
+// Make a scene current at the next frame boundary and unload the current one
+void SwitchScene(SceneManager *manager, SceneId id);
+
+// Switch if requested, run and record the current scene, then preload within SCENE_PRELOAD_BUDGET
+void RunSceneFrame(SceneManager *manager, RenderList *list);
+
+// Unload every scene
+void FreeSceneManager(SceneManager *manager);
+
+// The scene manager of the game, scenes request switches through it
+SceneManager *GetSceneManager(void);
+
+#endif // SCENE_MANAGER_H
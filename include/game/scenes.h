@@ -0,0 +1,17 @@
+#ifndef SCENES_H
+#define SCENES_H
+
+#include "game.h"
+#include "scene_manager.h"
+
+// Lives of the local player in a single player game, then it is game over
+#define GAMEPLAY_LIVES 3
+
+// NPCs fighting in the arena
+#define ARENA_NPC_COUNT MAX_NETWORKED_NPCS
+
+// Register the title, gameplay, arena and game over scenes. Gameplay starts
+// from a copy of settings (network sessions, NPC count, hash log).
+void RegisterGameScenes(SceneManager *manager, const GameData *settings);
+
+#endif // SCENES_H
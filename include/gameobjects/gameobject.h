@@ -1,6 +1,7 @@
 #ifndef GAMEOBJECT_H
 #define GAMEOBJECT_H
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -12,8 +13,17 @@
 #include "../include/events/events.h"
 #include "../include/fsm/fsm.h"
 #include "../include/animation/animation.h"
+#include "../include/utils/entity_handle.h"
 
 
+// Which side a game object fights for, game objects of different factions are hostile
+typedef enum
+{
+    FACTION_PLAYERS,
+    FACTION_SKYNET,
+    FACTION_ROGUES,
+    FACTION_COUNT
+} Faction;
 
 // Base structure for a game object
 typedef struct GameObject
@@ -24,6 +34,9 @@ typedef struct GameObject
 
     StateConfig *stateConfigs; // Pointer to the array of state configurations for this game object
 
+    // Layers running beside currentState, indexed by FsmLayer - 1 (see FsmLayer)
+    FsmLayerState layers[FSM_LAYER_COUNT - 1];
+
     // Position Vectors
     Vector2 position; // Gameobjects position in the game world
     Vector2 velocity;
@@ -43,6 +56,18 @@ typedef struct GameObject
     AnimationData animation; // Player Animation
 
     int health; // The health of the game object
+    int entity; // Entity index in the world (see GatherGameObjects), -1 until added
+    EntityHandle handle; // Identity in the entity table, unlike entity it never changes
+    uint8_t faction; // Faction the game object fights for
+
+    // Modifiers written every tick by the status effects (see TickStatusEffects)
+    float speedScale;  // Multiplies movement (slow, stun)
+    float damageScale; // Multiplies damage taken (shield)
+
+    // Sleeping (see SleepSystem)
+    bool asleep;             // Parked out of the update, collision and AI lists
+    unsigned int quietTicks; // Ticks spent idle, still and without events
+    int sleepSlot;           // Slot in the sleep system (-1 if not managed)
 } GameObject;
 
 // Initialize a new game object with the given name and default values
@@ -60,12 +85,21 @@ void InitGameObject(GameObject *obj,
 // Helper function to initialize animation
 void InitGameObjectAnimation(GameObject *obj, Rectangle *frames, int frameCount, float speed);
 
+// Helper function to play a clip whose frames are shared by every object playing it
+void InitGameObjectSharedAnimation(GameObject *obj, Rectangle *frames, int frameCount, float speed);
+
+// Move a game object, keeping its collider and bounds in step
+void SetGameObjectPosition(GameObject *obj, Vector2 position);
+
 // Check collision
 bool CheckCollision(GameObject *lhs, GameObject *rhs);
 
 // Handle Collision
 void HandleCollision(GameObject *lhs, GameObject *rhs);
 
+// Detach a game object from the timers, status effects and scripts, without freeing it
+void ReleaseGameObject(GameObject *obj);
+
 // Delete a game object and free associated memory/resources
 void DeleteGameObject(GameObject *obj);
 
@@ -8,12 +8,24 @@
 
 // Include the header for the base game object
 #include "gameobject.h"
+#include "prefab.h"
+#include "projectile.h"
+#include "../utils/timer_wheel.h"
+#include "../utils/asset_cache.h"
+#include "../utils/script_system.h"
+#include "../utils/behavior_vm.h"
 
 // Define the NPC structure that extends GameObject with an additional aggression property
 typedef struct
 {
     GameObject base; // The base game object (inherits from GameObject)
     int aggression;  // The aggression level of the NPC (could affect behavior)
+
+    TimerId attackTimer;  // Ends the current bullet burst
+    TimerId fireCooldown; // Blocks the next burst until it expires
+    int burstTick;        // Ticks spent in the current burst
+    TimerId respawnTimer; // Brings the NPC back after dying
+    BehaviorState behavior; // Where the NPC is in the designer behavior
 } NPC;
 
 // Initialize a new NPC with a given name (returns a pointer to the NPC)
@@ -22,13 +34,22 @@ NPC *InitNPC(const char *name);
 // Cleanup NPC
 void DeleteNPC(GameObject *obj);
 
+// Set up the prefab NPCs are spawned from (see SpawnPrefab)
+void InitNPCPrefab(Prefab *prefab);
+
+// Whether the NPC's fire cooldown has expired
+bool NPCCanAttack(const NPC *npc);
+
+// Script of a sentry: guards its post until hit, then patrols either side of it
+ScriptStatus NPCSentryScript(ScriptFrame *frame);
+
 // Initialize NPC-specific states for the given GameObject
 void InitNPCFSM(GameObject *obj);
 
 // NPC-specific behaviors for different states
 
 // Handle events in the idle state
-void NPCIdleHandleEvent(GameObject *obj, Event event);
+void NPCIdleHandleEvent(GameObject *obj, const EventData *event);
 
 // State transition functions for idle state
 void NPCEnterIdle(GameObject *obj);
@@ -36,47 +57,26 @@ void NPCUpdateIdle(GameObject *obj);
 void NPCExitIdle(GameObject *obj);
 
 // Handle events in the attacking state
-void NPCAttackingHandleEvent(GameObject *obj, Event event);
+void NPCAttackingHandleEvent(GameObject *obj, const EventData *event);
 
 // State transition functions for attacking state
 void NPCEnterAttacking(GameObject *obj);
 void NPCUpdateAttacking(GameObject *obj);
 void NPCExitAttacking(GameObject *obj);
 
-// Handle events in the moving up state
-void NPCMovingUpHandleEvent(GameObject *obj, Event event);
-
-// State transition functions for moving up state
-void NPCEnterMovingUp(GameObject *obj); 
-void NPCUpdateMovingUp(GameObject *obj);
-void NPCExitMovingUp(GameObject *obj);
-
-// Handle events in the moving down state
-void NPCMovingDownHandleEvent(GameObject *obj, Event event);
-
-// State transition functions for moving down state
-void NPCEnterMovingDown(GameObject *obj);  
-void NPCUpdateMovingDown(GameObject *obj); 
-void NPCExitMovingDown(GameObject *obj);   
-
-// Handle events in the moving left state
-void NPCMovingLeftHandleEvent(GameObject *obj, Event event);
-
-// State transition functions for moving up state
-void NPCEnterMovingLeft(GameObject *obj);  
-void NPCUpdateMovingLeft(GameObject *obj); 
-void NPCExitMovingLeft(GameObject *obj); 
+// Handle events in the moving state (any direction, see HandleMoveEvent)
+void NPCMovingHandleEvent(GameObject *obj, const EventData *event);
 
-// Handle events in the moving right state 
-void NPCMovingRightHandleEvent(GameObject *obj, Event event);
+// State transition functions for moving state
+void NPCEnterMoving(GameObject *obj);
+void NPCUpdateMoving(GameObject *obj);
+void NPCExitMoving(GameObject *obj);
 
-// State transition functions for moving up state
-void NPCEnterMovingRight(GameObject *obj);  
-void NPCUpdateMovingRight(GameObject *obj);
-void NPCExitMovingRight(GameObject *obj); 
+// Turn a moving NPC's walk clip toward its velocity without leaving the state
+void NPCFaceMoveDirection(NPC *npc);
 
 // Handle events in the dead state
-void NPCDeadHandleEvent(GameObject *obj, Event event);
+void NPCDeadHandleEvent(GameObject *obj, const EventData *event);
 
 // State transition functions for dead state
 void NPCEnterDead(GameObject *obj);
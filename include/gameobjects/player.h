@@ -8,6 +8,9 @@
 
 // Include the header for the base game object
 #include "gameobject.h"
+#include "../utils/timer_wheel.h"
+#include "../utils/status_effects.h"
+#include "../utils/asset_cache.h"
 
 // Define the Player structure that extends GameObject with additional properties like stamina and mana
 typedef struct
@@ -18,13 +21,14 @@ typedef struct
 
     // Rolling Variables
     bool rolling;
-    int rollTimer;
+    TimerId rollTimer; // Pending EVENT_ROLL_END
 
     // Attacking Variables
     bool attacking;
-    int attackTimer;
+    TimerId attackTimer;  // Pending EVENT_ATTACK_END
+    TimerId fireCooldown; // Attacking is blocked while pending (COMMAND_FIRE_COOLDOWN)
 
-    int ROLL_DURATION; // frames
+    int ROLL_DURATION; // ticks
     int ATTACK_DURATION;
 
     c2Circle attackArea;
@@ -37,13 +41,16 @@ Player *InitPlayer(const char *name);
 // Cleanup Player
 void DeletePlayer(GameObject *obj);
 
+// Can the player start an attack (fire cooldown expired)?
+bool PlayerCanAttack(const Player *player);
+
 // Initialize the finite state machine (FSM) for the Player (sets up the player's states)
 void InitPlayerFSM(GameObject *obj);
 
 // Player-specific behaviors for different states
 
 // Handle events in the idle state (when the player is not performing any action)
-void PlayerIdleHandleEvent(GameObject *obj, Event event);
+void PlayerIdleHandleEvent(GameObject *obj, const EventData *event);
 
 // State transition functions for idle state
 void PlayerEnterIdle(GameObject *obj);  // Called when entering the idle state
@@ -51,7 +58,7 @@ void PlayerUpdateIdle(GameObject *obj); // Called to update the player's behavio
 void PlayerExitIdle(GameObject *obj);   // Called when exiting the idle state
 
 // Handle events in the walking state (when the player is walking)
-void PlayerWalkingHandleEvent(GameObject *obj, Event event);
+void PlayerWalkingHandleEvent(GameObject *obj, const EventData *event);
 
 // State transition functions for walking state
 void PlayerEnterWalking(GameObject *obj);  // Called when entering the walking state
@@ -59,15 +66,21 @@ void PlayerUpdateWalking(GameObject *obj); // Called to update the player's beha
 void PlayerExitWalking(GameObject *obj);   // Called when exiting the walking state
 
 // Handle events in the rolling state (when the player is rolling)
-void PlayerRollingHandleEvent(GameObject *obj, Event event);
+void PlayerRollingHandleEvent(GameObject *obj, const EventData *event);
 
 // State transition functions for rolling state
 void PlayerEnterRolling(GameObject *obj);  // Called when entering the rolling state
 void PlayerUpdateRolling(GameObject *obj); // Called to update the player's behavior while rolling
 void PlayerExitRolling(GameObject *obj);   // Called when exiting the rolling state
 
+// Handle events of the action layer while the player's hands are free (see FSM_LAYER_ACTION)
+void PlayerReadyHandleEvent(GameObject *obj, const EventData *event);
+
+// Called when the action layer returns to ready, restores the locomotion animation
+void PlayerEnterReady(GameObject *obj);
+
 // Handle events in the attacking state (when the player is attacking)
-void PlayerAttackingHandleEvent(GameObject *obj, Event event);
+void PlayerAttackingHandleEvent(GameObject *obj, const EventData *event);
 
 // State transition functions for attacking state
 void PlayerEnterAttacking(GameObject *obj);  // Called when entering the attacking state
@@ -75,7 +88,7 @@ void PlayerUpdateAttacking(GameObject *obj); // Called to update the player's be
 void PlayerExitAttacking(GameObject *obj);   // Called when exiting the attacking state
 
 // Handle events in the shielding state (when the player is defending with a shield)
-void PlayerShieldingHandleEvent(GameObject *obj, Event event);
+void PlayerShieldingHandleEvent(GameObject *obj, const EventData *event);
 
 // State transition functions for shielding state
 void PlayerEnterShielding(GameObject *obj);  // Called when entering the shielding state
@@ -83,7 +96,7 @@ void PlayerUpdateShielding(GameObject *obj); // Called to update the player's be
 void PlayerExitShielding(GameObject *obj);   // Called when exiting the shielding state
 
 // Handle events in the die state (when the player dies)
-void PlayerDieHandleEvent(GameObject *obj, Event event);
+void PlayerDieHandleEvent(GameObject *obj, const EventData *event);
 
 // State transition functions for die state
 void PlayerEnterDie(GameObject *obj);  // Called when entering the die state
@@ -91,7 +104,7 @@ void PlayerUpdateDie(GameObject *obj); // Called to update the player's behavior
 void PlayerExitDie(GameObject *obj);   // Called when exiting the dead state
 
 // Handle events in the respawn state (when the player respawns)
-void PlayerRespawnHandleEvent(GameObject *obj, Event event);
+void PlayerRespawnHandleEvent(GameObject *obj, const EventData *event);
 
 // State transition functions for respawn state
 void PlayerEnterRespawn(GameObject *obj);  // Called when entering the respawn state
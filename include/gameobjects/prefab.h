@@ -0,0 +1,63 @@
+#ifndef PREFAB_H
+#define PREFAB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "gameobject.h"
+
+// Frees a prefab's archetype (e.g. DeleteNPC)
+typedef void (*PrefabDeleteFunction)(GameObject *obj);
+
+// A kind of game object set up once: texture, collider, health, FSM tables
+// and first clip. Instances are byte copies of the archetype, so they share
+// its texture, state configs and first clip frames, and only their position
+// is patched. Shared state configs are never freed through an instance.
+typedef struct
+{
+    const char *name;            // What the prefab spawns (e.g. "Skynet")
+    GameObject *archetype;       // Fully initialised object of the prefab's type
+    size_t size;                 // Size of that type (e.g. sizeof(NPC))
+    PrefabDeleteFunction Delete; // Frees the archetype
+} Prefab;
+
+// Storage for the instances of one prefab, allocated once
+typedef struct
+{
+    const Prefab *prefab;
+    unsigned char *storage; // capacity instances of prefab->size bytes
+    int capacity;           // Most instances
+    int count;              // Slots used so far, released ones included
+    int filled;             // Slots holding a copy of the archetype (see FillPrefabPool)
+    int *released;          // Slots given back by ReleasePrefabInstance, reused first
+    int releasedCount;
+} PrefabPool;
+
+// Register a prefab, it owns the archetype from now on
+void InitPrefab(Prefab *prefab, const char *name, GameObject *archetype, size_t size, PrefabDeleteFunction Delete);
+
+// Free the archetype, after every pool of the prefab is freed
+void FreePrefab(Prefab *prefab);
+
+// Allocate storage for capacity instances of a prefab
+void InitPrefabPool(PrefabPool *pool, const Prefab *prefab, int capacity);
+
+// Allocate the storage only, FillPrefabPool touches it later
+void ReservePrefabPool(PrefabPool *pool, const Prefab *prefab, int capacity);
+
+// Fill up to count unused slots with the archetype, true once all are filled
+bool FillPrefabPool(PrefabPool *pool, int count);
+
+// Copy the prefab into a free slot at a position (NULL when the pool is full)
+GameObject *SpawnPrefab(PrefabPool *pool, Vector2 position);
+
+// Spawn one instance per position, returns how many fit in the pool
+int SpawnPrefabs(PrefabPool *pool, const Vector2 *positions, int count, GameObject **spawned);
+
+// Give an instance's slot back to the pool, after it left the world
+void ReleasePrefabInstance(PrefabPool *pool, GameObject *obj);
+
+// Release every instance and free the storage
+void FreePrefabPool(PrefabPool *pool);
+
+#endif // PREFAB_H
@@ -0,0 +1,78 @@
+#ifndef PROJECTILE_H
+#define PROJECTILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <raylib.h>
+
+#include "../utils/entity_handle.h"
+#include "../utils/spatial_grid.h"
+#include "../render/render_list.h"
+
+// Projectiles in flight at once (bullet hell NPC attacks)
+#define PROJECTILE_CAPACITY 65536
+
+// Fastest a projectile may travel per tick, bounds the broad phase margin
+#define PROJECTILE_MAX_SPEED 16.0f
+
+// Radius of every projectile
+#define PROJECTILE_RADIUS 3.0f
+
+// A projectile that hit a target this tick
+typedef struct
+{
+    int target; // Entity index of the target hit
+    EntityHandle owner; // The shooter
+    int damage; // Damage carried by the projectile
+} ProjectileHit;
+
+// Pool of projectiles stored as structure of arrays. Live projectiles are kept
+// dense in [0, count) so integration is a straight, vectorisable loop and
+// expired projectiles are recycled by swapping the last one into their place.
+typedef struct
+{
+    float *x;         // Position x
+    float *y;         // Position y
+    float *vx;        // Velocity x (per tick)
+    float *vy;        // Velocity y (per tick)
+    int32_t *life;    // Ticks left before the projectile expires
+    EntityHandle *owner; // The shooter
+    uint8_t *faction; // Faction of the shooter, only other factions are hit
+    uint8_t *damage;  // Damage dealt on hit
+    int count;        // Live projectiles
+    int capacity;     // Pool size
+
+    SpatialGrid broadPhase; // Targets bucketed by grid cell (rebuilt each tick)
+
+    ProjectileHit *hits; // Hits of the last update
+    int hitCount;
+    int hitCapacity;
+} ProjectileSystem;
+
+// Allocate a projectile pool
+void InitProjectileSystem(ProjectileSystem *system, int capacity);
+
+// Spawn a projectile, returns false if the pool is full
+bool SpawnProjectile(ProjectileSystem *system, Vector2 position, Vector2 velocity, int life, EntityHandle owner, uint8_t faction, int damage);
+
+// Spawn count projectiles evenly spread around a circle (a bullet hell ring)
+void SpawnProjectileRing(ProjectileSystem *system, Vector2 centre, int count, float speed, float angleOffset, int life, EntityHandle owner, uint8_t faction, int damage);
+
+// Sweep projectiles against the targets, move them and recycle expired ones.
+// Hits are collected in system->hits for the caller to apply
+void UpdateProjectiles(ProjectileSystem *system, const SpatialAgent *targets, int targetCount);
+
+// Record every projectile as a single batch
+void DrawProjectiles(RenderList *list, const ProjectileSystem *system, Color color);
+
+// Remove every projectile
+void ClearProjectiles(ProjectileSystem *system);
+
+// Free the pool
+void FreeProjectileSystem(ProjectileSystem *system);
+
+// The projectile pool used by gameplay code (NPC attack states)
+ProjectileSystem *GetProjectileSystem(void);
+
+#endif // PROJECTILE_H
@@ -0,0 +1,97 @@
+#ifndef CLIENT_SERVER_H
+#define CLIENT_SERVER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../command/command.h"
+#include "../gameobjects/gameobject.h"
+#include "net_socket.h"
+#include "interpolation.h"
+
+// Players in a hosted game, the host always controls player 0
+#define CLIENT_SERVER_MAX_PLAYERS 4
+#define CLIENT_SERVER_MAX_CLIENTS (CLIENT_SERVER_MAX_PLAYERS - 1)
+
+// Entities replicated per snapshot, bounded by the interpolation buffers allocated
+#define CLIENT_SERVER_MAX_ENTITIES 256
+
+// Entities per snapshot packet (keeps packets below a typical 1200 byte MTU)
+#define SNAPSHOT_ENTITIES_PER_PACKET 44
+
+// Default interpolation delay in ticks (100ms at 60Hz)
+#define DEFAULT_INTERPOLATION_DELAY 6
+
+// Ticks a client may extrapolate past the newest snapshot before holding
+#define MAX_EXTRAPOLATION_TICKS 10
+
+typedef enum
+{
+    NET_ROLE_NONE,   // Single player or lockstep
+    NET_ROLE_HOST,   // Authoritative server that also has a local player
+    NET_ROLE_CLIENT  // Sends input, renders interpolated server snapshots
+} NetRole;
+
+// A client as seen by the host
+typedef struct
+{
+    bool connected;      // Has this slot been taken by a client?
+    NetAddress address;  // Where the client's packets come from
+    int player;          // Index of the player this client controls
+    PlayerInput input;   // Latest movement and pending action received from the client
+    bool hasInput;       // Has an input arrived since the last tick?
+    uint32_t viewTick;   // Server tick the client was rendering when it sent the action
+    uint32_t viewLag;    // Ticks the client's view trailed the host when its last input ran
+} RemoteClient;
+
+typedef struct
+{
+    NetRole role;
+    NetSocket socket;
+
+    // Host side
+    RemoteClient clients[CLIENT_SERVER_MAX_CLIENTS];
+    int clientCount; // Number of client slots (players - 1)
+
+    // Client side
+    NetAddress server;               // Address of the host
+    int localPlayer;                 // Player index assigned by the host (-1 until known)
+    int playerCount;                 // Players in the host's world
+    int entityCount;                 // Entities in the host's world
+    InterpolationBuffer *buffers;    // One interpolation buffer per replicated entity
+    uint32_t newestTick;             // Newest snapshot tick received
+    float renderTick;                // Fractional server tick being rendered
+    float interpolationDelay;        // Ticks the render tick trails the newest snapshot
+} ClientServerSession;
+
+// Start hosting on a port for up to clientCount clients
+bool InitHost(ClientServerSession *session, unsigned short port, int clientCount);
+
+// Connect to a host ("host:port"), rendering interpolationDelay ticks in the past
+bool InitClient(ClientServerSession *session, const char *serverAddress, float interpolationDelay);
+
+// Host: receive commands from clients (new clients are assigned a free player)
+void HostReceiveInputs(ClientServerSession *session);
+
+// Host: send a snapshot of the world to every connected client
+void HostBroadcastSnapshot(ClientServerSession *session, uint32_t tick, GameObject **objects, int count, int playerCount);
+
+// Host: ticks a player's view trails the simulation (0 for the host's own player)
+uint32_t PlayerViewLag(const ClientServerSession *session, int player);
+
+// Client: send the local command together with the tick currently rendered
+void ClientSendInput(ClientServerSession *session, PlayerInput input);
+
+// Client: receive snapshots into the interpolation buffers
+void ClientReceiveSnapshots(ClientServerSession *session);
+
+// Client: advance the render tick, keeping it interpolationDelay behind the newest snapshot
+void ClientAdvanceRenderTick(ClientServerSession *session);
+
+// Client: sample an entity at the current render tick
+bool ClientSampleEntity(const ClientServerSession *session, int entity, InterpolatedSample *sample);
+
+// Close the session
+void CloseClientServer(ClientServerSession *session);
+
+#endif // CLIENT_SERVER_H
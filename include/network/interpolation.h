@@ -0,0 +1,58 @@
+#ifndef INTERPOLATION_H
+#define INTERPOLATION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <raylib.h>
+
+#include "../fsm/fsm.h"
+#include "../utils/entity_handle.h"
+
+// Number of snapshots kept per remote entity, must be a power of two
+#define INTERPOLATION_SNAPSHOTS 8
+
+// A single received snapshot of a remote entity
+typedef struct
+{
+    uint32_t tick;     // Server tick the snapshot was taken at
+    EntityHandle handle; // Host's handle of the entity holding the index at that tick
+    Vector2 position;  // Position at that tick
+    Vector2 velocity;  // Velocity at that tick (selects directional animation clips)
+    State state;       // Replicated FSM state (drives the local animation clip)
+    State actionState; // Replicated action layer state (see FSM_LAYER_ACTION)
+    int health;        // Replicated health
+} EntitySnapshot;
+
+// Ring buffer of the most recent snapshots of one remote entity
+typedef struct
+{
+    EntitySnapshot snapshots[INTERPOLATION_SNAPSHOTS];
+    int count;  // Number of valid snapshots (up to INTERPOLATION_SNAPSHOTS)
+    int newest; // Index of the newest snapshot
+} InterpolationBuffer;
+
+// Result of sampling an interpolation buffer
+typedef struct
+{
+    Vector2 position; // Interpolated (or extrapolated) position
+    Vector2 velocity; // Velocity of the snapshot at or before the sample time
+    State state;      // State of the snapshot at or before the sample time
+    State actionState; // Action layer state of the same snapshot
+    int health;       // Health of the snapshot at or before the sample time
+    bool extrapolated; // Was the sample past the newest snapshot?
+} InterpolatedSample;
+
+// Reset a buffer, dropping all snapshots
+void ClearInterpolationBuffer(InterpolationBuffer *buffer);
+
+// Add a snapshot, out of order or duplicate snapshots are ignored
+void PushSnapshot(InterpolationBuffer *buffer, const EntitySnapshot *snapshot);
+
+// Newest tick in the buffer (0 if empty)
+uint32_t NewestSnapshotTick(const InterpolationBuffer *buffer);
+
+// Sample the buffer at a (fractional) render tick, extrapolating at most maxExtrapolation ticks
+bool SampleInterpolation(const InterpolationBuffer *buffer, float renderTick, float maxExtrapolation, InterpolatedSample *sample);
+
+#endif // INTERPOLATION_H
@@ -0,0 +1,50 @@
+#ifndef LAG_COMPENSATION_H
+#define LAG_COMPENSATION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../gameobjects/gameobject.h"
+
+// Ticks of collider history kept by the host, must be a power of two
+#define LAG_COMPENSATION_HISTORY 32
+
+// Furthest a hit may be rewound (250ms at 60Hz), bounds how far a lagging
+// or lying client can reach into the past
+#define LAG_COMPENSATION_MAX_REWIND 15
+
+// Short history of every entity's collider, stored as structure of arrays.
+// Each array holds LAG_COMPENSATION_HISTORY rows of maxEntities values, one row
+// per tick, so recording a tick writes three contiguous rows and a rewind
+// query reads three floats from the same row.
+typedef struct
+{
+    int maxEntities;                         // Entities per row
+    uint32_t ticks[LAG_COMPENSATION_HISTORY]; // Tick recorded in each row
+    int counts[LAG_COMPENSATION_HISTORY];     // Entities recorded in each row
+    bool valid[LAG_COMPENSATION_HISTORY];     // Has the row been recorded?
+    uint32_t newestTick;                      // Newest recorded tick
+    float *x;                                 // Collider centre x [row * maxEntities + entity]
+    float *y;                                 // Collider centre y [row * maxEntities + entity]
+    float *r;                                 // Collider radius   [row * maxEntities + entity]
+} ColliderHistory;
+
+// Allocate the history for up to maxEntities entities
+void InitColliderHistory(ColliderHistory *history, int maxEntities);
+
+// Record the colliders of every entity at the end of a tick
+void RecordColliderHistory(ColliderHistory *history, uint32_t tick, GameObject **objects, int count);
+
+// Clamp a view tick to what the history can answer (and LAG_COMPENSATION_MAX_REWIND)
+uint32_t ClampRewindTick(const ColliderHistory *history, uint32_t currentTick, uint32_t viewTick);
+
+// Collider of an entity as it was at a past tick, false if it was not recorded
+bool RewindCollider(const ColliderHistory *history, int entity, uint32_t tick, c2Circle *collider);
+
+// Follow the last entity to a new index, after whoever had it left the world
+void MoveColliderHistory(ColliderHistory *history, int from, int to);
+
+// Free the history
+void FreeColliderHistory(ColliderHistory *history);
+
+#endif // LAG_COMPENSATION_H
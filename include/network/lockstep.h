@@ -0,0 +1,80 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../command/command.h"
+#include "net_socket.h"
+
+// Maximum number of peers in a lockstep session (one player per peer)
+#define LOCKSTEP_MAX_PEERS 4
+
+// Ring buffer size for per-tick inputs, must be a power of two
+#define LOCKSTEP_INPUT_BUFFER 64
+
+// Number of most recent inputs repeated in every packet to hide packet loss
+// Must be greater than twice the input delay
+#define LOCKSTEP_REDUNDANCY 16
+
+// Ticks between state hash exchanges
+#define LOCKSTEP_HASH_INTERVAL 30
+
+// Ring buffer size for recorded local state hashes
+#define LOCKSTEP_HASH_HISTORY 16
+
+// Peer to peer deterministic lockstep session
+// Peers exchange only their PlayerInput per tick (one byte), so bandwidth does not depend on
+// how many NPCs are simulated, every peer runs the same deterministic simulation
+typedef struct
+{
+    bool active;    // Is lockstep mode running?
+    int localPeer;  // Index of the local peer (also the index of its player)
+    int peerCount;  // Number of peers including the local one
+    int inputDelay; // Ticks between sampling local input and executing it
+
+    NetSocket socket;                       // UDP socket shared by all peers
+    NetAddress peers[LOCKSTEP_MAX_PEERS];   // Peer addresses (local slot unused)
+
+    uint32_t currentTick;   // Next tick to simulate
+    uint32_t nextLocalTick; // Next tick the local input will be scheduled for
+
+    // Per peer input ring buffers, inputTicks marks which tick a slot holds
+    uint8_t inputs[LOCKSTEP_MAX_PEERS][LOCKSTEP_INPUT_BUFFER]; // Packed, see PackPlayerInput
+    int64_t inputTicks[LOCKSTEP_MAX_PEERS][LOCKSTEP_INPUT_BUFFER];
+
+    // Local state hashes recorded every LOCKSTEP_HASH_INTERVAL ticks
+    uint32_t hashes[LOCKSTEP_HASH_HISTORY];
+    int64_t hashTicks[LOCKSTEP_HASH_HISTORY];
+
+    // Latest hash checkpoint received from each peer
+    uint32_t remoteHashes[LOCKSTEP_MAX_PEERS];
+    int64_t remoteHashTicks[LOCKSTEP_MAX_PEERS];
+
+    bool desynced;        // Set once a state hash mismatch is detected
+    uint32_t desyncTick;  // Tick of the first detected mismatch
+    uint32_t stallFrames; // Consecutive frames spent waiting for peer input
+} LockstepSession;
+
+// Open a session, peerAddresses holds "host:port" for every peer (the local entry is ignored)
+bool InitLockstep(LockstepSession *session, int localPeer, int peerCount, unsigned short localPort, const char **peerAddresses, int inputDelay);
+
+// Schedule the local input for a future tick (currentTick + inputDelay) if not yet done
+void LockstepSubmitLocalInput(LockstepSession *session, PlayerInput input);
+
+// Send the local inputs to all peers and receive any waiting peer packets
+void LockstepPoll(LockstepSession *session);
+
+// Are the inputs of every peer known for the current tick?
+bool LockstepReadyToAdvance(const LockstepSession *session);
+
+// Input of a peer for the current tick (only valid when ready to advance)
+PlayerInput LockstepGetInput(const LockstepSession *session, int peer);
+
+// Finish the current tick, recording its state hash for desync detection
+void LockstepAdvance(LockstepSession *session, uint32_t stateHash);
+
+// Close the session socket
+void CloseLockstep(LockstepSession *session);
+
+#endif // LOCKSTEP_H
@@ -0,0 +1,43 @@
+#ifndef NET_SOCKET_H
+#define NET_SOCKET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Non-blocking UDP socket
+typedef struct
+{
+    intptr_t handle; // Platform socket handle
+    bool open;       // Is the socket open?
+} NetSocket;
+
+// IPv4 address and port, both stored in network byte order
+typedef struct
+{
+    uint32_t host;
+    uint16_t port;
+} NetAddress;
+
+// Initialise / shutdown the platform socket layer (Winsock on Windows)
+bool InitNetwork(void);
+void ExitNetwork(void);
+
+// Open a non-blocking UDP socket bound to the given local port
+bool OpenNetSocket(NetSocket *netSocket, unsigned short port);
+
+// Resolve "host:port" (e.g. "127.0.0.1:7778") into a NetAddress
+bool ResolveNetAddress(NetAddress *address, const char *hostAndPort);
+
+// Compare two addresses
+bool NetAddressEqual(const NetAddress *lhs, const NetAddress *rhs);
+
+// Send a datagram, returns false if it could not be sent
+bool NetSend(NetSocket *netSocket, const NetAddress *to, const void *data, int size);
+
+// Receive a datagram if one is waiting, returns its size or 0 if none is waiting
+int NetReceive(NetSocket *netSocket, NetAddress *from, void *buffer, int size);
+
+// Close the socket
+void CloseNetSocket(NetSocket *netSocket);
+
+#endif // NET_SOCKET_H
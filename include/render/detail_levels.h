@@ -0,0 +1,59 @@
+#ifndef DETAIL_LEVELS_H
+#define DETAIL_LEVELS_H
+
+#include <stdbool.h>
+
+#include <raylib.h>
+
+#include "../animation/animation.h"
+
+// Default distances from the local player where each level starts, in pixels
+#define DETAIL_REDUCED_DISTANCE 250.0f
+#define DETAIL_STATIC_DISTANCE 400.0f
+#define DETAIL_IMPOSTOR_DISTANCE 550.0f
+
+// Default distance past which health bars and labels are not drawn
+#define DETAIL_OVERLAY_DISTANCE 200.0f
+
+// Default ticks per animation update at the reduced level
+#define DETAIL_REDUCED_STRIDE 3
+
+// Side of the square drawn for an impostor
+#define DETAIL_IMPOSTOR_SIZE 6.0f
+
+// How much of an NPC is animated and drawn, by distance
+typedef enum
+{
+    DETAIL_FULL,     // Animated every tick
+    DETAIL_REDUCED,  // Animated every reducedStride ticks
+    DETAIL_STATIC,   // Holds its animation frame
+    DETAIL_IMPOSTOR, // A dot of its colour, no sprite
+    DETAIL_LEVEL_COUNT
+} DetailLevel;
+
+// Where each level of detail starts, set from the command line (--lod), and
+// how many awake NPCs were at each level last tick
+typedef struct
+{
+    float reducedDistance;
+    float staticDistance;
+    float impostorDistance;
+    float overlayDistance; // Health bars and labels only up to here
+    int reducedStride;
+
+    int counts[DETAIL_LEVEL_COUNT];
+} DetailLevels;
+
+// Use the default distances and stride
+void InitDetailLevels(DetailLevels *levels);
+
+// Level of something at position, seen from focus
+DetailLevel GetDetailLevel(const DetailLevels *levels, Vector2 focus, Vector2 position);
+
+// Whether health bar and label are drawn for something at position
+bool ShowsOverlay(const DetailLevels *levels, Vector2 focus, Vector2 position);
+
+// Set how often an animation updates at a level
+void SetAnimationDetail(AnimationData *animationData, const DetailLevels *levels, DetailLevel level);
+
+#endif // DETAIL_LEVELS_H
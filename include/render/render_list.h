@@ -0,0 +1,160 @@
+#ifndef RENDER_LIST_H
+#define RENDER_LIST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <raylib.h>
+
+// Room allocated up front, every array doubles when it runs out
+#define RENDER_LIST_INITIAL_COMMANDS 1024
+#define RENDER_LIST_INITIAL_TEXT 4096
+#define RENDER_LIST_INITIAL_POINTS 1024
+
+// Quads submitted per batch before checking the render batch limit
+#define RENDER_QUAD_CHUNK 1024
+
+// Sort keys: the layer in the top byte, y biased into the 24 bits below
+#define RENDER_SORT_Y_BIAS 0x800000
+#define RENDER_SORT_Y_MAX 0xFFFFFF
+
+// Element moves per command the incremental sort may spend before falling
+// back to a radix sort
+#define RENDER_SORT_MOVE_BUDGET 4
+
+// What draws over what, lowest first. Within a layer, lower y first
+typedef enum
+{
+    RENDER_LAYER_BACKGROUND,
+    RENDER_LAYER_WORLD,   // Entities and walls, y-sorted by their feet
+    RENDER_LAYER_EFFECTS, // Projectiles, trigger outlines
+    RENDER_LAYER_OVERLAY, // Health bars and labels, above every entity
+    RENDER_LAYER_HUD
+} RenderLayer;
+
+typedef enum
+{
+    RENDER_CLEAR,
+    RENDER_SPRITE,
+    RENDER_RECTANGLE,
+    RENDER_RECTANGLE_LINES,
+    RENDER_CIRCLE,
+    RENDER_CIRCLE_LINES,
+    RENDER_TEXT,
+    RENDER_QUADS
+} RenderCommandType;
+
+// One draw, holding copies of everything it needs so the simulation can
+// move on while it is submitted
+typedef struct
+{
+    uint8_t type; // RenderCommandType
+    Color color;  // Tint of sprites, colour of everything else
+    uint32_t key; // Layer and y, see SetDrawOrder
+    union
+    {
+        struct
+        {
+            Texture2D texture;
+            Rectangle source;
+            Vector2 position; // Top left corner
+        } sprite;
+        Rectangle rectangle;
+        struct
+        {
+            Vector2 centre;
+            float radius;
+        } circle;
+        struct
+        {
+            int offset;    // Start of the string in the list's text
+            int x, y;      // Top left, or top centre when centered
+            int size;
+            bool centered; // Measured when submitted
+        } text;
+        struct
+        {
+            int first;     // First centre in the list's points
+            int count;
+            float radius;  // Half the side of each square
+        } quads;
+    };
+} RenderCommand;
+
+// Everything one frame draws, recorded by the simulation and submitted to
+// the GPU by whoever owns the window (see RenderQueue)
+typedef struct
+{
+    RenderCommand *commands;
+    int count;
+    int capacity;
+    uint32_t key; // Stamped on every command pushed
+
+    int *order; // Submission order of the commands, valid once sorted
+    int orderCapacity;
+    bool sorted;
+
+    char *text; // Strings of the text commands, back to back
+    int textUsed;
+    int textCapacity;
+
+    Vector2 *points; // Centres of the quad commands
+    int pointCount;
+    int pointCapacity;
+} RenderList;
+
+// Sorts render lists, starting from the order of the previous frame since
+// entities barely move between two. Only used by the simulation's thread.
+typedef struct
+{
+    int *order;           // Sorted command indices of the last list
+    uint32_t *keys;       // Their keys, moved along while sorting
+    int *scratch;         // Radix sort buffers
+    uint32_t *scratchKeys;
+    int capacity;
+    int count;            // Commands of the last list (-1 before the first)
+
+    int moves;  // Moves the incremental sort of the last list took
+    bool radix; // The last list changed too much and was radix sorted
+} RenderSorter;
+
+// Allocate an empty render list
+void InitRenderList(RenderList *list);
+
+// Forget every command, keeping the memory for the next frame
+void ClearRenderList(RenderList *list);
+
+// Layer and y of the commands pushed next (background at y 0 after a clear)
+void SetDrawOrder(RenderList *list, RenderLayer layer, float y);
+
+// Record the draws, the same as the raylib function of the same shape
+void PushClear(RenderList *list, Color color);
+void PushSprite(RenderList *list, Texture2D texture, Rectangle source, Vector2 position, Color tint);
+void PushRectangle(RenderList *list, float x, float y, float width, float height, Color color);
+void PushRectangleLines(RenderList *list, float x, float y, float width, float height, Color color);
+void PushCircle(RenderList *list, Vector2 centre, float radius, Color color);
+void PushCircleLines(RenderList *list, Vector2 centre, float radius, Color color);
+void PushText(RenderList *list, const char *text, int x, int y, int size, Color color);
+
+// Text centred horizontally on x, measured when submitted
+void PushTextCentered(RenderList *list, const char *text, int x, int y, int size, Color color);
+
+// Squares of the same colour batched into one command, returns where to write count centres
+Vector2 *PushQuads(RenderList *list, int count, float radius, Color color);
+
+// Draw every command, between BeginDrawing and EndDrawing on the window's thread
+void SubmitRenderList(const RenderList *list);
+
+// Free the render list
+void FreeRenderList(RenderList *list);
+
+// Allocate a sorter without any previous order
+void InitRenderSorter(RenderSorter *sorter);
+
+// Order the commands of a list by key, ties in the order they were pushed
+void SortRenderList(RenderSorter *sorter, RenderList *list);
+
+// Free the sorter
+void FreeRenderSorter(RenderSorter *sorter);
+
+#endif // RENDER_LIST_H
@@ -0,0 +1,95 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "render_list.h"
+#include "../utils/input_manager.h"
+
+// Lists in flight: one submitted, one ready, one being recorded
+#define RENDER_QUEUE_LISTS 3
+
+// Runs one tick of the game and records what it draws
+typedef void (*SimulateFunction)(RenderList *list, void *context);
+
+// Work that needs the window's GL context (loading a texture)
+typedef void (*RenderJobFunction)(void *argument);
+
+// A texture released while a list recorded earlier may still draw it
+typedef struct
+{
+    Texture2D texture;
+    uint32_t list; // Number of the last list that may draw it
+} PendingUnload;
+
+// Where the last frame went, for the debug overlay
+typedef struct
+{
+    double simulateTime; // Seconds the last tick took to update and record
+    double submitTime;   // Seconds the last list took to submit
+    int commandCount;    // Commands of the last list submitted
+    int sortMoves;       // Moves sorting the last list from the one before took
+    bool sortRadix;      // The last list was radix sorted from scratch
+} RenderStats;
+
+// Hands the render lists of the simulation to the window's thread. The
+// simulation runs on its own thread and records a list per tick while the
+// window's thread submits the previous one, at most two ticks behind.
+typedef struct
+{
+    RenderList lists[RENDER_QUEUE_LISTS];
+    int recording;  // List the simulation records into
+    int ready;      // Newest list waiting to be submitted (-1 when none)
+    int submitting; // List the window's thread draws (-1 when none)
+
+    uint32_t listNumbers[RENDER_QUEUE_LISTS]; // Number of the tick each list was recorded by, from 1
+    uint32_t recorded;                        // Number of the newest list recorded or being recorded
+    PendingUnload *unloads; // Released textures, unloaded once their list was drawn
+    int unloadCount;
+    int unloadCapacity;
+
+    SimulateFunction simulate;
+    void *context;
+    RenderSorter sorter; // Sorts every list once recorded, on the simulation's thread
+
+    bool open;            // Between InitRenderQueue and CloseRenderQueue, lists may draw textures
+    bool threaded;        // False on the web and with --single-thread
+    bool stopping;        // The simulation finishes its tick and exits
+    bool simulationDone;  // The simulation thread exited
+    pthread_t simulationThread;
+    pthread_t windowThread;
+    pthread_mutex_t lock;
+    pthread_cond_t changed; // Signalled whenever anything above changes
+
+    RenderJobFunction job; // Pending GL work of the simulation (NULL when none)
+    void *jobArgument;
+
+    InputFrame input; // Sampled since the simulation last took it
+
+    RenderStats stats; // Written by both threads, read with GetRenderStats
+} RenderQueue;
+
+// Start the simulation, on its own thread unless threaded is false
+void InitRenderQueue(RenderQueue *queue, SimulateFunction simulate, void *context, bool threaded);
+
+// One frame on the window's thread: sample input, then submit the newest list
+void RenderFrame(RenderQueue *queue);
+
+// Stop the simulation after its current tick and free the lists
+void CloseRenderQueue(RenderQueue *queue);
+
+// Timings of the last tick and frame, from either thread
+RenderStats GetRenderStats(RenderQueue *queue);
+
+// Run a job on the window's thread, waiting for it (runs it directly there)
+void RunOnRenderThread(RenderJobFunction job, void *argument);
+
+// Unload a texture once every list recorded so far was drawn (directly while the queue is closed)
+void UnloadTextureAfterFrame(Texture2D texture);
+
+// The render queue of the game, initialised by main
+RenderQueue *GetRenderQueue(void);
+
+#endif // RENDER_QUEUE_H
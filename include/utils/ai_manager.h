@@ -1,10 +1,16 @@
 #ifndef AI_MANAGER_H
 #define AI_MANAGER_H
 
+#include <stdbool.h>
+
 #include "../command/command.h"
+#include "../gameobjects/gameobject.h"
+#include "influence_map.h"
 
 void InitAIManager();
-Command PollAI();
+Command DirectionToCommand(Vector2 direction);
+Command ChaseCommand(const GameObject *obj, const GameObject *target);
+Command PollAI(GameObject *obj, GameObject *target, bool targetVisible, const InfluenceMap *influence);
 void ExitInputManager();
 
 #endif // AI_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,54 @@
+#ifndef ASSET_CACHE_H
+#define ASSET_CACHE_H
+
+#include <raylib.h>
+
+// Assets loaded at once across every scene, and the longest path kept
+#define ASSET_CACHE_CAPACITY 32
+#define ASSET_PATH_LENGTH 128
+
+typedef enum
+{
+    ASSET_TEXTURE,
+    ASSET_SOUND
+} AssetType;
+
+// A loaded asset and how many holders share it
+typedef struct
+{
+    char path[ASSET_PATH_LENGTH];
+    AssetType type;
+    Texture2D texture;
+    Sound sound;
+    int references; // Unloaded when it drops to 0
+} CachedAsset;
+
+// Textures and sounds shared by path. A scene preparing in the background
+// acquires what the running scene already holds without loading it again,
+// and the last holder to release an asset unloads it.
+typedef struct
+{
+    CachedAsset assets[ASSET_CACHE_CAPACITY];
+    int count;
+    int loads; // Assets actually loaded from disk (debug statistics)
+} AssetCache;
+
+// Load a texture, or share it when it is already loaded
+Texture2D AcquireTexture(AssetCache *cache, const char *path);
+
+// Drop a reference to a texture, unloading it after the last one
+void ReleaseTexture(AssetCache *cache, Texture2D texture);
+
+// Load a sound (the audio device must be open), or share it when it is already loaded
+Sound AcquireSound(AssetCache *cache, const char *path);
+
+// Drop a reference to a sound, unloading it after the last one
+void ReleaseSound(AssetCache *cache, Sound sound);
+
+// Unload everything still held, before the window closes
+void FreeAssetCache(AssetCache *cache);
+
+// The asset cache shared by every scene
+AssetCache *GetAssetCache(void);
+
+#endif // ASSET_CACHE_H
@@ -0,0 +1,100 @@
+#ifndef BEHAVIOR_VM_H
+#define BEHAVIOR_VM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../command/command.h"
+#include "../gameobjects/gameobject.h"
+#include "influence_map.h"
+
+// Program limits, a behavior is a few dozen instructions
+#define BEHAVIOR_MAX_CODE 256
+#define BEHAVIOR_MAX_CONSTANTS 64
+#define BEHAVIOR_MAX_LABELS 64
+
+// Scratch registers and persistent blackboard slots of every NPC
+#define BEHAVIOR_REGISTERS 8
+#define BEHAVIOR_BLACKBOARD_SLOTS 8
+
+// Instructions an NPC may run per tick unless the program sets its own (.budget)
+#define BEHAVIOR_DEFAULT_BUDGET 64
+
+// Instructions are 32 bits: opcode, then three 8 bit operands or one 8 bit
+// operand and a 16 bit one (constant, jump target, command or ticks)
+#define BEHAVIOR_OPCODE(instruction) ((instruction) & 0xFF)
+#define BEHAVIOR_A(instruction) (((instruction) >> 8) & 0xFF)
+#define BEHAVIOR_B(instruction) (((instruction) >> 16) & 0xFF)
+#define BEHAVIOR_C(instruction) (((instruction) >> 24) & 0xFF)
+#define BEHAVIOR_WIDE(instruction) ((instruction) >> 16)
+
+typedef enum
+{
+    // Data and arithmetic
+    BEHAVIOR_OP_LOADK, // ra = constant
+    BEHAVIOR_OP_MOVE,  // ra = rb
+    BEHAVIOR_OP_LOAD,  // ra = blackboard slot
+    BEHAVIOR_OP_STORE, // blackboard slot = ra
+    BEHAVIOR_OP_ADD,   // ra = rb + rc
+    BEHAVIOR_OP_SUB,   // ra = rb - rc
+    BEHAVIOR_OP_MUL,   // ra = rb * rc
+    BEHAVIOR_OP_DIV,   // ra = rb / rc (0 when rc is 0)
+    BEHAVIOR_OP_LT,    // ra = rb < rc
+    BEHAVIOR_OP_LE,    // ra = rb <= rc
+    BEHAVIOR_OP_EQ,    // ra = rb == rc
+
+    // Control flow
+    BEHAVIOR_OP_JMP,    // Jump to a label
+    BEHAVIOR_OP_JMPIF,  // Jump when ra is not 0
+    BEHAVIOR_OP_JMPNOT, // Jump when ra is 0
+
+    // Perception queries
+    BEHAVIOR_OP_SEEN,      // ra = target visible
+    BEHAVIOR_OP_DIST,      // ra = distance to the target (huge without one)
+    BEHAVIOR_OP_HEALTH,    // ra = own health
+    BEHAVIOR_OP_CANATTACK, // ra = not attacking and the fire cooldown expired
+    BEHAVIOR_OP_CROWD,     // ra = ally influence where the NPC stands
+
+    // End the NPC's tick with a command
+    BEHAVIOR_OP_EMIT,    // The given command
+    BEHAVIOR_OP_CHASE,   // Move toward the target
+    BEHAVIOR_OP_RETREAT, // Move toward less threat
+    BEHAVIOR_OP_FLANK,   // Move around the crowd
+    BEHAVIOR_OP_WAIT,    // No command for the given ticks
+
+    BEHAVIOR_OP_COUNT
+} BehaviorOpcode;
+
+// A compiled behavior, shared by every NPC running it
+typedef struct
+{
+    uint32_t code[BEHAVIOR_MAX_CODE];
+    int length;
+    float constants[BEHAVIOR_MAX_CONSTANTS];
+    int constantCount;
+    int budget; // Instructions per NPC per tick
+} BehaviorProgram;
+
+// Where one NPC is in a behavior, kept across ticks
+typedef struct
+{
+    uint16_t pc;        // Next instruction
+    uint16_t waitTicks; // Ticks left of a wait
+    float registers[BEHAVIOR_REGISTERS];
+    float blackboard[BEHAVIOR_BLACKBOARD_SLOTS];
+} BehaviorState;
+
+// Compile behavior assembly, reporting errors with their line to stderr
+bool CompileBehavior(BehaviorProgram *program, const char *source);
+
+// Compile a behavior assembly file
+bool LoadBehaviorProgram(BehaviorProgram *program, const char *path);
+
+// Start a behavior from the top with a clear blackboard
+void ResetBehaviorState(BehaviorState *state);
+
+// Run an NPC's behavior until it decides this tick's command or runs out of budget
+Command RunBehavior(const BehaviorProgram *program, BehaviorState *state, GameObject *obj, GameObject *target,
+                    bool targetVisible, const InfluenceMap *influence);
+
+#endif // BEHAVIOR_VM_H
@@ -0,0 +1,51 @@
+#ifndef COMBAT_H
+#define COMBAT_H
+
+#include <stdbool.h>
+
+#include "../gameobjects/gameobject.h"
+
+// What dealt a piece of damage
+typedef enum
+{
+    DAMAGE_CONTACT,    // Bumping into an enemy
+    DAMAGE_MELEE,      // A player's attack area
+    DAMAGE_PROJECTILE, // A projectile hit
+    DAMAGE_STATUS,     // A status effect such as poison
+    DAMAGE_KIND_COUNT
+} DamageKind;
+
+// A piece of damage gathered during the tick
+typedef struct
+{
+    EntityHandle target; // The damaged object
+    EntityHandle source; // The attacker (empty for none)
+    int amount;          // Health to take off
+    DamageKind kind;     // What dealt the damage
+} DamageEvent;
+
+// Gathers the damage of a tick from every source so it is applied in one
+// pass at a single point of the tick, grouped by target
+typedef struct
+{
+    DamageEvent *events; // Damage queued this tick, in submission order
+    DamageEvent *sorted; // Scratch: the events while they are sorted by target
+    int count;           // Queued events
+    int capacity;        // Size of both event arrays
+} CombatQueue;
+
+// Prepare an empty combat queue
+void InitCombatQueue(CombatQueue *queue);
+
+// Queue damage against a target, applied by the next ResolveCombat
+void QueueDamage(CombatQueue *queue, EntityHandle target, EntityHandle source, int amount, DamageKind kind);
+
+// Apply every queued damage event grouped by target, resolving each target
+// through the entity table, and send EVENT_DIE to each object whose health
+// crossed zero. Returns the number of deaths
+int ResolveCombat(CombatQueue *queue);
+
+// Free the queue
+void FreeCombatQueue(CombatQueue *queue);
+
+#endif // COMBAT_H
@@ -8,8 +8,56 @@
 static const float COLLISION_BUFFER = 2.0f;
 static const float COLLISION_PUSH_BACK = 2.0f;
 
+// Simulation ticks per second
+#define TICKS_PER_SECOND 60
+
 // Firing Cooldown (0.1 seconds)
 static const double COMMAND_FIRE_COOLDOWN = 0.1f;
+#define COMMAND_FIRE_COOLDOWN_TICKS ((uint32_t)(COMMAND_FIRE_COOLDOWN * TICKS_PER_SECOND + 0.5))
+
+// Damage dealt to a player bumping into an NPC, and by a player's attack
+#define CONTACT_DAMAGE 5
+#define MELEE_DAMAGE 1
+
+// Share of the damage a shielding player still takes
+static const float SHIELD_DAMAGE_SCALE = 0.25f;
+
+// NPCs below this health retreat from threat
+#define NPC_RETREAT_HEALTH 30
+
+// Ally influence above which an NPC flanks instead of chasing straight in
+static const float NPC_CROWD_THRESHOLD = 2.5f;
+
+// Nearest hostiles an NPC leader considers when picking its target
+#define NPC_TARGET_CANDIDATES 4
+
+// How far a sentry patrols either side of its post, and how long it pauses at each end
+static const float NPC_SENTRY_PATROL_DISTANCE = 120.0f;
+#define NPC_SENTRY_PAUSE_TICKS 90
+
+// Frames of an NPC walk clip, the sprite sheet has one row of them per facing
+#define NPC_WALK_FRAMES 9
+
+// Ticks a dead NPC waits before respawning
+#define NPC_RESPAWN_TICKS 60
+
+// NPCs spawn on a grid of this many columns and spacing, in bands of rows
+// taken by the factions in turn (see CreateNPCs). The spacing is wider than
+// SQUAD_RADIUS, idle NPCs lead squads of their own instead of walking into
+// each other's formations, and stand still long enough to sleep
+#define NPC_SPAWN_COLUMNS 16
+#define NPC_SPAWN_BAND_ROWS 4
+static const float NPC_SPAWN_SPACING = 250.0f;
+
+// NPC bullet hell bursts: rings of projectiles fired while attacking
+static const float NPC_ATTACK_RANGE = 200.0f;
+static const float NPC_PROJECTILE_SPEED = 2.5f;
+#define NPC_BURST_TICKS 48          // Length of a burst
+#define NPC_BURST_INTERVAL_TICKS 6  // Ticks between rings in a burst
+#define NPC_BURST_RING_SIZE 24      // Projectiles per ring
+#define NPC_FIRE_COOLDOWN_TICKS 120 // Rest between bursts
+#define NPC_PROJECTILE_LIFE_TICKS 240
+#define NPC_PROJECTILE_DAMAGE 1
 
 // Firing Trigger Treshold
 static const float FIRING_TRIGGER_TRESHOLD = 0.1f;
@@ -22,4 +70,23 @@ static const float MOVE_VERTICAL_THRESHOLD = 0.5f;
 static const float MOVE_HORIZONTAL_THRESHOLD = 0.5f;
 static const float MOVE_DIAGONAL_THRESHOLD = 0.5f;
 
+// Assets shared through the asset cache (see AcquireTexture)
+#define PLAYER_SPRITE_SHEET "./assets/player_sprite_sheet.png"
+#define NPC_SPRITE_SHEET "./assets/npc_sprite_sheet.png"
+#define SECRET_SOUND "./assets/secret.wav"
+
+// Default per-tick state hash log (debug builds only), networked processes
+// started from the same directory each get their own
+#define STATE_HASH_LOG_PATH "state_hash.log"
+#define STATE_HASH_PEER_LOG_PATH "state_hash_peer%d.log"
+#define STATE_HASH_HOST_LOG_PATH "state_hash_host.log"
+#define STATE_HASH_CLIENT_LOG_PATH "state_hash_client.log"
+
+// Size of the level's static geometry grid in perception tiles (32 units each)
+#define LEVEL_WIDTH_TILES 128
+#define LEVEL_HEIGHT_TILES 128
+
+// Tags of trigger volumes
+#define TRIGGER_TAG_SECRET 1
+
 #endif // CONSTANTS_H
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef ENTITY_HANDLE_H
+#define ENTITY_HANDLE_H
+
+#include <stdint.h>
+
+// Handle to a game object that stays safe to hold after it is destroyed (see ResolveEntity)
+typedef struct
+{
+    int index;           // Slot in the entity table
+    uint32_t generation; // Generation of the slot (0 = no entity)
+} EntityHandle;
+
+#endif // ENTITY_HANDLE_H
@@ -0,0 +1,50 @@
+#ifndef ENTITY_TABLE_H
+#define ENTITY_TABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../gameobjects/gameobject.h"
+
+// Removes a destroyed game object from the world (lists, pools, storage)
+typedef void (*EntityDestroyFunction)(GameObject *obj, void *context);
+
+// Every live game object behind a generation-counted handle. Destruction is
+// deferred: QueueDestroy invalidates the handle at once, but the object stays
+// where it is until FlushDestroyQueue runs at the end of the tick, so nothing
+// iterating the world during the tick ever sees a hole.
+typedef struct
+{
+    GameObject **objects;  // Object of each slot (NULL while free)
+    uint32_t *generations; // Current generation of each slot, bumped on destroy
+    int *freeSlots;        // Stack of free slots
+    int freeCount;
+    int count;             // Live objects
+    int capacity;
+
+    GameObject **destroyQueue; // Destroyed this tick, removed by FlushDestroyQueue
+    int destroyCount;
+} EntityTable;
+
+// Allocate a table for up to capacity live objects
+void InitEntityTable(EntityTable *table, int capacity);
+
+// Give an object a handle, returns false when the table is full
+bool RegisterEntity(EntityTable *table, GameObject *obj);
+
+// The object behind a handle, NULL once it was destroyed
+GameObject *ResolveEntity(const EntityTable *table, EntityHandle handle);
+
+// Invalidate an object's handle now and remove it at the end of the tick
+bool QueueDestroy(EntityTable *table, GameObject *obj);
+
+// Remove the objects destroyed this tick through destroy, then free their slots
+void FlushDestroyQueue(EntityTable *table, EntityDestroyFunction destroy, void *context);
+
+// Free the table
+void FreeEntityTable(EntityTable *table);
+
+// The entity table of the world, objects destroy themselves through it
+EntityTable *GetEntityTable(void);
+
+#endif // ENTITY_TABLE_H
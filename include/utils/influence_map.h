@@ -0,0 +1,60 @@
+#ifndef INFLUENCE_MAP_H
+#define INFLUENCE_MAP_H
+
+#include <stdbool.h>
+
+#include "../gameobjects/gameobject.h"
+#include "perception.h"
+
+// Perception tiles per influence cell along each axis (cells align with the tilemap)
+#define INFLUENCE_TILES_PER_CELL 4
+
+// Size of an influence cell in world units
+#define INFLUENCE_CELL (PERCEPTION_TILE * INFLUENCE_TILES_PER_CELL)
+
+// What an influence layer measures
+typedef enum
+{
+    INFLUENCE_THREAT,    // Danger from players, higher near attacking players
+    INFLUENCE_ALLIES,    // Density of NPCs
+    INFLUENCE_PROXIMITY, // Closeness to a player, spreads the furthest
+    INFLUENCE_LAYER_COUNT
+} InfluenceLayer;
+
+// Low resolution grids of influence that spread out and fade over time. Each
+// layer is stored with a one cell border of zeros so the propagation kernel
+// runs over plain rows without edge checks.
+typedef struct
+{
+    int width;  // Cells across
+    int height; // Cells down
+    int stride; // Floats per padded row (width + 2)
+
+    float *values[INFLUENCE_LAYER_COUNT];  // Current influence, padded
+    float *next[INFLUENCE_LAYER_COUNT];    // Propagation output, swapped with values
+    float *sources[INFLUENCE_LAYER_COUNT]; // Deposits of this tick, padded
+} InfluenceMap;
+
+// Allocate a map covering width x height perception tiles
+void InitInfluenceMap(InfluenceMap *map, int widthTiles, int heightTiles);
+
+// Add influence at a world position for this tick
+void DepositInfluence(InfluenceMap *map, InfluenceLayer layer, Vector2 position, float amount);
+
+// Spread and fade every layer one step toward this tick's deposits, then clear the deposits
+void UpdateInfluenceMap(InfluenceMap *map);
+
+// Influence of a layer at a world position
+float SampleInfluence(const InfluenceMap *map, InfluenceLayer layer, Vector2 position);
+
+// Direction (unit, 8 way) to the neighbouring cell closer to the players but
+// away from threat and crowding, zero when staying is best
+Vector2 InfluenceFlankDirection(const InfluenceMap *map, Vector2 position);
+
+// Direction (unit, 8 way) to the neighbouring cell with the least threat, zero when staying is best
+Vector2 InfluenceRetreatDirection(const InfluenceMap *map, Vector2 position);
+
+// Free the map
+void FreeInfluenceMap(InfluenceMap *map);
+
+#endif // INFLUENCE_MAP_H
@@ -1,10 +1,31 @@
 #ifndef INPUT_MANAGER_H
 #define INPUT_MANAGER_H
 
+#include <stdbool.h>
+
 #include "../include/command/command.h"
 
+// Input sampled once per frame on the window's thread, what the simulation
+// reads (it may run on another thread, see RenderQueue)
+typedef struct
+{
+    PlayerInput commands; // Latest movement and action commands
+    bool confirm;         // ENTER pressed since the simulation last looked
+    bool cycle;           // TAB pressed since the simulation last looked
+    float frameTime;      // Seconds the last frame took, what animations advance by
+} InputFrame;
+
 void InitInputManager();
-Command PollInput();
+PlayerInput PollInput();
 void ExitInputManager();
 
+// Sample the keyboard and gamepad, on the window's thread
+InputFrame SampleInput(void);
+
+// Hand the simulation the input of its next tick
+void SetFrameInput(InputFrame input);
+
+// The input of the tick being simulated
+const InputFrame *GetFrameInput(void);
+
 #endif // INPUT_MANAGER_H
\ No newline at end of file
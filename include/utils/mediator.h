@@ -5,14 +5,16 @@
 
 #include "../include/command/command.h"
 #include "../include/gameobjects/gameobject.h"
+#include "entity_table.h"
 
 // Define the Mediator structure
 typedef struct Mediator
 {
-    GameObject *obj;
+    GameObject *obj;     // Only used while handle resolves to it
+    EntityHandle handle; // The object's handle when the mediator was created (empty if unregistered)
 } Mediator;
 
-// Function to create a mediator instance
+// Function to create a mediator instance, register the object first (see RegisterEntity)
 Mediator *CreateMediator(GameObject *obj);
 
 // Execute Command
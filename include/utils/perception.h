@@ -0,0 +1,73 @@
+#ifndef PERCEPTION_H
+#define PERCEPTION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../gameobjects/gameobject.h"
+
+// Size of a static geometry tile, perception is only recomputed when an observer or its target crosses one
+#define PERCEPTION_TILE 32.0f
+
+// How far NPCs can see
+#define PERCEPTION_RANGE 300.0f
+
+// Half angle of the vision cone (cos 60 degrees)
+#define PERCEPTION_CONE_COS 0.5f
+
+// Anything this close is noticed whichever way the NPC faces, walls still block it
+#define PERCEPTION_NEAR_RADIUS 48.0f
+
+// What a single observer last concluded, reused until something moves a tile
+typedef struct
+{
+    int observerTile;  // Packed tile of the observer when last computed
+    int target;        // Entity index of the target when last computed
+    int targetTile;    // Packed tile of the target when last computed
+    uint8_t facing;    // Facing octant when last computed
+    bool valid;        // False until computed once
+    bool visible;      // Whether the target was seen
+    Vector2 direction; // Facing, kept while the observer stands still
+} PerceptionCache;
+
+// Line of sight and vision cones against a grid of blocking tiles. Every
+// observer's view of its target is cached and only recomputed when the
+// observer or the target moves to another tile, the observer turns or picks
+// another target.
+typedef struct
+{
+    uint8_t *blocked; // One byte per tile, non zero tiles block sight
+    int width;        // Tiles across (tiles outside the grid never block)
+    int height;       // Tiles down
+
+    PerceptionCache *cache; // Indexed by entity index
+    int cacheCapacity;
+
+    int recomputed; // Observers recomputed by the last update (debug statistics)
+} Perception;
+
+// Allocate an empty level of width x height tiles for up to maxEntities observers
+void InitPerception(Perception *perception, int width, int height, int maxEntities);
+
+// Mark every tile overlapping a rectangle (in world units) as blocking
+void AddPerceptionWall(Perception *perception, Rectangle wall);
+
+// Whether the tile containing a world position blocks sight
+bool IsTileBlocked(const Perception *perception, Vector2 position);
+
+// Walk the tiles between two points, true if none of them blocks sight
+bool HasLineOfSight(const Perception *perception, Vector2 from, Vector2 to);
+
+// Refresh what every observer knows about its target (one batch per AI tick), targets may be NULL
+void UpdatePerception(Perception *perception, GameObject **observers, GameObject **targets, int count);
+
+// Whether an observer saw its target in the last UpdatePerception
+bool CanSeeTarget(const Perception *perception, const GameObject *observer);
+
+// Follow an observer from entity index from to to, the one at to left the world (from == to forgets it)
+void MovePerceptionCache(Perception *perception, int from, int to);
+
+// Free the level and caches
+void FreePerception(Perception *perception);
+
+#endif // PERCEPTION_H
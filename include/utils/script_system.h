@@ -0,0 +1,165 @@
+#ifndef SCRIPT_SYSTEM_H
+#define SCRIPT_SYSTEM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../events/events.h"
+#include "../gameobjects/gameobject.h"
+#include "timer_wheel.h"
+
+// Locals a script keeps across waits (ordinary locals are lost on every wait)
+#define SCRIPT_FRAME_VARS 4
+
+// A script that moved this close to its destination has arrived
+#define SCRIPT_ARRIVAL_RADIUS 4.0f
+
+// What a suspended script waits for
+typedef enum
+{
+    SCRIPT_WAIT_NONE,    // Ready to run on the next script tick
+    SCRIPT_WAIT_TICKS,   // A timer on the script system's wheel
+    SCRIPT_WAIT_EVENT,   // An event handled by its game object
+    SCRIPT_WAIT_ARRIVAL  // Its game object reaching a point
+} ScriptWait;
+
+// Result of running a script until it waits
+typedef enum
+{
+    SCRIPT_WAITING, // Suspended, resumed when its wait is over
+    SCRIPT_DONE     // Finished, its frame is recycled
+} ScriptStatus;
+
+typedef struct ScriptFrame ScriptFrame;
+
+// A script, written between SCRIPT_BEGIN and SCRIPT_END
+typedef ScriptStatus (*ScriptFunction)(ScriptFrame *frame);
+
+// Everything a suspended script keeps: the line to resume at, what it waits
+// for and a few locals. Frames are pooled, one per scripted game object.
+struct ScriptFrame
+{
+    GameObject *obj;         // The game object the script drives
+    ScriptFunction function; // The script
+    int line;                // Where to resume (0 = from the start)
+    ScriptWait wait;         // What the script waits for
+    Event event;             // Awaited event (SCRIPT_WAIT_EVENT)
+    Vector2 destination;     // Where it is going (SCRIPT_WAIT_ARRIVAL)
+    TimerId timer;           // Wake up timer (SCRIPT_WAIT_TICKS)
+    int vars[SCRIPT_FRAME_VARS]; // Locals that survive waits
+    int next;                // Next frame in the free list
+    int steeringSlot;        // Index in the steering list (-1 when not moving)
+};
+
+// Called before a script resumes or steers its game object, e.g. to wake it
+typedef void (*ScriptResumeFunction)(GameObject *obj, void *context);
+
+// Pool of script frames. Waiting costs nothing per tick: timers sit on the
+// system's own timer wheel, event waits are checked when the event is handled
+// and only scripts moving to a point are looked at every tick. Woken frames
+// are queued and resumed together by TickScripts.
+typedef struct
+{
+    ScriptFrame *frames; // Frame pool
+    int capacity;        // Frames in the pool
+    int freeList;        // First free frame (-1 when the pool is full)
+    int count;           // Running scripts
+
+    int *frameOf;        // Frame of each entity index (-1 when not scripted)
+    int entityCapacity;
+
+    int *ready;          // Frames to resume on the next tick
+    int readyCount;
+    int *resuming;       // Frames being resumed by TickScripts (-1 once stopped)
+    int resumingCount;
+    int *steering;       // Frames moving their game object to a point
+    int steeringCount;
+
+    TimerWheel wheel;    // Timers of the SCRIPT_WAIT_TICKS waits
+
+    ScriptResumeFunction resume; // Called before a script drives its game object (may be NULL)
+    void *context;               // Passed to resume
+} ScriptSystem;
+
+// Start a script function's body, the frame's line picks where it resumes
+#define SCRIPT_BEGIN(frame) \
+    switch ((frame)->line)  \
+    {                       \
+    case 0:
+
+// End a script function's body, the script is finished
+#define SCRIPT_END(frame) \
+    }                     \
+    (frame)->line = -1;   \
+    return SCRIPT_DONE
+
+// Return to the caller and continue from here when resumed. The line number
+// is the resume point, so one wait per line and no switch statements of the
+// script's own around a wait
+#define SCRIPT_SUSPEND(frame)         \
+    do                                \
+    {                                 \
+        (frame)->line = __LINE__;     \
+        return SCRIPT_WAITING;        \
+    case __LINE__:;                   \
+    } while (0)
+
+// Wait the given number of ticks
+#define SCRIPT_WAIT_TICKS(frame, ticks)     \
+    do                                      \
+    {                                       \
+        ScriptWaitTicks((frame), (ticks));  \
+        SCRIPT_SUSPEND(frame);              \
+    } while (0)
+
+// Wait until the game object handles an event
+#define SCRIPT_WAIT_EVENT(frame, awaited)     \
+    do                                        \
+    {                                         \
+        ScriptWaitEvent((frame), (awaited));  \
+        SCRIPT_SUSPEND(frame);                \
+    } while (0)
+
+// Walk the game object straight to a point and wait until it arrives (its
+// states must handle EVENT_MOVE, see HandleMoveEvent)
+#define SCRIPT_MOVE_TO(frame, point)       \
+    do                                     \
+    {                                      \
+        ScriptMoveTo((frame), (point));    \
+        SCRIPT_SUSPEND(frame);             \
+    } while (0)
+
+// Allocate capacity frames for game objects with entity indices below maxEntities
+void InitScriptSystem(ScriptSystem *system, int capacity, int maxEntities, ScriptResumeFunction resume, void *context);
+
+// Run a script on a game object from the next tick, replacing its current one.
+// Returns false if the pool is full
+bool StartScript(ScriptSystem *system, GameObject *obj, ScriptFunction function);
+
+// Stop the script of a game object (call before deleting it)
+void StopScript(ScriptSystem *system, GameObject *obj);
+
+// Follow a game object from entity index from to to, after the one at to stopped
+void MoveScriptEntity(ScriptSystem *system, int from, int to);
+
+// Whether a game object runs a script
+bool HasScript(const ScriptSystem *system, const GameObject *obj);
+
+// Used by SCRIPT_WAIT_TICKS, SCRIPT_WAIT_EVENT and SCRIPT_MOVE_TO
+void ScriptWaitTicks(ScriptFrame *frame, uint32_t ticks);
+void ScriptWaitEvent(ScriptFrame *frame, Event event);
+void ScriptMoveTo(ScriptFrame *frame, Vector2 destination);
+
+// Wake the script waiting for this event on the game object (called by HandleEvent)
+void NotifyScriptEvent(ScriptSystem *system, GameObject *obj, Event event);
+
+// Advance the script timers, steer moving scripts and resume the woken ones
+void TickScripts(ScriptSystem *system);
+
+// Free the frame pool
+void FreeScriptSystem(ScriptSystem *system);
+
+// The script system used by gameplay code
+ScriptSystem *GetScriptSystem(void);
+
+#endif // SCRIPT_SYSTEM_H
@@ -0,0 +1,66 @@
+#ifndef SLEEP_SYSTEM_H
+#define SLEEP_SYSTEM_H
+
+#include <stdbool.h>
+
+#include "../gameobjects/gameobject.h"
+
+// Ticks an entity must stay idle and still before it is put to sleep (2s at 60Hz)
+#define SLEEP_QUIET_TICKS 120
+
+// Sleepers within this distance of a player or moving entity wake up,
+// larger than the AI chase distance so nothing that could react stays asleep
+#define SLEEP_WAKE_RADIUS 320.0f
+
+// Cell size of the sleeper grid
+#define SLEEP_GRID_CELL 128.0f
+
+// Buckets of the sleeper grid (cells are hashed, the world is unbounded), power of two
+#define SLEEP_GRID_BUCKETS 1024
+
+// Parks idle entities out of the update, collision and AI lists.
+// Awake entities live in a dense active list, sleepers in a hashed
+// uniform grid so waking only looks at cells near something moving.
+typedef struct
+{
+    GameObject **objects;   // Every managed game object, indexed by slot
+    Vector2 *lastPositions; // Position of each awake object at the end of the last update
+    int *active;            // Slots of the awake objects, the only ones updated each tick
+    int *activeIndex;       // Index of each slot in active (-1 while asleep)
+    int *bucketOf;          // Grid bucket of each sleeper
+    int *nextSleeper;       // Next sleeper in the same bucket (-1 ends the list)
+    int *previousSleeper;   // Previous sleeper in the same bucket (-1 for the first)
+    int buckets[SLEEP_GRID_BUCKETS]; // First sleeper in each bucket (-1 when empty)
+    int count;              // Number of managed objects
+    int capacity;           // Maximum number of managed objects
+    int activeCount;        // Number of awake objects
+} SleepSystem;
+
+// Allocate a sleep system for up to capacity objects
+void InitSleepSystem(SleepSystem *system, int capacity);
+
+// Add an object (awake), returns its slot or -1 when full
+int AddToSleepSystem(SleepSystem *system, GameObject *obj);
+
+// Stop managing an object, the last slot moves into its place
+void RemoveFromSleepSystem(SleepSystem *system, GameObject *obj);
+
+// Wake an object, call before sending an event to an object that may be asleep
+void WakeGameObject(SleepSystem *system, GameObject *obj);
+
+// Wake every sleeper within radius of a position (e.g. a trigger volume)
+void WakeGameObjectsNear(SleepSystem *system, Vector2 position, float radius);
+
+// Collect the slots of the sleepers in the grid cells within radius of any of the points
+int FindSleepersNear(const SleepSystem *system, const float *x, const float *y, int pointCount, float radius, int *slots, int maxSlots);
+
+// Put quiet objects to sleep and wake sleepers near the wakers or anything that moved
+void UpdateSleepSystem(SleepSystem *system, GameObject **wakers, int wakerCount);
+
+// Free the sleep system
+void FreeSleepSystem(SleepSystem *system);
+
+// The sleep system parking the NPCs, events and triggers wake sleepers through it
+SleepSystem *GetSleepSystem(void);
+
+#endif // SLEEP_SYSTEM_H
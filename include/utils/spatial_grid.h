@@ -0,0 +1,58 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <raylib.h>
+
+// Grid cell size and hashed bucket count (power of two)
+#define SPATIAL_GRID_CELL 64.0f
+#define SPATIAL_GRID_BUCKETS 4096
+
+// Factions kept apart inside every bucket (at least FACTION_COUNT)
+#define SPATIAL_GRID_FACTIONS 4
+
+// Number of (bucket, faction) runs, the runs of bucket b are b * SPATIAL_GRID_FACTIONS onwards
+#define SPATIAL_GRID_RUNS (SPATIAL_GRID_BUCKETS * SPATIAL_GRID_FACTIONS)
+
+// Something placed in the grid, gathered every tick
+typedef struct
+{
+    Vector2 position; // Collider centre
+    float radius;     // Collider radius
+    int entity;       // Entity index (same order as GatherGameObjects)
+    uint8_t faction;  // Faction of the entity, different factions are hostile
+} SpatialAgent;
+
+// Broad phase shared by projectiles and target queries. Agents are bucketed
+// by every grid cell their collider (plus a margin) overlaps, counting sorted
+// by bucket and then faction, so each bucket is a contiguous run of agent
+// indices and the agents of one faction a contiguous run inside it.
+typedef struct
+{
+    int runStart[SPATIAL_GRID_RUNS + 1]; // Run r holds entries [runStart[r], runStart[r + 1])
+    int *entries;                        // Agent indices sorted by run
+    int *entryRuns;                      // Scratch: run of each entry while sorting
+    int *entryAgents;                    // Scratch: agent of each entry while sorting
+    int entryCapacity;
+} SpatialGrid;
+
+// Grid cell containing a world coordinate
+int SpatialGridCoordinate(float value);
+
+// Hashed bucket of a grid cell
+int SpatialGridBucket(int cellX, int cellY);
+
+// Bucket every agent in each cell within its radius plus margin
+void BuildSpatialGrid(SpatialGrid *grid, const SpatialAgent *agents, int count, float margin);
+
+// For each querying agent, find up to k agents of other factions within range,
+// nearest first. results holds k agent indices per query, counts how many were found
+void FindNearestHostiles(const SpatialGrid *grid, const SpatialAgent *agents, const int *queries, int queryCount,
+                         int k, float range, int *results, int *counts);
+
+// Free the grid buffers
+void FreeSpatialGrid(SpatialGrid *grid);
+
+#endif // SPATIAL_GRID_H
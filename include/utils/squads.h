@@ -0,0 +1,78 @@
+#ifndef SQUADS_H
+#define SQUADS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../command/command.h"
+#include "../gameobjects/gameobject.h"
+
+// Most NPCs in a squad, the leader included
+#define SQUAD_MAX_MEMBERS 8
+
+// NPCs within this distance of a leader join its squad
+#define SQUAD_RADIUS 200.0f
+
+// Ticks between regrouping the squads by proximity
+#define SQUAD_REFORM_TICKS 30
+
+// Distance between neighbouring formation slots
+#define SQUAD_SPACING 40.0f
+
+// Members this close to their slot move with the leader instead of toward the slot
+#define SQUAD_SLOT_TOLERANCE 8.0f
+
+// Buckets of the grid NPCs are recruited from (cells of SQUAD_RADIUS, hashed with the faction), power of two
+#define SQUAD_GRID_BUCKETS 1024
+
+// A group of NPCs led by its first member
+typedef struct
+{
+    GameObject *members[SQUAD_MAX_MEMBERS]; // members[0] is the leader
+    int memberCount;
+    Command order; // What the leader decided this tick
+} Squad;
+
+// Groups nearby NPCs into squads. Only leaders run the full AI, the members
+// hold a formation around their leader and join in its attacks.
+typedef struct
+{
+    Squad *squads;
+    int count;
+    int capacity;
+
+    int *squadOf; // Squad of each entity index (-1 for none)
+    int entityCapacity;
+
+    uint32_t formedTick; // Tick the squads were last formed
+    int formedFrom;      // Number of NPCs they were formed from
+    bool dirty;          // A leader died or fell asleep, regroup next tick
+
+    // Living NPCs not in a squad yet while forming them, by index into the
+    // NPCs given to FormSquads, in ascending order within each bucket
+    int *bucketOf;                   // Grid bucket of each NPC (-1 when not in the grid)
+    int *nextFree;                   // Next free NPC in the same bucket (-1 ends the list)
+    int *previousFree;               // Previous free NPC in the same bucket (-1 for the first)
+    int freeCapacity;                // NPCs the arrays above hold
+    int buckets[SQUAD_GRID_BUCKETS]; // First free NPC in each bucket (-1 when empty)
+} SquadSystem;
+
+// Allocate a squad system for entity indices below maxEntities
+void InitSquadSystem(SquadSystem *system, int maxEntities);
+
+// Whether the squads should be formed again this tick
+bool SquadsNeedReform(const SquadSystem *system, uint32_t tick, int npcCount);
+
+// Forget every squad, before members leave the world or are renumbered
+void DisbandSquads(SquadSystem *system);
+
+// Group the given NPCs into squads by proximity, in order so every peer agrees
+void FormSquads(SquadSystem *system, GameObject **npcs, int count, uint32_t tick);
+
+// Command for a squad member: hold its formation slot, or follow the leader's order
+Command SquadMemberCommand(const Squad *squad, int slot);
+
+// Free the squad system
+void FreeSquadSystem(SquadSystem *system);
+
+#endif // SQUADS_H
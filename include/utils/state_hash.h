@@ -0,0 +1,56 @@
+#ifndef STATE_HASH_H
+#define STATE_HASH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "../gameobjects/gameobject.h"
+
+// What CompareStateHashLogs returns when the logs match, or could not be read
+#define STATE_HASH_LOGS_MATCH -1
+#define STATE_HASH_LOGS_UNREADABLE -2
+
+// Per-tick hash of the simulation state, used to prove that two runs
+// (e.g. 1 thread vs 8 threads, native vs web) produced identical results.
+// Entity hashes are kept and folded into the world hash as entities change,
+// so a tick only rehashes what was simulated.
+typedef struct
+{
+    FILE *log;              // Per-tick hash log (NULL when logging is disabled)
+    bool logEntities;       // Also log every entity's hash, to find which one diverged
+    uint32_t tick;          // Tick of the last hashed world state
+    uint32_t worldHash;     // Hash of the whole world for the last tick
+    uint32_t *entityHashes; // Latest hash of each entity, by entity index
+    uint32_t sum;           // Sum of the entity hashes folded with their index
+    int count;              // Entities in the hash, [0, count)
+    int capacity;           // Size of entityHashes
+} StateHasher;
+
+// xxHash32 of an arbitrary block of memory
+uint32_t StateHash32(const void *data, size_t length, uint32_t seed);
+
+// Hash the simulation relevant fields of a single game object
+uint32_t HashGameObject(const GameObject *obj, uint32_t seed);
+
+// Open the hasher for up to capacity entities, logPath may be NULL to only keep the running hash
+void InitStateHasher(StateHasher *hasher, const char *logPath, int capacity);
+
+// Rehash a game object whose state may have changed, at its entity index
+void StateHashObject(StateHasher *hasher, const GameObject *obj);
+
+// The entity at from takes the place of the removed one at to (see RemoveGameObject)
+void MoveStateHashEntity(StateHasher *hasher, int from, int to);
+
+// Finish the world hash of a tick and append it to the log
+uint32_t StateHashTick(StateHasher *hasher, uint32_t tick);
+
+// Close the hash log
+void CloseStateHasher(StateHasher *hasher);
+
+// Compare two hash logs, reports the first divergent tick and, where both
+// logged entity hashes, the first divergent entity
+// Returns the divergent tick, STATE_HASH_LOGS_MATCH or STATE_HASH_LOGS_UNREADABLE
+long CompareStateHashLogs(const char *lhsPath, const char *rhsPath);
+
+#endif // STATE_HASH_H
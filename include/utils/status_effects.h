@@ -0,0 +1,65 @@
+#ifndef STATUS_EFFECTS_H
+#define STATUS_EFFECTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../gameobjects/gameobject.h"
+#include "combat.h"
+
+// Expiry of effects that last until removed (e.g. a shield held in STATE_SHIELD)
+#define STATUS_PERMANENT UINT32_MAX
+
+// Ticks between poison damage
+#define STATUS_POISON_INTERVAL 30
+
+// Kinds of status effect, each stored in its own dense arrays
+typedef enum
+{
+    STATUS_POISON, // Deals magnitude damage every STATUS_POISON_INTERVAL ticks
+    STATUS_SLOW,   // Scales movement by magnitude (0..1)
+    STATUS_STUN,   // Stops movement
+    STATUS_SHIELD, // Scales damage taken by magnitude (0..1)
+    STATUS_TYPE_COUNT
+} StatusType;
+
+// Every live effect of one type, structure of arrays kept dense in [0, count)
+typedef struct
+{
+    GameObject **objects; // Affected game object
+    float *magnitude;     // Strength, meaning depends on the type
+    uint32_t *expiry;     // Tick the effect ends on (STATUS_PERMANENT for never)
+    EntityHandle *source; // Whoever applied it (empty for none)
+    int count;
+    int capacity;
+} StatusEffectArray;
+
+// Status effects of every game object, ticked in one batch per type
+typedef struct
+{
+    StatusEffectArray effects[STATUS_TYPE_COUNT];
+} StatusEffects;
+
+// Allocate the effect arrays (they grow when full)
+void InitStatusEffects(StatusEffects *system, int capacity);
+
+// Apply an effect for ticks ticks (0 = until removed). Effects of the same type stack
+void ApplyStatusEffect(StatusEffects *system, GameObject *obj, StatusType type, float magnitude, uint32_t ticks, EntityHandle source);
+
+// Remove every effect of a type from an object
+void RemoveStatusEffects(StatusEffects *system, GameObject *obj, StatusType type);
+
+// Remove every effect from an object (before deleting it)
+void ClearStatusEffects(StatusEffects *system, GameObject *obj);
+
+// Expire finished effects, write the movement/damage modifiers of affected
+// objects and queue poison damage for the combat pass
+void TickStatusEffects(StatusEffects *system, CombatQueue *combat);
+
+// Free the effect arrays
+void FreeStatusEffects(StatusEffects *system);
+
+// The status effects used by gameplay code (state functions)
+StatusEffects *GetStatusEffects(void);
+
+#endif // STATUS_EFFECTS_H
@@ -0,0 +1,81 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../events/events.h"
+#include "../gameobjects/gameobject.h"
+
+// Hierarchical timing wheel: 4 levels of 256 slots cover any delay that fits
+// in 32 bits of ticks. Level 0 holds timers due in the next 256 ticks, each
+// higher level is 256 times coarser and is cascaded down as time advances.
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_BITS 8
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+
+// Timers allocated up front, the pool doubles when it runs out
+#define TIMER_WHEEL_INITIAL_CAPACITY 1024
+
+// Handle to a scheduled timer, stays safe to use after the timer expired
+typedef struct
+{
+    int index;           // Timer slot in the pool
+    uint32_t generation; // Generation of the timer (0 = no timer)
+} TimerId;
+
+// Delivers an expired timer's event to its game object
+typedef void (*TimerDeliverFunction)(GameObject *obj, Event event, void *context);
+
+typedef struct
+{
+    GameObject *target;  // Game object the event is delivered to (NULL = plain cooldown)
+    Event event;         // Event delivered on expiry
+    uint32_t expiry;     // Tick the timer expires on
+    uint32_t generation; // Bumped every time the timer is released
+    int slot;            // Wheel slot holding the timer (-1 while free)
+    int next;            // Next timer in the slot (or free list)
+    int previous;        // Previous timer in the slot
+} Timer;
+
+typedef struct
+{
+    Timer *timers;       // Timer pool
+    int capacity;        // Timers in the pool
+    int freeList;        // First free timer (-1 when the pool is full)
+    int pending;         // Scheduled timers
+    uint32_t now;        // Current tick
+    int slots[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS]; // First timer in each slot (-1 when empty)
+
+    TimerDeliverFunction deliver; // Called for every expired timer with a target
+    void *context;                // Passed to deliver
+} TimerWheel;
+
+// Prepare a timer wheel, deliver may be NULL to call HandleEvent directly
+void InitTimerWheel(TimerWheel *wheel, TimerDeliverFunction deliver, void *context);
+
+// Deliver event to target in ticks (at least 1) ticks, target may be NULL for a cooldown
+TimerId ScheduleTimer(TimerWheel *wheel, GameObject *target, Event event, uint32_t ticks);
+
+// Cancel a pending timer and clear the id, returns false if it was not pending
+bool CancelTimer(TimerWheel *wheel, TimerId *id);
+
+// Cancel every pending timer targeting a game object (call before deleting it)
+void CancelTimersFor(TimerWheel *wheel, GameObject *target);
+
+// Is the timer still waiting to expire?
+bool IsTimerPending(const TimerWheel *wheel, TimerId id);
+
+// Ticks until the timer expires, 0 if it is not pending
+uint32_t TimerRemaining(const TimerWheel *wheel, TimerId id);
+
+// Advance one tick and deliver the timers expiring on it
+void AdvanceTimerWheel(TimerWheel *wheel);
+
+// Free the timer pool
+void FreeTimerWheel(TimerWheel *wheel);
+
+// The central timer service used by gameplay code (states, cooldowns)
+TimerWheel *GetTimerService(void);
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,98 @@
+#ifndef TRIGGER_VOLUMES_H
+#define TRIGGER_VOLUMES_H
+
+#include <stdbool.h>
+
+#include "../gameobjects/gameobject.h"
+
+// Cell size of the trigger grid
+#define TRIGGER_GRID_CELL 128.0f
+
+// Buckets of the trigger grid (cells are hashed, the world is unbounded), power of two
+#define TRIGGER_GRID_BUCKETS 4096
+
+// Most triggers a single entity can be inside at once
+#define TRIGGER_MAX_OVERLAPS 8
+
+// Shape of a trigger volume
+typedef enum
+{
+    TRIGGER_SHAPE_BOX,
+    TRIGGER_SHAPE_CIRCLE
+} TriggerShape;
+
+// A zone that reports entities entering and leaving it
+typedef struct
+{
+    TriggerShape shape;
+    c2AABB box;      // Used when shape is TRIGGER_SHAPE_BOX
+    c2Circle circle; // Used when shape is TRIGGER_SHAPE_CIRCLE
+    int tag;         // What the trigger is for, interpreted by the game (e.g. a secret area)
+} TriggerVolume;
+
+// Whether an entity entered or left a trigger
+typedef enum
+{
+    TRIGGER_ENTER,
+    TRIGGER_EXIT
+} TriggerEventType;
+
+// An entity crossing a trigger's boundary
+typedef struct
+{
+    int trigger;           // Index of the trigger volume
+    GameObject *obj;       // The entity that crossed it
+    TriggerEventType type; // Entered or left
+} TriggerEvent;
+
+// Which triggers an entity is inside, and where it was last checked
+typedef struct
+{
+    Vector2 lastPosition;
+    int inside[TRIGGER_MAX_OVERLAPS];
+    int insideCount;
+    bool tracked; // False until the entity is first checked
+} TriggerOccupant;
+
+// Static trigger volumes bucketed in a hashed uniform grid. Only entities that
+// moved since the last update are checked, and only against the triggers of
+// the cell they are in, so idle entities and far away triggers cost nothing.
+typedef struct
+{
+    TriggerVolume *volumes;
+    int count;
+    int capacity;
+
+    int buckets[TRIGGER_GRID_BUCKETS]; // First node of each bucket (-1 when empty)
+    int *nodeTrigger;                  // Trigger of each grid node
+    int *nodeNext;                     // Next node in the same bucket (-1 ends the list)
+    int nodeCount;
+    int nodeCapacity;
+
+    TriggerOccupant *occupants; // Indexed by entity index
+    int occupantCapacity;
+
+    TriggerEvent *events; // Crossings of the last update
+    int eventCount;
+    int eventCapacity;
+} TriggerVolumes;
+
+// Allocate trigger volumes for entities with indices below maxEntities
+void InitTriggerVolumes(TriggerVolumes *system, int maxEntities);
+
+// Add a box trigger, returns its index
+int AddTriggerBox(TriggerVolumes *system, c2AABB box, int tag);
+
+// Add a circle trigger, returns its index
+int AddTriggerCircle(TriggerVolumes *system, c2Circle circle, int tag);
+
+// Check the entities that moved and collect enter/exit events in system->events
+void UpdateTriggerVolumes(TriggerVolumes *system, GameObject **objects, int count);
+
+// Follow an entity from index from to to, the one at to left the world (from == to forgets it)
+void MoveTriggerOccupant(TriggerVolumes *system, int from, int to);
+
+// Free the trigger volumes
+void FreeTriggerVolumes(TriggerVolumes *system);
+
+#endif // TRIGGER_VOLUMES_H
@@ -1,8 +1,10 @@
+#include <math.h>
 #include <stdlib.h>
 #include <time.h>
 
 #include "../include/command/command.h"
 #include "../include/utils/ai_manager.h"
+#include "../include/utils/constants.h"
 
 #include "../include/gameobjects/npc.h"
 #include "../include/gameobjects/player.h"
@@ -41,6 +43,60 @@ Command NPCFollowPlayer(NPC *obj, Player player)
     return COMMAND_NONE;
 }
 
+/**
+ * DirectionToCommand - Converts a direction into a move command.
+ *
+ * @direction: The direction to move in, need not be normalised.
+ *
+ * Return: The move command along the dominant axis, or COMMAND_NONE for zero.
+ */
+Command DirectionToCommand(Vector2 direction)
+{
+    if (direction.x == 0.0f && direction.y == 0.0f)
+    {
+        return COMMAND_NONE;
+    }
+
+    if (fabsf(direction.y) >= fabsf(direction.x))
+    {
+        return direction.y < 0.0f ? COMMAND_MOVE_UP : COMMAND_MOVE_DOWN;
+    }
+
+    return direction.x < 0.0f ? COMMAND_MOVE_LEFT : COMMAND_MOVE_RIGHT;
+}
+
+/**
+ * ChaseCommand - Returns the move command closing in on a target.
+ *
+ * @obj:    The chasing game object.
+ * @target: What it chases.
+ *
+ * Lines up vertically first, then horizontally.
+ *
+ * Return: The move command, or COMMAND_NONE when standing on the target.
+ */
+Command ChaseCommand(const GameObject *obj, const GameObject *target)
+{
+    if (obj->position.y > target->position.y)
+    {
+        return COMMAND_MOVE_UP;
+    }
+    else if (obj->position.y < target->position.y)
+    {
+        return COMMAND_MOVE_DOWN;
+    }
+    else if (obj->position.x > target->position.x)
+    {
+        return COMMAND_MOVE_LEFT;
+    }
+    else if (obj->position.x < target->position.x)
+    {
+        return COMMAND_MOVE_RIGHT;
+    }
+
+    return COMMAND_NONE;
+}
+
 /**
  * PollAI - Retrieves a random command from the AI.
  *
@@ -48,41 +104,43 @@ Command NPCFollowPlayer(NPC *obj, Player player)
  * `rand()` function to select a command from the available pool of commands, with
  * the total number of commands being defined by `COMMAND_COUNT`.
  *
+ * The NPC only chases or attacks a target it can see (see UpdatePerception),
+ * so walls and the NPC's facing matter, not just the distance. The target is
+ * the hostile picked by the nearest target query, a player or an NPC of
+ * another faction. A hurt NPC
+ * retreats from threat and an NPC in a crowd flanks around it, both read
+ * from the influence map instead of looking at every other entity.
+ *
  * @return: A randomly chosen Command value from the range [0, COMMAND_COUNT-1].
  */
-Command PollAI(GameObject *obj, GameObject* player)
+Command PollAI(GameObject *obj, GameObject *target, bool targetVisible, const InfluenceMap *influence)
 {
-    if (obj->health <= 0)
+    // Dead NPCs wait for their respawn timer
+    if (obj->currentState == STATE_DEAD)
     {
-        obj->position.x = 450;
-        obj->position.y = 450;
-
-        obj->collider.p.x = obj->position.x;
-        obj->collider.p.y = obj->position.y;
-
-        obj->health = 100;
+        return COMMAND_NONE;
+    }
+    // Close enough to the target for a bullet burst
+    else if (targetVisible && Vector2Distance(obj->position, target->position) < NPC_ATTACK_RANGE &&
+             obj->currentState != STATE_ATTACKING && NPCCanAttack((NPC *)obj))
+    {
+        return COMMAND_ATTACK;
+    }
+    // Badly hurt, back away from the players
+    else if (targetVisible && obj->health < NPC_RETREAT_HEALTH)
+    {
+        return DirectionToCommand(InfluenceRetreatDirection(influence, obj->position));
+    }
+    // Too many NPCs here already, go around them
+    else if (targetVisible && SampleInfluence(influence, INFLUENCE_ALLIES, obj->position) > NPC_CROWD_THRESHOLD)
+    {
+        return DirectionToCommand(InfluenceFlankDirection(influence, obj->position));
     }
-    // If the player is in range
-    else if (Vector2Distance(obj->position, player->position) < 300.0f)
+    // If the target is in sight
+    else if (targetVisible)
     {
-        if (obj->position.y > player->position.y)
-        {
-            return COMMAND_MOVE_UP;
-        }
-        else if (obj->position.y < player->position.y)
-        {
-            return COMMAND_MOVE_DOWN;
-        }
-        else if (obj->position.x > player->position.x)
-        {
-            return COMMAND_MOVE_LEFT;
-        }
-        else if (obj->position.x < player->position.x)
-        {
-            return COMMAND_MOVE_RIGHT;
-        }
+        return ChaseCommand(obj, target);
     }
-    
 
     return COMMAND_NONE;
 }
@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include "../include/animation/animation.h"
+#include "../include/utils/input_manager.h"
 
 /**
  * InitAnimation - Initialises an animation with the given parameters.
@@ -27,19 +28,45 @@ void InitAnimation(AnimationData *animationData,
                    float frameDuration,
                    bool loop)
 {
-    // Store texture and allocate memory for frame data in animationData
-    animationData->texture = texture;
-    animationData->frames = (Rectangle *)malloc(frameCount * sizeof(Rectangle));
+    // Allocate memory for the frame data
+    Rectangle *copy = (Rectangle *)malloc(frameCount * sizeof(Rectangle));
 
-    // Copy each frame from frames array to animationData's frames
-    if (animationData->frames != NULL)
+    // Copy each frame from frames array to the animation's own frames
+    if (copy != NULL)
     {
         for (int i = 0; i < frameCount; i++)
         {
-            animationData->frames[i] = frames[i];
+            copy[i] = frames[i];
         }
     }
 
+    InitSharedAnimation(animationData, texture, copy, frameCount, frameDuration, loop);
+}
+
+/**
+ * InitSharedAnimation - Initialises an animation playing frames it does not own.
+ *
+ * @animationData: The animation to initialise.
+ * @texture:       The sprite sheet the frames are cut from.
+ * @frames:        The frames, kept alive by the caller for as long as the
+ *                 animation plays them.
+ * @frameCount:    The total number of frames in the animation.
+ * @frameDuration: The duration each frame should be displayed, in seconds.
+ * @loop:          Whether the animation loops back to the first frame.
+ *
+ * Nothing is allocated, so objects that replay the same clip on every state
+ * change can all point at one static table of frames.
+ */
+void InitSharedAnimation(AnimationData *animationData,
+                         Texture2D texture,
+                         Rectangle *frames,
+                         int frameCount,
+                         float frameDuration,
+                         bool loop)
+{
+    animationData->texture = texture;
+    animationData->frames = frames;
+
     // Initialise animation properties
     animationData->frameCount = frameCount;
     animationData->frameDuration = frameDuration;
@@ -47,6 +74,9 @@ void InitAnimation(AnimationData *animationData,
     animationData->currentFrame = 0;  // Start at the first frame
     animationData->frameTimer = 0.0f; // Reset frame timer to zero
     animationData->active = true;     // Set animation as active by default
+    animationData->updateStride = 1;  // Full rate until a detail level says otherwise
+    animationData->skippedUpdates = 0;
+    animationData->skippedTime = 0.0f;
 }
 
 /**
@@ -68,11 +98,31 @@ void UpdateAnimation(AnimationData *animationData)
         return;
     }
 
-    // Update frame timer with delta time (time elapsed since last frame)
-    animationData->frameTimer += GetFrameTime();
+    // Far away animations hold their frame (see SetAnimationDetail)
+    if (animationData->updateStride == 0)
+    {
+        return;
+    }
+
+    // Mid-range ones advance every updateStride updates, by the time of all of them
+    animationData->skippedTime += GetFrameInput()->frameTime;
+    if (++animationData->skippedUpdates < animationData->updateStride)
+    {
+        return;
+    }
+
+    // Update frame timer with delta time (time elapsed since last frame, sampled
+    // on the window's thread)
+    animationData->frameTimer += animationData->skippedTime;
+    animationData->skippedUpdates = 0;
+    animationData->skippedTime = 0.0f;
+
+    // Time held back by a reduced rate is kept across frames, so the animation
+    // skips frames rather than slowing down
+    bool catchUp = animationData->updateStride > 1 && animationData->frameDuration > 0.0f;
 
     // Check if it's time to advance to the next frame
-    if (animationData->frameTimer >= animationData->frameDuration)
+    while (animationData->frameTimer >= animationData->frameDuration)
     {
         animationData->currentFrame++; // Move to the next frame
 
@@ -90,13 +140,19 @@ void UpdateAnimation(AnimationData *animationData)
         }
 
         // Reset the frame timer after advancing frames
-        animationData->frameTimer = 0.0f;
+        if (!catchUp)
+        {
+            animationData->frameTimer = 0.0f;
+            break;
+        }
+        animationData->frameTimer -= animationData->frameDuration;
     }
 }
 
 /**
  * RenderAnimation - Renders the current frame of the animation at a specified position.
  *
+ * @list:          The render list of the frame, the sprite is recorded into it.
  * @animationData: A constant pointer to the AnimationData structure, which holds
  *                 all the information needed to display the animation.
  * @position:      A Vector2 specifying the x and y screen coordinates where the
@@ -107,7 +163,7 @@ void UpdateAnimation(AnimationData *animationData)
  * animationData, adjusts the drawing position to center the texture, and renders
  * the frame at the specified position with the given tint.
  */
-void RenderAnimation(const AnimationData *animationData, Vector2 position, Color tint)
+void RenderAnimation(RenderList *list, const AnimationData *animationData, Vector2 position, Color tint)
 {
     // If the animation is inactive, don't render it
     if (!animationData->active)
@@ -124,8 +180,9 @@ void RenderAnimation(const AnimationData *animationData, Vector2 position, Color
         position.y - frame.height / 2 // Offset Y by half the frame height
     };
 
-    // Render the current frame with the given tint color
-    DrawTextureRec(
+    // Record the current frame with the given tint color, the texture and frame are copied
+    PushSprite(
+        list,
         animationData->texture,
         frame,
         adjustedPosition,
@@ -0,0 +1,212 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/utils/asset_cache.h"
+#include "../include/render/render_queue.h"
+
+// The asset cache shared by every scene
+static AssetCache assetCache;
+
+// A texture load handed to the window's thread
+typedef struct
+{
+    const char *path;
+    Texture2D texture;
+} TextureLoad;
+
+// Texture load job, GL calls only work on the window's thread
+static void LoadTextureJob(void *argument)
+{
+    TextureLoad *load = (TextureLoad *)argument;
+    load->texture = LoadTexture(load->path);
+}
+
+/**
+ * GetAssetCache - Returns the asset cache shared by every scene.
+ *
+ * Game objects load their sprite sheets from their init functions, which
+ * only receive a name, so they go through this shared cache.
+ *
+ * Return: The asset cache.
+ */
+AssetCache *GetAssetCache(void)
+{
+    return &assetCache;
+}
+
+// Finds a loaded asset by path
+static CachedAsset *FindAsset(AssetCache *cache, const char *path, AssetType type)
+{
+    for (int i = 0; i < cache->count; i++)
+    {
+        if (cache->assets[i].type == type && strcmp(cache->assets[i].path, path) == 0)
+        {
+            return &cache->assets[i];
+        }
+    }
+
+    return NULL;
+}
+
+// Claims an entry for a new asset
+static CachedAsset *AddAsset(AssetCache *cache, const char *path, AssetType type)
+{
+    if (cache->count >= ASSET_CACHE_CAPACITY || strlen(path) >= ASSET_PATH_LENGTH)
+    {
+        fprintf(stderr, "Asset cache cannot hold %s\n", path);
+        return NULL;
+    }
+
+    CachedAsset *asset = &cache->assets[cache->count++];
+    memset(asset, 0, sizeof(CachedAsset));
+    strcpy(asset->path, path);
+    asset->type = type;
+    return asset;
+}
+
+// Unloads an asset and fills its entry with the last one, a texture once
+// the lists that may still draw it were submitted
+static void RemoveAsset(AssetCache *cache, CachedAsset *asset)
+{
+    if (asset->type == ASSET_TEXTURE)
+    {
+        UnloadTextureAfterFrame(asset->texture);
+    }
+    else
+    {
+        UnloadSound(asset->sound);
+    }
+
+    *asset = cache->assets[--cache->count];
+}
+
+/**
+ * AcquireTexture - Loads a texture or shares the loaded one.
+ *
+ * @cache: The asset cache.
+ * @path:  Path of the image.
+ *
+ * Every call must be matched by a ReleaseTexture.
+ *
+ * Return: The texture (id 0 if it could not be loaded).
+ */
+Texture2D AcquireTexture(AssetCache *cache, const char *path)
+{
+    CachedAsset *asset = FindAsset(cache, path, ASSET_TEXTURE);
+
+    if (asset == NULL)
+    {
+        TextureLoad load = {path, {0}};
+        RunOnRenderThread(LoadTextureJob, &load);
+        Texture2D texture = load.texture;
+
+        asset = AddAsset(cache, path, ASSET_TEXTURE);
+        if (asset == NULL)
+        {
+            return texture; // Unshared, ReleaseTexture will not find it
+        }
+
+        asset->texture = texture;
+        cache->loads++;
+    }
+
+    asset->references++;
+    return asset->texture;
+}
+
+/**
+ * ReleaseTexture - Drops a reference to a texture.
+ *
+ * @cache:   The asset cache.
+ * @texture: A texture returned by AcquireTexture.
+ */
+void ReleaseTexture(AssetCache *cache, Texture2D texture)
+{
+    for (int i = 0; i < cache->count; i++)
+    {
+        CachedAsset *asset = &cache->assets[i];
+
+        if (asset->type == ASSET_TEXTURE && asset->texture.id == texture.id)
+        {
+            if (--asset->references == 0)
+            {
+                RemoveAsset(cache, asset);
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * AcquireSound - Loads a sound or shares the loaded one.
+ *
+ * @cache: The asset cache.
+ * @path:  Path of the sound file.
+ *
+ * Every call must be matched by a ReleaseSound, before the audio device closes.
+ *
+ * Return: The sound.
+ */
+Sound AcquireSound(AssetCache *cache, const char *path)
+{
+    CachedAsset *asset = FindAsset(cache, path, ASSET_SOUND);
+
+    if (asset == NULL)
+    {
+        Sound sound = LoadSound(path);
+
+        asset = AddAsset(cache, path, ASSET_SOUND);
+        if (asset == NULL)
+        {
+            return sound;
+        }
+
+        asset->sound = sound;
+        cache->loads++;
+    }
+
+    asset->references++;
+    return asset->sound;
+}
+
+/**
+ * ReleaseSound - Drops a reference to a sound.
+ *
+ * @cache: The asset cache.
+ * @sound: A sound returned by AcquireSound.
+ */
+void ReleaseSound(AssetCache *cache, Sound sound)
+{
+    for (int i = 0; i < cache->count; i++)
+    {
+        CachedAsset *asset = &cache->assets[i];
+
+        if (asset->type == ASSET_SOUND && asset->sound.stream.buffer == sound.stream.buffer)
+        {
+            if (--asset->references == 0)
+            {
+                RemoveAsset(cache, asset);
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * FreeAssetCache - Unloads every asset still held.
+ *
+ * @cache: The asset cache to free.
+ *
+ * Anything still held at exit was leaked by its holder, it is reported.
+ */
+void FreeAssetCache(AssetCache *cache)
+{
+    while (cache->count > 0)
+    {
+        CachedAsset *asset = &cache->assets[cache->count - 1];
+        fprintf(stderr, "Asset %s still held %d times\n", asset->path, asset->references);
+        RemoveAsset(cache, asset);
+    }
+
+    memset(cache, 0, sizeof(AssetCache));
+}
@@ -0,0 +1,703 @@
+#include <ctype.h>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <raylib.h>
+#include <raymath.h>
+
+#include "../include/utils/behavior_vm.h"
+#include "../include/utils/ai_manager.h"
+#include "../include/utils/constants.h"
+
+#include "../include/gameobjects/npc.h"
+
+// Dispatch with computed goto where the compiler has it (GCC, Clang), a switch elsewhere
+#if defined(__GNUC__)
+#define BEHAVIOR_COMPUTED_GOTO
+#endif
+
+// Longest line and most tokens (mnemonic plus three operands) of behavior assembly
+#define BEHAVIOR_LINE_LENGTH 128
+#define BEHAVIOR_LINE_TOKENS 4
+
+// What an instruction operand is written as
+typedef enum
+{
+    OPERAND_NONE,
+    OPERAND_REGISTER, // r0 .. r7
+    OPERAND_SLOT,     // b0 .. b7
+    OPERAND_NUMBER,   // A constant, e.g. 200 or 0.5
+    OPERAND_LABEL,    // A jump target
+    OPERAND_COMMAND,  // none, up, down, left, right or attack
+    OPERAND_TICKS     // A whole number of ticks
+} BehaviorOperand;
+
+typedef struct
+{
+    const char *name;
+    BehaviorOperand operands[3];
+} BehaviorOpInfo;
+
+static const BehaviorOpInfo behaviorOps[BEHAVIOR_OP_COUNT] = {
+    [BEHAVIOR_OP_LOADK] = {"loadk", {OPERAND_REGISTER, OPERAND_NUMBER}},
+    [BEHAVIOR_OP_MOVE] = {"move", {OPERAND_REGISTER, OPERAND_REGISTER}},
+    [BEHAVIOR_OP_LOAD] = {"load", {OPERAND_REGISTER, OPERAND_SLOT}},
+    [BEHAVIOR_OP_STORE] = {"store", {OPERAND_SLOT, OPERAND_REGISTER}},
+    [BEHAVIOR_OP_ADD] = {"add", {OPERAND_REGISTER, OPERAND_REGISTER, OPERAND_REGISTER}},
+    [BEHAVIOR_OP_SUB] = {"sub", {OPERAND_REGISTER, OPERAND_REGISTER, OPERAND_REGISTER}},
+    [BEHAVIOR_OP_MUL] = {"mul", {OPERAND_REGISTER, OPERAND_REGISTER, OPERAND_REGISTER}},
+    [BEHAVIOR_OP_DIV] = {"div", {OPERAND_REGISTER, OPERAND_REGISTER, OPERAND_REGISTER}},
+    [BEHAVIOR_OP_LT] = {"lt", {OPERAND_REGISTER, OPERAND_REGISTER, OPERAND_REGISTER}},
+    [BEHAVIOR_OP_LE] = {"le", {OPERAND_REGISTER, OPERAND_REGISTER, OPERAND_REGISTER}},
+    [BEHAVIOR_OP_EQ] = {"eq", {OPERAND_REGISTER, OPERAND_REGISTER, OPERAND_REGISTER}},
+    [BEHAVIOR_OP_JMP] = {"jmp", {OPERAND_LABEL}},
+    [BEHAVIOR_OP_JMPIF] = {"jmpif", {OPERAND_REGISTER, OPERAND_LABEL}},
+    [BEHAVIOR_OP_JMPNOT] = {"jmpnot", {OPERAND_REGISTER, OPERAND_LABEL}},
+    [BEHAVIOR_OP_SEEN] = {"seen", {OPERAND_REGISTER}},
+    [BEHAVIOR_OP_DIST] = {"dist", {OPERAND_REGISTER}},
+    [BEHAVIOR_OP_HEALTH] = {"health", {OPERAND_REGISTER}},
+    [BEHAVIOR_OP_CANATTACK] = {"canattack", {OPERAND_REGISTER}},
+    [BEHAVIOR_OP_CROWD] = {"crowd", {OPERAND_REGISTER}},
+    [BEHAVIOR_OP_EMIT] = {"emit", {OPERAND_COMMAND}},
+    [BEHAVIOR_OP_CHASE] = {"chase", {OPERAND_NONE}},
+    [BEHAVIOR_OP_RETREAT] = {"retreat", {OPERAND_NONE}},
+    [BEHAVIOR_OP_FLANK] = {"flank", {OPERAND_NONE}},
+    [BEHAVIOR_OP_WAIT] = {"wait", {OPERAND_TICKS}},
+};
+
+static const struct
+{
+    const char *name;
+    Command command;
+} behaviorCommands[] = {
+    {"none", COMMAND_NONE},
+    {"up", COMMAND_MOVE_UP},
+    {"down", COMMAND_MOVE_DOWN},
+    {"left", COMMAND_MOVE_LEFT},
+    {"right", COMMAND_MOVE_RIGHT},
+    {"attack", COMMAND_ATTACK},
+};
+
+// Labels seen by the first compiler pass
+typedef struct
+{
+    char names[BEHAVIOR_MAX_LABELS][32];
+    int targets[BEHAVIOR_MAX_LABELS];
+    int count;
+} BehaviorLabels;
+
+// Splits a line into its label (if any) and tokens, comments and commas dropped
+static int TokenizeLine(char *line, char **label, char **tokens)
+{
+    char *comment = strpbrk(line, ";#");
+    if (comment != NULL)
+    {
+        *comment = '\0';
+    }
+
+    *label = NULL;
+    int count = 0;
+
+    for (char *token = strtok(line, " \t\r,"); token != NULL; token = strtok(NULL, " \t\r,"))
+    {
+        size_t length = strlen(token);
+
+        if (count == 0 && *label == NULL && token[length - 1] == ':')
+        {
+            token[length - 1] = '\0';
+            *label = token;
+        }
+        else if (count < BEHAVIOR_LINE_TOKENS)
+        {
+            tokens[count++] = token;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    return count;
+}
+
+// Parses rN or bN below limit
+static bool ParseIndexed(const char *token, char prefix, int limit, int *value)
+{
+    if (token[0] != prefix || !isdigit((unsigned char)token[1]))
+    {
+        return false;
+    }
+
+    char *end;
+    long index = strtol(token + 1, &end, 10);
+    if (*end != '\0' || index >= limit)
+    {
+        return false;
+    }
+
+    *value = (int)index;
+    return true;
+}
+
+// Adds a constant to the pool, reusing an equal one
+static int AddConstant(BehaviorProgram *program, float value)
+{
+    for (int k = 0; k < program->constantCount; k++)
+    {
+        if (program->constants[k] == value)
+        {
+            return k;
+        }
+    }
+
+    if (program->constantCount == BEHAVIOR_MAX_CONSTANTS)
+    {
+        return -1;
+    }
+
+    program->constants[program->constantCount] = value;
+    return program->constantCount++;
+}
+
+// Finds a label's instruction index
+static bool FindLabel(const BehaviorLabels *labels, const char *token, int *value)
+{
+    for (int l = 0; l < labels->count; l++)
+    {
+        if (strcmp(labels->names[l], token) == 0)
+        {
+            *value = labels->targets[l];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Finds a command by its name in behavior assembly
+static bool FindCommand(const char *token, int *value)
+{
+    for (size_t c = 0; c < sizeof(behaviorCommands) / sizeof(behaviorCommands[0]); c++)
+    {
+        if (strcmp(behaviorCommands[c].name, token) == 0)
+        {
+            *value = behaviorCommands[c].command;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Encodes one operand, returns false with a message when it does not parse
+static bool ParseOperand(BehaviorProgram *program, const BehaviorLabels *labels, BehaviorOperand kind,
+                         const char *token, int *value, const char **error)
+{
+    char *end;
+
+    switch (kind)
+    {
+    case OPERAND_REGISTER:
+        if (!ParseIndexed(token, 'r', BEHAVIOR_REGISTERS, value))
+        {
+            *error = "expected a register r0-r7";
+            return false;
+        }
+        return true;
+
+    case OPERAND_SLOT:
+        if (!ParseIndexed(token, 'b', BEHAVIOR_BLACKBOARD_SLOTS, value))
+        {
+            *error = "expected a blackboard slot b0-b7";
+            return false;
+        }
+        return true;
+
+    case OPERAND_NUMBER:
+    {
+        float number = strtof(token, &end);
+        if (*end != '\0')
+        {
+            *error = "expected a number";
+            return false;
+        }
+
+        *value = AddConstant(program, number);
+        if (*value < 0)
+        {
+            *error = "too many constants";
+            return false;
+        }
+        return true;
+    }
+
+    case OPERAND_LABEL:
+        if (!FindLabel(labels, token, value))
+        {
+            *error = "unknown label";
+            return false;
+        }
+        return true;
+
+    case OPERAND_COMMAND:
+        if (!FindCommand(token, value))
+        {
+            *error = "expected none, up, down, left, right or attack";
+            return false;
+        }
+        return true;
+
+    case OPERAND_TICKS:
+    {
+        long ticks = strtol(token, &end, 10);
+        if (*end != '\0' || ticks < 1 || ticks > 0xFFFF)
+        {
+            *error = "expected ticks between 1 and 65535";
+            return false;
+        }
+
+        *value = (int)ticks;
+        return true;
+    }
+
+    default:
+        *error = "unexpected operand";
+        return false;
+    }
+}
+
+// Encodes one instruction from its tokens
+static bool AssembleInstruction(BehaviorProgram *program, const BehaviorLabels *labels, char **tokens, int count,
+                                const char **error)
+{
+    int op = 0;
+    while (op < BEHAVIOR_OP_COUNT && strcmp(behaviorOps[op].name, tokens[0]) != 0)
+    {
+        op++;
+    }
+
+    if (op == BEHAVIOR_OP_COUNT)
+    {
+        *error = "unknown instruction";
+        return false;
+    }
+
+    int operandCount = 0;
+    while (operandCount < 3 && behaviorOps[op].operands[operandCount] != OPERAND_NONE)
+    {
+        operandCount++;
+    }
+
+    if (count != operandCount + 1)
+    {
+        *error = "wrong number of operands";
+        return false;
+    }
+
+    uint32_t instruction = (uint32_t)op;
+    int narrow = 0;
+
+    for (int o = 0; o < operandCount; o++)
+    {
+        BehaviorOperand kind = behaviorOps[op].operands[o];
+        int value;
+
+        if (!ParseOperand(program, labels, kind, tokens[o + 1], &value, error))
+        {
+            return false;
+        }
+
+        // Registers and slots take the next byte, the rest the upper 16 bits
+        if (kind == OPERAND_REGISTER || kind == OPERAND_SLOT)
+        {
+            instruction |= (uint32_t)value << (8 * ++narrow);
+        }
+        else
+        {
+            instruction |= (uint32_t)value << 16;
+        }
+    }
+
+    program->code[program->length++] = instruction;
+    return true;
+}
+
+/**
+ * CompileBehavior - Compiles behavior assembly.
+ *
+ * @program: Receives the compiled behavior.
+ * @source:  The assembly, one instruction per line.
+ *
+ * A line holds an optional "label:", an instruction with comma or space
+ * separated operands, and an optional comment after ';' or '#'. ".budget N"
+ * sets the instructions every NPC may run per tick. Running off the end starts
+ * over from the top, so a behavior is a loop deciding one command per tick.
+ *
+ * Return: false if the assembly has an error, reported to stderr.
+ */
+bool CompileBehavior(BehaviorProgram *program, const char *source)
+{
+    memset(program, 0, sizeof(BehaviorProgram));
+    program->budget = BEHAVIOR_DEFAULT_BUDGET;
+
+    BehaviorLabels labels = {0};
+
+    // First pass finds the labels, second pass encodes with every label known
+    for (int pass = 0; pass < 2; pass++)
+    {
+        const char *cursor = source;
+        int lineNumber = 0;
+        int instructions = 0;
+
+        while (*cursor != '\0')
+        {
+            size_t length = strcspn(cursor, "\n");
+            char line[BEHAVIOR_LINE_LENGTH];
+            char *label;
+            char *tokens[BEHAVIOR_LINE_TOKENS];
+            const char *error = NULL;
+
+            lineNumber++;
+
+            if (length >= sizeof(line))
+            {
+                error = "line too long";
+            }
+            else
+            {
+                memcpy(line, cursor, length);
+                line[length] = '\0';
+            }
+
+            cursor += length + (cursor[length] == '\n' ? 1 : 0);
+
+            int count = error == NULL ? TokenizeLine(line, &label, tokens) : 0;
+
+            if (error == NULL && count < 0)
+            {
+                error = "too many operands";
+            }
+            else if (error == NULL && pass == 0 && label != NULL)
+            {
+                for (int l = 0; l < labels.count; l++)
+                {
+                    if (strcmp(labels.names[l], label) == 0)
+                    {
+                        error = "label defined twice";
+                    }
+                }
+
+                if (error == NULL && (labels.count == BEHAVIOR_MAX_LABELS || strlen(label) >= sizeof(labels.names[0])))
+                {
+                    error = "too many labels or label too long";
+                }
+                else if (error == NULL)
+                {
+                    strcpy(labels.names[labels.count], label);
+                    labels.targets[labels.count++] = instructions;
+                }
+            }
+
+            if (error == NULL && count > 0 && strcmp(tokens[0], ".budget") == 0)
+            {
+                char *end;
+                long budget = count == 2 ? strtol(tokens[1], &end, 10) : 0;
+
+                if (count != 2 || *end != '\0' || budget < 1)
+                {
+                    error = "expected .budget followed by a positive count";
+                }
+                else
+                {
+                    program->budget = (int)budget;
+                }
+            }
+            else if (error == NULL && count > 0)
+            {
+                // One slot is kept for the jump back to the top
+                if (instructions == BEHAVIOR_MAX_CODE - 1)
+                {
+                    error = "too many instructions";
+                }
+                else if (pass == 1)
+                {
+                    AssembleInstruction(program, &labels, tokens, count, &error);
+                }
+
+                instructions++;
+            }
+
+            if (error != NULL)
+            {
+                fprintf(stderr, "Behavior line %d: %s\n", lineNumber, error);
+                return false;
+            }
+        }
+    }
+
+    // Jump back to the top past the last instruction, so execution never runs off the code
+    program->code[program->length++] = BEHAVIOR_OP_JMP;
+    return true;
+}
+
+/**
+ * LoadBehaviorProgram - Compiles a behavior assembly file.
+ *
+ * @program: Receives the compiled behavior.
+ * @path:    The assembly file.
+ *
+ * Return: false if the file is missing or does not compile.
+ */
+bool LoadBehaviorProgram(BehaviorProgram *program, const char *path)
+{
+    char *source = LoadFileText(path);
+
+    if (source == NULL)
+    {
+        memset(program, 0, sizeof(BehaviorProgram));
+        return false;
+    }
+
+    bool compiled = CompileBehavior(program, source);
+    UnloadFileText(source);
+
+    if (!compiled)
+    {
+        fprintf(stderr, "Failed to compile behavior %s\n", path);
+    }
+
+    return compiled;
+}
+
+/**
+ * ResetBehaviorState - Starts a behavior over.
+ *
+ * @state: The NPC's behavior state.
+ */
+void ResetBehaviorState(BehaviorState *state)
+{
+    memset(state, 0, sizeof(BehaviorState));
+}
+
+/**
+ * RunBehavior - Runs an NPC's behavior for one tick.
+ *
+ * @program:       The compiled behavior.
+ * @state:         The NPC's place in it, registers and blackboard.
+ * @obj:           The NPC.
+ * @target:        Its target, may be NULL.
+ * @targetVisible: Whether the NPC can see its target (see UpdatePerception).
+ * @influence:     The influence map, for crowd, retreat and flank.
+ *
+ * Runs instructions until one ends the tick with a command or the program's
+ * instruction budget is spent, in which case the NPC does nothing this tick
+ * and carries on from there next tick. A runaway loop therefore costs at most
+ * the budget per NPC per tick. Dead NPCs do not run, as with PollAI.
+ *
+ * Return: The NPC's command for this tick.
+ */
+Command RunBehavior(const BehaviorProgram *program, BehaviorState *state, GameObject *obj, GameObject *target,
+                    bool targetVisible, const InfluenceMap *influence)
+{
+    if (obj->currentState == STATE_DEAD)
+    {
+        return COMMAND_NONE;
+    }
+
+    if (state->waitTicks > 0)
+    {
+        state->waitTicks--;
+        return COMMAND_NONE;
+    }
+
+    const uint32_t *code = program->code;
+    const float *constants = program->constants;
+    float *r = state->registers;
+    float *blackboard = state->blackboard;
+    int budget = program->budget;
+    int pc = state->pc;
+    uint32_t instruction;
+    Command command = COMMAND_NONE;
+
+#ifdef BEHAVIOR_COMPUTED_GOTO
+    static const void *dispatch[BEHAVIOR_OP_COUNT] = {
+        [BEHAVIOR_OP_LOADK] = &&op_LOADK,
+        [BEHAVIOR_OP_MOVE] = &&op_MOVE,
+        [BEHAVIOR_OP_LOAD] = &&op_LOAD,
+        [BEHAVIOR_OP_STORE] = &&op_STORE,
+        [BEHAVIOR_OP_ADD] = &&op_ADD,
+        [BEHAVIOR_OP_SUB] = &&op_SUB,
+        [BEHAVIOR_OP_MUL] = &&op_MUL,
+        [BEHAVIOR_OP_DIV] = &&op_DIV,
+        [BEHAVIOR_OP_LT] = &&op_LT,
+        [BEHAVIOR_OP_LE] = &&op_LE,
+        [BEHAVIOR_OP_EQ] = &&op_EQ,
+        [BEHAVIOR_OP_JMP] = &&op_JMP,
+        [BEHAVIOR_OP_JMPIF] = &&op_JMPIF,
+        [BEHAVIOR_OP_JMPNOT] = &&op_JMPNOT,
+        [BEHAVIOR_OP_SEEN] = &&op_SEEN,
+        [BEHAVIOR_OP_DIST] = &&op_DIST,
+        [BEHAVIOR_OP_HEALTH] = &&op_HEALTH,
+        [BEHAVIOR_OP_CANATTACK] = &&op_CANATTACK,
+        [BEHAVIOR_OP_CROWD] = &&op_CROWD,
+        [BEHAVIOR_OP_EMIT] = &&op_EMIT,
+        [BEHAVIOR_OP_CHASE] = &&op_CHASE,
+        [BEHAVIOR_OP_RETREAT] = &&op_RETREAT,
+        [BEHAVIOR_OP_FLANK] = &&op_FLANK,
+        [BEHAVIOR_OP_WAIT] = &&op_WAIT,
+    };
+
+// Every handler jumps straight to the next one, no shared dispatch branch
+#define VM_CASE(op) op_##op:
+#define VM_NEXT()                                            \
+    do                                                       \
+    {                                                        \
+        if (--budget < 0)                                    \
+        {                                                    \
+            goto exhausted;                                  \
+        }                                                    \
+        instruction = code[pc++];                            \
+        goto *dispatch[BEHAVIOR_OPCODE(instruction)];        \
+    } while (0)
+
+    VM_NEXT();
+#else
+#define VM_CASE(op) case BEHAVIOR_OP_##op:
+#define VM_NEXT() continue
+
+    for (;;)
+    {
+        if (--budget < 0)
+        {
+            goto exhausted;
+        }
+
+        instruction = code[pc++];
+
+        switch (BEHAVIOR_OPCODE(instruction))
+        {
+#endif
+
+    VM_CASE(LOADK)
+    r[BEHAVIOR_A(instruction)] = constants[BEHAVIOR_WIDE(instruction)];
+    VM_NEXT();
+
+    VM_CASE(MOVE)
+    r[BEHAVIOR_A(instruction)] = r[BEHAVIOR_B(instruction)];
+    VM_NEXT();
+
+    VM_CASE(LOAD)
+    r[BEHAVIOR_A(instruction)] = blackboard[BEHAVIOR_B(instruction)];
+    VM_NEXT();
+
+    VM_CASE(STORE)
+    blackboard[BEHAVIOR_A(instruction)] = r[BEHAVIOR_B(instruction)];
+    VM_NEXT();
+
+    VM_CASE(ADD)
+    r[BEHAVIOR_A(instruction)] = r[BEHAVIOR_B(instruction)] + r[BEHAVIOR_C(instruction)];
+    VM_NEXT();
+
+    VM_CASE(SUB)
+    r[BEHAVIOR_A(instruction)] = r[BEHAVIOR_B(instruction)] - r[BEHAVIOR_C(instruction)];
+    VM_NEXT();
+
+    VM_CASE(MUL)
+    r[BEHAVIOR_A(instruction)] = r[BEHAVIOR_B(instruction)] * r[BEHAVIOR_C(instruction)];
+    VM_NEXT();
+
+    VM_CASE(DIV)
+    r[BEHAVIOR_A(instruction)] = r[BEHAVIOR_C(instruction)] != 0.0f
+                                     ? r[BEHAVIOR_B(instruction)] / r[BEHAVIOR_C(instruction)]
+                                     : 0.0f;
+    VM_NEXT();
+
+    VM_CASE(LT)
+    r[BEHAVIOR_A(instruction)] = r[BEHAVIOR_B(instruction)] < r[BEHAVIOR_C(instruction)];
+    VM_NEXT();
+
+    VM_CASE(LE)
+    r[BEHAVIOR_A(instruction)] = r[BEHAVIOR_B(instruction)] <= r[BEHAVIOR_C(instruction)];
+    VM_NEXT();
+
+    VM_CASE(EQ)
+    r[BEHAVIOR_A(instruction)] = r[BEHAVIOR_B(instruction)] == r[BEHAVIOR_C(instruction)];
+    VM_NEXT();
+
+    VM_CASE(JMP)
+    pc = BEHAVIOR_WIDE(instruction);
+    VM_NEXT();
+
+    VM_CASE(JMPIF)
+    if (r[BEHAVIOR_A(instruction)] != 0.0f)
+    {
+        pc = BEHAVIOR_WIDE(instruction);
+    }
+    VM_NEXT();
+
+    VM_CASE(JMPNOT)
+    if (r[BEHAVIOR_A(instruction)] == 0.0f)
+    {
+        pc = BEHAVIOR_WIDE(instruction);
+    }
+    VM_NEXT();
+
+    VM_CASE(SEEN)
+    r[BEHAVIOR_A(instruction)] = targetVisible;
+    VM_NEXT();
+
+    VM_CASE(DIST)
+    r[BEHAVIOR_A(instruction)] = target != NULL ? Vector2Distance(obj->position, target->position) : FLT_MAX;
+    VM_NEXT();
+
+    VM_CASE(HEALTH)
+    r[BEHAVIOR_A(instruction)] = (float)obj->health;
+    VM_NEXT();
+
+    VM_CASE(CANATTACK)
+    r[BEHAVIOR_A(instruction)] = obj->currentState != STATE_ATTACKING && NPCCanAttack((NPC *)obj);
+    VM_NEXT();
+
+    VM_CASE(CROWD)
+    r[BEHAVIOR_A(instruction)] = SampleInfluence(influence, INFLUENCE_ALLIES, obj->position);
+    VM_NEXT();
+
+    VM_CASE(EMIT)
+    command = (Command)BEHAVIOR_WIDE(instruction);
+    goto done;
+
+    VM_CASE(CHASE)
+    command = target != NULL ? ChaseCommand(obj, target) : COMMAND_NONE;
+    goto done;
+
+    VM_CASE(RETREAT)
+    command = DirectionToCommand(InfluenceRetreatDirection(influence, obj->position));
+    goto done;
+
+    VM_CASE(FLANK)
+    command = DirectionToCommand(InfluenceFlankDirection(influence, obj->position));
+    goto done;
+
+    VM_CASE(WAIT)
+    state->waitTicks = (uint16_t)(BEHAVIOR_WIDE(instruction) - 1);
+    goto done;
+
+#ifndef BEHAVIOR_COMPUTED_GOTO
+        }
+    }
+#endif
+
+#undef VM_CASE
+#undef VM_NEXT
+
+exhausted:
+    // Carry on from the instruction that did not fit in the budget
+    state->pc = (uint16_t)pc;
+    return COMMAND_NONE;
+
+done:
+    state->pc = (uint16_t)pc;
+    return command;
+}
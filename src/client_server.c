@@ -0,0 +1,458 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/network/client_server.h"
+
+// Packet identifiers ("CSIN" client input, "CSSN" server snapshot)
+#define CLIENT_INPUT_MAGIC 0x4353494Eu
+#define SERVER_SNAPSHOT_MAGIC 0x4353534Eu
+
+// magic + view tick + command
+#define CLIENT_INPUT_PACKET_SIZE (4 + 4 + 1)
+
+// magic + tick + your player + player count + entity total + first entity + entity count
+#define SNAPSHOT_HEADER_SIZE (4 + 4 + 1 + 1 + 2 + 2 + 1)
+
+// position + velocity + states (locomotion in the low nibble, action layer in the high one) + health
+// + handle (slot, generation)
+#define SNAPSHOT_ENTITY_SIZE (4 * 4 + 1 + 2 + 2 + 4)
+
+#define SNAPSHOT_PACKET_SIZE (SNAPSHOT_HEADER_SIZE + SNAPSHOT_ENTITIES_PER_PACKET * SNAPSHOT_ENTITY_SIZE)
+
+// Packets are written byte by byte in little endian so native and web builds agree
+static void WriteU16(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = (uint8_t)(value);
+    buffer[1] = (uint8_t)(value >> 8);
+}
+
+static uint16_t ReadU16(const uint8_t *buffer)
+{
+    return (uint16_t)(buffer[0] | (buffer[1] << 8));
+}
+
+static void WriteU32(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = (uint8_t)(value);
+    buffer[1] = (uint8_t)(value >> 8);
+    buffer[2] = (uint8_t)(value >> 16);
+    buffer[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t ReadU32(const uint8_t *buffer)
+{
+    return (uint32_t)buffer[0] | ((uint32_t)buffer[1] << 8) | ((uint32_t)buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+}
+
+// Floats are sent by their bit pattern so the client sees exactly the host's values
+static void WriteF32(uint8_t *buffer, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    WriteU32(buffer, bits);
+}
+
+static float ReadF32(const uint8_t *buffer)
+{
+    uint32_t bits = ReadU32(buffer);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * InitHost - Starts an authoritative host session.
+ *
+ * @session:     The session to initialise.
+ * @port:        UDP port clients connect to.
+ * @clientCount: Number of remote players the host accepts.
+ *
+ * The host runs the simulation for everyone. Player 0 is the host's own
+ * player, each connecting client is given the next free player.
+ *
+ * Return: true if the session is ready to run.
+ */
+bool InitHost(ClientServerSession *session, unsigned short port, int clientCount)
+{
+    memset(session, 0, sizeof(ClientServerSession));
+
+    if (clientCount < 1 || clientCount > CLIENT_SERVER_MAX_CLIENTS)
+    {
+        fprintf(stderr, "Host accepts 1 to %d clients\n", CLIENT_SERVER_MAX_CLIENTS);
+        return false;
+    }
+
+    if (!InitNetwork() || !OpenNetSocket(&session->socket, port))
+    {
+        return false;
+    }
+
+    session->clientCount = clientCount;
+    for (int i = 0; i < clientCount; i++)
+    {
+        session->clients[i].player = i + 1;
+        session->clients[i].input = (PlayerInput){COMMAND_NONE, COMMAND_NONE};
+    }
+
+    session->localPlayer = 0;
+    session->playerCount = clientCount + 1;
+    session->role = NET_ROLE_HOST;
+
+    printf("Hosting on port %u for %d clients\n", port, clientCount);
+    return true;
+}
+
+/**
+ * InitClient - Connects to a host and prepares the interpolation buffers.
+ *
+ * @session:            The session to initialise.
+ * @serverAddress:      "host:port" of the host.
+ * @interpolationDelay: Ticks the rendered world trails the newest snapshot,
+ *                      must cover the snapshot interval plus network jitter.
+ *
+ * Return: true if the session is ready to run.
+ */
+bool InitClient(ClientServerSession *session, const char *serverAddress, float interpolationDelay)
+{
+    memset(session, 0, sizeof(ClientServerSession));
+
+    if (interpolationDelay < 1.0f || interpolationDelay >= INTERPOLATION_SNAPSHOTS)
+    {
+        fprintf(stderr, "Interpolation delay must be between 1 and %d ticks\n", INTERPOLATION_SNAPSHOTS - 1);
+        return false;
+    }
+
+    if (!ResolveNetAddress(&session->server, serverAddress))
+    {
+        return false;
+    }
+
+    // Port 0 lets the OS pick a free local port
+    if (!InitNetwork() || !OpenNetSocket(&session->socket, 0))
+    {
+        return false;
+    }
+
+    session->buffers = (InterpolationBuffer *)calloc(CLIENT_SERVER_MAX_ENTITIES, sizeof(InterpolationBuffer));
+    if (!session->buffers)
+    {
+        fprintf(stderr, "Failed to allocate interpolation buffers\n");
+        exit(1);
+    }
+
+    session->localPlayer = -1;
+    session->interpolationDelay = interpolationDelay;
+    session->role = NET_ROLE_CLIENT;
+
+    printf("Connecting to %s (interpolation delay %.0f ticks)\n", serverAddress, interpolationDelay);
+    return true;
+}
+
+// Finds the client slot for an address, claiming a free slot for new clients
+static RemoteClient *FindClient(ClientServerSession *session, const NetAddress *address)
+{
+    RemoteClient *freeSlot = NULL;
+
+    for (int i = 0; i < session->clientCount; i++)
+    {
+        RemoteClient *client = &session->clients[i];
+
+        if (client->connected && NetAddressEqual(&client->address, address))
+        {
+            return client;
+        }
+
+        if (!client->connected && freeSlot == NULL)
+        {
+            freeSlot = client;
+        }
+    }
+
+    if (freeSlot != NULL)
+    {
+        freeSlot->connected = true;
+        freeSlot->address = *address;
+        printf("Client connected as player %d\n", freeSlot->player + 1);
+    }
+
+    return freeSlot;
+}
+
+/**
+ * HostReceiveInputs - Receives the commands sent by clients since the last tick.
+ *
+ * @session: The host session.
+ *
+ * Clients send their command every frame. A command other than COMMAND_NONE is
+ * kept until the host executes it, so a one frame attack or roll is never
+ * overwritten by the idle packets that follow it in the same tick.
+ */
+void HostReceiveInputs(ClientServerSession *session)
+{
+    uint8_t packet[CLIENT_INPUT_PACKET_SIZE];
+    NetAddress from;
+    int size;
+
+    while ((size = NetReceive(&session->socket, &from, packet, sizeof(packet))) > 0)
+    {
+        if (size != CLIENT_INPUT_PACKET_SIZE || ReadU32(packet) != CLIENT_INPUT_MAGIC)
+        {
+            continue;
+        }
+
+        RemoteClient *client = FindClient(session, &from);
+        if (client == NULL)
+        {
+            continue; // Game is full
+        }
+
+        PlayerInput input = UnpackPlayerInput(packet[8]);
+
+        // The newest movement wins, an action waits for the tick that runs it
+        client->input.move = input.move;
+        if (!client->hasInput || client->input.action == COMMAND_NONE)
+        {
+            client->input.action = input.action;
+            client->viewTick = ReadU32(packet + 4);
+        }
+        client->hasInput = true;
+    }
+}
+
+/**
+ * HostBroadcastSnapshot - Sends the world state of a tick to every client.
+ *
+ * @session:     The host session.
+ * @tick:        The simulation tick the state belongs to.
+ * @objects:     All game objects, in the order used by GatherGameObjects.
+ * @count:       Number of game objects.
+ * @playerCount: Number of players at the start of @objects.
+ *
+ * Large worlds are split over several packets of SNAPSHOT_ENTITIES_PER_PACKET
+ * entities. Each packet carries its tick and entity range, so a lost packet
+ * only leaves a gap that the client's interpolation buffers bridge.
+ */
+void HostBroadcastSnapshot(ClientServerSession *session, uint32_t tick, GameObject **objects, int count, int playerCount)
+{
+    uint8_t packet[SNAPSHOT_PACKET_SIZE];
+
+    if (count > CLIENT_SERVER_MAX_ENTITIES)
+    {
+        count = CLIENT_SERVER_MAX_ENTITIES;
+    }
+
+    for (int i = 0; i < session->clientCount; i++)
+    {
+        RemoteClient *client = &session->clients[i];
+
+        if (!client->connected)
+        {
+            continue;
+        }
+
+        for (int first = 0; first < count; first += SNAPSHOT_ENTITIES_PER_PACKET)
+        {
+            int entities = count - first < SNAPSHOT_ENTITIES_PER_PACKET ? count - first : SNAPSHOT_ENTITIES_PER_PACKET;
+
+            WriteU32(packet, SERVER_SNAPSHOT_MAGIC);
+            WriteU32(packet + 4, tick);
+            packet[8] = (uint8_t)client->player;
+            packet[9] = (uint8_t)playerCount;
+            WriteU16(packet + 10, (uint16_t)count);
+            WriteU16(packet + 12, (uint16_t)first);
+            packet[14] = (uint8_t)entities;
+
+            uint8_t *entity = packet + SNAPSHOT_HEADER_SIZE;
+            for (int e = 0; e < entities; e++)
+            {
+                const GameObject *obj = objects[first + e];
+
+                WriteF32(entity, obj->position.x);
+                WriteF32(entity + 4, obj->position.y);
+                WriteF32(entity + 8, obj->velocity.x);
+                WriteF32(entity + 12, obj->velocity.y);
+                entity[16] = (uint8_t)(obj->currentState | (GetLayerState(obj, FSM_LAYER_ACTION) << 4));
+                WriteU16(entity + 17, (uint16_t)(int16_t)obj->health);
+                WriteU16(entity + 19, (uint16_t)obj->handle.index);
+                WriteU32(entity + 21, obj->handle.generation);
+                entity += SNAPSHOT_ENTITY_SIZE;
+            }
+
+            NetSend(&session->socket, &client->address, packet, (int)(entity - packet));
+        }
+    }
+}
+
+/**
+ * PlayerViewLag - Returns how far behind the simulation a player is seeing.
+ *
+ * @session: The host session.
+ * @player:  Index of the player.
+ *
+ * Remote players see the world interpolationDelay ticks plus their latency in
+ * the past, lag compensation rewinds their hits by this amount.
+ *
+ * Return: The lag in ticks, 0 for the host's own player or unknown players.
+ */
+uint32_t PlayerViewLag(const ClientServerSession *session, int player)
+{
+    for (int i = 0; i < session->clientCount; i++)
+    {
+        if (session->clients[i].connected && session->clients[i].player == player)
+        {
+            return session->clients[i].viewLag;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * ClientSendInput - Sends the local input to the host.
+ *
+ * @session: The client session.
+ * @input:   The movement and action sampled from the local input devices.
+ *
+ * The tick the client is rendering is sent along, so the host knows what the
+ * player was looking at when they acted.
+ */
+void ClientSendInput(ClientServerSession *session, PlayerInput input)
+{
+    uint8_t packet[CLIENT_INPUT_PACKET_SIZE];
+
+    WriteU32(packet, CLIENT_INPUT_MAGIC);
+    WriteU32(packet + 4, session->renderTick > 0.0f ? (uint32_t)(session->renderTick + 0.5f) : 0);
+    packet[8] = PackPlayerInput(input);
+
+    NetSend(&session->socket, &session->server, packet, sizeof(packet));
+}
+
+/**
+ * ClientReceiveSnapshots - Receives snapshots into the interpolation buffers.
+ *
+ * @session: The client session.
+ */
+void ClientReceiveSnapshots(ClientServerSession *session)
+{
+    uint8_t packet[SNAPSHOT_PACKET_SIZE];
+    NetAddress from;
+    int size;
+
+    while ((size = NetReceive(&session->socket, &from, packet, sizeof(packet))) > 0)
+    {
+        if (size < SNAPSHOT_HEADER_SIZE || ReadU32(packet) != SERVER_SNAPSHOT_MAGIC ||
+            !NetAddressEqual(&from, &session->server))
+        {
+            continue;
+        }
+
+        uint32_t tick = ReadU32(packet + 4);
+        int total = ReadU16(packet + 10);
+        int first = ReadU16(packet + 12);
+        int entities = packet[14];
+
+        if (size != SNAPSHOT_HEADER_SIZE + entities * SNAPSHOT_ENTITY_SIZE ||
+            total > CLIENT_SERVER_MAX_ENTITIES || first + entities > total)
+        {
+            continue;
+        }
+
+        session->localPlayer = packet[8];
+        session->playerCount = packet[9];
+        session->entityCount = total;
+
+        const uint8_t *entity = packet + SNAPSHOT_HEADER_SIZE;
+        for (int e = 0; e < entities; e++)
+        {
+            EntitySnapshot snapshot;
+            snapshot.tick = tick;
+            snapshot.position.x = ReadF32(entity);
+            snapshot.position.y = ReadF32(entity + 4);
+            snapshot.velocity.x = ReadF32(entity + 8);
+            snapshot.velocity.y = ReadF32(entity + 12);
+            snapshot.state = (entity[16] & 0x0F) < STATE_COUNT ? (State)(entity[16] & 0x0F) : STATE_IDLE;
+            snapshot.actionState = (entity[16] >> 4) < STATE_COUNT ? (State)(entity[16] >> 4) : STATE_IDLE;
+            snapshot.health = (int16_t)ReadU16(entity + 17);
+            snapshot.handle.index = ReadU16(entity + 19);
+            snapshot.handle.generation = ReadU32(entity + 21);
+
+            PushSnapshot(&session->buffers[first + e], &snapshot);
+            entity += SNAPSHOT_ENTITY_SIZE;
+        }
+
+        if (tick > session->newestTick)
+        {
+            session->newestTick = tick;
+        }
+    }
+}
+
+/**
+ * ClientAdvanceRenderTick - Moves the render time forward by one frame.
+ *
+ * @session: The client session.
+ *
+ * The render tick normally advances one tick per frame. It is gently pulled
+ * towards newestTick - interpolationDelay to absorb clock drift, and snapped
+ * there when it is off by more than the delay (first snapshot, long stall).
+ */
+void ClientAdvanceRenderTick(ClientServerSession *session)
+{
+    if (session->newestTick == 0)
+    {
+        return;
+    }
+
+    float target = (float)session->newestTick - session->interpolationDelay;
+    session->renderTick += 1.0f;
+
+    float error = target - session->renderTick;
+    if (error > session->interpolationDelay || error < -session->interpolationDelay)
+    {
+        session->renderTick = target;
+    }
+    else
+    {
+        session->renderTick += error * 0.1f;
+    }
+}
+
+/**
+ * ClientSampleEntity - Samples a replicated entity at the current render tick.
+ *
+ * @session: The client session.
+ * @entity:  Index of the entity (same order as the host's GatherGameObjects).
+ * @sample:  Receives the interpolated position, state and health.
+ *
+ * Return: false if nothing has been received for the entity yet.
+ */
+bool ClientSampleEntity(const ClientServerSession *session, int entity, InterpolatedSample *sample)
+{
+    if (entity < 0 || entity >= session->entityCount)
+    {
+        return false;
+    }
+
+    return SampleInterpolation(&session->buffers[entity], session->renderTick, MAX_EXTRAPOLATION_TICKS, sample);
+}
+
+/**
+ * CloseClientServer - Closes the session and frees the interpolation buffers.
+ *
+ * @session: The session to close.
+ */
+void CloseClientServer(ClientServerSession *session)
+{
+    if (session->role == NET_ROLE_NONE)
+    {
+        return;
+    }
+
+    CloseNetSocket(&session->socket);
+    ExitNetwork();
+
+    free(session->buffers);
+    session->buffers = NULL;
+    session->role = NET_ROLE_NONE;
+}
@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/utils/combat.h"
+#include "../include/fsm/fsm.h"
+#include "../include/utils/entity_table.h"
+#include "../include/utils/sleep_system.h"
+
+/**
+ * InitCombatQueue - Prepares an empty combat queue.
+ *
+ * @queue: The combat queue to initialise.
+ */
+void InitCombatQueue(CombatQueue *queue)
+{
+    memset(queue, 0, sizeof(CombatQueue));
+}
+
+/**
+ * QueueDamage - Queues damage against a target.
+ *
+ * @queue:  The combat queue.
+ * @target: Handle of the damaged object.
+ * @source: Handle of the attacker, or an empty one.
+ * @amount: Health to take off.
+ * @kind:   What dealt the damage.
+ *
+ * Nothing is applied yet, so every system sees the same health values for
+ * the whole tick regardless of the order they run in.
+ */
+void QueueDamage(CombatQueue *queue, EntityHandle target, EntityHandle source, int amount, DamageKind kind)
+{
+    if (target.index < 0)
+    {
+        return;
+    }
+
+    if (queue->count == queue->capacity)
+    {
+        int capacity = queue->capacity > 0 ? queue->capacity * 2 : 64;
+        DamageEvent *events = (DamageEvent *)realloc(queue->events, sizeof(DamageEvent) * capacity);
+        DamageEvent *sorted = (DamageEvent *)realloc(queue->sorted, sizeof(DamageEvent) * capacity);
+
+        if (!events || !sorted)
+        {
+            fprintf(stderr, "Failed to grow combat queue\n");
+            exit(1);
+        }
+
+        queue->events = events;
+        queue->sorted = sorted;
+        queue->capacity = capacity;
+    }
+
+    queue->events[queue->count++] = (DamageEvent){target, source, amount, kind};
+}
+
+/**
+ * SortEventsByTarget - Sorts the queued events by target entity.
+ *
+ * @queue: The combat queue.
+ *
+ * A radix sort on the target's slot, a byte per pass and only as many passes
+ * as the largest slot needs, so the cost follows the number of events rather
+ * than the size of the world. Every pass is stable, so each target's events
+ * keep their submission order.
+ *
+ * Return: The sorted events, either of the queue's two event arrays.
+ */
+static DamageEvent *SortEventsByTarget(CombatQueue *queue)
+{
+    DamageEvent *from = queue->events;
+    DamageEvent *to = queue->sorted;
+
+    int largest = 0;
+    for (int i = 0; i < queue->count; i++)
+    {
+        largest = queue->events[i].target.index > largest ? queue->events[i].target.index : largest;
+    }
+
+    for (int shift = 0; shift == 0 || (largest >> shift) > 0; shift += 8)
+    {
+        int start[257] = {0};
+
+        for (int i = 0; i < queue->count; i++)
+        {
+            start[((from[i].target.index >> shift) & 0xFF) + 1]++;
+        }
+
+        for (int digit = 0; digit < 256; digit++)
+        {
+            start[digit + 1] += start[digit];
+        }
+
+        for (int i = 0; i < queue->count; i++)
+        {
+            to[start[(from[i].target.index >> shift) & 0xFF]++] = from[i];
+        }
+
+        DamageEvent *swap = from;
+        from = to;
+        to = swap;
+    }
+
+    return from;
+}
+
+/**
+ * ResolveCombat - Applies the damage queued this tick.
+ *
+ * @queue: The combat queue, emptied on return.
+ *
+ * The events are sorted by target, which keeps the submission order within
+ * a target and makes the result identical on every machine. Each target is
+ * resolved through its handle, events against objects destroyed during the
+ * tick are dropped. Its health is then written once, scaled by its damage
+ * modifier (see TickStatusEffects) and rounded to at least 1 unless the
+ * modifier is zero. Objects whose health crosses zero receive EVENT_DIE
+ * exactly once, objects that were already dead take no further damage, so
+ * nothing has to poll health every tick.
+ *
+ * Return: The number of objects that died.
+ */
+int ResolveCombat(CombatQueue *queue)
+{
+    if (queue->count == 0)
+    {
+        return 0;
+    }
+
+    const DamageEvent *sorted = SortEventsByTarget(queue);
+    const EntityTable *entities = GetEntityTable();
+    int deaths = 0;
+
+    for (int first = 0, last = 0; first < queue->count; first = last)
+    {
+        // The events of one target are next to each other
+        last = first + 1;
+        while (last < queue->count && sorted[last].target.index == sorted[first].target.index)
+        {
+            last++;
+        }
+
+        GameObject *obj = ResolveEntity(entities, sorted[first].target);
+
+        if (obj != NULL && obj->health > 0)
+        {
+            int damage = 0;
+            for (int e = first; e < last; e++)
+            {
+                damage += sorted[e].amount;
+            }
+
+            // A shield softens every hit but never turns one into nothing,
+            // only a modifier of zero (full immunity) takes no health
+            int scaled = (int)(damage * obj->damageScale + 0.5f);
+            if (scaled < 1 && damage > 0 && obj->damageScale > 0.0f)
+            {
+                scaled = 1;
+            }
+
+            obj->health -= scaled;
+
+            // Taking damage is activity, a sleeper is simulated (and rehashed) again
+            WakeGameObject(GetSleepSystem(), obj);
+
+            if (obj->health <= 0)
+            {
+                // The death names the last attacker and the damage of the tick
+                EventData death = MakeHitEvent(EVENT_DIE, sorted[last - 1].source, damage);
+                HandleEventData(obj, &death);
+                deaths++;
+            }
+        }
+    }
+
+    queue->count = 0;
+
+    return deaths;
+}
+
+/**
+ * FreeCombatQueue - Frees the combat queue.
+ *
+ * @queue: The combat queue to free.
+ */
+void FreeCombatQueue(CombatQueue *queue)
+{
+    free(queue->events);
+    free(queue->sorted);
+    memset(queue, 0, sizeof(CombatQueue));
+}
@@ -26,3 +26,105 @@ void ExecuteCommand(Command command, Mediator *mediator)
     // The Mediator will process the command and interact with the FSM.
     MediatorExecuteCommand(command, mediator);
 }
+
+/**
+ * ExecutePlayerInput - Executes a player's input of one tick.
+ *
+ * @input:    The movement and action commands of the tick.
+ * @mediator: The mediator of the player.
+ *
+ * The movement always runs, so a tick without a move stops the locomotion
+ * layer (COMMAND_NONE sends EVENT_NONE) rather than leaving the player
+ * sliding on its old velocity. The action then runs on top of it, so
+ * attacking while walking reaches the action layer in the same tick.
+ */
+void ExecutePlayerInput(PlayerInput input, Mediator *mediator)
+{
+    ExecuteCommand(input.move, mediator);
+
+    if (input.action != COMMAND_NONE)
+    {
+        ExecuteCommand(input.action, mediator);
+    }
+}
+
+/**
+ * PackPlayerInput - Packs a player's input into one byte.
+ *
+ * @input: The input to pack.
+ *
+ * Return: The movement in the low nibble and the action in the high one.
+ */
+uint8_t PackPlayerInput(PlayerInput input)
+{
+    return (uint8_t)((unsigned int)input.move | ((unsigned int)input.action << 4));
+}
+
+/**
+ * UnpackPlayerInput - Unpacks a player's input packed by PackPlayerInput.
+ *
+ * @packed: The packed input, possibly from the network.
+ *
+ * Return: The input, with any command out of range read as COMMAND_NONE.
+ */
+PlayerInput UnpackPlayerInput(uint8_t packed)
+{
+    int move = packed & 0x0F;
+    int action = packed >> 4;
+
+    PlayerInput input;
+    input.move = move < COMMAND_COUNT ? (Command)move : COMMAND_NONE;
+    input.action = action < COMMAND_COUNT ? (Command)action : COMMAND_NONE;
+    return input;
+}
+
+/**
+ * CommandToEvent - Translates a command into the event it sends to the FSM.
+ *
+ * @command: The command to translate.
+ * @source:  Handle of the game object issuing it (empty for none).
+ * @event:   Receives the event and its payload (the direction of a move).
+ *
+ * Players and NPCs share this mapping, whether the command came from input,
+ * the network or the AI.
+ *
+ * Return: false if the command sends no event.
+ */
+bool CommandToEvent(Command command, EntityHandle source, EventData *event)
+{
+    switch (command)
+    {
+    case COMMAND_NONE:
+        *event = MakeEvent(EVENT_NONE);
+        break;
+    case COMMAND_MOVE_UP:
+        *event = MakeEvent(EVENT_MOVE_UP);
+        break;
+    case COMMAND_MOVE_DOWN:
+        *event = MakeEvent(EVENT_MOVE_DOWN);
+        break;
+    case COMMAND_MOVE_LEFT:
+        *event = MakeEvent(EVENT_MOVE_LEFT);
+        break;
+    case COMMAND_MOVE_RIGHT:
+        *event = MakeEvent(EVENT_MOVE_RIGHT);
+        break;
+    case COMMAND_ATTACK:
+        *event = MakeEvent(EVENT_ATTACK);
+        break;
+    case COMMAND_ROLL:
+        *event = MakeEvent(EVENT_ROLL);
+        break;
+    case COMMAND_COLLISION_START:
+        *event = MakeEvent(EVENT_DIE);
+        break;
+    case COMMAND_COLLISION_END:
+        *event = MakeEvent(EVENT_RESPAWN);
+        break;
+    default:
+        return false;
+    }
+
+    event->source = source;
+    return true;
+}
@@ -0,0 +1,89 @@
+#include <string.h>
+
+#include <raymath.h>
+
+#include "../include/render/detail_levels.h"
+
+/**
+ * InitDetailLevels - Uses the default distances and stride.
+ *
+ * @levels: The detail levels to initialise.
+ */
+void InitDetailLevels(DetailLevels *levels)
+{
+    memset(levels, 0, sizeof(DetailLevels));
+
+    levels->reducedDistance = DETAIL_REDUCED_DISTANCE;
+    levels->staticDistance = DETAIL_STATIC_DISTANCE;
+    levels->impostorDistance = DETAIL_IMPOSTOR_DISTANCE;
+    levels->overlayDistance = DETAIL_OVERLAY_DISTANCE;
+    levels->reducedStride = DETAIL_REDUCED_STRIDE;
+}
+
+/**
+ * GetDetailLevel - Returns the level of detail of something.
+ *
+ * @levels:   The detail levels.
+ * @focus:    Where the view is centred, the local player.
+ * @position: Where the thing is.
+ *
+ * Return: The first level whose distance the thing is closer than.
+ */
+DetailLevel GetDetailLevel(const DetailLevels *levels, Vector2 focus, Vector2 position)
+{
+    float distanceSqr = Vector2DistanceSqr(focus, position);
+
+    if (distanceSqr < levels->reducedDistance * levels->reducedDistance)
+    {
+        return DETAIL_FULL;
+    }
+    if (distanceSqr < levels->staticDistance * levels->staticDistance)
+    {
+        return DETAIL_REDUCED;
+    }
+    if (distanceSqr < levels->impostorDistance * levels->impostorDistance)
+    {
+        return DETAIL_STATIC;
+    }
+    return DETAIL_IMPOSTOR;
+}
+
+/**
+ * ShowsOverlay - Returns whether a health bar and label are drawn.
+ *
+ * @levels:   The detail levels.
+ * @focus:    Where the view is centred, the local player.
+ * @position: Where the thing is.
+ *
+ * Return: True within overlayDistance of the focus.
+ */
+bool ShowsOverlay(const DetailLevels *levels, Vector2 focus, Vector2 position)
+{
+    return Vector2DistanceSqr(focus, position) < levels->overlayDistance * levels->overlayDistance;
+}
+
+/**
+ * SetAnimationDetail - Sets how often an animation updates at a level.
+ *
+ * @animationData: The animation.
+ * @levels:        The detail levels.
+ * @level:         The level of its owner this tick.
+ *
+ * Full detail updates every tick, reduced every reducedStride ticks with
+ * the time of the skipped ones, static and impostors hold their frame.
+ */
+void SetAnimationDetail(AnimationData *animationData, const DetailLevels *levels, DetailLevel level)
+{
+    switch (level)
+    {
+    case DETAIL_FULL:
+        animationData->updateStride = 1;
+        break;
+    case DETAIL_REDUCED:
+        animationData->updateStride = levels->reducedStride > 1 ? levels->reducedStride : 1;
+        break;
+    default:
+        animationData->updateStride = 0;
+        break;
+    }
+}
@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/utils/entity_table.h"
+
+// The entity table of the world, initialised by InitGame
+static EntityTable entityTable;
+
+/**
+ * GetEntityTable - Returns the entity table of the world.
+ *
+ * State functions only receive their game object, so an object that decides
+ * to leave the world (e.g. an NPC that does not respawn) queues itself here.
+ *
+ * Return: The entity table.
+ */
+EntityTable *GetEntityTable(void)
+{
+    return &entityTable;
+}
+
+/**
+ * InitEntityTable - Allocates the slots and the destroy queue.
+ *
+ * @table:    The entity table to initialise.
+ * @capacity: Most live objects at once.
+ */
+void InitEntityTable(EntityTable *table, int capacity)
+{
+    memset(table, 0, sizeof(EntityTable));
+
+    table->objects = (GameObject **)calloc(capacity, sizeof(GameObject *));
+    table->generations = (uint32_t *)malloc(sizeof(uint32_t) * capacity);
+    table->freeSlots = (int *)malloc(sizeof(int) * capacity);
+    table->destroyQueue = (GameObject **)malloc(sizeof(GameObject *) * capacity);
+
+    if (!table->objects || !table->generations || !table->freeSlots || !table->destroyQueue)
+    {
+        fprintf(stderr, "Failed to allocate entity table\n");
+        exit(1);
+    }
+
+    // Slots are handed out lowest first, generation 0 is never valid
+    for (int i = 0; i < capacity; i++)
+    {
+        table->generations[i] = 1;
+        table->freeSlots[i] = capacity - 1 - i;
+    }
+
+    table->freeCount = capacity;
+    table->capacity = capacity;
+}
+
+/**
+ * RegisterEntity - Gives a game object a handle.
+ *
+ * @table: The entity table.
+ * @obj:   The game object, its handle is written to obj->handle.
+ *
+ * Return: true if registered, false when the table is full.
+ */
+bool RegisterEntity(EntityTable *table, GameObject *obj)
+{
+    if (table->freeCount == 0)
+    {
+        fprintf(stderr, "Entity table is full\n");
+        return false;
+    }
+
+    int slot = table->freeSlots[--table->freeCount];
+
+    table->objects[slot] = obj;
+    table->count++;
+
+    obj->handle = (EntityHandle){slot, table->generations[slot]};
+    return true;
+}
+
+/**
+ * ResolveEntity - Returns the game object behind a handle.
+ *
+ * @table:  The entity table.
+ * @handle: The handle to resolve.
+ *
+ * The generation of a slot changes as soon as its object is destroyed, so an
+ * old handle resolves to NULL rather than to whatever reuses the slot.
+ *
+ * Return: The game object, or NULL if the handle is empty or stale.
+ */
+GameObject *ResolveEntity(const EntityTable *table, EntityHandle handle)
+{
+    if (handle.generation == 0 || handle.index < 0 || handle.index >= table->capacity ||
+        table->generations[handle.index] != handle.generation)
+    {
+        return NULL;
+    }
+
+    return table->objects[handle.index];
+}
+
+/**
+ * QueueDestroy - Destroys a game object at the end of the tick.
+ *
+ * @table: The entity table.
+ * @obj:   The game object to destroy.
+ *
+ * The handle stops resolving right away, but the object stays in every list
+ * until FlushDestroyQueue, so it is safe to call from state functions and
+ * event handlers in the middle of an update.
+ *
+ * Return: true if queued, false if the object is not registered or already queued.
+ */
+bool QueueDestroy(EntityTable *table, GameObject *obj)
+{
+    if (ResolveEntity(table, obj->handle) != obj)
+    {
+        return false;
+    }
+
+    uint32_t *generation = &table->generations[obj->handle.index];
+    if (++*generation == 0)
+    {
+        *generation = 1; // Skip "no entity" on wrap around
+    }
+
+    table->destroyQueue[table->destroyCount++] = obj;
+    return true;
+}
+
+/**
+ * FlushDestroyQueue - Removes the game objects destroyed this tick.
+ *
+ * @table:   The entity table.
+ * @destroy: Takes each object out of the world, it may free the object.
+ * @context: Passed to destroy.
+ *
+ * Call once per tick after every system ran. Objects destroyed by destroy
+ * itself are removed in the same flush.
+ */
+void FlushDestroyQueue(EntityTable *table, EntityDestroyFunction destroy, void *context)
+{
+    for (int i = 0; i < table->destroyCount; i++)
+    {
+        GameObject *obj = table->destroyQueue[i];
+        int slot = obj->handle.index; // destroy may free the object
+
+        destroy(obj, context);
+
+        table->objects[slot] = NULL;
+        table->freeSlots[table->freeCount++] = slot;
+        table->count--;
+    }
+
+    table->destroyCount = 0;
+}
+
+/**
+ * FreeEntityTable - Frees the entity table.
+ *
+ * @table: The entity table to free.
+ */
+void FreeEntityTable(EntityTable *table)
+{
+    free(table->objects);
+    free(table->generations);
+    free(table->freeSlots);
+    free(table->destroyQueue);
+    memset(table, 0, sizeof(EntityTable));
+}
@@ -1,17 +1,127 @@
+#include <math.h>
+
 #include "../include/fsm/fsm.h"
 #include "../include/gameobjects/gameobject.h"
+#include "../include/utils/script_system.h"
+#include "../include/utils/sleep_system.h"
+
+// Where a layer keeps its state, the locomotion layer is the game object's own
+static void LayerFields(GameObject *obj, FsmLayer layer, State **previousState, State **currentState,
+                        StateConfig **stateConfigs)
+{
+    if (layer == FSM_LAYER_LOCOMOTION)
+    {
+        *previousState = &obj->previousState;
+        *currentState = &obj->currentState;
+        *stateConfigs = obj->stateConfigs;
+        return;
+    }
+
+    FsmLayerState *layerState = &obj->layers[layer - 1];
+    *previousState = &layerState->previousState;
+    *currentState = &layerState->currentState;
+    *stateConfigs = layerState->stateConfigs;
+}
+
+/**
+ * MakeEvent - Builds an event without payload.
+ *
+ * @type: The event.
+ *
+ * The cardinal move events get their unit direction at full magnitude, so
+ * handlers read every move from the payload whichever way it was sent.
+ *
+ * Return: The event, with no source.
+ */
+EventData MakeEvent(Event type)
+{
+    EventData event = {type, {0, 0}, {0, 0}, 0.0f, 0};
+
+    switch (type)
+    {
+    case EVENT_MOVE_UP:
+        event.direction = (Vector2){0, -1};
+        break;
+    case EVENT_MOVE_DOWN:
+        event.direction = (Vector2){0, 1};
+        break;
+    case EVENT_MOVE_LEFT:
+        event.direction = (Vector2){-1, 0};
+        break;
+    case EVENT_MOVE_RIGHT:
+        event.direction = (Vector2){1, 0};
+        break;
+    default:
+        return event;
+    }
+
+    event.magnitude = 1.0f;
+    return event;
+}
 
 /**
- * HandleEvent - Handles an event for a given game object based on its current state.
+ * MakeMoveEvent - Builds an EVENT_MOVE in any direction.
+ *
+ * @direction: Where to move, any length (zero means stop).
+ * @magnitude: How hard to move, clamped to 0..1.
+ *
+ * Return: The event, its direction normalized.
+ */
+EventData MakeMoveEvent(Vector2 direction, float magnitude)
+{
+    EventData event = {EVENT_MOVE, {0, 0}, {0, 0}, 0.0f, 0};
+    float length = sqrtf(direction.x * direction.x + direction.y * direction.y);
+
+    if (length > 0.0f)
+    {
+        event.direction = (Vector2){direction.x / length, direction.y / length};
+        event.magnitude = fminf(fmaxf(magnitude, 0.0f), 1.0f);
+    }
+
+    return event;
+}
+
+/**
+ * MakeHitEvent - Builds an event caused by another game object's hit.
+ *
+ * @type:   The event (e.g. EVENT_COLLISION_START, EVENT_DIE).
+ * @source: Handle of the game object behind the hit.
+ * @damage: Damage the hit dealt.
+ *
+ * Return: The event.
+ */
+EventData MakeHitEvent(Event type, EntityHandle source, int damage)
+{
+    EventData event = MakeEvent(type);
+
+    event.source = source;
+    event.damage = damage;
+    return event;
+}
+
+/**
+ * HandleEventData - Handles an event for a given game object based on its current state.
  *
  * This function checks the current state of the game object and, if an event handler
  * (HandleEvent) is defined for the current state, it calls that function to handle the event.
+ * Every other layer the object uses then handles the same event in its own current state.
+ * Handlers read the payload (direction, source, damage) from the event itself.
  *
  * @obj:   A pointer to the GameObject that is receiving the event.
  * @event: The event to be handled (such as a user input, time-based event, etc.).
  */
-void HandleEvent(GameObject *obj, Event event)
+void HandleEventData(GameObject *obj, const EventData *event)
 {
+    // Any real event counts as activity, a sleeper is woken so it is updated
+    // again and its state change takes effect
+    if (event->type != EVENT_NONE)
+    {
+        WakeGameObject(GetSleepSystem(), obj);
+
+        // A script waiting for this event resumes on the next script tick
+        NotifyScriptEvent(GetScriptSystem(), obj, event->type);
+    }
+
     // Get the state configuration for the current state of the object
     StateConfig *config = &obj->stateConfigs[obj->currentState];
 
@@ -20,6 +130,43 @@ void HandleEvent(GameObject *obj, Event event)
     {
         config->HandleEvent(obj, event); // Call the state's event handler
     }
+
+    for (int l = 0; l < FSM_LAYER_COUNT - 1; l++)
+    {
+        FsmLayerState *layer = &obj->layers[l];
+
+        if (layer->stateConfigs != NULL && layer->stateConfigs[layer->currentState].HandleEvent)
+        {
+            layer->stateConfigs[layer->currentState].HandleEvent(obj, event);
+        }
+    }
+}
+
+/**
+ * HandleEvent - Handles an event without payload for a given game object.
+ *
+ * @obj:   A pointer to the GameObject that is receiving the event.
+ * @event: The event to be handled (see MakeEvent).
+ */
+void HandleEvent(GameObject *obj, Event event)
+{
+    EventData data = MakeEvent(event);
+    HandleEventData(obj, &data);
+}
+
+/**
+ * HandleMoveEvent - Handles an EVENT_MOVE carrying the direction to move in.
+ *
+ * One moving state can cover every direction, analog ones included, instead
+ * of a state per EVENT_MOVE_UP/DOWN/LEFT/RIGHT.
+ *
+ * @obj:       A pointer to the GameObject that is receiving the event.
+ * @direction: Where to move at full magnitude, any length (zero means stop).
+ */
+void HandleMoveEvent(GameObject *obj, Vector2 direction)
+{
+    EventData event = MakeMoveEvent(direction, 1.0f);
+    HandleEventData(obj, &event);
 }
 
 /**
@@ -27,6 +174,7 @@ void HandleEvent(GameObject *obj, Event event)
  *
  * This function checks if the current state has an update function defined, and if so, it calls that
  * function to perform any state-specific actions (e.g., animation updates, state-based actions).
+ * The other layers the object uses are updated after it.
  *
  * @obj: A pointer to the GameObject whose state needs to be updated.
  */
@@ -40,6 +188,62 @@ void UpdateState(GameObject *obj)
     {
         config->Update(obj); // Perform the update for the current state (e.g., animation, actions)
     }
+
+    for (int l = 0; l < FSM_LAYER_COUNT - 1; l++)
+    {
+        FsmLayerState *layer = &obj->layers[l];
+
+        if (layer->stateConfigs != NULL && layer->stateConfigs[layer->currentState].Update)
+        {
+            layer->stateConfigs[layer->currentState].Update(obj);
+        }
+    }
+}
+
+// Whether a layer's current state lists newState as a valid next state
+static bool CanEnterLayerState(GameObject *obj, FsmLayer layer, State newState)
+{
+    State *previousState, *currentState;
+    StateConfig *stateConfigs;
+    LayerFields(obj, layer, &previousState, &currentState, &stateConfigs);
+
+    if (stateConfigs == NULL)
+    {
+        return false;
+    }
+
+    // Loop through the possible next states and check if newState is valid
+    StateConfig *currentConfig = &stateConfigs[*currentState];
+    for (int i = 0; i < currentConfig->nextStatesCount; i++)
+    {
+        if (currentConfig->nextStates[i] == newState)
+            return true; // Valid transition found
+    }
+    return false; // No valid transition found
+}
+
+// Runs the current state's Exit, switches the layer to newState and runs its Entry
+static void SwitchLayerState(GameObject *obj, FsmLayer layer, State newState)
+{
+    State *previousState, *currentState;
+    StateConfig *stateConfigs;
+    LayerFields(obj, layer, &previousState, &currentState, &stateConfigs);
+
+    // Get the configuration of the current state and the new state
+    StateConfig *currentConfig = &stateConfigs[*currentState];
+    StateConfig *newConfig = &stateConfigs[newState];
+
+    // If the current state has an exit function defined, call it
+    if (currentConfig->Exit)
+        currentConfig->Exit(obj);
+
+    // Update the layer's previous and current state
+    *previousState = *currentState;
+    *currentState = newState;
+
+    // If the new state has an entry function defined, call it
+    if (newConfig->Entry)
+        newConfig->Entry(obj);
 }
 
 /**
@@ -55,16 +259,7 @@ void UpdateState(GameObject *obj)
  */
 bool CanEnterState(GameObject *obj, State newState)
 {
-    // Get the current state configuration
-    StateConfig *currentConfig = &obj->stateConfigs[obj->currentState];
-
-    // Loop through the possible next states and check if newState is valid
-    for (int i = 0; i < currentConfig->nextStatesCount; i++)
-    {
-        if (currentConfig->nextStates[i] == newState)
-            return true; // Valid transition found
-    }
-    return false; // No valid transition found
+    return CanEnterLayerState(obj, FSM_LAYER_LOCOMOTION, newState);
 }
 
 /**
@@ -80,34 +275,141 @@ bool CanEnterState(GameObject *obj, State newState)
  * @return: Returns true if the transition is successful, false if the transition is invalid.
  */
 bool ChangeState(GameObject *obj, State newState)
+{
+    return ChangeLayerState(obj, FSM_LAYER_LOCOMOTION, newState);
+}
+
+/**
+ * ApplyReplicatedState - Forces the game object into a state decided elsewhere.
+ *
+ * Network clients do not simulate, the host's state is authoritative. Snapshots
+ * can skip intermediate states (e.g. Dead -> Respawn -> Idle within one
+ * snapshot interval), so the transition is not validated. Exit and entry
+ * functions still run, they select the animation clip for the new state.
+ *
+ * @obj:      A pointer to the GameObject whose state is being replicated.
+ * @newState: The state the host reported for the game object.
+ */
+void ApplyReplicatedState(GameObject *obj, State newState)
+{
+    ApplyReplicatedLayerState(obj, FSM_LAYER_LOCOMOTION, newState);
+}
+
+/**
+ * InitFsmLayer - Gives a game object a state machine layer.
+ *
+ * @obj:          The game object.
+ * @layer:        The layer, not the locomotion one (see InitGameObject).
+ * @stateConfigs: STATE_COUNT state configs for the layer, owned by the game
+ *                object from now on (see FreeFsmLayers). States the layer does
+ *                not use are left zeroed.
+ * @initialState: The layer's first state, its Entry is not run.
+ */
+void InitFsmLayer(GameObject *obj, FsmLayer layer, StateConfig *stateConfigs, State initialState)
+{
+    FsmLayerState *layerState = &obj->layers[layer - 1];
+
+    layerState->stateConfigs = stateConfigs;
+    layerState->currentState = initialState;
+    layerState->previousState = initialState;
+}
+
+/**
+ * GetLayerState - Returns the current state of a layer.
+ *
+ * @obj:   The game object.
+ * @layer: The layer.
+ *
+ * Return: The layer's current state, STATE_IDLE if the object does not use the layer.
+ */
+State GetLayerState(const GameObject *obj, FsmLayer layer)
+{
+    if (layer == FSM_LAYER_LOCOMOTION)
+    {
+        return obj->currentState;
+    }
+
+    const FsmLayerState *layerState = &obj->layers[layer - 1];
+    return layerState->stateConfigs != NULL ? layerState->currentState : STATE_IDLE;
+}
+
+/**
+ * ChangeLayerState - Attempts to change the state of one layer.
+ *
+ * @obj:      The game object.
+ * @layer:    The layer to change, the others keep their state and see no Exit or Entry.
+ * @newState: The state to which the layer will transition.
+ *
+ * Return: true if the transition is valid for the layer and was made.
+ */
+bool ChangeLayerState(GameObject *obj, FsmLayer layer, State newState)
 {
     // Check if the state transition is valid
-    if (!CanEnterState(obj, newState))
+    if (!CanEnterLayerState(obj, layer, newState))
     {
+        State *previousState, *currentState;
+        StateConfig *stateConfigs;
+        LayerFields(obj, layer, &previousState, &currentState, &stateConfigs);
+
         // If the transition is not valid, print an error and return false
-        printf("Invalid state transition from %s to %s\n",
-               obj->stateConfigs[obj->currentState].name,
-               obj->stateConfigs[newState].name);
+        if (stateConfigs != NULL)
+        {
+            printf("Invalid state transition from %s to %s\n",
+                   stateConfigs[*currentState].name,
+                   stateConfigs[newState].name);
+        }
         return false; // Transition failed
     }
 
-    // Get the configuration of the current state and the new state
-    StateConfig *currentConfig = &obj->stateConfigs[obj->currentState];
-    StateConfig *newConfig = &obj->stateConfigs[newState];
+    SwitchLayerState(obj, layer, newState);
+    return true; // State transition successful
+}
 
-    // If the current state has an exit function defined, call it
-    if (currentConfig->Exit)
-        currentConfig->Exit(obj);
+/**
+ * ApplyReplicatedLayerState - Forces one layer into a state decided elsewhere.
+ *
+ * @obj:      The game object being replicated.
+ * @layer:    The layer.
+ * @newState: The state the host reported for the layer.
+ *
+ * See ApplyReplicatedState, layers the object does not use are left alone.
+ */
+void ApplyReplicatedLayerState(GameObject *obj, FsmLayer layer, State newState)
+{
+    State *previousState, *currentState;
+    StateConfig *stateConfigs;
+    LayerFields(obj, layer, &previousState, &currentState, &stateConfigs);
 
-    // Update the object's previous and current state
-    obj->previousState = obj->currentState;
-    obj->currentState = newState;
+    if (stateConfigs == NULL || *currentState == newState)
+        return;
 
-    // If the new state has an entry function defined, call it
-    if (newConfig->Entry)
-        newConfig->Entry(obj);
+    SwitchLayerState(obj, layer, newState);
+}
 
-    return true; // State transition successful
+/**
+ * FreeFsmLayers - Frees the state configs of the layers beside the locomotion one.
+ *
+ * @obj: The game object.
+ */
+void FreeFsmLayers(GameObject *obj)
+{
+    for (int l = 0; l < FSM_LAYER_COUNT - 1; l++)
+    {
+        StateConfig *stateConfigs = obj->layers[l].stateConfigs;
+
+        if (stateConfigs == NULL)
+        {
+            continue;
+        }
+
+        for (int i = 0; i < STATE_COUNT; i++)
+        {
+            free(stateConfigs[i].nextStates);
+        }
+
+        free(stateConfigs);
+        obj->layers[l].stateConfigs = NULL;
+    }
 }
 
 /**
@@ -1,30 +1,995 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <raylib.h>
 
 #include "../include/game/game.h"
+#include "../include/utils/constants.h"
+#include "../include/render/render_queue.h"
+
+static int SizeGame(GameData *gameData);
+static void InitGameSystems(GameData *gameData);
+static void InitGameNPCs(GameData *gameData);
+static void FinishGame(GameData *gameData);
+static void CreatePlayers(GameData *gameData, int playerCount);
+static void CreateNPCs(GameData *gameData, int npcCount);
+static void DeliverTimerEvent(GameObject *obj, Event event, void *context);
+static void WakeScriptedObject(GameObject *obj, void *context);
+static void RemoveGameObject(GameObject *obj, void *context);
+static void CreateTriggers(GameData *gameData);
+static void CreateWalls(GameData *gameData);
+static void HandleTriggerEvents(GameData *gameData);
+static bool IsHashingState(const GameData *gameData);
+
+/**
+ * InitGame - Initializes the game, setting up the player, NPC, and mediator.
+ *
+ * This function prepares the game for play by creating a player, an NPC, and
+ * a mediator to manage interactions between these entities. The `GameData`
+ * structure is used to store the current state of the game. The whole world
+ * is built at once, scenes preparing it between frames use InitGameStep.
+ *
+ * @gameData: A pointer to the GameData structure containing the game state.
+ */
+void InitGame(GameData *gameData)
+{
+    int step = 0;
+    while (!InitGameStep(gameData, step))
+    {
+        step++;
+    }
+}
+
+/**
+ * InitGameStep - Builds the world one bounded step at a time.
+ *
+ * @gameData: A pointer to the GameData structure containing the game state.
+ * @step:     Steps taken so far, 0 for the first.
+ *
+ * The systems and players come first, then the NPC storage, then up to
+ * GAME_INIT_NPCS_PER_STEP NPCs per step, each hashed as it joins, then as
+ * many spare pool slots per step, and last the level. Each step takes a bounded time whatever the NPC count, so a scene
+ * preload spreads the world over the frames before it (see GameplayPreload).
+ * A world cut short is freed by CloseGame like a complete one.
+ *
+ * Return: true once the world is complete.
+ */
+bool InitGameStep(GameData *gameData, int step)
+{
+    switch (step)
+    {
+    case 0:
+        InitGameSystems(gameData);
+        return false;
+    case 1:
+        InitGameNPCs(gameData);
+        return false;
+    default:
+        break;
+    }
+
+    if (gameData->npcCount < gameData->npcSpawnCount)
+    {
+        int spawned = gameData->npcCount;
+        int count = gameData->npcSpawnCount - spawned;
+
+        CreateNPCs(gameData, spawned + (count < GAME_INIT_NPCS_PER_STEP ? count : GAME_INIT_NPCS_PER_STEP));
+
+        if (IsHashingState(gameData))
+        {
+            for (int i = spawned; i < gameData->npcCount; i++)
+            {
+                StateHashObject(&gameData->stateHasher, &gameData->npcs[i]->base);
+            }
+        }
+
+        // The pool ran out, the world holds what it got
+        if (gameData->npcCount == spawned)
+        {
+            gameData->npcSpawnCount = spawned;
+        }
+        return false;
+    }
+
+    // Slots left for respawns and a host's later NPCs
+    if (!FillPrefabPool(&gameData->npcPool, GAME_INIT_NPCS_PER_STEP))
+    {
+        return false;
+    }
+
+    FinishGame(gameData);
+    return true;
+}
+
+/**
+ * InitGameSystems - The first step of InitGameStep: systems, players and the state hasher.
+ *
+ * @gameData: A pointer to the GameData structure containing the game state.
+ */
+static void InitGameSystems(GameData *gameData)
+{
+    InitAudioDevice();      // Initialize audio device
+
+    // Every system is sized for the players and the NPCs asked for
+    gameData->npcSpawnCount = SizeGame(gameData);
+    int capacity = gameData->objectCapacity;
+
+    // Gameplay timers and cooldowns expire as events, delivered through DeliverTimerEvent
+    InitTimerWheel(GetTimerService(), DeliverTimerEvent, gameData);
+
+    // Pooled projectiles fired by NPC bursts
+    InitProjectileSystem(GetProjectileSystem(), PROJECTILE_CAPACITY);
+    InitCombatQueue(&gameData->combat);
+    InitStatusEffects(GetStatusEffects(), capacity);
+    InitScriptSystem(GetScriptSystem(), capacity, capacity, WakeScriptedObject, gameData);
+
+    // Handles of every game object, destroyed ones are removed at the end of the tick (see RemoveGameObject)
+    InitEntityTable(GetEntityTable(), capacity);
+
+    // One player per lockstep peer or hosted client, a single local player otherwise
+    int localPlayer = 0;
+    int playerCount = 1;
+
+    if (gameData->lockstep.active)
+    {
+        localPlayer = gameData->lockstep.localPeer;
+        playerCount = gameData->lockstep.peerCount;
+    }
+    else if (gameData->clientServer.role == NET_ROLE_HOST)
+    {
+        playerCount = gameData->clientServer.playerCount;
+        InitColliderHistory(&gameData->colliderHistory, capacity);
+    }
+    else if (gameData->clientServer.role == NET_ROLE_CLIENT)
+    {
+        playerCount = 0; // Created once the host's first snapshot arrives
+    }
+
+    CreatePlayers(gameData, playerCount);
+
+    if (playerCount > 0)
+    {
+        // The local player is the one driven by this machine's input
+        gameData->player = gameData->players[localPlayer];
+        gameData->mediator = gameData->mediators[localPlayer];
+    }
+
+    // Levels of detail, unless the command line set them
+    if (gameData->detail.impostorDistance <= 0.0f)
+    {
+        InitDetailLevels(&gameData->detail);
+    }
+
+#ifdef DEBUG
+    // State hashing is cheap enough to always run in debug builds. Lockstep
+    // peers, host and client default to different logs so two processes in
+    // the same directory do not write over each other
+    char defaultLogPath[64] = STATE_HASH_LOG_PATH;
+
+    if (gameData->lockstep.active)
+    {
+        snprintf(defaultLogPath, sizeof(defaultLogPath), STATE_HASH_PEER_LOG_PATH, gameData->lockstep.localPeer);
+    }
+    else if (gameData->clientServer.role == NET_ROLE_HOST)
+    {
+        snprintf(defaultLogPath, sizeof(defaultLogPath), "%s", STATE_HASH_HOST_LOG_PATH);
+    }
+    else if (gameData->clientServer.role == NET_ROLE_CLIENT)
+    {
+        snprintf(defaultLogPath, sizeof(defaultLogPath), "%s", STATE_HASH_CLIENT_LOG_PATH);
+    }
+
+    InitStateHasher(&gameData->stateHasher, gameData->hashLogPath != NULL ? gameData->hashLogPath : defaultLogPath, capacity);
+#else
+    InitStateHasher(&gameData->stateHasher, gameData->hashLogPath, capacity);
+#endif
+    gameData->stateHasher.logEntities = gameData->hashEntities;
+
+    // Every entity is hashed once as it joins, from then on only what the tick simulated
+    if (IsHashingState(gameData))
+    {
+        for (int i = 0; i < gameData->playerCount; i++)
+        {
+            StateHashObject(&gameData->stateHasher, &gameData->players[i]->base);
+        }
+    }
+}
+
+/**
+ * InitGameNPCs - The second step of InitGameStep: where the NPCs will live.
+ *
+ * @gameData: A pointer to the GameData structure containing the game state.
+ *
+ * The NPCs themselves are spawned by the steps after it, into a pool whose
+ * storage is only reserved here.
+ */
+static void InitGameNPCs(GameData *gameData)
+{
+    // Idle NPCs far from the players are put to sleep
+    InitNPCPrefab(&gameData->npcPrefab);
+    ReservePrefabPool(&gameData->npcPool, &gameData->npcPrefab, gameData->npcCapacity);
+    InitSleepSystem(GetSleepSystem(), gameData->npcCapacity);
+    InitSquadSystem(&gameData->squads, gameData->objectCapacity);
+}
+
+/**
+ * FinishGame - The last step of InitGameStep: the sentry and the level.
+ *
+ * @gameData: A pointer to the GameData structure containing the game state.
+ */
+static void FinishGame(GameData *gameData)
+{
+    // The first NPC is a scripted sentry, clients only mirror what the host simulates
+    if (gameData->clientServer.role != NET_ROLE_CLIENT)
+    {
+        StartScript(GetScriptSystem(), &gameData->npcs[0]->base, NPCSentryScript);
+    }
+
+    CreateTriggers(gameData);
+    CreateWalls(gameData);
+
+    gameData->tick = 0;
+
+    printf("Game Initialized!\n");
+}
+
+// Allocates one of the arrays sized for the world
+static void *AllocateGameArray(size_t size, int count)
+{
+    void *array = malloc(size * count);
+    if (!array)
+    {
+        fprintf(stderr, "Failed to allocate the game's arrays\n");
+        exit(1);
+    }
+    return array;
+}
+
+/**
+ * SizeGame - Decides how many objects the world holds and allocates for them.
+ *
+ * @gameData: A pointer to the GameData structure containing the game state.
+ *
+ * The NPCs asked for (npcCount, at least one) are clamped to MAX_NPCS, and to
+ * MAX_NETWORKED_NPCS for a host since every entity has to fit in its
+ * snapshots. Clients make room for whatever a host can send. Players always
+ * get MAX_PLAYERS slots, a host's clients join after InitGame.
+ *
+ * Return: The number of NPCs to spawn.
+ */
+static int SizeGame(GameData *gameData)
+{
+    int npcCount = gameData->npcCount > 0 ? gameData->npcCount : 1;
+    int maxNPCs = gameData->clientServer.role != NET_ROLE_NONE ? MAX_NETWORKED_NPCS : MAX_NPCS;
+
+    if (npcCount > maxNPCs)
+    {
+        fprintf(stderr, "Asked for %d NPCs, spawning the most this game holds: %d\n", npcCount, maxNPCs);
+        npcCount = maxNPCs;
+    }
+
+    gameData->npcCount = 0;
+    gameData->npcCapacity = gameData->clientServer.role == NET_ROLE_CLIENT ? MAX_NETWORKED_NPCS : npcCount;
+    gameData->objectCapacity = MAX_PLAYERS + gameData->npcCapacity;
+
+    int capacity = gameData->objectCapacity;
+    GameScratch *scratch = &gameData->scratch;
+
+    gameData->npcs = (NPC **)AllocateGameArray(sizeof(NPC *), gameData->npcCapacity);
+    scratch->objects = (GameObject **)AllocateGameArray(sizeof(GameObject *), capacity);
+    scratch->awake = (GameObject **)AllocateGameArray(sizeof(GameObject *), capacity);
+    scratch->agents = (SpatialAgent *)AllocateGameArray(sizeof(SpatialAgent), capacity);
+    scratch->agentObjects = (GameObject **)AllocateGameArray(sizeof(GameObject *), capacity);
+    scratch->queries = (int *)AllocateGameArray(sizeof(int), capacity);
+    scratch->candidates = (int *)AllocateGameArray(sizeof(int), capacity * NPC_TARGET_CANDIDATES);
+    scratch->candidateCounts = (int *)AllocateGameArray(sizeof(int), capacity);
+    scratch->leaders = (GameObject **)AllocateGameArray(sizeof(GameObject *), capacity);
+    scratch->targets = (GameObject **)AllocateGameArray(sizeof(GameObject *), capacity);
+
+    return npcCount;
+}
+
+/**
+ * DeliverTimerEvent - Delivers an expired gameplay timer to its game object.
+ *
+ * @obj:     The game object the timer was scheduled for.
+ * @event:   The event to deliver.
+ * @context: The GameData the timer service was initialised with.
+ */
+static void DeliverTimerEvent(GameObject *obj, Event event, void *context)
+{
+    (void)context;
+
+    // Sleeping objects are not updated, HandleEvent wakes them so they can react to the event
+    HandleEvent(obj, event);
+}
+
+/**
+ * WakeScriptedObject - Wakes a game object its script is about to drive.
+ *
+ * @obj:     The scripted game object.
+ * @context: The GameData the script system was initialised with.
+ */
+static void WakeScriptedObject(GameObject *obj, void *context)
+{
+    (void)context;
+    WakeGameObject(GetSleepSystem(), obj);
+}
+
+/**
+ * IsHashingState - Whether the world state is hashed each tick.
+ *
+ * @gameData: A pointer to the GameData structure containing the game state.
+ *
+ * Return: Always in debug builds, otherwise only when a hash log was asked
+ *         for or lockstep peers compare hashes.
+ */
+static bool IsHashingState(const GameData *gameData)
+{
+#ifdef DEBUG
+    (void)gameData;
+    return true;
+#else
+    return gameData->stateHasher.log != NULL || gameData->lockstep.active;
+#endif
+}
+
+/**
+ * RemoveGameObject - Takes a destroyed game object out of the world.
+ *
+ * @obj:     The destroyed game object (see QueueDestroy).
+ * @context: The GameData the entity table was flushed with.
+ *
+ * Runs at the end of the tick, once nothing iterates the world anymore. The
+ * last NPC takes the destroyed one's place in npcs and in the sleep system,
+ * along with its entity index, so the NPCs stay dense and entity indices keep
+ * following GatherGameObjects. Clients see another handle arrive at the index
+ * and drop its interpolation (see PushSnapshot). Players leave with their
+ * session, not here.
+ */
+static void RemoveGameObject(GameObject *obj, void *context)
+{
+    GameData *gameData = (GameData *)context;
+
+    int n = obj->entity - gameData->playerCount;
+    if (n < 0 || n >= gameData->npcCount || &gameData->npcs[n]->base != obj)
+    {
+        fprintf(stderr, "Only NPCs can be destroyed\n");
+        return;
+    }
+
+    int hole = obj->entity;
+    int last = gameData->npcCount - 1;
+    int lastEntity = gameData->playerCount + last;
+
+    // Squads point at their members, they regroup on the next update
+    DisbandSquads(&gameData->squads);
+
+    // The sleep system swap removes the same way, so slots keep matching npcs
+    RemoveFromSleepSystem(GetSleepSystem(), obj);
+    ReleaseGameObject(obj);
+    ReleasePrefabInstance(&gameData->npcPool, obj);
+
+    gameData->npcs[n] = gameData->npcs[last];
+    gameData->npcs[last] = NULL;
+    gameData->npcCount--;
+
+    // Systems keyed by entity index follow the moved NPC (or forget the hole when nothing moved)
+    MoveScriptEntity(GetScriptSystem(), lastEntity, hole);
+    MoveTriggerOccupant(&gameData->triggers, lastEntity, hole);
+    MovePerceptionCache(&gameData->perception, lastEntity, hole);
+    MoveColliderHistory(&gameData->colliderHistory, lastEntity, hole);
+    MoveStateHashEntity(&gameData->stateHasher, lastEntity, hole);
+
+    if (n != last)
+    {
+        gameData->npcs[n]->base.entity = hole;
+    }
+}
+
+/**
+ * CreateTriggers - Places the trigger volumes of the level.
+ *
+ * @gameData: A pointer to the GameData structure containing the game state.
+ */
+static void CreateTriggers(GameData *gameData)
+{
+    InitTriggerVolumes(&gameData->triggers, gameData->objectCapacity);
+
+    // A hidden area in the bottom right corner of the screen
+    AddTriggerBox(&gameData->triggers, (c2AABB){{SCREEN_WIDTH - 100, SCREEN_HEIGHT - 100}, {SCREEN_WIDTH, SCREEN_HEIGHT}}, TRIGGER_TAG_SECRET);
+
+    gameData->secretSound = AcquireSound(GetAssetCache(), SECRET_SOUND);
+
+    // Designers tune the NPCs here without rebuilding, the built-in AI runs if it is missing
+    LoadBehaviorProgram(&gameData->behavior, "./assets/behaviors/npc.bvm");
+}
+
+/**
+ * CreateWalls - Places the static geometry that blocks NPC sight.
+ *
+ * @gameData: A pointer to the GameData structure containing the game state.
+ */
+static void CreateWalls(GameData *gameData)
+{
+    InitPerception(&gameData->perception, LEVEL_WIDTH_TILES, LEVEL_HEIGHT_TILES, gameData->objectCapacity);
+
+    AddPerceptionWall(&gameData->perception, (Rectangle){128, 192, 160, 32});
+    AddPerceptionWall(&gameData->perception, (Rectangle){544, 128, 32, 192});
+
+    // Influence cells line up with the wall tiles
+    InitInfluenceMap(&gameData->influence, LEVEL_WIDTH_TILES, LEVEL_HEIGHT_TILES);
+}
+
+// Wakes the sleepers inside a trigger volume (within its bounding circle)
+static void WakeTriggerSleepers(const TriggerVolume *volume)
+{
+    if (volume->shape == TRIGGER_SHAPE_BOX)
+    {
+        Vector2 centre = {(volume->box.min.x + volume->box.max.x) / 2.0f, (volume->box.min.y + volume->box.max.y) / 2.0f};
+        float radius = Vector2Distance(centre, (Vector2){volume->box.max.x, volume->box.max.y});
+        WakeGameObjectsNear(GetSleepSystem(), centre, radius);
+    }
+    else
+    {
+        WakeGameObjectsNear(GetSleepSystem(), (Vector2){volume->circle.p.x, volume->circle.p.y}, volume->circle.r);
+    }
+}
+
+/**
+ * HandleTriggerEvents - Reacts to entities crossing trigger volumes this tick.
+ *
+ * Sleepers never move into a trigger themselves, so an entity entering one
+ * wakes the sleepers inside it.
+ *
+ * @gameData: A pointer to the GameData structure containing the game state.
+ */
+static void HandleTriggerEvents(GameData *gameData)
+{
+    TriggerVolumes *triggers = &gameData->triggers;
+
+    for (int e = 0; e < triggers->eventCount; e++)
+    {
+        const TriggerEvent *event = &triggers->events[e];
+        bool isLocalPlayer = gameData->player != NULL && event->obj == &gameData->player->base;
+
+        if (event->type == TRIGGER_ENTER)
+        {
+            WakeTriggerSleepers(&triggers->volumes[event->trigger]);
+        }
+
+        // Only the player at this machine hears the secret
+        if (triggers->volumes[event->trigger].tag == TRIGGER_TAG_SECRET && event->type == TRIGGER_ENTER && isLocalPlayer)
+        {
+            printf("%s found a secret area\n", event->obj->name);
+            PlaySound(gameData->secretSound);
+        }
+    }
+}
+
+/**
+ * CreatePlayers - Creates players until the world holds the requested number.
+ *
+ * @gameData:    A pointer to the GameData structure containing the game state.
+ * @playerCount: Number of players the world should hold.
+ */
+static void CreatePlayers(GameData *gameData, int playerCount)
+{
+    static const char *playerNames[MAX_PLAYERS] = {"Player Hero", "Player Two", "Player Three", "Player Four"};
+
+    if (playerCount > MAX_PLAYERS)
+    {
+        playerCount = MAX_PLAYERS;
+    }
+
+    for (int i = gameData->playerCount; i < playerCount; i++)
+    {
+        gameData->players[i] = InitPlayer(playerNames[i]);
+        gameData->players[i]->base.entity = i; // Players come first (see GatherGameObjects)
+        RegisterEntity(GetEntityTable(), &gameData->players[i]->base);
+
+        // Spread the players out around the centre of the screen
+        Vector2 position = gameData->players[i]->base.position;
+        position.x += (i - (playerCount - 1) / 2.0f) * 100.0f;
+        SetGameObjectPosition(&gameData->players[i]->base, position);
+
+        // Create a mediator to facilitate communication between
+        // Command and FSM, ultimately updating the playes state
+        gameData->mediators[i] = CreateMediator(&gameData->players[i]->base);
+    }
+
+    if (playerCount > gameData->playerCount)
+    {
+        gameData->playerCount = playerCount;
+    }
+}
+
+/**
+ * CreateNPCs - Creates NPCs until the world holds the requested number.
+ *
+ * @gameData: A pointer to the GameData structure containing the game state.
+ * @npcCount: Number of NPCs the world should hold.
+ *
+ * The first NPC starts at its usual spot, the rest are laid out on a grid
+ * spreading away from the screen so most of them start out of reach. The
+ * factions take bands of NPC_SPAWN_BAND_ROWS rows in turn, with a gap
+ * between bands wider than perception, attack and wake reach, so hostiles
+ * start out of each other's sight and the quiet ones fall asleep. NPCs are
+ * copies of the NPC prefab spawned into the NPC pool.
+ */
+static void CreateNPCs(GameData *gameData, int npcCount)
+{
+    if (npcCount > gameData->npcCapacity)
+    {
+        npcCount = gameData->npcCapacity;
+    }
+
+    int first = gameData->npcCount;
+    if (npcCount <= first)
+    {
+        return;
+    }
+
+    Vector2 *positions = (Vector2 *)AllocateGameArray(sizeof(Vector2), npcCount - first);
+    GameObject **spawned = (GameObject **)AllocateGameArray(sizeof(GameObject *), npcCount - first);
+
+    // Beyond the furthest an NPC reacts to a hostile from, by a row
+    float reach = PERCEPTION_RANGE > NPC_ATTACK_RANGE ? PERCEPTION_RANGE : NPC_ATTACK_RANGE;
+    float bandGap = (reach > SLEEP_WAKE_RADIUS ? reach : SLEEP_WAKE_RADIUS) + NPC_SPAWN_SPACING;
+
+    for (int i = first; i < npcCount; i++)
+    {
+        int row = i / NPC_SPAWN_COLUMNS;
+        float y = 100.0f + row * NPC_SPAWN_SPACING + (row / NPC_SPAWN_BAND_ROWS) * bandGap;
+
+        positions[i - first] = i > 0 ? (Vector2){100.0f + (i % NPC_SPAWN_COLUMNS) * NPC_SPAWN_SPACING, y}
+                                     : gameData->npcPrefab.archetype->position;
+    }
+
+    int count = SpawnPrefabs(&gameData->npcPool, positions, npcCount - first, spawned);
+
+    for (int i = first; i < first + count; i++)
+    {
+        NPC *npc = (NPC *)spawned[i - first];
+
+        npc->base.entity = gameData->playerCount + i; // NPCs follow the players (see GatherGameObjects)
+        npc->base.faction = (i / NPC_SPAWN_COLUMNS / NPC_SPAWN_BAND_ROWS) % 2 == 0 ? FACTION_SKYNET : FACTION_ROGUES; // Bands take turns
+        RegisterEntity(GetEntityTable(), &npc->base);
+        gameData->npcs[i] = npc;
+        AddToSleepSystem(GetSleepSystem(), &npc->base);
+    }
+
+    gameData->npcCount = first + count;
+
+    free(positions);
+    free(spawned);
+}
+
+/**
+ * UpdateNPC - Applies an NPC's AI command and runs its state update.
+ *
+ * @npc:     The NPC to update.
+ * @command: What its squad decided it does this tick.
+ */
+static void UpdateNPC(NPC *npc, Command command)
+{
+    EventData event;
+    if (CommandToEvent(command, npc->base.handle, &event))
+    {
+        HandleEventData(&npc->base, &event);
+    }
+
+    // Update the NPC's state after handling the event
+    UpdateState(&npc->base);
+}
+
+/**
+ * UpdateSquads - Runs the AI of the awake NPCs, one decision per squad.
+ *
+ * Nearby NPCs of a faction are grouped into squads. Only the leaders pick a
+ * target and run the designer behavior (see RunBehavior), or PollAI when
+ * none is loaded, their members follow in formation (see
+ * SquadMemberCommand), so the AI cost shrinks with the squad size. NPCs that
+ * woke up since the squads were formed wait for the next regroup, which
+ * happens right away because the number of awake NPCs changed. Scripted NPCs
+ * are left out, their scripts drive them (see TickScripts).
+ *
+ * Every leader asks for its nearest hostiles, players or NPCs of another
+ * faction, in one batch against a grid built once per tick, and goes for the
+ * nearest one it has a line of sight to. Ties go to the lower entity so every
+ * lockstep peer picks the same target.
+ *
+ * @gameData: A pointer to the GameData structure containing the game state.
+ */
+static void UpdateSquads(GameData *gameData)
+{
+    SleepSystem *sleepSystem = GetSleepSystem();
+    SquadSystem *squads = &gameData->squads;
+    GameScratch *scratch = &gameData->scratch;
+
+    GameObject **awake = scratch->awake;
+    int awakeCount = 0;
+
+    for (int a = 0; a < sleepSystem->activeCount; a++)
+    {
+        GameObject *obj = &gameData->npcs[sleepSystem->active[a]]->base;
+
+        if (HasScript(GetScriptSystem(), obj))
+        {
+            UpdateState(obj); // Its script already sent this tick's events
+        }
+        else
+        {
+            awake[awakeCount++] = obj;
+        }
+    }
+
+    if (SquadsNeedReform(squads, gameData->tick, awakeCount))
+    {
+        FormSquads(squads, awake, awakeCount, gameData->tick);
+    }
+
+    // Everyone that can be targeted, players first then the awake NPCs
+    SpatialAgent *agents = scratch->agents;
+    GameObject **agentObjects = scratch->agentObjects;
+    int agentCount = 0;
+
+    for (int i = 0; i < gameData->playerCount; i++)
+    {
+        GameObject *obj = &gameData->players[i]->base;
+        agentObjects[agentCount] = obj;
+        agents[agentCount++] = (SpatialAgent){obj->position, obj->collider.r, obj->entity, obj->faction};
+    }
+
+    for (int a = 0; a < sleepSystem->activeCount; a++)
+    {
+        GameObject *obj = &gameData->npcs[sleepSystem->active[a]]->base;
+
+        // The dead are nobody's target
+        if (obj->currentState != STATE_DEAD)
+        {
+            agentObjects[agentCount] = obj;
+            agents[agentCount++] = (SpatialAgent){obj->position, obj->collider.r, obj->entity, obj->faction};
+        }
+    }
+
+    // The leaders still standing ask for their nearest hostiles, all in one batch
+    int *queries = scratch->queries;
+    int queryCount = 0;
+
+    for (int i = gameData->playerCount; i < agentCount; i++)
+    {
+        int s = squads->squadOf[agents[i].entity];
+
+        if (s >= 0 && squads->squads[s].members[0] == agentObjects[i])
+        {
+            queries[queryCount++] = i;
+        }
+    }
+
+    int *candidates = scratch->candidates;
+    int *candidateCounts = scratch->candidateCounts;
+
+    BuildSpatialGrid(&gameData->targeting, agents, agentCount, 0.0f);
+    FindNearestHostiles(&gameData->targeting, agents, queries, queryCount, NPC_TARGET_CANDIDATES, PERCEPTION_RANGE,
+                        candidates, candidateCounts);
+
+    // Each leader goes for the nearest hostile not behind a wall, or the nearest one
+    GameObject **leaders = scratch->leaders;
+    GameObject **targets = scratch->targets;
+    int leaderCount = 0;
+
+    for (int s = 0; s < squads->count; s++)
+    {
+        leaders[leaderCount] = squads->squads[s].members[0];
+        targets[leaderCount++] = NULL;
+    }
+
+    for (int q = 0; q < queryCount; q++)
+    {
+        GameObject *leader = agentObjects[queries[q]];
+        const int *found = &candidates[q * NPC_TARGET_CANDIDATES];
+        GameObject *target = candidateCounts[q] > 0 ? agentObjects[found[0]] : NULL;
+
+        for (int c = 0; c < candidateCounts[q]; c++)
+        {
+            if (HasLineOfSight(&gameData->perception, leader->position, agents[found[c]].position))
+            {
+                target = agentObjects[found[c]];
+                break;
+            }
+        }
+
+        targets[squads->squadOf[leader->entity]] = target;
+    }
+
+    // What the leaders can see of their targets, in one batch before they think
+    UpdatePerception(&gameData->perception, leaders, targets, leaderCount);
+
+    for (int s = 0; s < squads->count; s++)
+    {
+        Squad *squad = &squads->squads[s];
+        GameObject *leader = squad->members[0];
+
+        if (leader->asleep)
+        {
+            squads->dirty = true; // Its members need a new leader
+            continue;
+        }
+
+        bool visible = CanSeeTarget(&gameData->perception, leader);
+
+        if (gameData->behavior.length > 0)
+        {
+            squad->order = RunBehavior(&gameData->behavior, &((NPC *)leader)->behavior, leader, targets[s], visible,
+                                       &gameData->influence);
+        }
+        else
+        {
+            squad->order = PollAI(leader, targets[s], visible, &gameData->influence);
+        }
+        UpdateNPC((NPC *)leader, squad->order);
+
+        if (leader->currentState == STATE_DEAD)
+        {
+            squads->dirty = true;
+        }
+
+        for (int m = 1; m < squad->memberCount; m++)
+        {
+            if (!squad->members[m]->asleep)
+            {
+                UpdateNPC((NPC *)squad->members[m], SquadMemberCommand(squad, m));
+            }
+        }
+    }
+}
+
+// Where detail is measured from, the local player (the screen centre until there is one)
+static Vector2 DetailFocus(const GameData *gameData)
+{
+    if (gameData->player != NULL)
+    {
+        return gameData->player->base.position;
+    }
+
+    return (Vector2){SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f};
+}
+
+/**
+ * UpdateDetailLevels - Picks how often each NPC's animation updates this tick.
+ *
+ * @gameData: A pointer to the GameData structure containing the game state.
+ *
+ * Runs before the state updates that advance the animations. Only awake NPCs
+ * are visited, sleepers do not animate and a woken one keeps the level it
+ * fell asleep at until the next tick. Also counts the awake NPCs at each
+ * level for the debug overlay.
+ */
+static void UpdateDetailLevels(GameData *gameData)
+{
+    DetailLevels *detail = &gameData->detail;
+    SleepSystem *sleepSystem = GetSleepSystem();
+    Vector2 focus = DetailFocus(gameData);
+
+    memset(detail->counts, 0, sizeof(detail->counts));
+
+    for (int a = 0; a < sleepSystem->activeCount; a++)
+    {
+        NPC *npc = gameData->npcs[sleepSystem->active[a]]; // NPCs are added to the sleep system in order
+        DetailLevel level = GetDetailLevel(detail, focus, npc->base.position);
+
+        SetAnimationDetail(&npc->base.animation, detail, level);
+        detail->counts[level]++;
+    }
+}
+
+/**
+ * UpdateClient - Updates a network client from the host's snapshots.
+ *
+ * A client does not simulate. It sends its input to the host and renders every
+ * entity interpolationDelay ticks in the past, interpolating positions between
+ * the two snapshots around the render tick. States and health are taken from
+ * the snapshots as they are, only the animations advance locally.
+ *
+ * @gameData: A pointer to the GameData structure containing the game state.
+ */
+static void UpdateClient(GameData *gameData)
+{
+    ClientServerSession *session = &gameData->clientServer;
+
+    ClientSendInput(session, GetFrameInput()->commands);
+    ClientReceiveSnapshots(session);
+
+    if (session->localPlayer < 0)
+    {
+        return; // Nothing received from the host yet
+    }
+
+    // Mirror the players and NPCs of the host's world
+    CreatePlayers(gameData, session->playerCount);
+    CreateNPCs(gameData, session->entityCount - session->playerCount);
+
+    // The host swap removes the NPCs it destroys, so the ones it no longer has are the last ones here
+    int hostNpcCount = session->entityCount - session->playerCount;
+    for (int n = hostNpcCount > 0 ? hostNpcCount : 0; n < gameData->npcCount; n++)
+    {
+        QueueDestroy(GetEntityTable(), &gameData->npcs[n]->base);
+    }
+    FlushDestroyQueue(GetEntityTable(), RemoveGameObject, gameData);
+
+    if (session->localPlayer < gameData->playerCount)
+    {
+        gameData->player = gameData->players[session->localPlayer];
+        gameData->mediator = gameData->mediators[session->localPlayer];
+    }
+
+    ClientAdvanceRenderTick(session);
+
+    // Timers started by replicated states run locally, the next snapshot stays authoritative
+    AdvanceTimerWheel(GetTimerService());
+
+    // Projectiles are not replicated, bursts started by replicated states fly for show only
+    UpdateProjectiles(GetProjectileSystem(), NULL, 0);
+
+    // Entity order matches the host's GatherGameObjects, which only holds while the counts agree
+    if (gameData->playerCount != session->playerCount ||
+        gameData->playerCount + gameData->npcCount != session->entityCount)
+    {
+        return;
+    }
+
+    GameObject **objects = gameData->scratch.objects;
+    int count = GatherGameObjects(gameData, objects, gameData->objectCapacity);
+
+    UpdateDetailLevels(gameData);
+
+    for (int i = 0; i < count; i++)
+    {
+        GameObject *obj = objects[i];
+        InterpolatedSample sample;
+
+        if (!ClientSampleEntity(session, i, &sample))
+        {
+            continue;
+        }
+
+        // State first, Exit/Entry functions may move the object (e.g. respawning)
+        obj->velocity = sample.velocity; // Entry functions pick the directional clip from it
+        ApplyReplicatedState(obj, sample.state);
+        ApplyReplicatedLayerState(obj, FSM_LAYER_ACTION, sample.actionState);
+
+        // A turning NPC stays in its Moving state, so no Entry picks the new clip
+        if (i >= gameData->playerCount)
+        {
+            NPCFaceMoveDirection((NPC *)obj);
+        }
+
+        SetGameObjectPosition(obj, sample.position);
+        obj->health = sample.health;
+
+        UpdateAnimation(&obj->animation);
+    }
+
+    // Triggers react to the interpolated positions
+    UpdateTriggerVolumes(&gameData->triggers, objects, count);
+    HandleTriggerEvents(gameData);
+
+    // The attack area is only shown while the host reports the player attacking
+    for (int i = 0; i < gameData->playerCount; i++)
+    {
+        Player *player = gameData->players[i];
+        player->attacking = GetLayerState(&player->base, FSM_LAYER_ACTION) == STATE_ATTACKING;
+    }
+}
 
 /**
- * InitGame - Initializes the game, setting up the player, NPC, and mediator.
+ * AttackTargetCollider - Returns the collider a player's attack is tested against.
  *
- * This function prepares the game for play by creating a player, an NPC, and
- * a mediator to manage interactions between these entities. The `GameData`
- * structure is used to store the current state of the game.
+ * Remote players see the world in the past (interpolation delay plus latency),
+ * so on the host their attacks are tested against the target's collider as it
+ * was on their screen. The host's own player uses the current collider.
  *
  * @gameData: A pointer to the GameData structure containing the game state.
+ * @player:   Index of the attacking player.
+ * @entity:   Entity index of the target (same order as GatherGameObjects).
+ * @target:   The target game object.
+ *
+ * Return: The (possibly rewound) collider of the target.
  */
-void InitGame(GameData *gameData)
+static c2Circle AttackTargetCollider(GameData *gameData, int player, int entity, GameObject *target)
 {
-    printf("Game Initialized!\n");
+    c2Circle collider = target->collider;
 
-    InitAudioDevice();      // Initialize audio device
+    if (gameData->clientServer.role == NET_ROLE_HOST)
+    {
+        uint32_t lag = PlayerViewLag(&gameData->clientServer, player);
+
+        if (lag > 0)
+        {
+            uint32_t rewindTick = ClampRewindTick(&gameData->colliderHistory, gameData->tick, gameData->tick - lag);
+            RewindCollider(&gameData->colliderHistory, entity, rewindTick, &collider);
+        }
+    }
+
+    return collider;
+}
+
+// The game object at an entity index, players first and then the NPCs (see GatherGameObjects)
+static GameObject *GameObjectAt(GameData *gameData, int entity)
+{
+    if (entity < 0 || entity >= gameData->playerCount + gameData->npcCount)
+    {
+        return NULL;
+    }
+
+    return entity < gameData->playerCount ? &gameData->players[entity]->base
+                                          : &gameData->npcs[entity - gameData->playerCount]->base;
+}
+
+/**
+ * UpdateGameProjectiles - Moves the projectiles and queues their hits.
+ *
+ * Nothing is gathered while no projectile is in flight. Otherwise the players
+ * and awake NPCs are the targets, along with the sleepers the sleep system's
+ * grid holds near a projectile, so bullets do not pass through sleepers while
+ * the rest of them stay parked. Projectiles only hit factions other than the
+ * shooter's. Each hit queues the projectile's damage for the combat pass,
+ * which wakes a sleeping target.
+ *
+ * @gameData: A pointer to the GameData structure containing the game state.
+ */
+static void UpdateGameProjectiles(GameData *gameData)
+{
+    ProjectileSystem *projectiles = GetProjectileSystem();
+
+    if (projectiles->count == 0)
+    {
+        // Still clears last tick's hits
+        UpdateProjectiles(projectiles, NULL, 0);
+        return;
+    }
+
+    SleepSystem *sleepSystem = GetSleepSystem();
+    SpatialAgent *targets = gameData->scratch.agents;
+    int targetCount = 0;
 
-    // Initialize the player and NPC with their respective names
-    gameData->player = InitPlayer("Player Hero");
-    gameData->npc = InitNPC("Skynet");
+    for (int i = 0; i < gameData->playerCount; i++)
+    {
+        GameObject *obj = &gameData->players[i]->base;
+        targets[targetCount++] = (SpatialAgent){obj->position, obj->collider.r, i, obj->faction};
+    }
+
+    for (int a = 0; a < sleepSystem->activeCount; a++)
+    {
+        GameObject *obj = &gameData->npcs[sleepSystem->active[a]]->base;
+        targets[targetCount++] = (SpatialAgent){obj->position, obj->collider.r, obj->entity, obj->faction};
+    }
+
+    // A sleeper is hit when within its collider, the projectile's radius and a full step
+    float reach = PROJECTILE_RADIUS + PROJECTILE_MAX_SPEED + gameData->npcPrefab.archetype->collider.r;
+    int *sleepers = gameData->scratch.queries;
+    int sleeperCount = FindSleepersNear(sleepSystem, projectiles->x, projectiles->y, projectiles->count, reach,
+                                        sleepers, gameData->objectCapacity);
+
+    for (int s = 0; s < sleeperCount; s++)
+    {
+        GameObject *obj = &gameData->npcs[sleepers[s]]->base;
+        targets[targetCount++] = (SpatialAgent){obj->position, obj->collider.r, obj->entity, obj->faction};
+    }
+
+    UpdateProjectiles(projectiles, targets, targetCount);
+
+    for (int h = 0; h < projectiles->hitCount; h++)
+    {
+        const ProjectileHit *hit = &projectiles->hits[h];
+        GameObject *target = GameObjectAt(gameData, hit->target);
 
-    // Create a mediator to facilitate communication between
-    // Command and FSM, ultimately updating the playes state
-    gameData->mediator = CreateMediator(&gameData->player->base);
+        if (target != NULL)
+        {
+            QueueDamage(&gameData->combat, target->handle, hit->owner, hit->damage, DAMAGE_PROJECTILE);
+        }
+    }
 }
 
 /**
@@ -39,180 +1004,469 @@ void InitGame(GameData *gameData)
  */
 void UpdateGame(GameData *gameData)
 {
-    DrawText("Game Updating...", 190, 260, 20, DARKBLUE);
+    // Clients only render what the host simulated
+    if (gameData->clientServer.role == NET_ROLE_CLIENT)
+    {
+        UpdateClient(gameData);
+        return;
+    }
+
+    if (gameData->lockstep.active)
+    {
+        // Sample local input, every peer executes it inputDelay ticks from now
+        LockstepSubmitLocalInput(&gameData->lockstep, GetFrameInput()->commands);
+        LockstepPoll(&gameData->lockstep);
 
-    // Poll input from the user and execute the corresponding command
-    Command command = PollInput();
-    ExecuteCommand(command, gameData->mediator); // Execute the command via the mediator
+        // Stall the simulation until the inputs of every peer are known for this tick
+        if (!LockstepReadyToAdvance(&gameData->lockstep))
+        {
+            gameData->lockstep.stallFrames++;
+            return;
+        }
 
-    // Check if player should die
-    if (gameData->player->base.health <= 0)
+        // Execute every player's input for this tick via their mediator
+        for (int i = 0; i < gameData->playerCount; i++)
+        {
+            ExecutePlayerInput(LockstepGetInput(&gameData->lockstep, i), gameData->mediators[i]);
+        }
+    }
+    else
     {
-        ChangeState((GameObject *)gameData->player, STATE_DEAD);
+        // Take the input sampled this frame and execute the corresponding commands
+        ExecutePlayerInput(GetFrameInput()->commands, gameData->mediator); // Execute them via the mediator
+
+        // A host also executes the latest input of every connected client
+        if (gameData->clientServer.role == NET_ROLE_HOST)
+        {
+            HostReceiveInputs(&gameData->clientServer);
+
+            for (int i = 0; i < gameData->clientServer.clientCount; i++)
+            {
+                RemoteClient *client = &gameData->clientServer.clients[i];
+
+                if (client->hasInput && client->player < gameData->playerCount)
+                {
+                    // Remember how far in the past the client was looking when it acted
+                    client->viewLag = gameData->tick > client->viewTick ? gameData->tick - client->viewTick : 0;
+
+                    ExecutePlayerInput(client->input, gameData->mediators[client->player]);
+                    client->hasInput = false;
+                    client->input = (PlayerInput){COMMAND_NONE, COMMAND_NONE};
+                }
+            }
+        }
     }
 
-    // Update the player's state based on its current configuration
-    UpdateState(&gameData->player->base);
+    // Deliver the gameplay timers (roll/attack ends, cooldowns) expiring this tick
+    AdvanceTimerWheel(GetTimerService());
 
+    // Expire status effects and set this tick's movement and damage modifiers
+    TickStatusEffects(GetStatusEffects(), &gameData->combat);
 
-    // Simple random behavior for NPC AI (not truly an AI, just random selection)
-    // Static variable to track the last AI action time
-    // static float lastAITime = 0.0f;
+    // Far away NPCs animate less, before their states advance the animations
+    UpdateDetailLevels(gameData);
 
-    // Randomly select a command for the NPC
-    command = PollAI(&gameData->npc->base, &gameData->player->base);
-    switch (command)
+    for (int i = 0; i < gameData->playerCount; i++)
     {
-    case COMMAND_NONE:
-        HandleEvent((GameObject *)gameData->npc, EVENT_NONE);
-        printf("COMMAND_NONE");
-        break;
-    case COMMAND_MOVE_UP:
-        HandleEvent((GameObject *)gameData->npc, EVENT_MOVE_UP);
-        break;
-    case COMMAND_MOVE_DOWN:
-        HandleEvent((GameObject *)gameData->npc, EVENT_MOVE_DOWN);
-        break;
-    case COMMAND_MOVE_LEFT:
-        HandleEvent((GameObject *)gameData->npc, EVENT_MOVE_LEFT);
-        break;
-    case COMMAND_MOVE_RIGHT:
-        HandleEvent((GameObject *)gameData->npc, EVENT_MOVE_RIGHT);
-        break;
-    case COMMAND_ATTACK:
-        HandleEvent((GameObject *)gameData->npc, EVENT_ATTACK);
-        break;
-    case COMMAND_COLLISION_START:
-        HandleEvent((GameObject *)gameData->npc, EVENT_DIE);
-        break;
-    case COMMAND_COLLISION_END:
-        HandleEvent((GameObject *)gameData->npc, EVENT_RESPAWN);
-        break;
-    default:
-        break;
+        // Update the player's state based on its current configuration
+        UpdateState(&gameData->players[i]->base);
     }
 
-    // Update the NPC's state after handling the event
-    UpdateState(&gameData->npc->base);
+    // Only awake NPCs think, move and collide, sleepers cost nothing per tick
+    SleepSystem *sleepSystem = GetSleepSystem();
+
+    // Spread the influence of players and awake NPCs, so AI can read the situation from the map
+    for (int i = 0; i < gameData->playerCount; i++)
+    {
+        Player *player = gameData->players[i];
+        DepositInfluence(&gameData->influence, INFLUENCE_THREAT, player->base.position, player->attacking ? 2.0f : 1.0f);
+        DepositInfluence(&gameData->influence, INFLUENCE_PROXIMITY, player->base.position, 1.0f);
+    }
+
+    for (int a = 0; a < sleepSystem->activeCount; a++)
+    {
+        DepositInfluence(&gameData->influence, INFLUENCE_ALLIES, gameData->npcs[sleepSystem->active[a]]->base.position, 1.0f);
+    }
+
+    UpdateInfluenceMap(&gameData->influence);
 
-    // Check for collisions between player and NPC
-    if (CheckCollision(&gameData->player->base, &gameData->npc->base))
+    // Scripted NPCs follow their scripts, squad leaders decide for the rest and their members follow
+    TickScripts(GetScriptSystem());
+    UpdateSquads(gameData);
+
+    for (int i = 0; i < gameData->playerCount; i++)
     {
-        if (gameData->player->base.currentState != STATE_COLLISION)
+        Player *player = gameData->players[i];
+
+        for (int a = 0; a < sleepSystem->activeCount; a++)
         {
-            HandleEvent(&gameData->player->base, EVENT_COLLISION_START);
+            int n = sleepSystem->active[a]; // NPCs are added to the sleep system in order
+            NPC *npc = gameData->npcs[n];
+
+            // Check for collisions between player and NPC
+            if (CheckCollision(&player->base, &npc->base))
+            {
+                EventData contact = MakeHitEvent(EVENT_COLLISION_START, npc->base.handle, CONTACT_DAMAGE);
+
+                if (player->base.currentState != STATE_COLLISION)
+                {
+                    HandleEventData(&player->base, &contact);
+                }
+
+                // Try to push back player, the contact damage is applied by the combat pass
+                HandleCollision(&player->base, &npc->base);
+                QueueDamage(&gameData->combat, player->base.handle, contact.source, contact.damage, DAMAGE_CONTACT);
+
+                // Ensure that we are separated after handling the collision
+                if (!CheckCollision(&player->base, &npc->base))
+                {
+                    printf("Transitioning back to STATE_IDLE state from STATE_COLLISION\n");
+                    HandleEvent(&player->base, EVENT_NONE); // Ideally a EVENT_COLLISION_END
+                }
+            }
+
+            // Check collision with the enemy and the player's attack
+            if (player->attacking)
+            {
+                // NPCs are the entities after the players (see GatherGameObjects)
+                c2Circle target = AttackTargetCollider(gameData, i, gameData->playerCount + n, &npc->base);
+
+                if (c2CircletoCircle(player->attackArea, target))
+                {
+                    if (npc->base.currentState != STATE_COLLISION)
+                    {
+                        EventData hit = MakeHitEvent(EVENT_COLLISION_START, player->base.handle, MELEE_DAMAGE);
+                        HandleEventData(&npc->base, &hit);
+
+                        QueueDamage(&gameData->combat, npc->base.handle, hit.source, hit.damage, DAMAGE_MELEE);
+                    }
+                }
+            }
         }
+    }
 
-        // Try to push back player
-        HandleCollision(&gameData->player->base, &gameData->npc->base);
+    UpdateGameProjectiles(gameData);
 
-        // Ensure that we are separated after handling the collision
-        if (!CheckCollision(&gameData->player->base, &gameData->npc->base))
+    // Only entities that are awake can have moved into or out of a trigger
+    {
+        GameObject **movers = gameData->scratch.objects;
+        int moverCount = 0;
+
+        for (int i = 0; i < gameData->playerCount; i++)
+        {
+            movers[moverCount++] = &gameData->players[i]->base;
+        }
+
+        for (int a = 0; a < sleepSystem->activeCount; a++)
         {
-            printf("Transitioning back to STATE_IDLE state from STATE_COLLISION\n");
-            HandleEvent(&gameData->player->base, EVENT_NONE); // Ideally a EVENT_COLLISION_END
+            movers[moverCount++] = &gameData->npcs[sleepSystem->active[a]]->base;
         }
+
+        UpdateTriggerVolumes(&gameData->triggers, movers, moverCount);
+        HandleTriggerEvents(gameData);
     }
-    
-    // Check collision with the enemy and the player's attack
-    if (gameData->player->attacking)
+
+    // Apply the tick's damage in one pass, deaths are announced with EVENT_DIE
+    ResolveCombat(&gameData->combat);
+
+    // Fold what the tick simulated into the state hash, before quiet NPCs are
+    // parked. Sleepers keep their hash, anything touching one wakes it first
+    if (IsHashingState(gameData))
     {
-        if (c2CircletoCircle(gameData->player->attackArea, gameData->npc->base.collider))
+        for (int i = 0; i < gameData->playerCount; i++)
         {
-            if (gameData->npc->base.currentState != STATE_COLLISION)
-            {
-                HandleEvent(&gameData->npc->base, EVENT_COLLISION_START);
+            StateHashObject(&gameData->stateHasher, &gameData->players[i]->base);
+        }
+        for (int a = 0; a < sleepSystem->activeCount; a++)
+        {
+            StateHashObject(&gameData->stateHasher, sleepSystem->objects[sleepSystem->active[a]]);
+        }
+    }
 
-                gameData->npc->base.health--;
-            }
+    // Park NPCs that have gone quiet, wake sleepers near the players or anything that moved
+    GameObject *wakers[MAX_PLAYERS];
+    for (int i = 0; i < gameData->playerCount; i++)
+    {
+        wakers[i] = &gameData->players[i]->base;
+    }
+    UpdateSleepSystem(sleepSystem, wakers, gameData->playerCount);
+
+    // Remove what was destroyed during the tick, before the world is hashed and sent
+    FlushDestroyQueue(GetEntityTable(), RemoveGameObject, gameData);
+
+    // Hash the resulting world state so runs (and lockstep peers) can be compared for divergence
+    uint32_t worldHash = 0;
+    if (IsHashingState(gameData))
+    {
+        // Log where the peers part from now on, so comparing the logs names the entity
+        if (gameData->lockstep.desynced)
+        {
+            gameData->stateHasher.logEntities = true;
         }
+
+        worldHash = StateHashTick(&gameData->stateHasher, gameData->tick);
+    }
+
+    if (gameData->lockstep.active)
+    {
+        LockstepAdvance(&gameData->lockstep, worldHash);
     }
+
+    // Send the authoritative result of this tick to the clients
+    if (gameData->clientServer.role == NET_ROLE_HOST)
+    {
+        GameObject **objects = gameData->scratch.objects;
+        int count = GatherGameObjects(gameData, objects, gameData->objectCapacity);
+        HostBroadcastSnapshot(&gameData->clientServer, gameData->tick, objects, count, gameData->playerCount);
+
+        // Keep the colliders the clients are about to see, for rewinding their hits later
+        RecordColliderHistory(&gameData->colliderHistory, gameData->tick, objects, count);
+    }
+
+    gameData->tick++;
 }
 
 /**
- * DrawGame - Draws the game elements to the screen (player, NPC, health bar, etc.).
+ * GatherGameObjects - Collects pointers to every game object in the world.
  *
- * This function handles drawing the player, NPC, health bars, and other UI
- * elements like the game title. It also handles rendering the player’s animation.
+ * @gameData:   A pointer to the GameData structure containing the game state.
+ * @objects:    Output array receiving the game object pointers.
+ * @maxObjects: Capacity of the output array.
  *
- * @gameData: A pointer to the GameData structure containing the game state.
+ * The order is stable between runs (players first, then NPCs) so systems such
+ * as state hashing can identify entities by their index.
+ *
+ * Return: The number of game objects written to @objects.
  */
-void DrawGame(GameData *gameData)
+int GatherGameObjects(GameData *gameData, GameObject **objects, int maxObjects)
 {
-    DrawText("Raylib Animated FSM Starter Kit!", 190, 180, 20, DARKBLUE);
+    int count = 0;
+
+    for (int i = 0; i < gameData->playerCount && count < maxObjects; i++)
+    {
+        objects[count++] = &gameData->players[i]->base;
+    }
+
+    for (int i = 0; i < gameData->npcCount && count < maxObjects; i++)
+    {
+        objects[count++] = &gameData->npcs[i]->base;
+    }
 
-    // Begin drawing to the screen
-    BeginDrawing();
+    return count;
+}
 
+/**
+ * DrawGame - Records the game elements of a frame (player, NPC, health bar, etc.).
+ *
+ * This function records drawing the player, NPC, health bars, and other UI
+ * elements like the game title. It also records the player’s animation. Nothing
+ * is drawn yet, the window's thread submits the list (see RenderQueue).
+ *
+ * Commands are recorded entity by entity, the draw order comes from their
+ * layer and y (SetDrawOrder): entities and walls are sorted by their feet so
+ * whoever is lower on screen covers whoever stands behind, health bars and
+ * labels go above every entity.
+ *
+ * @gameData: A pointer to the GameData structure containing the game state.
+ * @list:     The render list of this frame.
+ */
+void DrawGame(GameData *gameData, RenderList *list)
+{
     // Clear the screen with a white background
-    ClearBackground(DARKGREEN);
+    PushClear(list, DARKGREEN);
 
     // Draw some basic UI text (game title and description)
-    DrawText("Welcome to Raylib Animated FSM Starter", 190, 200, 20, LIGHTGRAY);
-    DrawText("Gameplay Programming I", 190, 220, 20, LIGHTGRAY);
+    PushText(list, "Welcome to Raylib Animated FSM Starter", 190, 200, 20, LIGHTGRAY);
+    PushText(list, "Gameplay Programming I", 190, 220, 20, LIGHTGRAY);
+
+    // Drawing Health Bar for the players and NPC
+    const int healthBarWidth = 100;
+    const int healthBarHeight = 10;
+
+    for (int i = 0; i < gameData->playerCount; i++)
+    {
+        Player *player = gameData->players[i];
+
+        // Drawing Player and Position Data
+        const char *infoPosition = TextFormat("(%.f, %.f)", player->base.position.x, player->base.position.y);
+
+        // Draw a circle representing the player at their position, and the player's animation over it
+        SetDrawOrder(list, RENDER_LAYER_WORLD, player->base.position.y);
+        PushCircleLines(list, player->base.position, 20, player->base.color);
+        RenderAnimation(list, &player->base.animation, player->base.position, WHITE);
+
+        if (player->attacking)
+        {
+            // Draw the attack area of the player
+            PushCircle(list, (Vector2){player->attackArea.p.x, player->attackArea.p.y}, player->attackArea.r, player->base.color);
+        }
+
+        // Draw text showing player position below the player
+        SetDrawOrder(list, RENDER_LAYER_OVERLAY, player->base.position.y);
+        PushTextCentered(list, infoPosition, player->base.position.x, player->base.position.y + 30, 20, DARKBLUE);
+
+        const int healthBarX = player->base.position.x - (healthBarWidth / 2); // Position health bar above the player
+        const int healthBarY = player->base.position.y - 40;
+
+        // Calculate health percentage (for drawing the health bar)
+        float healthPercentage = (float)player->base.health / 100;
+
+        // Draw the background of the health bar (gray)
+        PushRectangle(list, healthBarX, healthBarY, healthBarWidth, healthBarHeight, GRAY);
+
+        // Draw the health bar foreground (green based on current health)
+        PushRectangle(list, healthBarX, healthBarY, healthBarWidth * healthPercentage, healthBarHeight, GREEN);
+    }
+
+    // NPCs far from the local player are drawn with less detail (see DetailLevels)
+    Vector2 focus = DetailFocus(gameData);
+
+    for (int i = 0; i < gameData->npcCount; i++)
+    {
+        NPC *npc = gameData->npcs[i];
+        Color color = npc->base.asleep ? Fade(npc->base.color, 0.3f) : npc->base.color;
 
-    // Drawing Player and Position Data
-    const char *infoPosition = TextFormat("(%.f, %.f)", gameData->player->base.position.x, gameData->player->base.position.y);
+        SetDrawOrder(list, RENDER_LAYER_WORLD, npc->base.position.y);
 
-    // Draw a circle representing the player at their position
-    DrawCircleLines(gameData->player->base.position.x, gameData->player->base.position.y, 20, gameData->player->base.color);
+        if (GetDetailLevel(&gameData->detail, focus, npc->base.position) == DETAIL_IMPOSTOR)
+        {
+            // A dot of the NPC's colour, too far for the sprite to read
+            PushRectangle(list, npc->base.position.x - DETAIL_IMPOSTOR_SIZE / 2, npc->base.position.y - DETAIL_IMPOSTOR_SIZE / 2,
+                          DETAIL_IMPOSTOR_SIZE, DETAIL_IMPOSTOR_SIZE, color);
+        }
+        else
+        {
+            // Draw the NPC circle at their position, sleeping NPCs are drawn faded
+            PushCircle(list, npc->base.position, 20, color);
+            // Render the npc's animation at their current position
+            RenderAnimation(list, &npc->base.animation, npc->base.position, RAYWHITE);
+        }
+
+        // Health bar and position only close to the local player
+        if (!ShowsOverlay(&gameData->detail, focus, npc->base.position))
+        {
+            continue;
+        }
+
+        // Enemy health bar
+        SetDrawOrder(list, RENDER_LAYER_OVERLAY, npc->base.position.y);
+        const int healthBarXNPC = npc->base.position.x - (healthBarWidth / 2); // Position health bar above the player
+        const int healthBarYNPC = npc->base.position.y - 40;
+        // Calculate health percentage (for drawing the health bar)
+        float healthPercentageNPC = (float)npc->base.health / 100;
+        // Draw the background of the health bar (gray)
+        PushRectangle(list, healthBarXNPC, healthBarYNPC, healthBarWidth, healthBarHeight, GRAY);
+        // Draw the health bar foreground (green based on current health)
+        PushRectangle(list, healthBarXNPC, healthBarYNPC, healthBarWidth * healthPercentageNPC, healthBarHeight, GREEN);
+
+        // Draw text showing NPC position below the NPC
+        const char *infoPosition = TextFormat("(%.f, %.f)", npc->base.position.x, npc->base.position.y);
+        PushTextCentered(list, infoPosition, npc->base.position.x, npc->base.position.y + 30, 20, DARKBLUE);
+    }
+
+    // Every projectile in a single batch
+    SetDrawOrder(list, RENDER_LAYER_EFFECTS, 0.0f);
+    DrawProjectiles(list, GetProjectileSystem(), ORANGE);
+
+    // Walls
+    for (int tileY = 0; tileY < gameData->perception.height; tileY++)
+    {
+        for (int tileX = 0; tileX < gameData->perception.width; tileX++)
+        {
+            if (gameData->perception.blocked[tileY * gameData->perception.width + tileX])
+            {
+                SetDrawOrder(list, RENDER_LAYER_WORLD, (tileY + 1) * PERCEPTION_TILE);
+                PushRectangle(list, tileX * PERCEPTION_TILE, tileY * PERCEPTION_TILE, PERCEPTION_TILE, PERCEPTION_TILE, DARKGRAY);
+            }
+        }
+    }
 
-    if (gameData->player->attacking)
+#ifdef DEBUG
+    // Outline the trigger volumes
+    SetDrawOrder(list, RENDER_LAYER_EFFECTS, 0.0f);
+    for (int t = 0; t < gameData->triggers.count; t++)
     {
-        // Draw the attack area of the player
-        DrawCircle(gameData->player->attackArea.p.x, gameData->player->attackArea.p.y, gameData->player->attackArea.r, gameData->player->base.color);
+        const TriggerVolume *volume = &gameData->triggers.volumes[t];
+
+        if (volume->shape == TRIGGER_SHAPE_BOX)
+        {
+            PushRectangleLines(list, volume->box.min.x, volume->box.min.y,
+                               volume->box.max.x - volume->box.min.x, volume->box.max.y - volume->box.min.y, YELLOW);
+        }
+        else
+        {
+            PushCircleLines(list, (Vector2){volume->circle.p.x, volume->circle.p.y}, volume->circle.r, YELLOW);
+        }
     }
 
-    // Draw text showing player position below the player
-    DrawText(infoPosition,
-             gameData->player->base.position.x - (MeasureText(infoPosition, 20) / 2),
-             gameData->player->base.position.y + 30,
-             20, DARKBLUE);
+    SetDrawOrder(list, RENDER_LAYER_HUD, 0.0f);
+    PushText(list, TextFormat("Awake NPCs: %d / %d", GetSleepSystem()->activeCount, gameData->npcCount), 10, 575, 20, LIGHTGRAY);
+    PushText(list, TextFormat("Projectiles: %d", GetProjectileSystem()->count), 10, 550, 20, LIGHTGRAY);
+    PushText(list, TextFormat("Squads: %d", gameData->squads.count), 10, 525, 20, LIGHTGRAY);
 
-    // Drawing Health Bar for the player
-    const int healthBarWidth = 100;
-    const int healthBarHeight = 10;
-    const int healthBarX = gameData->player->base.position.x - (healthBarWidth / 2); // Position health bar above the player
-    const int healthBarY = gameData->player->base.position.y - 40;
-
-    // Calculate health percentage (for drawing the health bar)
-    float healthPercentage = (float)gameData->player->base.health / 100;
-
-    // Draw the background of the health bar (gray)
-    DrawRectangle(healthBarX, healthBarY, healthBarWidth, healthBarHeight, GRAY);
-
-    // Draw the health bar foreground (green based on current health)
-    DrawRectangle(healthBarX, healthBarY, healthBarWidth * healthPercentage, healthBarHeight, GREEN);
-
-    // Enemy health bar
-    const int healthBarXNPC = gameData->npc->base.position.x - (healthBarWidth / 2); // Position health bar above the player
-    const int healthBarYNPC = gameData->npc->base.position.y - 40;
-    // Calculate health percentage (for drawing the health bar)
-    float healthPercentageNPC = (float)gameData->npc->base.health / 100;
-    // Draw the background of the health bar (gray)
-    DrawRectangle(healthBarXNPC, healthBarYNPC, healthBarWidth, healthBarHeight, GRAY);
-    // Draw the health bar foreground (green based on current health)
-    DrawRectangle(healthBarXNPC, healthBarYNPC, healthBarWidth * healthPercentageNPC, healthBarHeight, GREEN);
-
-    // Drawing NPC and Position Data
-    infoPosition = TextFormat("(%.f, %.f)", gameData->npc->base.position.x, gameData->npc->base.position.y);
-
-    // Draw the NPC circle at their position
-    DrawCircle(gameData->npc->base.position.x, gameData->npc->base.position.y, 20, gameData->npc->base.color);
-    // Render the npc's animation at their current position
-    RenderAnimation(&gameData->npc->base.animation, gameData->npc->base.position, RAYWHITE);
-
-    // Draw text showing NPC position below the NPC
-    DrawText(infoPosition,
-             gameData->npc->base.position.x - (MeasureText(infoPosition, 20) / 2),
-             gameData->npc->base.position.y + 30,
-             20, DARKBLUE);
-
-    // Render the player's animation at their current position
-    RenderAnimation(&gameData->player->base.animation, gameData->player->base.position, WHITE);
-
-    // End drawing to the screen
-    EndDrawing();
+    // Where a frame goes: simulating and recording it, then submitting the previous one
+    RenderStats renderStats = GetRenderStats(GetRenderQueue());
+    PushText(list, TextFormat("Sim %.2f ms  Submit %.2f ms  Commands %d", renderStats.simulateTime * 1000.0,
+                              renderStats.submitTime * 1000.0, renderStats.commandCount),
+             10, 500, 20, LIGHTGRAY);
+
+    // How far the draw order moved since the last frame
+    PushText(list, renderStats.sortRadix ? "Sort: radix" : TextFormat("Sort: %d moves", renderStats.sortMoves),
+             10, 475, 20, LIGHTGRAY);
+
+    // NPCs at each level of detail and where the levels start
+    const DetailLevels *detail = &gameData->detail;
+    PushText(list, TextFormat("LOD full %d  reduced %d  static %d  dots %d", detail->counts[DETAIL_FULL],
+                              detail->counts[DETAIL_REDUCED], detail->counts[DETAIL_STATIC], detail->counts[DETAIL_IMPOSTOR]),
+             10, 450, 20, LIGHTGRAY);
+    PushText(list, TextFormat("LOD at %.0f / %.0f / %.0f px, bars within %.0f px", detail->reducedDistance,
+                              detail->staticDistance, detail->impostorDistance, detail->overlayDistance),
+             10, 425, 20, LIGHTGRAY);
+
+    // The level boundaries around the local player
+    SetDrawOrder(list, RENDER_LAYER_EFFECTS, 0.0f);
+    PushCircleLines(list, focus, detail->reducedDistance, Fade(SKYBLUE, 0.5f));
+    PushCircleLines(list, focus, detail->staticDistance, Fade(BLUE, 0.5f));
+    PushCircleLines(list, focus, detail->impostorDistance, Fade(DARKBLUE, 0.5f));
+#endif
+
+    SetDrawOrder(list, RENDER_LAYER_HUD, 0.0f);
+    if (gameData->lockstep.active)
+    {
+        // Lockstep status, a desync means the peers' simulations have diverged
+        PushText(list, TextFormat("Lockstep peer %d/%d tick %u", gameData->lockstep.localPeer + 1,
+                                  gameData->lockstep.peerCount, gameData->lockstep.currentTick),
+                 10, 10, 20, LIGHTGRAY);
+
+        if (gameData->lockstep.desynced)
+        {
+            PushText(list, TextFormat("DESYNC at tick %u", gameData->lockstep.desyncTick), 10, 35, 20, RED);
+        }
+        else if (gameData->lockstep.stallFrames > 0)
+        {
+            PushText(list, "Waiting for peers...", 10, 35, 20, YELLOW);
+        }
+    }
+    else if (gameData->clientServer.role == NET_ROLE_HOST)
+    {
+        PushText(list, TextFormat("Hosting tick %u", gameData->tick), 10, 10, 20, LIGHTGRAY);
+    }
+    else if (gameData->clientServer.role == NET_ROLE_CLIENT)
+    {
+        ClientServerSession *session = &gameData->clientServer;
+
+        if (session->localPlayer < 0)
+        {
+            PushText(list, "Connecting to host...", 10, 10, 20, YELLOW);
+        }
+        else
+        {
+            // Render tick trails the newest snapshot by the interpolation delay
+            PushText(list, TextFormat("Client player %d render tick %.1f (newest %u)", session->localPlayer + 1,
+                                      session->renderTick, session->newestTick),
+                     10, 10, 20, LIGHTGRAY);
+        }
+    }
 }
 
 /**
@@ -227,13 +1481,39 @@ void CloseGame(GameData *gameData)
 {
     printf("Game Closed!\n");
 
+    if (gameData != NULL)
+    {
+        ReleaseSound(GetAssetCache(), gameData->secretSound);
+    }
+
     CloseAudioDevice();     // Close audio device
 
+    // Flush the state hash log and leave any network session
+    if (gameData != NULL)
+    {
+        CloseStateHasher(&gameData->stateHasher);
+        CloseLockstep(&gameData->lockstep);
+        CloseClientServer(&gameData->clientServer);
+        FreeColliderHistory(&gameData->colliderHistory);
+        FreeCombatQueue(&gameData->combat);
+        FreeTriggerVolumes(&gameData->triggers);
+        FreePerception(&gameData->perception);
+        FreeInfluenceMap(&gameData->influence);
+        FreeSquadSystem(&gameData->squads);
+        FreeSpatialGrid(&gameData->targeting);
+        FreeScriptSystem(GetScriptSystem());
+    }
+
     // If the game data is not null, delete all objects associated with the game
     if (gameData != NULL)
     {
         DeleteGameData(gameData);
     }
+
+    FreeTimerWheel(GetTimerService());
+    FreeEntityTable(GetEntityTable());
+    FreeProjectileSystem(GetProjectileSystem());
+    FreeStatusEffects(GetStatusEffects());
 }
 
 /**
@@ -249,19 +1529,37 @@ void DeleteGameData(GameData *gameData)
     if (gameData != NULL)
     {
         // Delete the player and NPC objects if they are not null
-        if (gameData->player != NULL)
+        for (int i = 0; i < gameData->playerCount; i++)
         {
-            DeletePlayer(&gameData->player->base);
-        }
+            if (gameData->players[i] != NULL)
+            {
+                DeletePlayer(&gameData->players[i]->base);
+            }
 
-        if (gameData->npc != NULL)
-        {
-            DeleteNPC(&gameData->npc->base);
+            if (gameData->mediators[i] != NULL)
+            {
+                DeleteMediator(gameData->mediators[i]);
+            }
         }
 
-        if (gameData->mediator != NULL)
-        {
-            DeleteMediator(gameData->mediator);
-        }
+        // NPCs live in the pool, the prefab's archetype owns what they share
+        FreePrefabPool(&gameData->npcPool);
+        FreePrefab(&gameData->npcPrefab);
+
+        FreeSleepSystem(GetSleepSystem());
+
+        GameScratch *scratch = &gameData->scratch;
+        free(gameData->npcs);
+        free(scratch->objects);
+        free(scratch->awake);
+        free(scratch->agents);
+        free(scratch->agentObjects);
+        free(scratch->queries);
+        free(scratch->candidates);
+        free(scratch->candidateCounts);
+        free(scratch->leaders);
+        free(scratch->targets);
+        memset(scratch, 0, sizeof(GameScratch));
+        gameData->npcs = NULL;
     }
 }
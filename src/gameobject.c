@@ -1,5 +1,8 @@
 #include "../include/gameobjects/gameobject.h"
 #include "../include/utils/constants.h"
+#include "../include/utils/timer_wheel.h"
+#include "../include/utils/status_effects.h"
+#include "../include/utils/script_system.h"
 
 // Specific define for CUTE_HEADERS, enabling implementation of functions
 #define CUTE_C2_IMPLEMENTATION
@@ -59,11 +62,28 @@ void InitGameObject(GameObject *obj,
     obj->currentState = currentState;
     obj->previousState = STATE_COUNT; // So that at initial load idle animation is loaded
 
+    // Only the locomotion layer until InitFsmLayer adds more
+    for (int l = 0; l < FSM_LAYER_COUNT - 1; l++)
+    {
+        obj->layers[l] = (FsmLayerState){STATE_IDLE, STATE_IDLE, NULL};
+    }
+
     obj->color = color;
     obj->collider = collider;
     obj->bounds = bounds;
     obj->keyframes = keyframes;
     obj->health = health;
+
+    obj->asleep = false;
+    obj->quietTicks = 0;
+    obj->sleepSlot = -1;
+
+    // Not part of a world yet and unaffected by status effects, NPCs pick their faction
+    obj->entity = -1;
+    obj->handle = (EntityHandle){0, 0};
+    obj->faction = FACTION_PLAYERS;
+    obj->speedScale = 1.0f;
+    obj->damageScale = 1.0f;
 }
 
 /**
@@ -85,6 +105,47 @@ void InitGameObjectAnimation(GameObject *obj, Rectangle *frames, int frameCount,
     obj->animation = animation;
 }
 
+/**
+ * InitGameObjectSharedAnimation - Plays a clip without copying its frames.
+ *
+ * @obj:        The GameObject to play the clip on.
+ * @frames:     The clip's frames, which must outlive every object playing them.
+ * @frameCount: The total number of frames in the clip.
+ * @speed:      The frame duration in seconds.
+ *
+ * State entries that run again and again use this, so entering a state never
+ * allocates and the frames of the previous clip need no freeing.
+ */
+void InitGameObjectSharedAnimation(GameObject *obj, Rectangle *frames, int frameCount, float speed)
+{
+    InitSharedAnimation(&obj->animation, obj->keyframes, frames, frameCount, speed, true);
+}
+
+/**
+ * SetGameObjectPosition - Places a GameObject at a new position.
+ *
+ * @obj:      The GameObject to move.
+ * @position: The new position in world coordinates.
+ *
+ * The circle collider is centred on the new position and the bounding box is
+ * translated by the same offset so collision data never lags behind the object.
+ */
+void SetGameObjectPosition(GameObject *obj, Vector2 position)
+{
+    float offsetX = position.x - obj->position.x;
+    float offsetY = position.y - obj->position.y;
+
+    obj->position = position;
+
+    obj->collider.p.x = position.x;
+    obj->collider.p.y = position.y;
+
+    obj->bounds.min.x += offsetX;
+    obj->bounds.min.y += offsetY;
+    obj->bounds.max.x += offsetX;
+    obj->bounds.max.y += offsetY;
+}
+
 /**
  * CheckCollision - Checks for a collision between the player and an NPC.
  *
@@ -124,20 +185,17 @@ bool CheckCollision(GameObject *lhs, GameObject *rhs)
  * HandleCollision - Responds to a detected collision between the player and an NPC.
  *
  * @player: A pointer to the Player structure, representing the player character
- *          in the game. This function modifies the player’s health and position.
+ *          in the game. This function modifies the player’s position.
  * @npc:    A pointer to the NPC structure, representing the non-player character.
  *          This function modifies the NPC's appearance to show collision feedback.
  *
- * This function applies the effects of a collision on the player and NPC.
- * It reduces the player's health by a specified amount and changes the NPC's color
- * to visually indicate the collision. Additionally, the player is pushed back slightly
- * by a vector calculated along the direction from the NPC to the player.
+ * This function applies the physical effects of a collision on the player and NPC.
+ * It changes the NPC's color to visually indicate the collision and pushes the
+ * player back slightly along the direction from the NPC to the player. The contact
+ * damage is queued by the caller and applied by the combat pass (see ResolveCombat).
  */
 void HandleCollision(GameObject *lhs, GameObject *rhs)
 {
-    // Decrease the player's health as a result of the collision
-    lhs->health -= 5; // Example amount
-
     // Change NPC color to visually indicate a collision has occurred
     rhs->color = RED;
 
@@ -152,6 +210,22 @@ void HandleCollision(GameObject *lhs, GameObject *rhs)
 }
 
 
+/**
+ * ReleaseGameObject - Detaches a GameObject from the shared services.
+ *
+ * Pending timers must never deliver to a released object, nor effects or
+ * scripts point at it. Nothing is freed, so this is all objects living in
+ * pooled storage (see PrefabPool) need before their storage goes away.
+ *
+ * @obj: A pointer to the GameObject to release.
+ */
+void ReleaseGameObject(GameObject *obj)
+{
+    CancelTimersFor(GetTimerService(), obj);
+    ClearStatusEffects(GetStatusEffects(), obj);
+    StopScript(GetScriptSystem(), obj);
+}
+
 /**
  * DeleteGameObject - Frees all dynamically allocated memory associated with a GameObject.
  *
@@ -165,6 +239,9 @@ void DeleteGameObject(GameObject *obj)
     if (obj == NULL)
         return;
 
+    ReleaseGameObject(obj);
+    FreeFsmLayers(obj);
+
     // Check if state configurations exist for this GameObject
     if (obj->stateConfigs)
     {
@@ -183,7 +260,6 @@ void DeleteGameObject(GameObject *obj)
         obj->stateConfigs = NULL; // Nullify after freeing
     }
 
-    // Free the GameObject
+    // Free the GameObject, anything that may outlive it holds its handle (see ResolveEntity)
     free(obj);
-    obj = NULL; // Nullify
 }
@@ -0,0 +1,252 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/utils/influence_map.h"
+
+// Share of a cell's influence that reaches its neighbours per step, per layer
+static const float INFLUENCE_DECAY[INFLUENCE_LAYER_COUNT] = {0.6f, 0.4f, 0.85f};
+
+// How quickly cells move toward their new value per step (0..1), smooths jitter
+static const float INFLUENCE_MOMENTUM = 0.25f;
+
+// Weights used to score a cell when flanking
+static const float FLANK_THREAT_WEIGHT = 0.5f;
+static const float FLANK_ALLY_WEIGHT = 0.75f;
+
+// Neighbouring cells, 8 way
+static const int NEIGHBOUR_X[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+static const int NEIGHBOUR_Y[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+// Padded index of the cell containing a world position, -1 outside the map
+static int CellIndex(const InfluenceMap *map, Vector2 position)
+{
+    int cellX = (int)floorf(position.x / INFLUENCE_CELL);
+    int cellY = (int)floorf(position.y / INFLUENCE_CELL);
+
+    if (cellX < 0 || cellY < 0 || cellX >= map->width || cellY >= map->height)
+    {
+        return -1;
+    }
+
+    return (cellY + 1) * map->stride + (cellX + 1);
+}
+
+/**
+ * InitInfluenceMap - Allocates empty influence layers.
+ *
+ * @map:         The influence map to initialise.
+ * @widthTiles:  Width of the level in perception tiles.
+ * @heightTiles: Height of the level in perception tiles.
+ */
+void InitInfluenceMap(InfluenceMap *map, int widthTiles, int heightTiles)
+{
+    memset(map, 0, sizeof(InfluenceMap));
+
+    map->width = (widthTiles + INFLUENCE_TILES_PER_CELL - 1) / INFLUENCE_TILES_PER_CELL;
+    map->height = (heightTiles + INFLUENCE_TILES_PER_CELL - 1) / INFLUENCE_TILES_PER_CELL;
+    map->stride = map->width + 2;
+
+    size_t cells = (size_t)map->stride * (map->height + 2);
+
+    for (int layer = 0; layer < INFLUENCE_LAYER_COUNT; layer++)
+    {
+        map->values[layer] = (float *)calloc(cells, sizeof(float));
+        map->next[layer] = (float *)calloc(cells, sizeof(float));
+        map->sources[layer] = (float *)calloc(cells, sizeof(float));
+
+        if (!map->values[layer] || !map->next[layer] || !map->sources[layer])
+        {
+            fprintf(stderr, "Failed to allocate influence map\n");
+            exit(1);
+        }
+    }
+}
+
+/**
+ * DepositInfluence - Adds influence at a position for this tick.
+ *
+ * @map:      The influence map.
+ * @layer:    The layer to add to.
+ * @position: World position of the source.
+ * @amount:   Strength of the source, deposits in the same cell add up.
+ */
+void DepositInfluence(InfluenceMap *map, InfluenceLayer layer, Vector2 position, float amount)
+{
+    int cell = CellIndex(map, position);
+
+    if (cell >= 0)
+    {
+        map->sources[layer][cell] += amount;
+    }
+}
+
+// One propagation step of a padded row, written so the compiler can vectorise it
+static void PropagateRow(float *restrict out, const float *restrict row, const float *restrict up,
+                         const float *restrict down, const float *restrict source, int width, float decay)
+{
+    for (int x = 1; x <= width; x++)
+    {
+        float left = row[x - 1];
+        float right = row[x + 1];
+        float horizontal = left > right ? left : right;
+        float vertical = up[x] > down[x] ? up[x] : down[x];
+        float neighbour = (horizontal > vertical ? horizontal : vertical) * decay;
+        float target = source[x] > neighbour ? source[x] : neighbour;
+
+        out[x] = row[x] + (target - row[x]) * INFLUENCE_MOMENTUM;
+    }
+}
+
+/**
+ * UpdateInfluenceMap - Advances every layer by one step.
+ *
+ * @map: The influence map.
+ *
+ * Each cell moves a little toward the larger of its own deposits and the
+ * strongest neighbour scaled by the layer's decay, so influence spreads out
+ * from its sources over a few ticks and fades once they leave. The work is a
+ * fixed pass over a small grid no matter how many entities deposited.
+ */
+void UpdateInfluenceMap(InfluenceMap *map)
+{
+    size_t cells = (size_t)map->stride * (map->height + 2);
+
+    for (int layer = 0; layer < INFLUENCE_LAYER_COUNT; layer++)
+    {
+        float *values = map->values[layer];
+        float *next = map->next[layer];
+        float *sources = map->sources[layer];
+
+        for (int y = 1; y <= map->height; y++)
+        {
+            PropagateRow(next + y * map->stride, values + y * map->stride,
+                         values + (y - 1) * map->stride, values + (y + 1) * map->stride,
+                         sources + y * map->stride, map->width, INFLUENCE_DECAY[layer]);
+        }
+
+        // The border of next stays zero, it was never written
+        map->values[layer] = next;
+        map->next[layer] = values;
+
+        memset(sources, 0, sizeof(float) * cells);
+    }
+}
+
+/**
+ * SampleInfluence - Reads a layer at a world position.
+ *
+ * @map:      The influence map.
+ * @layer:    The layer to read.
+ * @position: World position.
+ *
+ * Return: The influence, 0 outside the map.
+ */
+float SampleInfluence(const InfluenceMap *map, InfluenceLayer layer, Vector2 position)
+{
+    int cell = CellIndex(map, position);
+    return cell >= 0 ? map->values[layer][cell] : 0.0f;
+}
+
+// Picks the neighbour (or the current cell) with the best score, returns its direction
+static Vector2 BestNeighbourDirection(const InfluenceMap *map, Vector2 position, bool flank)
+{
+    int cell = CellIndex(map, position);
+    if (cell < 0)
+    {
+        return (Vector2){0.0f, 0.0f};
+    }
+
+    const float *threat = map->values[INFLUENCE_THREAT];
+    const float *allies = map->values[INFLUENCE_ALLIES];
+    const float *proximity = map->values[INFLUENCE_PROXIMITY];
+
+    int best = -1;
+    float bestScore;
+
+    // Staying put is the option to beat, border cells are never chosen
+    if (flank)
+    {
+        bestScore = proximity[cell] - threat[cell] * FLANK_THREAT_WEIGHT - allies[cell] * FLANK_ALLY_WEIGHT;
+    }
+    else
+    {
+        bestScore = -threat[cell];
+    }
+
+    int cellX = cell % map->stride;
+    int cellY = cell / map->stride;
+
+    for (int n = 0; n < 8; n++)
+    {
+        int x = cellX + NEIGHBOUR_X[n];
+        int y = cellY + NEIGHBOUR_Y[n];
+
+        if (x < 1 || y < 1 || x > map->width || y > map->height)
+        {
+            continue;
+        }
+
+        int neighbour = y * map->stride + x;
+        float score = flank ? proximity[neighbour] - threat[neighbour] * FLANK_THREAT_WEIGHT - allies[neighbour] * FLANK_ALLY_WEIGHT
+                            : -threat[neighbour];
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = n;
+        }
+    }
+
+    if (best < 0)
+    {
+        return (Vector2){0.0f, 0.0f};
+    }
+
+    return Vector2Normalize((Vector2){(float)NEIGHBOUR_X[best], (float)NEIGHBOUR_Y[best]});
+}
+
+/**
+ * InfluenceFlankDirection - Chooses where to go to close in on the players
+ * without walking into threat or bunching up with other NPCs.
+ *
+ * @map:      The influence map.
+ * @position: World position of the NPC.
+ *
+ * Return: Unit direction toward the best neighbouring cell, or zero.
+ */
+Vector2 InfluenceFlankDirection(const InfluenceMap *map, Vector2 position)
+{
+    return BestNeighbourDirection(map, position, true);
+}
+
+/**
+ * InfluenceRetreatDirection - Chooses where to go to get away from threat.
+ *
+ * @map:      The influence map.
+ * @position: World position of the NPC.
+ *
+ * Return: Unit direction toward the least threatened neighbouring cell, or zero.
+ */
+Vector2 InfluenceRetreatDirection(const InfluenceMap *map, Vector2 position)
+{
+    return BestNeighbourDirection(map, position, false);
+}
+
+/**
+ * FreeInfluenceMap - Frees the influence layers.
+ *
+ * @map: The influence map to free.
+ */
+void FreeInfluenceMap(InfluenceMap *map)
+{
+    for (int layer = 0; layer < INFLUENCE_LAYER_COUNT; layer++)
+    {
+        free(map->values[layer]);
+        free(map->next[layer]);
+        free(map->sources[layer]);
+    }
+
+    memset(map, 0, sizeof(InfluenceMap));
+}
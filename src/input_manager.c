@@ -29,11 +29,16 @@ void InitInputManager()
  * If no gamepad input is detected, it checks the keyboard for key presses and
  * returns corresponding commands.
  *
- * Returns the appropriate command (from an enumerated Command type) based on
- * detected input, or COMMAND_NONE if no relevant input is detected.
+ * Movement and actions are read separately, so holding a direction and the
+ * attack button gives both a move and an attack.
+ *
+ * Returns the movement and action commands (from an enumerated Command type)
+ * based on detected input, each COMMAND_NONE if no relevant input is detected.
  */
-Command PollInput()
+PlayerInput PollInput()
 {
+    PlayerInput input = {COMMAND_NONE, COMMAND_NONE};
+
     // Check for gamepad input first
     if (IsGamepadAvailable(0))
     {
@@ -51,65 +56,104 @@ Command PollInput()
                               IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_FACE_LEFT) ||
                               IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_FACE_RIGHT));
 
-        // If the gamepad is active, determine specific command based on input
+        // If the gamepad is active, determine specific commands based on input
         if (gamepadActive)
         {
             // Check D-pad directional buttons for movement commands
             if (IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_FACE_UP))
-                return COMMAND_MOVE_UP;
-            if (IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_FACE_DOWN))
-                return COMMAND_MOVE_DOWN;
-            if (IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_FACE_LEFT))
-                return COMMAND_MOVE_LEFT;
-            if (IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_FACE_RIGHT))
-                return COMMAND_MOVE_RIGHT;
-
-            // Check thumbstick for directional input, prioritising vertical movement
-            if (fabs(leftStickY) > fabs(leftStickX))
+                input.move = COMMAND_MOVE_UP;
+            else if (IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_FACE_DOWN))
+                input.move = COMMAND_MOVE_DOWN;
+            else if (IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_FACE_LEFT))
+                input.move = COMMAND_MOVE_LEFT;
+            else if (IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_FACE_RIGHT))
+                input.move = COMMAND_MOVE_RIGHT;
+
+            // Otherwise the thumbstick, prioritising vertical movement
+            else if (fabs(leftStickY) > fabs(leftStickX))
             {
                 if (leftStickY < -MOVE_VERTICAL_THRESHOLD)
-                    return COMMAND_MOVE_UP;
-                if (leftStickY > MOVE_VERTICAL_THRESHOLD)
-                    return COMMAND_MOVE_DOWN;
+                    input.move = COMMAND_MOVE_UP;
+                else if (leftStickY > MOVE_VERTICAL_THRESHOLD)
+                    input.move = COMMAND_MOVE_DOWN;
             }
             else
             {
                 if (leftStickX < -MOVE_HORIZONTAL_THRESHOLD)
-                    return COMMAND_MOVE_LEFT;
-                if (leftStickX > MOVE_HORIZONTAL_THRESHOLD)
-                    return COMMAND_MOVE_RIGHT;
+                    input.move = COMMAND_MOVE_LEFT;
+                else if (leftStickX > MOVE_HORIZONTAL_THRESHOLD)
+                    input.move = COMMAND_MOVE_RIGHT;
             }
 
-            // Check right trigger for firing command
+            // Check right trigger for firing command, whether moving or not
             if (rightTrigger > FIRING_TRIGGER_TRESHOLD)
-                return COMMAND_ATTACK;
+                input.action = COMMAND_ATTACK;
 
-            // No specific gamepad input detected, return no command
-            return COMMAND_NONE;
+            return input;
         }
     }
 
-
-    
     if (IsKeyPressed(KEY_W) || IsKeyDown(KEY_W))
-        return COMMAND_MOVE_UP;
-    if (IsKeyPressed(KEY_S) || IsKeyDown(KEY_S))
-        return COMMAND_MOVE_DOWN;
-    if (IsKeyPressed(KEY_A) || IsKeyDown(KEY_A))
-        return COMMAND_MOVE_LEFT;
-    if (IsKeyPressed(KEY_D) || IsKeyDown(KEY_D))
-        return COMMAND_MOVE_RIGHT;
+        input.move = COMMAND_MOVE_UP;
+    else if (IsKeyPressed(KEY_S) || IsKeyDown(KEY_S))
+        input.move = COMMAND_MOVE_DOWN;
+    else if (IsKeyPressed(KEY_A) || IsKeyDown(KEY_A))
+        input.move = COMMAND_MOVE_LEFT;
+    else if (IsKeyPressed(KEY_D) || IsKeyDown(KEY_D))
+        input.move = COMMAND_MOVE_RIGHT;
+
     if (IsKeyPressed(KEY_F) || IsKeyDown(KEY_F))
-        return COMMAND_ROLL;
-    if (IsKeyPressed(KEY_SPACE) || IsKeyDown(KEY_SPACE))
-        return COMMAND_ATTACK;
-    if (IsKeyPressed(KEY_I))
-        return COMMAND_COLLISION_START;
-    if (IsKeyPressed(KEY_O))
-        return COMMAND_COLLISION_END;
-
-    // No input detected, return no command
-    return COMMAND_NONE;
+        input.action = COMMAND_ROLL;
+    else if (IsKeyPressed(KEY_SPACE) || IsKeyDown(KEY_SPACE))
+        input.action = COMMAND_ATTACK;
+    else if (IsKeyPressed(KEY_I))
+        input.action = COMMAND_COLLISION_START;
+    else if (IsKeyPressed(KEY_O))
+        input.action = COMMAND_COLLISION_END;
+
+    return input;
+}
+
+// Input of the tick being simulated, handed over by SetFrameInput
+static InputFrame frameInput;
+
+/**
+ * SampleInput - Samples the input of a frame.
+ *
+ * raylib updates the keyboard and gamepad state when a frame ends, on the
+ * window's thread, so the input is sampled there and handed to the
+ * simulation rather than polled by it.
+ *
+ * Return: The gameplay commands and the menu keys pressed this frame.
+ */
+InputFrame SampleInput(void)
+{
+    InputFrame input;
+    input.commands = PollInput();
+    input.confirm = IsKeyPressed(KEY_ENTER);
+    input.cycle = IsKeyPressed(KEY_TAB);
+    input.frameTime = GetFrameTime();
+    return input;
+}
+
+/**
+ * SetFrameInput - Hands the simulation the input of its next tick.
+ *
+ * @input: The input sampled since the previous tick.
+ */
+void SetFrameInput(InputFrame input)
+{
+    frameInput = input;
+}
+
+/**
+ * GetFrameInput - Returns the input of the tick being simulated.
+ *
+ * Return: The input, read by the simulation instead of polling raylib.
+ */
+const InputFrame *GetFrameInput(void)
+{
+    return &frameInput;
 }
 
 /**
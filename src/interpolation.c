@@ -0,0 +1,145 @@
+#include <string.h>
+
+#include "../include/network/interpolation.h"
+
+// Index of the i-th newest snapshot (0 = newest)
+static int SnapshotIndex(const InterpolationBuffer *buffer, int age)
+{
+    return (buffer->newest - age) & (INTERPOLATION_SNAPSHOTS - 1);
+}
+
+/**
+ * ClearInterpolationBuffer - Drops all snapshots from a buffer.
+ *
+ * @buffer: The interpolation buffer to clear.
+ */
+void ClearInterpolationBuffer(InterpolationBuffer *buffer)
+{
+    memset(buffer, 0, sizeof(InterpolationBuffer));
+}
+
+/**
+ * PushSnapshot - Adds a newly received snapshot to the buffer.
+ *
+ * @buffer:   The interpolation buffer of the entity.
+ * @snapshot: The received snapshot.
+ *
+ * Snapshots travel over UDP and can arrive late or twice, anything not newer
+ * than the newest snapshot already held is ignored so the buffer stays ordered.
+ * A snapshot of another entity than the newest one held means the host moved
+ * a different entity into this index, the old snapshots are dropped so it is
+ * not interpolated from where the previous one stood.
+ */
+void PushSnapshot(InterpolationBuffer *buffer, const EntitySnapshot *snapshot)
+{
+    if (buffer->count > 0 && snapshot->tick <= buffer->snapshots[buffer->newest].tick)
+    {
+        return;
+    }
+
+    const EntityHandle *newest = &buffer->snapshots[buffer->newest].handle;
+    if (buffer->count > 0 && (newest->index != snapshot->handle.index || newest->generation != snapshot->handle.generation))
+    {
+        ClearInterpolationBuffer(buffer);
+    }
+
+    buffer->newest = (buffer->newest + 1) & (INTERPOLATION_SNAPSHOTS - 1);
+    buffer->snapshots[buffer->newest] = *snapshot;
+
+    if (buffer->count < INTERPOLATION_SNAPSHOTS)
+    {
+        buffer->count++;
+    }
+}
+
+/**
+ * NewestSnapshotTick - Returns the tick of the newest snapshot in the buffer.
+ */
+uint32_t NewestSnapshotTick(const InterpolationBuffer *buffer)
+{
+    return buffer->count > 0 ? buffer->snapshots[buffer->newest].tick : 0;
+}
+
+// Copies the discrete (non interpolated) fields of a snapshot into a sample
+static void SampleDiscrete(const EntitySnapshot *snapshot, InterpolatedSample *sample)
+{
+    sample->velocity = snapshot->velocity;
+    sample->state = snapshot->state;
+    sample->actionState = snapshot->actionState;
+    sample->health = snapshot->health;
+}
+
+/**
+ * SampleInterpolation - Samples a remote entity at a render tick.
+ *
+ * @buffer:           The interpolation buffer of the entity.
+ * @renderTick:       Fractional server tick to render, normally the newest
+ *                    received tick minus the interpolation delay.
+ * @maxExtrapolation: Maximum ticks to extrapolate past the newest snapshot.
+ * @sample:           Receives the sampled position, state and health.
+ *
+ * When the render tick lies between two snapshots the position is linearly
+ * interpolated. When it lies past the newest snapshot (snapshots late or lost)
+ * the position is extrapolated with the velocity of the last two snapshots, for
+ * at most maxExtrapolation ticks, after which it holds. Discrete fields such as
+ * the FSM state are never blended, they come from the older snapshot.
+ *
+ * Return: false if the buffer holds no snapshots.
+ */
+bool SampleInterpolation(const InterpolationBuffer *buffer, float renderTick, float maxExtrapolation, InterpolatedSample *sample)
+{
+    if (buffer->count == 0)
+    {
+        return false;
+    }
+
+    const EntitySnapshot *newest = &buffer->snapshots[buffer->newest];
+    sample->extrapolated = false;
+
+    // Past the newest snapshot: extrapolate
+    if (renderTick >= (float)newest->tick)
+    {
+        SampleDiscrete(newest, sample);
+        sample->position = newest->position;
+
+        if (buffer->count >= 2 && renderTick > (float)newest->tick)
+        {
+            const EntitySnapshot *previous = &buffer->snapshots[SnapshotIndex(buffer, 1)];
+            float span = (float)(newest->tick - previous->tick);
+            float ahead = renderTick - (float)newest->tick;
+
+            if (ahead > maxExtrapolation)
+            {
+                ahead = maxExtrapolation;
+            }
+
+            sample->position.x += (newest->position.x - previous->position.x) / span * ahead;
+            sample->position.y += (newest->position.y - previous->position.y) / span * ahead;
+            sample->extrapolated = true;
+        }
+        return true;
+    }
+
+    // Walk back from the newest to find the pair bracketing the render tick
+    for (int age = 1; age < buffer->count; age++)
+    {
+        const EntitySnapshot *from = &buffer->snapshots[SnapshotIndex(buffer, age)];
+        const EntitySnapshot *to = &buffer->snapshots[SnapshotIndex(buffer, age - 1)];
+
+        if (renderTick >= (float)from->tick)
+        {
+            float t = (renderTick - (float)from->tick) / (float)(to->tick - from->tick);
+
+            sample->position.x = from->position.x + (to->position.x - from->position.x) * t;
+            sample->position.y = from->position.y + (to->position.y - from->position.y) * t;
+            SampleDiscrete(from, sample);
+            return true;
+        }
+    }
+
+    // Older than anything held, use the oldest snapshot
+    const EntitySnapshot *oldest = &buffer->snapshots[SnapshotIndex(buffer, buffer->count - 1)];
+    sample->position = oldest->position;
+    SampleDiscrete(oldest, sample);
+    return true;
+}
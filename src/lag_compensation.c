@@ -0,0 +1,179 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/network/lag_compensation.h"
+
+static int HistoryRow(uint32_t tick)
+{
+    return (int)(tick & (LAG_COMPENSATION_HISTORY - 1));
+}
+
+/**
+ * InitColliderHistory - Allocates the collider history ring.
+ *
+ * @history:     The history to initialise.
+ * @maxEntities: Most entities recorded per tick, extra entities are not rewound.
+ */
+void InitColliderHistory(ColliderHistory *history, int maxEntities)
+{
+    memset(history, 0, sizeof(ColliderHistory));
+
+    size_t values = (size_t)LAG_COMPENSATION_HISTORY * (size_t)maxEntities;
+    history->x = (float *)malloc(sizeof(float) * values);
+    history->y = (float *)malloc(sizeof(float) * values);
+    history->r = (float *)malloc(sizeof(float) * values);
+
+    if (!history->x || !history->y || !history->r)
+    {
+        fprintf(stderr, "Failed to allocate collider history\n");
+        exit(1);
+    }
+
+    history->maxEntities = maxEntities;
+}
+
+/**
+ * RecordColliderHistory - Stores the colliders of a tick in the history ring.
+ *
+ * @history: The collider history.
+ * @tick:    The simulation tick the colliders belong to.
+ * @objects: All game objects, in the order used by GatherGameObjects.
+ * @count:   Number of game objects.
+ *
+ * The oldest row is overwritten, so the ring always holds the last
+ * LAG_COMPENSATION_HISTORY ticks.
+ */
+void RecordColliderHistory(ColliderHistory *history, uint32_t tick, GameObject **objects, int count)
+{
+    int row = HistoryRow(tick);
+    size_t base = (size_t)row * (size_t)history->maxEntities;
+
+    if (count > history->maxEntities)
+    {
+        count = history->maxEntities;
+    }
+
+    float *x = history->x + base;
+    float *y = history->y + base;
+    float *r = history->r + base;
+
+    for (int i = 0; i < count; i++)
+    {
+        x[i] = objects[i]->collider.p.x;
+        y[i] = objects[i]->collider.p.y;
+        r[i] = objects[i]->collider.r;
+    }
+
+    history->ticks[row] = tick;
+    history->counts[row] = count;
+    history->valid[row] = true;
+    history->newestTick = tick;
+}
+
+/**
+ * ClampRewindTick - Limits a client's view tick to a tick the host can rewind to.
+ *
+ * @history:     The collider history.
+ * @currentTick: The tick being simulated.
+ * @viewTick:    The tick the attacker was looking at.
+ *
+ * View ticks from the future are treated as the newest recorded tick, view
+ * ticks older than LAG_COMPENSATION_MAX_REWIND (or the history) are moved
+ * forward, so a client can never hit with arbitrarily old positions.
+ *
+ * Return: The tick to rewind to.
+ */
+uint32_t ClampRewindTick(const ColliderHistory *history, uint32_t currentTick, uint32_t viewTick)
+{
+    if (viewTick > history->newestTick)
+    {
+        viewTick = history->newestTick;
+    }
+
+    uint32_t maxRewind = LAG_COMPENSATION_MAX_REWIND < LAG_COMPENSATION_HISTORY - 1 ? LAG_COMPENSATION_MAX_REWIND : LAG_COMPENSATION_HISTORY - 1;
+    if (currentTick > maxRewind && viewTick < currentTick - maxRewind)
+    {
+        viewTick = currentTick - maxRewind;
+    }
+
+    return viewTick;
+}
+
+/**
+ * RewindCollider - Looks up an entity's collider at a past tick.
+ *
+ * @history:  The collider history.
+ * @entity:   Index of the entity (same order as GatherGameObjects).
+ * @tick:     The tick to rewind to, normally from ClampRewindTick.
+ * @collider: Receives the collider at that tick.
+ *
+ * The lookup is a mask and three reads, cheap enough to run for every
+ * attacker every tick.
+ *
+ * Return: false if the tick is no longer (or not yet) in the history.
+ */
+bool RewindCollider(const ColliderHistory *history, int entity, uint32_t tick, c2Circle *collider)
+{
+    int row = HistoryRow(tick);
+
+    if (!history->valid[row] || history->ticks[row] != tick || entity < 0 || entity >= history->counts[row])
+    {
+        return false;
+    }
+
+    size_t index = (size_t)row * (size_t)history->maxEntities + (size_t)entity;
+    collider->p.x = history->x[index];
+    collider->p.y = history->y[index];
+    collider->r = history->r[index];
+    return true;
+}
+
+/**
+ * MoveColliderHistory - Follows an entity to a new entity index.
+ *
+ * @history: The collider history.
+ * @from:    The entity index the entity had, the last one recorded.
+ * @to:      Its new entity index, whoever had it left the world.
+ *
+ * Every recorded tick takes the entity's collider over into its new index and
+ * forgets the old one, so a rewound hit is tested against the entity that is
+ * there now. Moving an index onto itself forgets it.
+ */
+void MoveColliderHistory(ColliderHistory *history, int from, int to)
+{
+    for (int row = 0; row < LAG_COMPENSATION_HISTORY; row++)
+    {
+        if (!history->valid[row] || from < 0 || from >= history->counts[row])
+        {
+            continue;
+        }
+
+        size_t base = (size_t)row * (size_t)history->maxEntities;
+        if (to >= 0 && to < history->counts[row] && to != from)
+        {
+            history->x[base + to] = history->x[base + from];
+            history->y[base + to] = history->y[base + from];
+            history->r[base + to] = history->r[base + from];
+        }
+
+        // The last index is vacated, the entities after it are shorter by one
+        if (from == history->counts[row] - 1)
+        {
+            history->counts[row]--;
+        }
+    }
+}
+
+/**
+ * FreeColliderHistory - Frees the collider history ring.
+ *
+ * @history: The history to free.
+ */
+void FreeColliderHistory(ColliderHistory *history)
+{
+    free(history->x);
+    free(history->y);
+    free(history->r);
+    memset(history, 0, sizeof(ColliderHistory));
+}
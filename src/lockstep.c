@@ -0,0 +1,349 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/network/lockstep.h"
+
+// Packet identifier ("LSTP")
+#define LOCKSTEP_MAGIC 0x4C535450u
+
+// Marks "no hash checkpoint yet" in packets
+#define LOCKSTEP_NO_HASH 0xFFFFFFFFu
+
+// magic + sender + newest tick + redundant inputs + hash tick + hash
+#define LOCKSTEP_PACKET_SIZE (4 + 1 + 4 + LOCKSTEP_REDUNDANCY + 4 + 4)
+
+// Packets are written byte by byte in little endian so native and web builds agree
+static void WriteU32(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = (uint8_t)(value);
+    buffer[1] = (uint8_t)(value >> 8);
+    buffer[2] = (uint8_t)(value >> 16);
+    buffer[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t ReadU32(const uint8_t *buffer)
+{
+    return (uint32_t)buffer[0] | ((uint32_t)buffer[1] << 8) | ((uint32_t)buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+}
+
+static int InputSlot(int64_t tick)
+{
+    return (int)(tick & (LOCKSTEP_INPUT_BUFFER - 1));
+}
+
+static void StoreInput(LockstepSession *session, int peer, int64_t tick, uint8_t input)
+{
+    int slot = InputSlot(tick);
+    session->inputs[peer][slot] = input;
+    session->inputTicks[peer][slot] = tick;
+}
+
+static bool HasInput(const LockstepSession *session, int peer, int64_t tick)
+{
+    return session->inputTicks[peer][InputSlot(tick)] == tick;
+}
+
+/**
+ * InitLockstep - Opens a lockstep session with a fixed set of peers.
+ *
+ * @session:       The session to initialise.
+ * @localPeer:     Index of this process in the peer list.
+ * @peerCount:     Number of peers, including this one.
+ * @localPort:     UDP port to listen on.
+ * @peerAddresses: "host:port" for every peer, the entry at localPeer is ignored.
+ * @inputDelay:    Ticks of input delay, hides network latency up to
+ *                 inputDelay * frame time before the simulation has to stall.
+ *
+ * The first inputDelay ticks have no sampled input, every peer fills them with
+ * COMMAND_NONE so all simulations start identically.
+ *
+ * Return: true if the session is ready to run.
+ */
+bool InitLockstep(LockstepSession *session, int localPeer, int peerCount, unsigned short localPort, const char **peerAddresses, int inputDelay)
+{
+    memset(session, 0, sizeof(LockstepSession));
+
+    if (peerCount < 2 || peerCount > LOCKSTEP_MAX_PEERS || localPeer < 0 || localPeer >= peerCount)
+    {
+        fprintf(stderr, "Lockstep needs 2 to %d peers\n", LOCKSTEP_MAX_PEERS);
+        return false;
+    }
+
+    // Redundant inputs must cover the largest gap between two peers (2 * delay)
+    if (inputDelay < 1 || inputDelay * 2 >= LOCKSTEP_REDUNDANCY)
+    {
+        fprintf(stderr, "Lockstep input delay must be between 1 and %d ticks\n", LOCKSTEP_REDUNDANCY / 2 - 1);
+        return false;
+    }
+
+    session->localPeer = localPeer;
+    session->peerCount = peerCount;
+    session->inputDelay = inputDelay;
+
+    for (int peer = 0; peer < peerCount; peer++)
+    {
+        if (peer != localPeer && !ResolveNetAddress(&session->peers[peer], peerAddresses[peer]))
+        {
+            return false;
+        }
+    }
+
+    if (!InitNetwork() || !OpenNetSocket(&session->socket, localPort))
+    {
+        return false;
+    }
+
+    // No input is known for any tick yet
+    for (int peer = 0; peer < LOCKSTEP_MAX_PEERS; peer++)
+    {
+        for (int slot = 0; slot < LOCKSTEP_INPUT_BUFFER; slot++)
+        {
+            session->inputTicks[peer][slot] = -1;
+        }
+        session->remoteHashTicks[peer] = -1;
+    }
+
+    for (int slot = 0; slot < LOCKSTEP_HASH_HISTORY; slot++)
+    {
+        session->hashTicks[slot] = -1;
+    }
+
+    // Ticks inside the initial input delay are neutral for everyone
+    for (int peer = 0; peer < peerCount; peer++)
+    {
+        for (int tick = 0; tick < inputDelay; tick++)
+        {
+            StoreInput(session, peer, tick, (uint8_t)COMMAND_NONE);
+        }
+    }
+
+    session->currentTick = 0;
+    session->nextLocalTick = (uint32_t)inputDelay;
+    session->active = true;
+
+    printf("Lockstep peer %d of %d listening on port %u (input delay %d ticks)\n", localPeer, peerCount, localPort, inputDelay);
+    return true;
+}
+
+/**
+ * LockstepSubmitLocalInput - Schedules the local input for a future tick.
+ *
+ * @session: The lockstep session.
+ * @input:   The movement and action sampled from the local input devices.
+ *
+ * The input is executed inputDelay ticks from now on every peer. While the
+ * simulation is stalled waiting for peers no further input is scheduled, so the
+ * local player can never get more than inputDelay ticks ahead.
+ */
+void LockstepSubmitLocalInput(LockstepSession *session, PlayerInput input)
+{
+    if (session->nextLocalTick <= session->currentTick + (uint32_t)session->inputDelay)
+    {
+        StoreInput(session, session->localPeer, session->nextLocalTick, PackPlayerInput(input));
+        session->nextLocalTick++;
+    }
+}
+
+// Compares the latest hash checkpoint of a peer with the locally recorded one
+static void CheckDesync(LockstepSession *session, int peer)
+{
+    int64_t tick = session->remoteHashTicks[peer];
+    if (tick < 0 || session->desynced)
+    {
+        return;
+    }
+
+    int slot = (int)((tick / LOCKSTEP_HASH_INTERVAL) % LOCKSTEP_HASH_HISTORY);
+    if (session->hashTicks[slot] == tick && session->hashes[slot] != session->remoteHashes[peer])
+    {
+        session->desynced = true;
+        session->desyncTick = (uint32_t)tick;
+        fprintf(stderr, "Lockstep desync with peer %d at tick %u (local %08x, remote %08x)\n",
+                peer, (uint32_t)tick, session->hashes[slot], session->remoteHashes[peer]);
+    }
+}
+
+// Latest recorded local hash checkpoint
+static bool LatestLocalHash(const LockstepSession *session, uint32_t *tick, uint32_t *hash)
+{
+    int64_t latest = -1;
+    for (int slot = 0; slot < LOCKSTEP_HASH_HISTORY; slot++)
+    {
+        if (session->hashTicks[slot] > latest)
+        {
+            latest = session->hashTicks[slot];
+            *hash = session->hashes[slot];
+        }
+    }
+
+    *tick = (uint32_t)latest;
+    return latest >= 0;
+}
+
+/**
+ * LockstepPoll - Exchanges inputs and hash checkpoints with the peers.
+ *
+ * @session: The lockstep session.
+ *
+ * Every call sends one fixed size packet to each peer holding the last
+ * LOCKSTEP_REDUNDANCY local inputs and the latest hash checkpoint, so a lost
+ * packet is covered by the next one and bandwidth stays constant no matter how
+ * many NPCs are in the world. All waiting packets are then received.
+ */
+void LockstepPoll(LockstepSession *session)
+{
+    if (!session->active)
+    {
+        return;
+    }
+
+    uint8_t packet[LOCKSTEP_PACKET_SIZE];
+    uint32_t newestTick = session->nextLocalTick - 1;
+
+    WriteU32(&packet[0], LOCKSTEP_MAGIC);
+    packet[4] = (uint8_t)session->localPeer;
+    WriteU32(&packet[5], newestTick);
+
+    for (int i = 0; i < LOCKSTEP_REDUNDANCY; i++)
+    {
+        int64_t tick = (int64_t)newestTick - (LOCKSTEP_REDUNDANCY - 1) + i;
+        packet[9 + i] = (tick >= 0 && HasInput(session, session->localPeer, tick))
+                            ? session->inputs[session->localPeer][InputSlot(tick)]
+                            : PackPlayerInput((PlayerInput){COMMAND_NONE, COMMAND_NONE});
+    }
+
+    uint32_t hashTick = LOCKSTEP_NO_HASH;
+    uint32_t hash = 0;
+    if (!LatestLocalHash(session, &hashTick, &hash))
+    {
+        hashTick = LOCKSTEP_NO_HASH;
+    }
+    WriteU32(&packet[9 + LOCKSTEP_REDUNDANCY], hashTick);
+    WriteU32(&packet[13 + LOCKSTEP_REDUNDANCY], hash);
+
+    for (int peer = 0; peer < session->peerCount; peer++)
+    {
+        if (peer != session->localPeer)
+        {
+            NetSend(&session->socket, &session->peers[peer], packet, LOCKSTEP_PACKET_SIZE);
+        }
+    }
+
+    // Receive everything that is waiting
+    uint8_t received[LOCKSTEP_PACKET_SIZE];
+    int size;
+    while ((size = NetReceive(&session->socket, NULL, received, sizeof(received))) > 0)
+    {
+        if (size != LOCKSTEP_PACKET_SIZE || ReadU32(&received[0]) != LOCKSTEP_MAGIC)
+        {
+            continue; // Not a lockstep packet
+        }
+
+        int peer = received[4];
+        if (peer >= session->peerCount || peer == session->localPeer)
+        {
+            continue;
+        }
+
+        int64_t remoteNewest = ReadU32(&received[5]);
+        for (int i = 0; i < LOCKSTEP_REDUNDANCY; i++)
+        {
+            int64_t tick = remoteNewest - (LOCKSTEP_REDUNDANCY - 1) + i;
+
+            // Only keep inputs for ticks that are still to be simulated
+            if (tick >= (int64_t)session->currentTick && !HasInput(session, peer, tick))
+            {
+                StoreInput(session, peer, tick, received[9 + i]);
+            }
+        }
+
+        uint32_t remoteHashTick = ReadU32(&received[9 + LOCKSTEP_REDUNDANCY]);
+        if (remoteHashTick != LOCKSTEP_NO_HASH && (int64_t)remoteHashTick > session->remoteHashTicks[peer])
+        {
+            session->remoteHashTicks[peer] = remoteHashTick;
+            session->remoteHashes[peer] = ReadU32(&received[13 + LOCKSTEP_REDUNDANCY]);
+            CheckDesync(session, peer);
+        }
+    }
+}
+
+/**
+ * LockstepReadyToAdvance - Checks whether every peer's input for the current tick is known.
+ *
+ * @session: The lockstep session.
+ *
+ * Return: true if the current tick can be simulated, false if the simulation must stall.
+ */
+bool LockstepReadyToAdvance(const LockstepSession *session)
+{
+    for (int peer = 0; peer < session->peerCount; peer++)
+    {
+        if (!HasInput(session, peer, session->currentTick))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * LockstepGetInput - Returns a peer's input for the current tick.
+ *
+ * @session: The lockstep session.
+ * @peer:    Index of the peer (and of the player it controls).
+ *
+ * Return: The input, or COMMAND_NONE for both commands if it is not known.
+ */
+PlayerInput LockstepGetInput(const LockstepSession *session, int peer)
+{
+    if (peer < 0 || peer >= session->peerCount || !HasInput(session, peer, session->currentTick))
+    {
+        return (PlayerInput){COMMAND_NONE, COMMAND_NONE};
+    }
+    return UnpackPlayerInput(session->inputs[peer][InputSlot(session->currentTick)]);
+}
+
+/**
+ * LockstepAdvance - Completes the current tick.
+ *
+ * @session:   The lockstep session.
+ * @stateHash: World state hash after simulating the current tick.
+ *
+ * Every LOCKSTEP_HASH_INTERVAL ticks the hash is recorded and compared against
+ * the checkpoints already received from the peers.
+ */
+void LockstepAdvance(LockstepSession *session, uint32_t stateHash)
+{
+    uint32_t tick = session->currentTick;
+
+    if (tick % LOCKSTEP_HASH_INTERVAL == 0)
+    {
+        int slot = (int)((tick / LOCKSTEP_HASH_INTERVAL) % LOCKSTEP_HASH_HISTORY);
+        session->hashes[slot] = stateHash;
+        session->hashTicks[slot] = tick;
+
+        for (int peer = 0; peer < session->peerCount; peer++)
+        {
+            if (peer != session->localPeer)
+            {
+                CheckDesync(session, peer);
+            }
+        }
+    }
+
+    session->currentTick++;
+    session->stallFrames = 0;
+}
+
+/**
+ * CloseLockstep - Closes the session.
+ */
+void CloseLockstep(LockstepSession *session)
+{
+    if (session->active)
+    {
+        CloseNetSocket(&session->socket);
+        ExitNetwork();
+        session->active = false;
+    }
+}
@@ -1,9 +1,11 @@
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <stdio.h>
 #include <raylib.h>
 
 #include "../include/game/game.h"
+#include "../include/game/scenes.h"
 #include "../include/events/events.h"
 #include "../include/fsm/fsm.h"
 #include "../include/gameobjects/gameobject.h"
@@ -12,6 +14,7 @@
 #include "../include/utils/mediator.h"
 #include "../include/utils/input_manager.h"
 #include "../include/utils/ai_manager.h"
+#include "../include/render/render_queue.h"
 
 // Specific include for build_web
 #if defined(WEB_BUILD)
@@ -21,49 +24,180 @@
 const int screenWidth = 800;
 const int screenHeight = 600;
 
-void GameLoop(GameData *gameData);
+void GameLoop(RenderQueue *renderQueue);
+static void SimulateFrame(RenderList *list, void *context);
 
-int main(void)
+int main(int argc, char *argv[])
 {
+    // Create and initialize Game Data
+    GameData gameData = {0};
+    InitDetailLevels(&gameData.detail);
+
+    // Command line options
+    // --compare-hashes <a> <b> : report the first divergent tick/entity of two state hash logs
+    // --hash-log <path>        : write the per-tick state hash log to <path>
+    // --lockstep <peer> <port> <host:port>... : lockstep multiplayer, one address per peer
+    // --input-delay <ticks>    : lockstep input delay (default 3)
+    // --host <port> <clients>  : authoritative host for 1 to 3 clients
+    // --connect <host:port>    : join a host, remote entities are interpolated
+    // --interp-delay <ticks>   : client interpolation delay (default 6)
+    // --npcs <count>           : number of NPCs to spawn (default 1, hosts at most 252)
+    // --single-thread          : simulate on the window's thread (to compare frame times)
+    // --lod <reduced> <static> <impostor> <bars> : distances where NPC detail drops (default 250 400 550 200)
+    int lockstepPeer = -1;
+    int lockstepPort = 0;
+    int lockstepPeerCount = 0;
+    int inputDelay = 3;
+    const char *peerAddresses[LOCKSTEP_MAX_PEERS];
+    int hostPort = -1;
+    int hostClients = 0;
+    const char *serverAddress = NULL;
+    float interpolationDelay = DEFAULT_INTERPOLATION_DELAY;
+    bool singleThread = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--compare-hashes") == 0 && i + 2 < argc)
+        {
+            // Exit code 0 when the logs match, 1 when they diverge, 2 when they cannot be read
+            long divergentTick = CompareStateHashLogs(argv[i + 1], argv[i + 2]);
+            return divergentTick == STATE_HASH_LOGS_MATCH ? 0 : divergentTick == STATE_HASH_LOGS_UNREADABLE ? 2 : 1;
+        }
+        else if (strcmp(argv[i], "--hash-log") == 0 && i + 1 < argc)
+        {
+            gameData.hashLogPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--hash-entities") == 0)
+        {
+            gameData.hashEntities = true;
+        }
+        else if (strcmp(argv[i], "--lockstep") == 0 && i + 2 < argc)
+        {
+            lockstepPeer = atoi(argv[++i]);
+            lockstepPort = atoi(argv[++i]);
+
+            // Every following argument up to the next option is a peer address
+            while (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0)
+            {
+                i++;
+                if (lockstepPeerCount < LOCKSTEP_MAX_PEERS)
+                {
+                    peerAddresses[lockstepPeerCount++] = argv[i];
+                }
+            }
+        }
+        else if (strcmp(argv[i], "--input-delay") == 0 && i + 1 < argc)
+        {
+            inputDelay = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--host") == 0 && i + 2 < argc)
+        {
+            hostPort = atoi(argv[++i]);
+            hostClients = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--connect") == 0 && i + 1 < argc)
+        {
+            serverAddress = argv[++i];
+        }
+        else if (strcmp(argv[i], "--npcs") == 0 && i + 1 < argc)
+        {
+            gameData.npcCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--interp-delay") == 0 && i + 1 < argc)
+        {
+            interpolationDelay = (float)atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--lod") == 0 && i + 4 < argc)
+        {
+            gameData.detail.reducedDistance = (float)atof(argv[++i]);
+            gameData.detail.staticDistance = (float)atof(argv[++i]);
+            gameData.detail.impostorDistance = (float)atof(argv[++i]);
+            gameData.detail.overlayDistance = (float)atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--single-thread") == 0)
+        {
+            singleThread = true;
+        }
+    }
+
+    if (lockstepPeer >= 0 &&
+        !InitLockstep(&gameData.lockstep, lockstepPeer, lockstepPeerCount, (unsigned short)lockstepPort, peerAddresses, inputDelay))
+    {
+        fprintf(stderr, "Failed to start lockstep session\n");
+        return 1;
+    }
+
+    if (lockstepPeer >= 0 && (hostPort >= 0 || serverAddress != NULL))
+    {
+        fprintf(stderr, "Lockstep cannot be combined with --host or --connect\n");
+        return 1;
+    }
+
+    if (hostPort >= 0 && !InitHost(&gameData.clientServer, (unsigned short)hostPort, hostClients))
+    {
+        fprintf(stderr, "Failed to start hosting\n");
+        return 1;
+    }
+
+    if (serverAddress != NULL && !InitClient(&gameData.clientServer, serverAddress, interpolationDelay))
+    {
+        fprintf(stderr, "Failed to connect to host\n");
+        return 1;
+    }
+
     // Seed the random number generator once at the start of the program
     srand(time(NULL));
 
     InitWindow(screenWidth, screenHeight, "Raylib Animated FSM StarterKit GPPI");
 
-    // Create and initialize Game Data
-    GameData gameData;
-
-    // Initialise Game
-    InitGame(&gameData);
+    // Network sessions start playing right away, a single player starts at the title.
+    // Every scene after the first is prepared while the one before it runs
+    SceneManager *scenes = GetSceneManager();
+    InitSceneManager(scenes);
+    RegisterGameScenes(scenes, &gameData);
+    SwitchScene(scenes, lockstepPeer >= 0 || hostPort >= 0 || serverAddress != NULL ? SCENE_GAMEPLAY : SCENE_TITLE);
 
     // For web builds, do not use WindowShouldClose
     // see https://github.com/raysan5/raylib/wiki/Working-for-Web-(HTML5)#41-avoid-raylib-whilewindowshouldclose-loop
 
+    // The scenes run on a simulation thread and record their frames, this
+    // thread owns the window and submits them (GLFW needs it to be the main one)
+    RenderQueue *renderQueue = GetRenderQueue();
+
 #if defined(WEB_BUILD)
-    emscripten_set_main_loop_arg((void (*)(void *))GameLoop, &gameData, 0, 1);
+    (void)singleThread;
+    InitRenderQueue(renderQueue, SimulateFrame, scenes, false);
+    emscripten_set_main_loop_arg((void (*)(void *))GameLoop, renderQueue, 0, 1);
 #else
+    InitRenderQueue(renderQueue, SimulateFrame, scenes, !singleThread);
+
     SetTargetFPS(60);
     while (!WindowShouldClose()) // Detect window close button or ESC key
     {
         // Call GameLoop
-        GameLoop(&gameData);
+        GameLoop(renderQueue);
     }
 #endif
 
-    // Free resources
-    CloseGame(&gameData);
+    // Free resources, the current scene closes its game once the simulation stopped
+    CloseRenderQueue(renderQueue);
+    FreeSceneManager(scenes);
+    FreeAssetCache(GetAssetCache());
 
     CloseWindow();
 
     return 0;
 }
 
-void GameLoop(GameData *gameData)
+void GameLoop(RenderQueue *renderQueue)
 {
-    // Update Game Data
-    // Should be outside BeginDrawing(); and EndDrawing();
-    UpdateGame(gameData);
+    // Submit the newest frame the simulation recorded
+    RenderFrame(renderQueue);
+}
 
-    // Draw the Game Objects
-    DrawGame(gameData);
+// One tick on the simulation thread: update and record the current scene
+// (UpdateGame and DrawGame while playing), then prepare the next one in the time left
+static void SimulateFrame(RenderList *list, void *context)
+{
+    RunSceneFrame((SceneManager *)context, list);
 }
\ No newline at end of file
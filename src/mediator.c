@@ -33,6 +33,7 @@ Mediator *CreateMediator(GameObject *obj)
         return NULL;
     }
     mediator->obj = obj;
+    mediator->handle = obj->handle;
     return mediator;
 }
 
@@ -49,6 +50,8 @@ Mediator *CreateMediator(GameObject *obj)
  *
  * Commands like movement, firing, and collisions are mapped to specific events, and the FSM determines how
  * the GameObject responds to those events, including transitioning to different states or performing specific actions.
+ *
+ * Commands for an object that was destroyed (its handle no longer resolves) are dropped.
  */
 void MediatorExecuteCommand(Command command, Mediator *mediator)
 {
@@ -58,37 +61,21 @@ void MediatorExecuteCommand(Command command, Mediator *mediator)
         return;
     }
 
-    switch (command)
+    GameObject *obj = mediator->obj;
+    if (mediator->handle.generation != 0)
+    {
+        obj = ResolveEntity(GetEntityTable(), mediator->handle);
+        if (obj == NULL)
+        {
+            return;
+        }
+    }
+
+    // The event carries its payload by value, nothing is allocated per command
+    EventData event;
+    if (CommandToEvent(command, obj->handle, &event))
     {
-    case COMMAND_NONE:
-        HandleEvent(mediator->obj, EVENT_NONE);
-        break;
-    case COMMAND_MOVE_UP:
-        HandleEvent(mediator->obj, EVENT_MOVE_UP);
-        break;
-    case COMMAND_MOVE_DOWN:
-        HandleEvent(mediator->obj, EVENT_MOVE_DOWN);
-        break;
-    case COMMAND_MOVE_LEFT:
-        HandleEvent(mediator->obj, EVENT_MOVE_LEFT);
-        break;
-    case COMMAND_MOVE_RIGHT:
-        HandleEvent(mediator->obj, EVENT_MOVE_RIGHT);
-        break;
-    case COMMAND_ATTACK:
-        HandleEvent(mediator->obj, EVENT_ATTACK);
-        break;
-    case COMMAND_ROLL:
-        HandleEvent(mediator->obj, EVENT_ROLL);
-        break;
-    case COMMAND_COLLISION_START:
-        HandleEvent(mediator->obj, EVENT_DIE);
-        break;
-    case COMMAND_COLLISION_END:
-        HandleEvent(mediator->obj, EVENT_RESPAWN);
-        break;
-    default:
-        break;
+        HandleEventData(obj, &event);
     }
 }
 
@@ -0,0 +1,267 @@
+// getaddrinfo and friends are POSIX, not part of C11
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/network/net_socket.h"
+
+#if defined(WEB_BUILD)
+// Browsers have no UDP, networking is unavailable in web builds
+#elif defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <fcntl.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#endif
+
+/**
+ * InitNetwork - Initialises the platform socket layer.
+ *
+ * Only Windows needs explicit start up (Winsock), on other platforms this is a no-op.
+ *
+ * Return: true if sockets can be used.
+ */
+bool InitNetwork(void)
+{
+#if defined(WEB_BUILD)
+    fprintf(stderr, "Networking is not supported in web builds\n");
+    return false;
+#elif defined(_WIN32)
+    WSADATA data;
+    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+#else
+    return true;
+#endif
+}
+
+/**
+ * ExitNetwork - Shuts down the platform socket layer.
+ */
+void ExitNetwork(void)
+{
+#if defined(_WIN32) && !defined(WEB_BUILD)
+    WSACleanup();
+#endif
+}
+
+/**
+ * OpenNetSocket - Opens a non-blocking UDP socket bound to a local port.
+ *
+ * @netSocket: The socket to open.
+ * @port:      Local port to bind to (0 lets the OS choose).
+ *
+ * Return: true if the socket was opened and bound.
+ */
+bool OpenNetSocket(NetSocket *netSocket, unsigned short port)
+{
+    netSocket->open = false;
+    netSocket->handle = -1;
+
+#if defined(WEB_BUILD)
+    (void)port;
+    return false;
+#else
+#if defined(_WIN32)
+    SOCKET handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle == INVALID_SOCKET)
+#else
+    int handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle < 0)
+#endif
+    {
+        fprintf(stderr, "Failed to create UDP socket\n");
+        return false;
+    }
+
+    struct sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(port);
+
+    if (bind(handle, (struct sockaddr *)&local, sizeof(local)) != 0)
+    {
+        fprintf(stderr, "Failed to bind UDP socket to port %u\n", port);
+#if defined(_WIN32)
+        closesocket(handle);
+#else
+        close(handle);
+#endif
+        return false;
+    }
+
+    // Never block the game loop waiting for packets
+#if defined(_WIN32)
+    u_long nonBlocking = 1;
+    ioctlsocket(handle, FIONBIO, &nonBlocking);
+#else
+    fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    netSocket->handle = (intptr_t)handle;
+    netSocket->open = true;
+    return true;
+#endif
+}
+
+/**
+ * ResolveNetAddress - Resolves a "host:port" string into an IPv4 address.
+ *
+ * @address:     The resolved address.
+ * @hostAndPort: Host name or dotted address followed by ':' and the port.
+ *
+ * Return: true if the address could be resolved.
+ */
+bool ResolveNetAddress(NetAddress *address, const char *hostAndPort)
+{
+#if defined(WEB_BUILD)
+    (void)address;
+    (void)hostAndPort;
+    return false;
+#else
+    char host[256];
+    const char *separator = strrchr(hostAndPort, ':');
+
+    if (separator == NULL || (size_t)(separator - hostAndPort) >= sizeof(host))
+    {
+        fprintf(stderr, "Invalid address %s, expected host:port\n", hostAndPort);
+        return false;
+    }
+
+    memcpy(host, hostAndPort, separator - hostAndPort);
+    host[separator - hostAndPort] = '\0';
+
+    struct addrinfo hints;
+    struct addrinfo *result = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    if (getaddrinfo(host, separator + 1, &hints, &result) != 0 || result == NULL)
+    {
+        fprintf(stderr, "Failed to resolve %s\n", hostAndPort);
+        return false;
+    }
+
+    struct sockaddr_in *resolved = (struct sockaddr_in *)result->ai_addr;
+    address->host = resolved->sin_addr.s_addr;
+    address->port = resolved->sin_port;
+
+    freeaddrinfo(result);
+    return true;
+#endif
+}
+
+/**
+ * NetAddressEqual - Checks whether two addresses refer to the same host and port.
+ */
+bool NetAddressEqual(const NetAddress *lhs, const NetAddress *rhs)
+{
+    return lhs->host == rhs->host && lhs->port == rhs->port;
+}
+
+/**
+ * NetSend - Sends a datagram to an address.
+ *
+ * @netSocket: The socket to send from.
+ * @to:        Destination address.
+ * @data:      Payload bytes.
+ * @size:      Payload size in bytes.
+ *
+ * Return: true if the whole datagram was handed to the OS.
+ */
+bool NetSend(NetSocket *netSocket, const NetAddress *to, const void *data, int size)
+{
+#if defined(WEB_BUILD)
+    (void)netSocket;
+    (void)to;
+    (void)data;
+    (void)size;
+    return false;
+#else
+    if (!netSocket->open)
+    {
+        return false;
+    }
+
+    struct sockaddr_in remote;
+    memset(&remote, 0, sizeof(remote));
+    remote.sin_family = AF_INET;
+    remote.sin_addr.s_addr = to->host;
+    remote.sin_port = to->port;
+
+    int sent = (int)sendto(netSocket->handle, (const char *)data, size, 0, (struct sockaddr *)&remote, sizeof(remote));
+    return sent == size;
+#endif
+}
+
+/**
+ * NetReceive - Receives a waiting datagram without blocking.
+ *
+ * @netSocket: The socket to receive on.
+ * @from:      Filled with the sender address (may be NULL).
+ * @buffer:    Buffer receiving the payload.
+ * @size:      Size of the buffer.
+ *
+ * Return: Size of the received datagram, or 0 if nothing is waiting.
+ */
+int NetReceive(NetSocket *netSocket, NetAddress *from, void *buffer, int size)
+{
+#if defined(WEB_BUILD)
+    (void)netSocket;
+    (void)from;
+    (void)buffer;
+    (void)size;
+    return 0;
+#else
+    if (!netSocket->open)
+    {
+        return 0;
+    }
+
+    struct sockaddr_in remote;
+    socklen_t remoteSize = sizeof(remote);
+
+    int received = (int)recvfrom(netSocket->handle, (char *)buffer, size, 0, (struct sockaddr *)&remote, &remoteSize);
+    if (received <= 0)
+    {
+        return 0; // Nothing waiting (EWOULDBLOCK) or an error, both mean no packet
+    }
+
+    if (from != NULL)
+    {
+        from->host = remote.sin_addr.s_addr;
+        from->port = remote.sin_port;
+    }
+
+    return received;
+#endif
+}
+
+/**
+ * CloseNetSocket - Closes the socket.
+ */
+void CloseNetSocket(NetSocket *netSocket)
+{
+#if !defined(WEB_BUILD)
+    if (netSocket->open)
+    {
+#if defined(_WIN32)
+        closesocket((SOCKET)netSocket->handle);
+#else
+        close((int)netSocket->handle);
+#endif
+    }
+#endif
+    netSocket->open = false;
+}
@@ -1,4 +1,55 @@
+#include <math.h>
+
 #include "../include/gameobjects/npc.h"
+#include "../include/utils/constants.h"
+
+// Build with -DNPC_TRACE to print every NPC state change and event. Off by
+// default, even in debug builds, as a world of NPCs would print every tick.
+#ifdef NPC_TRACE
+#define NPCTrace(npc, ...) (printf(__VA_ARGS__), printf("Aggression: %d\n\n", (npc)->aggression))
+#else
+#define NPCTrace(npc, ...) ((void)(npc))
+#endif
+
+// The NPC clips, every NPC plays these tables rather than a copy of its own
+static Rectangle npcIdleFrames[6] = {
+    {0, 128, 64, 64},   // Frame 1: Row 3, Column 1
+    {64, 128, 64, 64},  // Frame 2: Row 3, Column 2
+    {128, 128, 64, 64}, // Frame 3: Row 3, Column 3
+    {192, 128, 64, 64}, // Frame 4: Row 3, Column 4
+    {256, 128, 64, 64}, // Frame 5: Row 3, Column 5
+    {320, 128, 64, 64}  // Frame 6: Row 3, Column 6
+};
+
+static Rectangle npcAttackingFrames[6] = {
+    {0, 3328, 192, 192},   // Frame 1: Row 53, Column 1
+    {192, 3328, 192, 192}, // Frame 2: Row 53, Column 2
+    {384, 3328, 192, 192}, // Frame 3: Row 53, Column 3
+    {576, 3520, 192, 192}, // Frame 4: Row 53, Column 4
+    {768, 3520, 192, 192}, // Frame 5: Row 53, Column 5
+    {960, 3520, 192, 192}  // Frame 6: Row 53, Column 6
+};
+
+static Rectangle npcDeadFrames[6] = {
+    {0, 1280, 64, 64},   // Frame 1: Row 21, Column 1
+    {64, 1280, 64, 64},  // Frame 1: Row 21, Column 2
+    {128, 1280, 64, 64}, // Frame 1: Row 21, Column 3
+    {192, 1280, 64, 64}, // Frame 1: Row 21, Column 4
+    {256, 1280, 64, 64}, // Frame 1: Row 21, Column 5
+    {320, 1280, 64, 64}  // Frame 1: Row 21, Column 6
+};
+
+// One walk clip per facing, each a row of the sprite sheet
+#define NPC_WALK_ROW(row)                                                                        \
+    {{0, row, 64, 64}, {64, row, 64, 64}, {128, row, 64, 64}, {192, row, 64, 64}, {256, row, 64, 64}, \
+     {320, row, 64, 64}, {384, row, 64, 64}, {448, row, 64, 64}, {512, row, 64, 64}}
+
+static Rectangle npcWalkFrames[4][NPC_WALK_FRAMES] = {
+    NPC_WALK_ROW(512), // Up
+    NPC_WALK_ROW(576), // Left
+    NPC_WALK_ROW(640), // Down
+    NPC_WALK_ROW(704)  // Right
+};
 
 /**
  * InitNPC - Initializes a new NPC object with a given name.
@@ -25,8 +76,8 @@ NPC *InitNPC(const char *name)
         exit(1);
     }
 
-    // Load player texture
-    Texture2D npcTexture = LoadTexture("./assets/npc_sprite_sheet.png");
+    // Load NPC texture, shared with any other NPC loaded
+    Texture2D npcTexture = AcquireTexture(GetAssetCache(), NPC_SPRITE_SHEET);
 
     // Initialize the base GameObject structure within the NPC with the provided name
     InitGameObject(&npc->base,
@@ -47,6 +98,13 @@ NPC *InitNPC(const char *name)
 
     // Set the default aggression level for the NPC
     npc->aggression = 50;
+    npc->base.faction = FACTION_SKYNET;
+
+    npc->attackTimer = (TimerId){0, 0};
+    npc->fireCooldown = (TimerId){0, 0};
+    npc->burstTick = 0;
+    npc->respawnTimer = (TimerId){0, 0};
+    ResetBehaviorState(&npc->behavior);
 
     // Initialize the NPC's finite state machine (FSM) with state configurations
     InitNPCFSM(&npc->base);
@@ -78,9 +136,111 @@ void DeleteNPC(GameObject *obj)
     // Example of potential cleanup (not implemented here):
     // If the npc is holding a dynamically allocated object, such as a thor hammer:
     // free(npc->holding);
+    ReleaseTexture(GetAssetCache(), obj->keyframes);
     DeleteGameObject(obj);
 }
 
+/**
+ * InitNPCPrefab - Sets up the prefab every NPC is spawned from.
+ *
+ * @prefab: The prefab to initialise.
+ *
+ * InitNPC runs once for the archetype: the texture is loaded, the FSM tables
+ * built and the idle clip started a single time, however many NPCs spawn.
+ */
+void InitNPCPrefab(Prefab *prefab)
+{
+    NPC *archetype = InitNPC("Skynet");
+    InitPrefab(prefab, "Skynet", &archetype->base, sizeof(NPC), DeleteNPC);
+}
+
+/**
+ * NPCCanAttack - Checks whether the NPC may start a bullet burst.
+ *
+ * @npc: The NPC wanting to attack.
+ *
+ * Return: true once the cooldown started by the previous burst has expired.
+ */
+bool NPCCanAttack(const NPC *npc)
+{
+    return !IsTimerPending(GetTimerService(), npc->fireCooldown);
+}
+
+// Walk clip facing a direction, diagonals face their dominant axis
+static Rectangle *NPCWalkFrames(Vector2 direction)
+{
+    if (fabsf(direction.y) >= fabsf(direction.x))
+    {
+        return direction.y < 0 ? npcWalkFrames[0] : npcWalkFrames[2]; // Up, down
+    }
+
+    return direction.x < 0 ? npcWalkFrames[1] : npcWalkFrames[3]; // Left, right
+}
+
+// Sets the NPC's velocity from a move event, a step of at most one unit so
+// diagonals are no faster than straight moves. Returns false for a stop.
+static bool NPCSetMoveDirection(NPC *npc, const EventData *event)
+{
+    if (event->magnitude <= 0.0f)
+    {
+        return false;
+    }
+
+    npc->base.velocity = (Vector2){event->direction.x * event->magnitude, event->direction.y * event->magnitude};
+    return true;
+}
+
+/**
+ * NPCFaceMoveDirection - Turns a moving NPC's walk clip toward its velocity.
+ *
+ * @npc: The NPC in the Moving state.
+ *
+ * Changing direction stays in the Moving state, so instead of Exit and Entry
+ * restarting the clip only its frames are swapped for the walk row facing the
+ * new way. The current frame and its timer carry on, so the stride does not
+ * restart.
+ */
+void NPCFaceMoveDirection(NPC *npc)
+{
+    if (npc->base.currentState != STATE_MOVING || npc->base.animation.frameCount != NPC_WALK_FRAMES)
+    {
+        return;
+    }
+
+    npc->base.animation.frames = NPCWalkFrames(npc->base.velocity);
+}
+
+/**
+ * NPCSentryScript - Guards a post until hit, then patrols either side of it.
+ *
+ * @frame: The script's frame, vars[0] and vars[1] hold the post.
+ *
+ * Written top to bottom as a coroutine instead of spread over state
+ * callbacks. While it waits the sentry costs nothing per tick.
+ *
+ * Return: SCRIPT_WAITING, the patrol never ends.
+ */
+ScriptStatus NPCSentryScript(ScriptFrame *frame)
+{
+    SCRIPT_BEGIN(frame);
+
+    // Stand guard where the NPC spawned until a player's attack lands
+    frame->vars[0] = (int)frame->obj->position.x;
+    frame->vars[1] = (int)frame->obj->position.y;
+    SCRIPT_WAIT_EVENT(frame, EVENT_COLLISION_START);
+
+    // Then walk up and down past the post, looking around at each end
+    while (true)
+    {
+        SCRIPT_MOVE_TO(frame, ((Vector2){frame->vars[0] - NPC_SENTRY_PATROL_DISTANCE, frame->vars[1]}));
+        SCRIPT_WAIT_TICKS(frame, NPC_SENTRY_PAUSE_TICKS);
+        SCRIPT_MOVE_TO(frame, ((Vector2){frame->vars[0] + NPC_SENTRY_PATROL_DISTANCE, frame->vars[1]}));
+        SCRIPT_WAIT_TICKS(frame, NPC_SENTRY_PAUSE_TICKS);
+    }
+
+    SCRIPT_END(frame);
+}
+
 /**
  * InitNPCFSM - Initializes the Finite State Machine (FSM) for the NPC.
  *
@@ -105,7 +265,7 @@ void InitNPCFSM(GameObject *obj)
 
     // ---- STATE_IDLE state configuration ----
     // Define valid transitions from STATE_IDLE
-    State idleValidTransitions[] = {STATE_ATTACKING, STATE_MOVING_UP, STATE_MOVING_DOWN, STATE_MOVING_LEFT, STATE_MOVING_RIGHT, STATE_DEAD};
+    State idleValidTransitions[] = {STATE_ATTACKING, STATE_MOVING, STATE_DEAD};
 
     // Set up the state configuration for STATE_IDLE
     obj->stateConfigs[STATE_IDLE].name = "NPC_Idle";
@@ -119,7 +279,7 @@ void InitNPCFSM(GameObject *obj)
 
     // ---- STATE_ATTACKING state configuration ----
     // Define valid transitions from STATE_ATTACKING
-    State attackValidTransitions[] = {STATE_IDLE, STATE_MOVING_DOWN, STATE_MOVING_LEFT, STATE_MOVING_RIGHT, STATE_DEAD};
+    State attackValidTransitions[] = {STATE_IDLE, STATE_MOVING, STATE_DEAD};
 
     // Set up the state configuration for STATE_ATTACKING
     obj->stateConfigs[STATE_ATTACKING].name = "NPC_Attacking";
@@ -131,61 +291,19 @@ void InitNPCFSM(GameObject *obj)
     // Configure valid transitions for STATE_ATTACKING
     StateTransitions(&obj->stateConfigs[STATE_ATTACKING], attackValidTransitions, sizeof(attackValidTransitions) / sizeof(State));
 
-    // ---- STATE_MOVING_UP state configuration ----
-    // Define valid transitions from STATE_MOVING_UP
-    State movingUpValidTransitions[] = {STATE_IDLE, STATE_MOVING_DOWN, STATE_MOVING_LEFT, STATE_MOVING_RIGHT, STATE_ATTACKING, STATE_SHIELD, STATE_DEAD};
-
-    // Set up the state configuration for STATE_MOVING_UP
-    obj->stateConfigs[STATE_MOVING_UP].name = "NPC_Moving_Up";
-    obj->stateConfigs[STATE_MOVING_UP].HandleEvent = NPCMovingUpHandleEvent;
-    obj->stateConfigs[STATE_MOVING_UP].Entry = NPCEnterMovingUp;
-    obj->stateConfigs[STATE_MOVING_UP].Update = NPCUpdateMovingUp;
-    obj->stateConfigs[STATE_MOVING_UP].Exit = NPCExitMovingUp;
-
-    // Configure valid transitions for STATE_MOVING_UP
-    StateTransitions(&obj->stateConfigs[STATE_MOVING_UP], movingUpValidTransitions, sizeof(movingUpValidTransitions) / sizeof(State));
-
-    // ---- STATE_MOVING_DOWN state configuration ----
-    // Define valid transitions from STATE_MOVING_DOWN
-    State movingDownValidTransitions[] = {STATE_IDLE, STATE_MOVING_UP, STATE_MOVING_LEFT, STATE_MOVING_RIGHT, STATE_ATTACKING, STATE_SHIELD, STATE_DEAD};
-
-    // Set up the state configuration for STATE_MOVING_DOWN
-    obj->stateConfigs[STATE_MOVING_DOWN].name = "NPC_Moving_Down";
-    obj->stateConfigs[STATE_MOVING_DOWN].HandleEvent = NPCMovingDownHandleEvent;
-    obj->stateConfigs[STATE_MOVING_DOWN].Entry = NPCEnterMovingDown;
-    obj->stateConfigs[STATE_MOVING_DOWN].Update = NPCUpdateMovingDown;
-    obj->stateConfigs[STATE_MOVING_DOWN].Exit = NPCExitMovingDown;
-
-    // Configure valid transitions for STATE_MOVING_DOWN
-    StateTransitions(&obj->stateConfigs[STATE_MOVING_DOWN], movingDownValidTransitions, sizeof(movingDownValidTransitions) / sizeof(State));
-
-    // ---- STATE_MOVING_LEFT state configuration ----
-    // Define valid transitions from STATE_MOVING_LEFT
-    State movingLeftValidTransitions[] = {STATE_IDLE, STATE_MOVING_UP, STATE_MOVING_DOWN, STATE_MOVING_RIGHT, STATE_ATTACKING, STATE_SHIELD, STATE_DEAD};
-
-    // Set up the state configuration for STATE_MOVING_LEFT
-    obj->stateConfigs[STATE_MOVING_LEFT].name = "NPC_Moving_Left";
-    obj->stateConfigs[STATE_MOVING_LEFT].HandleEvent = NPCMovingLeftHandleEvent;
-    obj->stateConfigs[STATE_MOVING_LEFT].Entry = NPCEnterMovingLeft;
-    obj->stateConfigs[STATE_MOVING_LEFT].Update = NPCUpdateMovingLeft;
-    obj->stateConfigs[STATE_MOVING_LEFT].Exit = NPCExitMovingLeft;
-
-    // Configure valid transitions for STATE_MOVING_DOWN
-    StateTransitions(&obj->stateConfigs[STATE_MOVING_LEFT], movingLeftValidTransitions, sizeof(movingLeftValidTransitions) / sizeof(State));
-
-    // ---- STATE_MOVING_RIGHT state configuration ----
-    // Define valid transitions from STATE_MOVING_RIGHT
-    State movingRightValidTransitions[] = {STATE_IDLE, STATE_MOVING_UP, STATE_MOVING_DOWN, STATE_MOVING_LEFT, STATE_ATTACKING, STATE_SHIELD, STATE_DEAD};
-
-    // Set up the state configuration for STATE_MOVING_RIGHT
-    obj->stateConfigs[STATE_MOVING_RIGHT].name = "NPC_Moving_Right";
-    obj->stateConfigs[STATE_MOVING_RIGHT].HandleEvent = NPCMovingRightHandleEvent;
-    obj->stateConfigs[STATE_MOVING_RIGHT].Entry = NPCEnterMovingRight;
-    obj->stateConfigs[STATE_MOVING_RIGHT].Update = NPCUpdateMovingRight;
-    obj->stateConfigs[STATE_MOVING_RIGHT].Exit = NPCExitMovingRight;
-
-    // Configure valid transitions for STATE_MOVING_DOWN
-    StateTransitions(&obj->stateConfigs[STATE_MOVING_RIGHT], movingRightValidTransitions, sizeof(movingRightValidTransitions) / sizeof(State));
+    // ---- STATE_MOVING state configuration ----
+    // Define valid transitions from STATE_MOVING, changing direction stays in the state
+    State movingValidTransitions[] = {STATE_IDLE, STATE_ATTACKING, STATE_DEAD};
+
+    // Set up the state configuration for STATE_MOVING
+    obj->stateConfigs[STATE_MOVING].name = "NPC_Moving";
+    obj->stateConfigs[STATE_MOVING].HandleEvent = NPCMovingHandleEvent;
+    obj->stateConfigs[STATE_MOVING].Entry = NPCEnterMoving;
+    obj->stateConfigs[STATE_MOVING].Update = NPCUpdateMoving;
+    obj->stateConfigs[STATE_MOVING].Exit = NPCExitMoving;
+
+    // Configure valid transitions for STATE_MOVING
+    StateTransitions(&obj->stateConfigs[STATE_MOVING], movingValidTransitions, sizeof(movingValidTransitions) / sizeof(State));
 
     // ---- STATE_DEAD state configuration ----
     // Define valid transitions from STATE_DEAD
@@ -206,66 +324,69 @@ void InitNPCFSM(GameObject *obj)
 #define EMPTY_STATE_CONFIG \
     (StateConfig){NULL, NULL, NULL, NULL, NULL, NULL, 0}
     obj->stateConfigs[STATE_WALKING] = EMPTY_STATE_CONFIG;
+    obj->stateConfigs[STATE_ROLLING] = EMPTY_STATE_CONFIG;
+    obj->stateConfigs[STATE_SHIELD] = EMPTY_STATE_CONFIG;
     obj->stateConfigs[STATE_RESPAWN] = EMPTY_STATE_CONFIG;
     obj->stateConfigs[STATE_COLLISION] = EMPTY_STATE_CONFIG;
 }
 
 // Handles events for the NPC when in the Idle state
-void NPCIdleHandleEvent(GameObject *obj, Event event)
+void NPCIdleHandleEvent(GameObject *obj, const EventData *event)
 {
     NPC *npc = (NPC *)obj;
-    printf("\n%s Idle HandleEvent\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
+    NPCTrace(npc, "\n%s Idle HandleEvent\n", obj->name);
 
-    switch (event)
+    switch (event->type)
     {
     case EVENT_NONE:
         // Transition back to Idle if no specific event is triggered
         obj->previousState = obj->currentState;
         break;
     case EVENT_ATTACK:
-        // Transition to Attacking state if an attack event is received
-        ChangeState(obj, STATE_ATTACKING);
+        // Transition to Attacking state if an attack event is received and the last burst has cooled down
+        if (NPCCanAttack(npc))
+        {
+            ChangeState(obj, STATE_ATTACKING);
+        }
         break;
     case EVENT_MOVE_UP:
-        ChangeState(obj, STATE_MOVING_UP);
-        break;
     case EVENT_MOVE_DOWN:
-        ChangeState(obj, STATE_MOVING_DOWN);
-        break;
     case EVENT_MOVE_LEFT:
-        ChangeState(obj, STATE_MOVING_LEFT);
-        break;
     case EVENT_MOVE_RIGHT:
-        ChangeState(obj, STATE_MOVING_RIGHT);
+    case EVENT_MOVE:
+        // Face the direction first, entering Moving picks the walk clip from it
+        if (NPCSetMoveDirection(npc, event))
+        {
+            ChangeState(obj, STATE_MOVING);
+        }
         break;
     case EVENT_DIE:
         // Transition to Dead state if a die event is received
         ChangeState(obj, STATE_DEAD);
         break;
     // Ignore Events for other cases
-    case EVENT_MOVE:
     case EVENT_DEFEND:
     case EVENT_ROLL:
     case EVENT_RESPAWN:
     case EVENT_COLLISION_START:
     case EVENT_COLLISION_END:
+    case EVENT_ROLL_END:
+    case EVENT_ATTACK_END:
     case EVENT_COUNT:
         break;
     }
 }
 
 // Handles events for the NPC when in the Attacking state
-void NPCAttackingHandleEvent(GameObject *obj, Event event)
+void NPCAttackingHandleEvent(GameObject *obj, const EventData *event)
 {
     NPC *npc = (NPC *)obj;
-    printf("\n%s Attacking HandleEvent\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
+    NPCTrace(npc, "\n%s Attacking HandleEvent\n", obj->name);
 
-    switch (event)
+    switch (event->type)
     {
-    case EVENT_NONE:
-        // Transition back to Idle if no specific event is triggered
+    case EVENT_ATTACK_END:
+        // The burst is over once its timer fires
         ChangeState(obj, STATE_IDLE);
         break;
     case EVENT_DEFEND:
@@ -276,7 +397,8 @@ void NPCAttackingHandleEvent(GameObject *obj, Event event)
         // Transition to Dead state if a die event is received
         ChangeState(obj, STATE_DEAD);
         break;
-    // Ignore Events for other cases
+    // Ignore Events for other cases, the NPC keeps firing until the burst ends
+    case EVENT_NONE:
     case EVENT_MOVE_UP:
     case EVENT_MOVE_DOWN:
     case EVENT_MOVE_LEFT:
@@ -287,174 +409,78 @@ void NPCAttackingHandleEvent(GameObject *obj, Event event)
     case EVENT_RESPAWN:
     case EVENT_COLLISION_START:
     case EVENT_COLLISION_END:
+    case EVENT_ROLL_END:
     case EVENT_COUNT:
         break;
     }
 }
 
-// Handles events for the NPC when in the Moving Up state
-void NPCMovingUpHandleEvent(GameObject *obj, Event event)
-{
-    NPC *npc = (NPC *)obj;
-    printf("\n%s Moving Up HandleEvent\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
-
-    switch (event)
-    {
-    case EVENT_NONE:
-        // Transition back to Idle if no specific event is triggered
-        ChangeState(obj, STATE_IDLE);
-        break;
-    case EVENT_MOVE_DOWN:
-        ChangeState(obj, STATE_MOVING_DOWN);
-        break;
-    case EVENT_MOVE_LEFT:
-        ChangeState(obj, STATE_MOVING_LEFT);
-        break;
-    case EVENT_MOVE_RIGHT:
-        ChangeState(obj, STATE_MOVING_RIGHT);
-        break;
-    case EVENT_ATTACK:
-        // Transition to Attacking state if an attack event is received
-        ChangeState(obj, STATE_ATTACKING);
-        break;
-    case EVENT_DIE:
-        // Transition to Dead state if a die event is received
-        ChangeState(obj, STATE_DEAD);
-        break;
-    // Ignore Events for other cases
-    default:
-        break;
-    }
-}
-
-// Handles events for the NPC when in the Moving Down state
-void NPCMovingDownHandleEvent(GameObject *obj, Event event)
+// Handles events for the NPC when in the Moving state
+void NPCMovingHandleEvent(GameObject *obj, const EventData *event)
 {
     NPC *npc = (NPC *)obj;
-    printf("\n%s Moving Down HandleEvent\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
+    NPCTrace(npc, "\n%s Moving HandleEvent\n", obj->name);
 
-    switch (event)
+    switch (event->type)
     {
     case EVENT_NONE:
         // Transition back to Idle if no specific event is triggered
         ChangeState(obj, STATE_IDLE);
         break;
     case EVENT_MOVE_UP:
-        ChangeState(obj, STATE_MOVING_UP);
-        break;
-    case EVENT_MOVE_LEFT:
-        ChangeState(obj, STATE_MOVING_LEFT);
-        break;
-    case EVENT_MOVE_RIGHT:
-        ChangeState(obj, STATE_MOVING_RIGHT);
-        break;
-    case EVENT_ATTACK:
-        // Transition to Attacking state if an attack event is received
-        ChangeState(obj, STATE_ATTACKING);
-        break;
-    case EVENT_DIE:
-        // Transition to Dead state if a die event is received
-        ChangeState(obj, STATE_DEAD);
-        break;
-    // Ignore Events for other cases
-    default:
-        break;
-    }
-}
-
-// Handles events for the NPC when in the Moving Left state
-void NPCMovingLeftHandleEvent(GameObject *obj, Event event)
-{
-    NPC *npc = (NPC *)obj;
-    printf("\n%s Moving Left HandleEvent\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
-
-    switch (event)
-    {
-    case EVENT_NONE:
-        // Transition back to Idle if no specific event is triggered
-        ChangeState(obj, STATE_IDLE);
-        break;
-    case EVENT_MOVE_UP:
-        ChangeState(obj, STATE_MOVING_UP);
-        break;
-    case EVENT_MOVE_DOWN:
-        ChangeState(obj, STATE_MOVING_DOWN);
-        break;
-    case EVENT_MOVE_RIGHT:
-        ChangeState(obj, STATE_MOVING_RIGHT);
-        break;
-    case EVENT_ATTACK:
-        // Transition to Attacking state if an attack event is received
-        ChangeState(obj, STATE_ATTACKING);
-        break;
-    case EVENT_DIE:
-        // Transition to Dead state if a die event is received
-        ChangeState(obj, STATE_DEAD);
-        break;
-    // Ignore Events for other cases
-    default:
-        break;
-    }
-}
-
-// Handles events for the NPC when in the Moving Right state
-void NPCMovingRightHandleEvent(GameObject *obj, Event event)
-{
-    NPC *npc = (NPC *)obj;
-    printf("\n%s Moving Right HandleEvent\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
-
-    switch (event)
-    {
-    case EVENT_NONE:
-        // Transition back to Idle if no specific event is triggered
-        ChangeState(obj, STATE_IDLE);
-        break;
-    case EVENT_MOVE_UP:
-        ChangeState(obj, STATE_MOVING_UP);
-        break;
     case EVENT_MOVE_DOWN:
-        ChangeState(obj, STATE_MOVING_DOWN);
-        break;
     case EVENT_MOVE_LEFT:
-        ChangeState(obj, STATE_MOVING_LEFT);
+    case EVENT_MOVE_RIGHT:
+    case EVENT_MOVE:
+        // A new direction only turns the walk clip, no Exit or Entry
+        if (NPCSetMoveDirection(npc, event))
+        {
+            NPCFaceMoveDirection(npc);
+        }
+        else
+        {
+            ChangeState(obj, STATE_IDLE);
+        }
         break;
     case EVENT_ATTACK:
-        // Transition to Attacking state if an attack event is received
-        ChangeState(obj, STATE_ATTACKING);
+        // Transition to Attacking state if an attack event is received and the last burst has cooled down
+        if (NPCCanAttack(npc))
+        {
+            ChangeState(obj, STATE_ATTACKING);
+        }
         break;
     case EVENT_DIE:
         // Transition to Dead state if a die event is received
         ChangeState(obj, STATE_DEAD);
         break;
     // Ignore Events for other cases
-    default:
+    case EVENT_ROLL:
+    case EVENT_DEFEND:
+    case EVENT_RESPAWN:
+    case EVENT_COLLISION_START:
+    case EVENT_COLLISION_END:
+    case EVENT_ROLL_END:
+    case EVENT_ATTACK_END:
+    case EVENT_COUNT:
         break;
     }
 }
 
 // Handles events for the NPC when in the Dead state
-void NPCDeadHandleEvent(GameObject *obj, Event event)
+void NPCDeadHandleEvent(GameObject *obj, const EventData *event)
 {
     NPC *npc = (NPC *)obj;
-    printf("\n%s Dead HandleEvent\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
+    NPCTrace(npc, "\n%s Dead HandleEvent\n", obj->name);
 
-    switch (event)
+    switch (event->type)
     {
-    case EVENT_NONE:
-        // Transition back to Idle if no specific event is triggered (e.g., after dying, NPC should stay dead until respawned)
-        // You may want to handle respawning logic in the future here.
-        ChangeState(obj, STATE_IDLE);
-        break;
     case EVENT_RESPAWN:
-        // Transition to Idle or another state (e.g., Spawn) upon respawn event
+        // Transition to Idle or another state (e.g., Spawn) upon respawn event, sent by the respawn timer
         ChangeState(obj, STATE_IDLE); // or STATE_SPAWNING if you have that state
         break;
     // Ignore Events for other cases (e.g., move, defend) as dead NPCs cannot perform these actions.
+    // The NPC stays dead until it is respawned.
+    case EVENT_NONE:
     case EVENT_DIE:
     case EVENT_ATTACK:
     case EVENT_MOVE_UP:
@@ -466,6 +492,8 @@ void NPCDeadHandleEvent(GameObject *obj, Event event)
     case EVENT_DEFEND:
     case EVENT_COLLISION_START:
     case EVENT_COLLISION_END:
+    case EVENT_ROLL_END:
+    case EVENT_ATTACK_END:
     case EVENT_COUNT:
         break;
     }
@@ -477,25 +505,13 @@ void NPCDeadHandleEvent(GameObject *obj, Event event)
 void NPCEnterIdle(GameObject *obj)
 {
     NPC *npc = (NPC *)obj;
-    printf("%s -> ENTER -> Idle\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
+    NPCTrace(npc, "%s -> ENTER -> Idle\n", obj->name);
     // Initialization code for entering Idle state, such as resetting timers or animation.
 
     if (npc->base.previousState != npc->base.currentState && npc->base.currentState == STATE_IDLE)
     {
-        // Setup Idle Animations
-        Rectangle idle[7] = {
-            {0, 128, 64, 64},   // Frame 1: Row 3, Column 1
-            {64, 128, 64, 64},  // Frame 2: Row 3, Column 2
-            {128, 128, 64, 64}, // Frame 3: Row 3, Column 3
-            {192, 128, 64, 64}, // Frame 4: Row 3, Column 4
-            {256, 128, 64, 64}, // Frame 5: Row 3, Column 5
-            {320, 128, 64, 64}, // Frame 6: Row 3, Column 6
-            {384, 128, 64, 64}  // Frame 7: Row 3, Column 7
-        };
-
-        // Initialize the idle animation frames and play it
-        InitGameObjectAnimation(&npc->base, idle, 6, 0.2f);
+        // Play the idle animation frames
+        InitGameObjectSharedAnimation(&npc->base, npcIdleFrames, 6, 0.2f);
     }
 }
 
@@ -503,8 +519,7 @@ void NPCEnterIdle(GameObject *obj)
 void NPCUpdateIdle(GameObject *obj)
 {
     NPC *npc = (NPC *)obj;
-    printf("%s -> UPDATE -> Idle\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
+    NPCTrace(npc, "%s -> UPDATE -> Idle\n", obj->name);
     // During game loop and game ticks, execute Idle state behavior here, such as patrolling or observing.
     UpdateAnimation(&obj->animation);
 }
@@ -513,8 +528,7 @@ void NPCUpdateIdle(GameObject *obj)
 void NPCExitIdle(GameObject *obj)
 {
     NPC *npc = (NPC *)obj;
-    printf("%s <- EXIT <- Idle\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
+    NPCTrace(npc, "%s <- EXIT <- Idle\n", obj->name);
     // Cleanup code for leaving Idle state, if any.
 }
 
@@ -522,227 +536,94 @@ void NPCExitIdle(GameObject *obj)
 void NPCEnterAttacking(GameObject *obj)
 {
     NPC *npc = (NPC *)obj;
-    printf("%s -> ENTER -> Attacking\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
+    NPCTrace(npc, "%s -> ENTER -> Attacking\n", obj->name);
     // Initialization code for entering Attacking state, such as setting up attack animations.
-    Rectangle attacking[6] = {
-        {0, 3328, 192, 192},   // Frame 1: Row 53, Column 1
-        {192, 3328, 192, 192}, // Frame 2: Row 53, Column 2
-        {384, 3328, 192, 192}, // Frame 3: Row 53, Column 3
-        {576, 3520, 192, 192}, // Frame 4: Row 53, Column 4
-        {768, 3520, 192, 192}, // Frame 5: Row 53, Column 5
-        {960, 3520, 192, 192}  // Frame 6: Row 53, Column 6
-    };
-
-    // Initialize the idle animation frames and play it
-    InitGameObjectAnimation(&npc->base, attacking, 6, 0.2f);
+    InitGameObjectSharedAnimation(&npc->base, npcAttackingFrames, 6, 0.2f);
+
+    // Open the burst with a ring of projectiles, the burst ends when its timer fires
+    npc->burstTick = 0;
+    SpawnProjectileRing(GetProjectileSystem(), obj->position, NPC_BURST_RING_SIZE, NPC_PROJECTILE_SPEED, 0.0f,
+                        NPC_PROJECTILE_LIFE_TICKS, npc->base.handle, npc->base.faction, NPC_PROJECTILE_DAMAGE);
+    npc->attackTimer = ScheduleTimer(GetTimerService(), obj, EVENT_ATTACK_END, NPC_BURST_TICKS);
 }
 
 // Update function for Attacking state, called repeatedly during game ticks while in Attacking
 void NPCUpdateAttacking(GameObject *obj)
 {
     NPC *npc = (NPC *)obj;
-    printf("%s -> UPDATE -> Attacking\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
+    NPCTrace(npc, "%s -> UPDATE -> Attacking\n", obj->name);
     // During game loop and game ticks, execute Attacking state behavior here, such as dealing damage.
     UpdateAnimation(&obj->animation);
+
+    // Fire a ring every few ticks, each rotated by half a gap so the burst spirals
+    npc->burstTick++;
+    if (npc->burstTick % NPC_BURST_INTERVAL_TICKS == 0)
+    {
+        int ring = npc->burstTick / NPC_BURST_INTERVAL_TICKS;
+        float angleOffset = ring * PI / NPC_BURST_RING_SIZE;
+        SpawnProjectileRing(GetProjectileSystem(), obj->position, NPC_BURST_RING_SIZE, NPC_PROJECTILE_SPEED, angleOffset,
+                            NPC_PROJECTILE_LIFE_TICKS, npc->base.handle, npc->base.faction, NPC_PROJECTILE_DAMAGE);
+    }
 }
 
 // Exit function for Attacking state, executed once upon leaving Attacking
 void NPCExitAttacking(GameObject *obj)
 {
     NPC *npc = (NPC *)obj;
-    printf("%s <- EXIT <- Attacking\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
+    NPCTrace(npc, "%s <- EXIT <- Attacking\n", obj->name);
     // Cleanup code for leaving Attacking state, such as resetting attack cooldown.
     UpdateAnimation(&obj->animation);
-}
 
-void NPCEnterMovingUp(GameObject *obj)
-{
-    NPC *npc = (NPC *)obj;
-    printf("\n%s -> ENTER -> Moving Up\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
-
-    // Moving Up
-    Rectangle walkUp[9] = {
-        {0, 512, 64, 64},   // Frame 1: Row 8, Column 1
-        {64, 512, 64, 64},  // Frame 2: Row 8, Column 2
-        {128, 512, 64, 64}, // Frame 3: Row 8, Column 3
-        {192, 512, 64, 64}, // Frame 4: Row 8, Column 4
-        {256, 512, 64, 64}, // Frame 5: Row 8, Column 5
-        {320, 512, 64, 64}, // Frame 6: Row 8, Column 6
-        {384, 512, 64, 64}, // Frame 7: Row 8, Column 7
-        {448, 512, 64, 64}, // Frame 8: Row 8, Column 8
-        {512, 512, 64, 64}  // Frame 9: Row 8, Column 9
-    };
-    InitGameObjectAnimation(&npc->base, walkUp, 9, 0.1f);
-    obj->velocity.x = 0;
-    obj->velocity.y = -1;
+    // Stop the burst (e.g. when killed mid burst) and rest before the next one
+    CancelTimer(GetTimerService(), &npc->attackTimer);
+    npc->fireCooldown = ScheduleTimer(GetTimerService(), NULL, EVENT_NONE, NPC_FIRE_COOLDOWN_TICKS);
 }
 
-void NPCUpdateMovingUp(GameObject *obj)
+// Enter function for Moving state, plays the walk clip facing the velocity
+void NPCEnterMoving(GameObject *obj)
 {
     NPC *npc = (NPC *)obj;
-    printf("\n%s -> UPDATE -> Moving Up\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
-    
-    NPCMove(npc, &obj->velocity);
-    UpdateAnimation(&obj->animation);
-}
+    NPCTrace(npc, "\n%s -> ENTER -> Moving\n", obj->name);
 
-void NPCExitMovingUp(GameObject *obj)
-{
-    NPC *npc = (NPC *)obj;
-    printf("\n%s <- EXIT <- Moving Up\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
+    // One row of the sheet per facing, NPCFaceMoveDirection swaps the row
+    InitGameObjectSharedAnimation(&npc->base, NPCWalkFrames(obj->velocity), NPC_WALK_FRAMES, 0.1f);
 }
 
-void NPCEnterMovingDown(GameObject *obj)
+// Update function for Moving state, walks along the velocity
+void NPCUpdateMoving(GameObject *obj)
 {
     NPC *npc = (NPC *)obj;
-    printf("\n%s -> ENTER -> Moving Down\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
-
-    // Moving Down
-    Rectangle walkDown[9] = {
-        {0, 640, 64, 64},   // Frame 0
-        {64, 640, 64, 64},  // Frame 1
-        {128, 640, 64, 64}, // Frame 2
-        {192, 640, 64, 64}, // Frame 3
-        {256, 640, 64, 64}, // Frame 4
-        {320, 640, 64, 64}, // Frame 5
-        {384, 640, 64, 64}, // Frame 6
-        {448, 640, 64, 64}, // Frame 7
-        {512, 640, 64, 64}  // Frame 8
-    };
-    InitGameObjectAnimation(&npc->base, walkDown, 9, 0.1f);
-    obj->velocity.x = 0;
-    obj->velocity.y = 1;
-}
-
-void NPCUpdateMovingDown(GameObject *obj)
-{
-    NPC *npc = (NPC *)obj;
-    printf("\n%s -> UPDATE -> Moving Down\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
+    NPCTrace(npc, "\n%s -> UPDATE -> Moving\n", obj->name);
 
     NPCMove(npc, &obj->velocity);
     UpdateAnimation(&obj->animation);
 }
 
-void NPCExitMovingDown(GameObject *obj)
-{
-    NPC *npc = (NPC *)obj;
-    printf("\n%s <- EXIT <- Moving Down\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
-}
-
-void NPCEnterMovingLeft(GameObject *obj)
+// Exit function for Moving state
+void NPCExitMoving(GameObject *obj)
 {
     NPC *npc = (NPC *)obj;
-    printf("\n%s -> ENTER -> Moving Left\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
-    
-    // Moving Left
-    Rectangle walkLeft[9] = {
-        {0, 576, 64, 64},   // Frame 0
-        {64, 576, 64, 64},  // Frame 1
-        {128, 576, 64, 64}, // Frame 2
-        {192, 576, 64, 64}, // Frame 3
-        {256, 576, 64, 64}, // Frame 4
-        {320, 576, 64, 64}, // Frame 5
-        {384, 576, 64, 64}, // Frame 6
-        {448, 576, 64, 64}, // Frame 7
-        {512, 576, 64, 64}  // Frame 8
-    };
-    InitGameObjectAnimation(&npc->base, walkLeft, 9, 0.1f);
-    obj->velocity.x = -1;
-    obj->velocity.y = 0;
-}
-
-void NPCUpdateMovingLeft(GameObject *obj)
-{
-    NPC *npc = (NPC *)obj;
-    printf("\n%s -> UPDATE -> Moving Left\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
-
-    NPCMove(npc, &obj->velocity);
-    UpdateAnimation(&obj->animation);
-}
-
-void NPCExitMovingLeft(GameObject *obj)
-{
-    NPC *npc = (NPC *)obj;
-    printf("\n%s <- EXIT <- Moving Left\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
-}
-
-void NPCEnterMovingRight(GameObject *obj)
-{
-    NPC *npc = (NPC *)obj;
-    printf("\n%s -> ENTER -> Moving Right\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
-
-    // Moving Right
-    Rectangle walkRight[9] = {
-        {0, 704, 64, 64},   // Frame 0
-        {64, 704, 64, 64},  // Frame 1
-        {128, 704, 64, 64}, // Frame 2
-        {192, 704, 64, 64}, // Frame 3
-        {256, 704, 64, 64}, // Frame 4
-        {320, 704, 64, 64}, // Frame 5
-        {384, 704, 64, 64}, // Frame 6
-        {448, 704, 64, 64}, // Frame 7
-        {512, 704, 64, 64}  // Frame 8
-    };
-    InitGameObjectAnimation(&npc->base, walkRight, 9, 0.1f);
-    obj->velocity.x = 1;
-    obj->velocity.y = 0;
-}
-
-void NPCUpdateMovingRight(GameObject *obj)
-{
-    NPC *npc = (NPC *)obj;
-    printf("\n%s -> UPDATE -> Moving Right\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
-
-    NPCMove(npc, &obj->velocity);
-    UpdateAnimation(&obj->animation);
-}
-
-void NPCExitMovingRight(GameObject *obj)
-{
-    NPC *npc = (NPC *)obj;
-    printf("\n%s <- EXIT <- Moving Right\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
+    NPCTrace(npc, "\n%s <- EXIT <- Moving\n", obj->name);
 }
 
 // Enter function for Dead state, executed once upon entering Dead
 void NPCEnterDead(GameObject *obj)
 {
     NPC *npc = (NPC *)obj;
-    printf("%s -> ENTER -> Dead\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
+    NPCTrace(npc, "%s -> ENTER -> Dead\n", obj->name);
     // Initialization code for entering Dead state, such as playing death animation or disabling further actions.
-    Rectangle dead[6] = {
-        {0, 1280, 64, 64},   // Frame 1: Row 21, Column 1
-        {64, 1280, 64, 64},  // Frame 1: Row 21, Column 2
-        {128, 1280, 64, 64}, // Frame 1: Row 21, Column 3
-        {192, 1280, 64, 64}, // Frame 1: Row 21, Column 4
-        {256, 1280, 64, 64}, // Frame 1: Row 21, Column 5
-        {320, 1280, 64, 64}  // Frame 1: Row 21, Column 6
-    };
     // Initialize dead animation
-    InitGameObjectAnimation(&npc->base, dead, 6, 0.2f);
+    InitGameObjectSharedAnimation(&npc->base, npcDeadFrames, 6, 0.2f);
+
+    // Respawn after a while
+    npc->respawnTimer = ScheduleTimer(GetTimerService(), obj, EVENT_RESPAWN, NPC_RESPAWN_TICKS);
 }
 
 // Update function for Dead state, called repeatedly during game ticks while in Dead
 void NPCUpdateDead(GameObject *obj)
 {
     NPC *npc = (NPC *)obj;
-    printf("%s -> UPDATE -> Dead\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
+    NPCTrace(npc, "%s -> UPDATE -> Dead\n", obj->name);
     // During game loop and game ticks, execute Dead state behavior here, such as preventing any actions.
     // This could be a place to check if the NPC should be removed or respawned.
     UpdateAnimation(&obj->animation);
@@ -752,16 +633,21 @@ void NPCUpdateDead(GameObject *obj)
 void NPCExitDead(GameObject *obj)
 {
     NPC *npc = (NPC *)obj;
-    printf("%s -> EXIT -> Dead\n", obj->name);
-    printf("Aggression: %d\n\n", npc->aggression);
+    NPCTrace(npc, "%s -> EXIT -> Dead\n", obj->name);
     // Cleanup code for leaving Dead state, such as removing NPC from the active world, playing respawn animations, etc.
+    CancelTimer(GetTimerService(), &npc->respawnTimer);
+
+    // Respawn at the NPC spawn point with full health
+    SetGameObjectPosition(obj, (Vector2){450, 450});
+    obj->health = 100;
 }
 
 // Common movement function to handle state and animation transitions
 void NPCMove(NPC *npc, Vector2* moveDirection)
 {
-    npc->base.position.x += moveDirection->x;
-    npc->base.position.y += moveDirection->y;
+    // Status effects (slow, stun) scale the movement
+    npc->base.position.x += moveDirection->x * npc->base.speedScale;
+    npc->base.position.y += moveDirection->y * npc->base.speedScale;
 
     // Update Collider
     npc->base.collider.p.x = npc->base.position.x;
@@ -0,0 +1,327 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/utils/perception.h"
+
+static int TileCoordinate(float value)
+{
+    return (int)floorf(value / PERCEPTION_TILE);
+}
+
+// Packs a tile into a single int for cheap cache comparisons
+static int PackTile(Vector2 position)
+{
+    return (int)(((unsigned int)TileCoordinate(position.y) << 16) ^ ((unsigned int)TileCoordinate(position.x) & 0xFFFFu));
+}
+
+static bool TileBlocked(const Perception *perception, int tileX, int tileY)
+{
+    if (tileX < 0 || tileY < 0 || tileX >= perception->width || tileY >= perception->height)
+    {
+        return false;
+    }
+
+    return perception->blocked[tileY * perception->width + tileX] != 0;
+}
+
+// Quantises a facing direction into one of 8 octants
+static uint8_t FacingOctant(Vector2 direction)
+{
+    float angle = atan2f(direction.y, direction.x);
+    int octant = (int)floorf(angle / (PI / 4.0f) + 0.5f);
+    return (uint8_t)(octant & 7);
+}
+
+/**
+ * InitPerception - Allocates an open level and the perception caches.
+ *
+ * @perception:  The perception to initialise.
+ * @width:       Tiles across.
+ * @height:      Tiles down.
+ * @maxEntities: Entity indices of observers stay below this.
+ */
+void InitPerception(Perception *perception, int width, int height, int maxEntities)
+{
+    memset(perception, 0, sizeof(Perception));
+
+    perception->blocked = (uint8_t *)calloc((size_t)width * height, sizeof(uint8_t));
+    perception->cache = (PerceptionCache *)calloc(maxEntities, sizeof(PerceptionCache));
+
+    if (!perception->blocked || !perception->cache)
+    {
+        fprintf(stderr, "Failed to allocate perception\n");
+        exit(1);
+    }
+
+    perception->width = width;
+    perception->height = height;
+    perception->cacheCapacity = maxEntities;
+}
+
+/**
+ * AddPerceptionWall - Marks the tiles under a rectangle as blocking.
+ *
+ * @perception: The perception.
+ * @wall:       The wall in world units.
+ *
+ * Cached results are dropped, the geometry they were computed against changed.
+ */
+void AddPerceptionWall(Perception *perception, Rectangle wall)
+{
+    int minX = TileCoordinate(wall.x);
+    int minY = TileCoordinate(wall.y);
+    int maxX = TileCoordinate(wall.x + wall.width - 1.0f);
+    int maxY = TileCoordinate(wall.y + wall.height - 1.0f);
+
+    for (int tileY = minY; tileY <= maxY; tileY++)
+    {
+        for (int tileX = minX; tileX <= maxX; tileX++)
+        {
+            if (tileX >= 0 && tileY >= 0 && tileX < perception->width && tileY < perception->height)
+            {
+                perception->blocked[tileY * perception->width + tileX] = 1;
+            }
+        }
+    }
+
+    for (int i = 0; i < perception->cacheCapacity; i++)
+    {
+        perception->cache[i].valid = false;
+    }
+}
+
+/**
+ * IsTileBlocked - Checks whether the tile under a position blocks sight.
+ *
+ * @perception: The perception.
+ * @position:   A position in world units.
+ *
+ * Return: true if the tile is a wall.
+ */
+bool IsTileBlocked(const Perception *perception, Vector2 position)
+{
+    return TileBlocked(perception, TileCoordinate(position.x), TileCoordinate(position.y));
+}
+
+/**
+ * HasLineOfSight - Checks that no wall lies between two points.
+ *
+ * @perception: The perception.
+ * @from:       Start of the ray.
+ * @to:         End of the ray.
+ *
+ * Steps through every tile the segment passes, one tile boundary at a time
+ * (Amanatides and Woo), so the cost is the number of tiles crossed.
+ *
+ * Return: true if no tile along the segment blocks sight.
+ */
+bool HasLineOfSight(const Perception *perception, Vector2 from, Vector2 to)
+{
+    int tileX = TileCoordinate(from.x);
+    int tileY = TileCoordinate(from.y);
+    int endX = TileCoordinate(to.x);
+    int endY = TileCoordinate(to.y);
+
+    float dx = to.x - from.x;
+    float dy = to.y - from.y;
+
+    int stepX = dx > 0.0f ? 1 : -1;
+    int stepY = dy > 0.0f ? 1 : -1;
+
+    // Distance along the ray (0..1) to cross one tile, and to the first boundary
+    float deltaX = dx != 0.0f ? fabsf(PERCEPTION_TILE / dx) : INFINITY;
+    float deltaY = dy != 0.0f ? fabsf(PERCEPTION_TILE / dy) : INFINITY;
+
+    float boundaryX = (tileX + (stepX > 0 ? 1 : 0)) * PERCEPTION_TILE;
+    float boundaryY = (tileY + (stepY > 0 ? 1 : 0)) * PERCEPTION_TILE;
+    float nextX = dx != 0.0f ? (boundaryX - from.x) / dx : INFINITY;
+    float nextY = dy != 0.0f ? (boundaryY - from.y) / dy : INFINITY;
+
+    while (true)
+    {
+        if (TileBlocked(perception, tileX, tileY))
+        {
+            return false;
+        }
+
+        if (tileX == endX && tileY == endY)
+        {
+            return true;
+        }
+
+        if (nextX < nextY)
+        {
+            if (nextX > 1.0f)
+            {
+                return true; // Rounding left the end tile unreached, the segment is over
+            }
+            tileX += stepX;
+            nextX += deltaX;
+        }
+        else
+        {
+            if (nextY > 1.0f)
+            {
+                return true;
+            }
+            tileY += stepY;
+            nextY += deltaY;
+        }
+    }
+}
+
+/**
+ * UpdatePerception - Refreshes what each observer knows about its target.
+ *
+ * @perception: The perception.
+ * @observers:  The observers (normally the squad leaders).
+ * @targets:    What each observer is looking for (the nearest hostile), NULL
+ *              when it has nothing to look for.
+ * @count:      Number of observers.
+ *
+ * Observers face the way they last moved. An observer sees the target when it
+ * is within range, inside the vision cone (or very close) and no wall lies
+ * between them. Results are reused until the observer or the target crosses
+ * into another tile, the observer turns or picks another target, so a
+ * standing crowd costs a few compares per observer.
+ */
+void UpdatePerception(Perception *perception, GameObject **observers, GameObject **targets, int count)
+{
+    perception->recomputed = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        const GameObject *obj = observers[i];
+        const GameObject *target = targets[i];
+
+        if (obj->entity < 0 || obj->entity >= perception->cacheCapacity)
+        {
+            continue;
+        }
+
+        PerceptionCache *cache = &perception->cache[obj->entity];
+
+        // Facing follows movement, standing still keeps the last facing
+        uint8_t facing = cache->facing;
+        if (obj->velocity.x != 0.0f || obj->velocity.y != 0.0f)
+        {
+            cache->direction = obj->velocity;
+            facing = FacingOctant(obj->velocity);
+        }
+        else if (!cache->valid)
+        {
+            cache->direction = (Vector2){0.0f, 1.0f}; // Sprites start facing down
+            facing = FacingOctant(cache->direction);
+        }
+
+        if (target == NULL)
+        {
+            // Nothing to see, recomputed once a target turns up
+            cache->valid = true;
+            cache->facing = facing;
+            cache->target = -1;
+            cache->visible = false;
+            continue;
+        }
+
+        int observerTile = PackTile(obj->position);
+        int targetTile = PackTile(target->position);
+
+        if (cache->valid && cache->observerTile == observerTile && cache->target == target->entity &&
+            cache->targetTile == targetTile && cache->facing == facing)
+        {
+            continue;
+        }
+
+        cache->valid = true;
+        cache->observerTile = observerTile;
+        cache->target = target->entity;
+        cache->targetTile = targetTile;
+        cache->facing = facing;
+        perception->recomputed++;
+
+        float dx = target->position.x - obj->position.x;
+        float dy = target->position.y - obj->position.y;
+        float distanceSquared = dx * dx + dy * dy;
+
+        if (distanceSquared > PERCEPTION_RANGE * PERCEPTION_RANGE)
+        {
+            cache->visible = false;
+            continue;
+        }
+
+        // Inside the cone when the angle to the target is within the half angle
+        float facingLength = sqrtf(cache->direction.x * cache->direction.x + cache->direction.y * cache->direction.y);
+        float along = (dx * cache->direction.x + dy * cache->direction.y) / facingLength;
+        bool inCone = along >= PERCEPTION_CONE_COS * sqrtf(distanceSquared);
+        bool nearby = distanceSquared <= PERCEPTION_NEAR_RADIUS * PERCEPTION_NEAR_RADIUS;
+
+        cache->visible = (inCone || nearby) && HasLineOfSight(perception, obj->position, target->position);
+    }
+}
+
+/**
+ * CanSeeTarget - Returns what an observer concluded in the last update.
+ *
+ * @perception: The perception.
+ * @observer:   The observer.
+ *
+ * Return: true if the observer saw the target.
+ */
+bool CanSeeTarget(const Perception *perception, const GameObject *observer)
+{
+    if (observer->entity < 0 || observer->entity >= perception->cacheCapacity)
+    {
+        return false;
+    }
+
+    const PerceptionCache *cache = &perception->cache[observer->entity];
+    return cache->valid && cache->visible;
+}
+
+/**
+ * MovePerceptionCache - Follows an observer to a new entity index.
+ *
+ * @perception: The perception.
+ * @from:       The entity index the observer had.
+ * @to:         Its new entity index, whoever had it left the world.
+ *
+ * Caches of observers watching either index are recomputed on their next
+ * update. Moving an index onto itself forgets it.
+ */
+void MovePerceptionCache(Perception *perception, int from, int to)
+{
+    if (from < 0 || from >= perception->cacheCapacity || to < 0 || to >= perception->cacheCapacity)
+    {
+        return;
+    }
+
+    PerceptionCache cache = perception->cache[from];
+    perception->cache[from].valid = false;
+    if (from != to)
+    {
+        perception->cache[to] = cache;
+    }
+
+    for (int i = 0; i < perception->cacheCapacity; i++)
+    {
+        if (perception->cache[i].target == from || perception->cache[i].target == to)
+        {
+            perception->cache[i].valid = false;
+        }
+    }
+}
+
+/**
+ * FreePerception - Frees the level and caches.
+ *
+ * @perception: The perception to free.
+ */
+void FreePerception(Perception *perception)
+{
+    free(perception->blocked);
+    free(perception->cache);
+    memset(perception, 0, sizeof(Perception));
+}
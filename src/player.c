@@ -1,4 +1,5 @@
 #include "../include/gameobjects/player.h"
+#include "../include/utils/constants.h"
 
 // Initialize a new Player object with a given name
 /**
@@ -26,8 +27,8 @@ Player *InitPlayer(const char *name)
         exit(1);
     }
 
-    // Load player texture
-    Texture2D playerTexture = LoadTexture("./assets/player_sprite_sheet.png");
+    // Load player texture, every player shares it
+    Texture2D playerTexture = AcquireTexture(GetAssetCache(), PLAYER_SPRITE_SHEET);
 
     InitGameObject(&player->base,
                    name,                                                         // Name
@@ -50,12 +51,13 @@ Player *InitPlayer(const char *name)
     player->mana = 100.0f;
 
     player->rolling = false;
-    player->rollTimer = 0;
+    player->rollTimer = (TimerId){0, 0};
     player->ROLL_DURATION = 20;
 
     // Attacking Variables
     player->attacking = false;
-    player->attackTimer = 0;
+    player->attackTimer = (TimerId){0, 0};
+    player->fireCooldown = (TimerId){0, 0};
     player->ATTACK_DURATION = 40;
 
     player->attackArea.p.x = player->base.position.x;
@@ -93,9 +95,25 @@ void DeletePlayer(GameObject *obj)
     // If the player is holding a dynamically allocated object, such as a Shield:
     // free(player->holding);
     // Perform any player-specific cleanup here
+    ReleaseTexture(GetAssetCache(), obj->keyframes);
     DeleteGameObject(obj);
 }
 
+/**
+ * PlayerCanAttack - Checks whether the player may start an attack.
+ *
+ * @player: The player wanting to attack.
+ *
+ * An attack is blocked while the fire cooldown started by the previous
+ * attack (COMMAND_FIRE_COOLDOWN) is still pending on the timer service.
+ *
+ * Return: true if the player may attack.
+ */
+bool PlayerCanAttack(const Player *player)
+{
+    return !IsTimerPending(GetTimerService(), player->fireCooldown);
+}
+
 /**
  * InitPlayerFSM - Initializes the Finite State Machine (FSM) for the Player.
  *
@@ -104,6 +122,10 @@ void DeletePlayer(GameObject *obj)
  * This function sets up the state machine for the Player, allocating memory for
  * state configurations, defining valid state transitions, and associating
  * state handler functions with each state.
+ *
+ * Moving (idle, walking, rolling, dead, respawn) is the locomotion layer and
+ * attacking and shielding the action layer, so the player can attack while
+ * walking without a combined walking-attacking state.
  */
 void InitPlayerFSM(GameObject *obj)
 {
@@ -116,7 +138,7 @@ void InitPlayerFSM(GameObject *obj)
 
     // ---- STATE_IDLE state configuration ----
     // Define valid transitions from STATE_IDLE
-    State idleValidTransitions[] = {STATE_WALKING, STATE_ATTACKING, STATE_ROLLING, STATE_SHIELD, STATE_DEAD};
+    State idleValidTransitions[] = {STATE_WALKING, STATE_ROLLING, STATE_DEAD};
 
     // Set up the state configuration for STATE_IDLE
     obj->stateConfigs[STATE_IDLE].name = "Player_Idle";
@@ -130,7 +152,7 @@ void InitPlayerFSM(GameObject *obj)
 
     // ---- STATE_WALKING state configuration ----
     // Define valid transitions from STATE_WALKING
-    State walkingValidTransitions[] = {STATE_IDLE, STATE_ATTACKING, STATE_ROLLING, STATE_DEAD};
+    State walkingValidTransitions[] = {STATE_IDLE, STATE_ROLLING, STATE_DEAD};
 
     // Set up the state configuration for STATE_WALKING
     obj->stateConfigs[STATE_WALKING].name = "Player_Walking";
@@ -144,7 +166,7 @@ void InitPlayerFSM(GameObject *obj)
 
     // ---- STATE_ROLLING state configuration ----
     // Define valid transitions from STATE_ROLLING
-    State rollValidTransitions[] = {STATE_IDLE};
+    State rollValidTransitions[] = {STATE_IDLE, STATE_DEAD};
 
     // Set up the state configuration for STATE_ROLLING
     obj->stateConfigs[STATE_ROLLING].name = "Player_Rolling";
@@ -156,34 +178,6 @@ void InitPlayerFSM(GameObject *obj)
     // Configure valid transitions for STATE_ROLLING
     StateTransitions(&obj->stateConfigs[STATE_ROLLING], rollValidTransitions, sizeof(rollValidTransitions) / sizeof(State));
 
-    // ---- STATE_ATTACKING state configuration ----
-    // Define valid transitions from STATE_ATTACKING
-    State attackValidTransitions[] = {STATE_IDLE, STATE_DEAD};
-
-    // Set up the state configuration for STATE_ATTACKING
-    obj->stateConfigs[STATE_ATTACKING].name = "Player_Attacking";
-    obj->stateConfigs[STATE_ATTACKING].HandleEvent = PlayerAttackingHandleEvent;
-    obj->stateConfigs[STATE_ATTACKING].Entry = PlayerEnterAttacking;
-    obj->stateConfigs[STATE_ATTACKING].Update = PlayerUpdateAttacking;
-    obj->stateConfigs[STATE_ATTACKING].Exit = PlayerExitAttacking;
-
-    // Configure valid transitions for STATE_ATTACKING
-    StateTransitions(&obj->stateConfigs[STATE_ATTACKING], attackValidTransitions, sizeof(attackValidTransitions) / sizeof(State));
-
-    // ---- STATE_SHIELD state configuration ----
-    // Define valid transitions from STATE_SHIELD
-    State sheildingValidTransitions[] = {STATE_IDLE, STATE_DEAD};
-
-    // Set up the state configuration for STATE_SHIELD
-    obj->stateConfigs[STATE_SHIELD].name = "Player_Shielding";
-    obj->stateConfigs[STATE_SHIELD].HandleEvent = PlayerShieldingHandleEvent;
-    obj->stateConfigs[STATE_SHIELD].Entry = PlayerEnterShielding;
-    obj->stateConfigs[STATE_SHIELD].Update = PlayerUpdateShielding;
-    obj->stateConfigs[STATE_SHIELD].Exit = PlayerExitShielding;
-
-    // Configure valid transitions for STATE_SHIELD
-    StateTransitions(&obj->stateConfigs[STATE_SHIELD], sheildingValidTransitions, sizeof(sheildingValidTransitions) / sizeof(State));
-
     // ---- STATE_DEAD state configuration ----
     // Define valid transitions from STATE_DEAD
     State deadValidTransitions[] = {STATE_RESPAWN};
@@ -217,49 +211,79 @@ void InitPlayerFSM(GameObject *obj)
 #define EMPTY_STATE_CONFIG \
     (StateConfig){NULL, NULL, NULL, NULL, NULL, NULL, 0}
     obj->stateConfigs[STATE_COLLISION] = EMPTY_STATE_CONFIG;
+
+    // Attacking and shielding belong to the action layer
+    obj->stateConfigs[STATE_ATTACKING] = EMPTY_STATE_CONFIG;
+    obj->stateConfigs[STATE_SHIELD] = EMPTY_STATE_CONFIG;
+
+    // ---- Action layer, states it does not use stay empty ----
+    StateConfig *actionConfigs = (StateConfig *)calloc(STATE_COUNT, sizeof(StateConfig));
+    if (!actionConfigs)
+    {
+        fprintf(stderr, "Failed to allocate action state configs\n");
+        exit(1);
+    }
+
+    // ---- STATE_IDLE action configuration (hands free) ----
+    // Define valid transitions from a free action layer
+    State readyValidTransitions[] = {STATE_ATTACKING, STATE_SHIELD};
+
+    // Set up the state configuration for the free action layer
+    actionConfigs[STATE_IDLE].name = "Player_Ready";
+    actionConfigs[STATE_IDLE].HandleEvent = PlayerReadyHandleEvent;
+    actionConfigs[STATE_IDLE].Entry = PlayerEnterReady;
+
+    // Configure valid transitions for the free action layer
+    StateTransitions(&actionConfigs[STATE_IDLE], readyValidTransitions, sizeof(readyValidTransitions) / sizeof(State));
+
+    // ---- STATE_ATTACKING state configuration ----
+    // Define valid transitions from STATE_ATTACKING
+    State attackValidTransitions[] = {STATE_IDLE};
+
+    // Set up the state configuration for STATE_ATTACKING
+    actionConfigs[STATE_ATTACKING].name = "Player_Attacking";
+    actionConfigs[STATE_ATTACKING].HandleEvent = PlayerAttackingHandleEvent;
+    actionConfigs[STATE_ATTACKING].Entry = PlayerEnterAttacking;
+    actionConfigs[STATE_ATTACKING].Update = PlayerUpdateAttacking;
+    actionConfigs[STATE_ATTACKING].Exit = PlayerExitAttacking;
+
+    // Configure valid transitions for STATE_ATTACKING
+    StateTransitions(&actionConfigs[STATE_ATTACKING], attackValidTransitions, sizeof(attackValidTransitions) / sizeof(State));
+
+    // ---- STATE_SHIELD state configuration ----
+    // Define valid transitions from STATE_SHIELD
+    State sheildingValidTransitions[] = {STATE_IDLE};
+
+    // Set up the state configuration for STATE_SHIELD
+    actionConfigs[STATE_SHIELD].name = "Player_Shielding";
+    actionConfigs[STATE_SHIELD].HandleEvent = PlayerShieldingHandleEvent;
+    actionConfigs[STATE_SHIELD].Entry = PlayerEnterShielding;
+    actionConfigs[STATE_SHIELD].Update = PlayerUpdateShielding;
+    actionConfigs[STATE_SHIELD].Exit = PlayerExitShielding;
+
+    // Configure valid transitions for STATE_SHIELD
+    StateTransitions(&actionConfigs[STATE_SHIELD], sheildingValidTransitions, sizeof(sheildingValidTransitions) / sizeof(State));
+
+    InitFsmLayer(obj, FSM_LAYER_ACTION, actionConfigs, STATE_IDLE);
 }
 
 // Handles events for the Player when in the Idle state
-void PlayerIdleHandleEvent(GameObject *obj, Event event)
+void PlayerIdleHandleEvent(GameObject *obj, const EventData *event)
 {
     // Player *player = (Player *)obj;
     // printf("\n%s Idle HandleEvent\n", obj->name);
     // printf("Stamina: %.1f, Mana: %.1f\n\n", player->stamina, player->mana);
 
-    switch (event)
+    switch (event->type)
     {
     case EVENT_MOVE_UP:
-        // Transition back to Idle if no specific event is triggered
-        obj->velocity.x = 0;
-        obj->velocity.y = -1;
-        ChangeState(obj, STATE_WALKING);
-        break;
     case EVENT_MOVE_DOWN:
-        // Transition back to Idle if no specific event is triggered
-        obj->velocity.x = 0;
-        obj->velocity.y = 1;
-        ChangeState(obj, STATE_WALKING);
-        break;
     case EVENT_MOVE_LEFT:
-        // Transition back to Idle if no specific event is triggered
-        obj->velocity.x = -1;
-        obj->velocity.y = 0;
-        ChangeState(obj, STATE_WALKING);
-        break;
     case EVENT_MOVE_RIGHT:
-        // Transition back to Idle if no specific event is triggered
-        obj->velocity.x = 1;
-        obj->velocity.y = 0;
+        // Walk the way the event points, entering Walking picks the clip from it
+        obj->velocity = event->direction;
         ChangeState(obj, STATE_WALKING);
         break;
-    case EVENT_ATTACK:
-        // Transition to Attacking state if an attack event is received
-        ChangeState(obj, STATE_ATTACKING);
-        break;
-    case EVENT_DEFEND:
-        // Transition to Shielding state if a defend event is received
-        ChangeState(obj, STATE_SHIELD);
-        break;
     case EVENT_DIE:
         // Transition to Dead state if a die event is received
         ChangeState(obj, STATE_DEAD);
@@ -270,33 +294,33 @@ void PlayerIdleHandleEvent(GameObject *obj, Event event)
     case EVENT_NONE:
         obj->previousState = obj->currentState;
         break;
-    // Ignore Events for other cases
+    // Ignore Events for other cases (attacking and shielding are the action layer's)
+    case EVENT_ATTACK:
+    case EVENT_DEFEND:
     case EVENT_RESPAWN:
     case EVENT_MOVE:
     case EVENT_COLLISION_START:
     case EVENT_COLLISION_END:
+    case EVENT_ROLL_END:
+    case EVENT_ATTACK_END:
     case EVENT_COUNT:
         break;
     }
 }
 
 // Handles events for the Player when in the Walking state
-void PlayerWalkingHandleEvent(GameObject *obj, Event event)
+void PlayerWalkingHandleEvent(GameObject *obj, const EventData *event)
 {
     Player *player = (Player *)obj;
     printf("%s Walking HandleEvent\n", obj->name);
     printf("Stamina: %.1f, Mana: %.1f\n\n", player->stamina, player->mana);
 
-    switch (event)
+    switch (event->type)
     {
     case EVENT_NONE:
         // Transition back to Idle if no specific event is triggered
         ChangeState(obj, STATE_IDLE);
         break;
-    case EVENT_ATTACK:
-        // Transition to Attacking state if an attack event is received
-        ChangeState(obj, STATE_ATTACKING);
-        break;
     case EVENT_DIE:
         // Transition to Dead state if a die event is received
         ChangeState(obj, STATE_DEAD);
@@ -304,7 +328,8 @@ void PlayerWalkingHandleEvent(GameObject *obj, Event event)
     case EVENT_ROLL:
         ChangeState(obj, STATE_ROLLING);
         break;
-    // Ignore Events for other cases
+    // Ignore Events for other cases (the action layer attacks while walking)
+    case EVENT_ATTACK:
     case EVENT_MOVE_UP:
     case EVENT_MOVE_DOWN:
     case EVENT_MOVE:
@@ -314,21 +339,38 @@ void PlayerWalkingHandleEvent(GameObject *obj, Event event)
     case EVENT_RESPAWN:
     case EVENT_COLLISION_START:
     case EVENT_COLLISION_END:
+    case EVENT_ROLL_END:
+    case EVENT_ATTACK_END:
     case EVENT_COUNT:
         break;
     }
 }
 
-void PlayerRollingHandleEvent(GameObject *obj, Event event)
+void PlayerRollingHandleEvent(GameObject *obj, const EventData *event)
 {
     Player *player = (Player *)obj;
     printf("%s Walking HandleEvent\n", obj->name);
     printf("Stamina: %.1f, Mana: %.1f\n\n", player->stamina, player->mana);
 
+    // The roll ends when its timer fires
+    if (event->type == EVENT_ROLL_END)
+    {
+        player->rolling = false;
+        ChangeState(obj, STATE_IDLE);
+        return;
+    }
+
+    // Death is only announced once, so it interrupts the roll
+    if (event->type == EVENT_DIE)
+    {
+        ChangeState(obj, STATE_DEAD);
+        return;
+    }
+
     // While rolling you cant swap states
     if (!player->rolling)
     {
-        switch (event)
+        switch (event->type)
         {
         case EVENT_NONE:
             // Transition back to Idle if no specific event is triggered
@@ -363,65 +405,82 @@ void PlayerRollingHandleEvent(GameObject *obj, Event event)
         case EVENT_RESPAWN:
         case EVENT_COLLISION_START:
         case EVENT_COLLISION_END:
+        case EVENT_ROLL_END:
+        case EVENT_ATTACK_END:
         case EVENT_COUNT:
             break;
         }
     }
 }
 
+// Handles events of the action layer while the player's hands are free
+void PlayerReadyHandleEvent(GameObject *obj, const EventData *event)
+{
+    // Only a player standing or walking can start an action
+    if (obj->currentState != STATE_IDLE && obj->currentState != STATE_WALKING)
+    {
+        return;
+    }
+
+    switch (event->type)
+    {
+    case EVENT_ATTACK:
+        // Transition to Attacking state if an attack event is received (and not cooling down)
+        if (PlayerCanAttack((Player *)obj))
+        {
+            ChangeLayerState(obj, FSM_LAYER_ACTION, STATE_ATTACKING);
+        }
+        break;
+    case EVENT_DEFEND:
+        // Transition to Shielding state if a defend event is received
+        ChangeLayerState(obj, FSM_LAYER_ACTION, STATE_SHIELD);
+        break;
+    // Ignore Events for other cases
+    case EVENT_NONE:
+    case EVENT_MOVE_UP:
+    case EVENT_MOVE_DOWN:
+    case EVENT_MOVE_LEFT:
+    case EVENT_MOVE_RIGHT:
+    case EVENT_MOVE:
+    case EVENT_ROLL:
+    case EVENT_DIE:
+    case EVENT_RESPAWN:
+    case EVENT_COLLISION_START:
+    case EVENT_COLLISION_END:
+    case EVENT_ROLL_END:
+    case EVENT_ATTACK_END:
+    case EVENT_COUNT:
+        break;
+    }
+}
+
 // Handles events for the Player when in the Attacking state
-void PlayerAttackingHandleEvent(GameObject *obj, Event event)
+void PlayerAttackingHandleEvent(GameObject *obj, const EventData *event)
 {
     Player *player = (Player *)obj;
     printf("\n%s Attacking HandleEvent\n", obj->name);
     printf("Stamina: %.1f, Mana: %.1f\n\n", player->stamina, player->mana);
-    
-    if (!player->attacking)
+
+    // The attack ends when its timer fires, dying interrupts it (the locomotion layer handles the death)
+    if (event->type == EVENT_ATTACK_END || event->type == EVENT_DIE)
     {
-        switch (event)
-        {
-        case EVENT_NONE:
-            // Transition back to Idle if no specific event is triggered
-            ChangeState(obj, STATE_IDLE);
-            break;
-        case EVENT_DIE:
-            // Transition to Dead state if a die event is received
-            ChangeState(obj, STATE_DEAD);
-            break;
-        // Ignore Events for other cases
-        case EVENT_MOVE_UP:
-        case EVENT_ROLL:
-        case EVENT_MOVE_DOWN:
-        case EVENT_MOVE_LEFT:
-        case EVENT_MOVE_RIGHT:
-        case EVENT_ATTACK:
-        case EVENT_DEFEND:
-        case EVENT_RESPAWN:
-        case EVENT_MOVE:
-        case EVENT_COLLISION_START:
-        case EVENT_COLLISION_END:
-        case EVENT_COUNT:
-            break;
-        }
+        ChangeLayerState(obj, FSM_LAYER_ACTION, STATE_IDLE);
     }
 }
 
 // Handles events for the Player when in the Shielding state
-void PlayerShieldingHandleEvent(GameObject *obj, Event event)
+void PlayerShieldingHandleEvent(GameObject *obj, const EventData *event)
 {
     Player *player = (Player *)obj;
     printf("\n%s Sheilding HandleEvent\n", obj->name);
     printf("Stamina: %.1f, Mana: %.1f\n\n", player->stamina, player->mana);
 
-    switch (event)
+    switch (event->type)
     {
     case EVENT_NONE:
-        // Transition back to Idle if no specific event is triggered
-        ChangeState(obj, STATE_IDLE);
-        break;
     case EVENT_DIE:
-        // Transition to Dead state if a die event is received
-        ChangeState(obj, STATE_DEAD);
+        // Lower the shield once the defend input stops or the player dies
+        ChangeLayerState(obj, FSM_LAYER_ACTION, STATE_IDLE);
         break;
     // Ignore Events for other cases
     case EVENT_MOVE_UP:
@@ -435,13 +494,15 @@ void PlayerShieldingHandleEvent(GameObject *obj, Event event)
     case EVENT_MOVE:
     case EVENT_COLLISION_START:
     case EVENT_COLLISION_END:
+    case EVENT_ROLL_END:
+    case EVENT_ATTACK_END:
     case EVENT_COUNT:
         break;
     }
 }
 
 // Handles events for the Player when in the Die state
-void PlayerDieHandleEvent(GameObject *obj, Event event)
+void PlayerDieHandleEvent(GameObject *obj, const EventData *event)
 {
     Player *player = (Player *)obj;
     printf("\n%s Die HandleEvent\n", obj->name);
@@ -451,7 +512,7 @@ void PlayerDieHandleEvent(GameObject *obj, Event event)
 }
 
 // Handles events for the Player when in the Respawn state
-void PlayerRespawnHandleEvent(GameObject *obj, Event event)
+void PlayerRespawnHandleEvent(GameObject *obj, const EventData *event)
 {
     Player *player = (Player *)obj;
     printf("\n%s Die HandleEvent\n", obj->name);
@@ -463,8 +524,9 @@ void PlayerRespawnHandleEvent(GameObject *obj, Event event)
 // Common movement function to handle state and animation transitions
 void PlayerMove(Player *player, Vector2* moveDirection)
 {
-    player->base.position.x += moveDirection->x;
-    player->base.position.y += moveDirection->y;
+    // Status effects (slow, stun) scale the movement
+    player->base.position.x += moveDirection->x * player->base.speedScale;
+    player->base.position.y += moveDirection->y * player->base.speedScale;
 
     // Update Collider
     player->base.collider.p.x = player->base.position.x;
@@ -610,7 +672,9 @@ void PlayerEnterIdle(GameObject *obj)
     printf("\n%s -> ENTER -> Idle\n", obj->name);
     printf("Stamina: %.1f, Mana: %.1f\n\n", player->stamina, player->mana);
 
-    if (player->base.previousState != player->base.currentState && player->base.currentState == STATE_IDLE)
+    // A running action keeps its own clip
+    if (player->base.previousState != player->base.currentState && player->base.currentState == STATE_IDLE &&
+        GetLayerState(obj, FSM_LAYER_ACTION) == STATE_IDLE)
     {
         SelectRandomIdleAnimation(&player->base);
     }
@@ -622,6 +686,13 @@ void PlayerUpdateIdle(GameObject *obj)
     // printf("\n%s -> UPDATE -> Idle\n", obj->name);
     // printf("Stamina: %.1f, Mana: %.1f\n\n", player->stamina, player->mana);
     //  Complete the remainder of the method
+
+    // The action layer animates its own clip while busy
+    if (GetLayerState(obj, FSM_LAYER_ACTION) != STATE_IDLE)
+    {
+        return;
+    }
+
     UpdateAnimation(&obj->animation);
 
     // Check if the animation has finished
@@ -646,6 +717,12 @@ void PlayerEnterWalking(GameObject *obj)
     printf("\n%s -> ENTER -> Walking\n", obj->name);
     printf("Stamina: %.1f, Mana: %.1f\n\n", player->stamina, player->mana);
 
+    // A running action keeps its own clip
+    if (GetLayerState(obj, FSM_LAYER_ACTION) != STATE_IDLE)
+    {
+        return;
+    }
+
     if (obj->velocity.x == 0 && obj->velocity.y == -1)
     {
         // Moving Up Frames Default for moving
@@ -723,7 +800,12 @@ void PlayerUpdateWalking(GameObject *obj)
     printf("Stamina: %.1f, Mana: %.1f\n\n", player->stamina, player->mana);
     
     PlayerMove(player, &obj->velocity);
-    UpdateAnimation(&obj->animation);
+
+    // The action layer animates its own clip while busy
+    if (GetLayerState(obj, FSM_LAYER_ACTION) == STATE_IDLE)
+    {
+        UpdateAnimation(&obj->animation);
+    }
 }
 
 void PlayerExitWalking(GameObject *obj)
@@ -734,6 +816,21 @@ void PlayerExitWalking(GameObject *obj)
     // Complete the remainder of the method
 }
 
+void PlayerEnterReady(GameObject *obj)
+{
+    printf("\n%s -> ENTER -> Ready\n", obj->name);
+
+    // Back to the clip of whatever the player is doing meanwhile
+    if (obj->currentState == STATE_WALKING)
+    {
+        PlayerEnterWalking(obj);
+    }
+    else if (obj->currentState == STATE_IDLE)
+    {
+        SelectRandomIdleAnimation(obj);
+    }
+}
+
 void PlayerEnterAttacking(GameObject *obj)
 {
     Player *player = (Player *)obj;
@@ -818,6 +915,9 @@ void PlayerEnterAttacking(GameObject *obj)
 
     // Set attacking to true
     player->attacking = true;
+
+    // The timer service ends the attack (EVENT_ATTACK_END)
+    player->attackTimer = ScheduleTimer(GetTimerService(), obj, EVENT_ATTACK_END, (uint32_t)player->ATTACK_DURATION);
 }
 
 void PlayerUpdateAttacking(GameObject *obj)
@@ -828,21 +928,6 @@ void PlayerUpdateAttacking(GameObject *obj)
     // Complete the remainder of the method
     // Check if the attack should end or be interrupted (e.g., stamina depletion)
     UpdateAnimation(&obj->animation);
-
-    if (player->attackTimer < player->ATTACK_DURATION)
-    {
-        player->attackTimer++;
-    }
-    // Once attack is completed:
-    else
-    {
-        // Reset timer
-        player->attackTimer = 0;
-
-        player->attacking = false;
-
-        ChangeState(obj, STATE_IDLE);
-    }
 }
 
 void PlayerExitAttacking(GameObject *obj)
@@ -850,8 +935,12 @@ void PlayerExitAttacking(GameObject *obj)
     Player *player = (Player *)obj;
     printf("\n%s <- EXIT <- Attacking\n", obj->name);
     printf("Stamina: %.1f, Mana: %.1f\n\n", player->stamina, player->mana);
-    // Complete the remainder of the method
-    // Reset or adjust any temporary changes during attack, if needed
+    // The attack may be interrupted (e.g. by dying), drop its pending end
+    CancelTimer(GetTimerService(), &player->attackTimer);
+    player->attacking = false;
+
+    // Enforce the fire cooldown before the next attack
+    player->fireCooldown = ScheduleTimer(GetTimerService(), NULL, EVENT_NONE, COMMAND_FIRE_COOLDOWN_TICKS);
 }
 
 void PlayerEnterShielding(GameObject *obj)
@@ -861,6 +950,9 @@ void PlayerEnterShielding(GameObject *obj)
     printf("Stamina: %.1f, Mana: %.1f\n\n", player->stamina, player->mana);
     // Complete the remainder of the method
     // Example: Deduct some stamina for shielding
+
+    // Shielding reduces the damage taken until the shield is lowered
+    ApplyStatusEffect(GetStatusEffects(), obj, STATUS_SHIELD, SHIELD_DAMAGE_SCALE, 0, obj->handle);
 }
 void PlayerUpdateShielding(GameObject *obj)
 {
@@ -879,6 +971,7 @@ void PlayerExitShielding(GameObject *obj)
     printf("Stamina: %.1f, Mana: %.1f\n\n", player->stamina, player->mana);
     // Complete the remainder of the method
     // Reset any temporary shielding effects if necessary
+    RemoveStatusEffects(GetStatusEffects(), obj, STATUS_SHIELD);
 }
 
 void PlayerEnterDie(GameObject *obj)
@@ -932,6 +1025,12 @@ void PlayerEnterRolling(GameObject *obj)
     printf("\n%s -> ENTER -> Rolling\n", obj->name);
     printf("Stamina: %.1f, Mana: %.1f\n\n", player->stamina, player->mana);
 
+    // Rolling interrupts an attack or a raised shield
+    if (GetLayerState(obj, FSM_LAYER_ACTION) != STATE_IDLE)
+    {
+        ChangeLayerState(obj, FSM_LAYER_ACTION, STATE_IDLE);
+    }
+
     // Roll Frames Default for rolling
     Rectangle roll[9] = {
         {0, 1280, 64, 64},   // Frame 1: Row 8, Column 1
@@ -949,6 +1048,9 @@ void PlayerEnterRolling(GameObject *obj)
     // Change the speed of the player
     obj->velocity.x *= 10;
     obj->velocity.y *= 10;
+
+    // The timer service ends the roll (EVENT_ROLL_END)
+    player->rollTimer = ScheduleTimer(GetTimerService(), obj, EVENT_ROLL_END, (uint32_t)player->ROLL_DURATION);
 }
 
 void PlayerUpdateRolling(GameObject *obj)
@@ -960,22 +1062,10 @@ void PlayerUpdateRolling(GameObject *obj)
     // Update the rolling animation
     UpdateAnimation(&obj->animation);
 
-    if (player->rollTimer < player->ROLL_DURATION)
+    if (player->rolling)
     {
-        player->rollTimer++;
-    
         PlayerMove(player, &obj->velocity);
     }
-    // Once roll is completed:
-    else
-    {
-        // Reset timer
-        player->rollTimer = 0;
-
-        player->rolling = false;
-
-        ChangeState(obj, STATE_IDLE);
-    }
 }
 
 void PlayerExitRolling(GameObject *obj)
@@ -983,4 +1073,8 @@ void PlayerExitRolling(GameObject *obj)
     Player *player = (Player *)obj;
     printf("\n%s <- EXIT <- Rolling\n", obj->name);
     printf("Stamina: %.1f, Mana: %.1f\n\n", player->stamina, player->mana);
+
+    // The roll may be interrupted (e.g. by dying), drop its pending end
+    CancelTimer(GetTimerService(), &player->rollTimer);
+    player->rolling = false;
 }
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/gameobjects/prefab.h"
+
+/**
+ * InitPrefab - Registers a prefab built from a fully initialised game object.
+ *
+ * @prefab:    The prefab to initialise.
+ * @name:      What the prefab spawns.
+ * @archetype: The object every instance copies, built once by its type's
+ *             init function (texture, collider, health, FSM, first clip).
+ * @size:      Size of the archetype's type, e.g. sizeof(NPC).
+ * @Delete:    Frees the archetype when the prefab is freed.
+ */
+void InitPrefab(Prefab *prefab, const char *name, GameObject *archetype, size_t size, PrefabDeleteFunction Delete)
+{
+    prefab->name = name;
+    prefab->archetype = archetype;
+    prefab->size = size;
+    prefab->Delete = Delete;
+}
+
+/**
+ * FreePrefab - Frees a prefab's archetype.
+ *
+ * @prefab: The prefab to free.
+ *
+ * Instances share the archetype's state configs, so free their pools first.
+ */
+void FreePrefab(Prefab *prefab)
+{
+    if (prefab->archetype != NULL && prefab->Delete != NULL)
+    {
+        prefab->Delete(prefab->archetype);
+    }
+
+    memset(prefab, 0, sizeof(Prefab));
+}
+
+/**
+ * InitPrefabPool - Allocates storage for the instances of a prefab.
+ *
+ * @pool:     The pool to initialise.
+ * @prefab:   The prefab the pool spawns.
+ * @capacity: Most instances the pool holds.
+ *
+ * Every slot is filled with the archetype right away (see FillPrefabPool).
+ */
+void InitPrefabPool(PrefabPool *pool, const Prefab *prefab, int capacity)
+{
+    ReservePrefabPool(pool, prefab, capacity);
+    FillPrefabPool(pool, capacity);
+}
+
+/**
+ * ReservePrefabPool - Allocates storage for the instances of a prefab, without filling it.
+ *
+ * @pool:     The pool to initialise.
+ * @prefab:   The prefab the pool spawns.
+ * @capacity: Most instances the pool holds.
+ *
+ * Spawning works right away, FillPrefabPool warms the remaining slots in
+ * steps of any size.
+ */
+void ReservePrefabPool(PrefabPool *pool, const Prefab *prefab, int capacity)
+{
+    pool->prefab = prefab;
+    pool->storage = (unsigned char *)malloc(prefab->size * capacity);
+    pool->released = (int *)malloc(sizeof(int) * capacity);
+
+    if (!pool->storage || !pool->released)
+    {
+        fprintf(stderr, "Failed to allocate prefab pool\n");
+        exit(1);
+    }
+
+    pool->capacity = capacity;
+    pool->count = 0;
+    pool->filled = 0;
+    pool->releasedCount = 0;
+}
+
+/**
+ * FillPrefabPool - Copies the archetype into slots not used yet.
+ *
+ * @pool:  The pool.
+ * @count: Most slots to fill.
+ *
+ * Filled slots are touched before anything spawns into them, so spawning
+ * never pays for the first use of the storage's pages. Slots already spawned
+ * into are skipped, they hold a copy already.
+ *
+ * Return: true once every slot is filled.
+ */
+bool FillPrefabPool(PrefabPool *pool, int count)
+{
+    int first = pool->filled > pool->count ? pool->filled : pool->count;
+    int last = pool->capacity - first < count ? pool->capacity : first + count;
+
+    for (int i = first; i < last; i++)
+    {
+        memcpy(pool->storage + pool->prefab->size * i, pool->prefab->archetype, pool->prefab->size);
+    }
+
+    pool->filled = last;
+    return last == pool->capacity;
+}
+
+/**
+ * SpawnPrefab - Spawns an instance of the pool's prefab.
+ *
+ * @pool:     The pool to spawn into.
+ * @position: Where the instance starts.
+ *
+ * The archetype is copied as is and only the position (with its collider and
+ * bounds) is patched, nothing is loaded or allocated. Released slots are
+ * reused before new ones.
+ *
+ * Return: The instance, or NULL when the pool is full.
+ */
+GameObject *SpawnPrefab(PrefabPool *pool, Vector2 position)
+{
+    int slot;
+
+    if (pool->releasedCount > 0)
+    {
+        slot = pool->released[--pool->releasedCount];
+    }
+    else if (pool->count < pool->capacity)
+    {
+        slot = pool->count++;
+    }
+    else
+    {
+        return NULL;
+    }
+
+    GameObject *obj = (GameObject *)(pool->storage + pool->prefab->size * slot);
+    memcpy(obj, pool->prefab->archetype, pool->prefab->size);
+    SetGameObjectPosition(obj, position);
+
+    return obj;
+}
+
+/**
+ * SpawnPrefabs - Spawns an instance of the pool's prefab at each position.
+ *
+ * @pool:      The pool to spawn into.
+ * @positions: Where each instance starts.
+ * @count:     Number of instances wanted.
+ * @spawned:   Receives the instances, may be NULL.
+ *
+ * Return: Number of instances spawned, fewer than count once the pool is full.
+ */
+int SpawnPrefabs(PrefabPool *pool, const Vector2 *positions, int count, GameObject **spawned)
+{
+    int room = pool->capacity - pool->count + pool->releasedCount;
+    if (count > room)
+    {
+        count = room;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        GameObject *obj = SpawnPrefab(pool, positions[i]);
+
+        if (spawned != NULL)
+        {
+            spawned[i] = obj;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * ReleasePrefabInstance - Gives an instance's slot back to the pool.
+ *
+ * @pool: The pool the instance was spawned into.
+ * @obj:  The instance, already released (see ReleaseGameObject) and out of
+ *        every list of the world.
+ *
+ * The slot keeps its bytes until it is spawned into again, so pointers still
+ * held to it read a dead object rather than freed memory.
+ */
+void ReleasePrefabInstance(PrefabPool *pool, GameObject *obj)
+{
+    ptrdiff_t slot = ((unsigned char *)obj - pool->storage) / (ptrdiff_t)pool->prefab->size;
+
+    if (slot < 0 || slot >= pool->count)
+    {
+        fprintf(stderr, "Released instance is not from this pool\n");
+        return;
+    }
+
+    obj->entity = -1; // Releasing it again when the pool is freed does nothing
+    pool->released[pool->releasedCount++] = (int)slot;
+}
+
+/**
+ * FreePrefabPool - Releases every instance and frees the pool's storage.
+ *
+ * @pool: The pool to free.
+ */
+void FreePrefabPool(PrefabPool *pool)
+{
+    for (int i = 0; i < pool->count; i++)
+    {
+        ReleaseGameObject((GameObject *)(pool->storage + pool->prefab->size * i));
+    }
+
+    free(pool->storage);
+    free(pool->released);
+    memset(pool, 0, sizeof(PrefabPool));
+}
@@ -0,0 +1,308 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/gameobjects/projectile.h"
+
+// The projectile pool shared by gameplay code, initialised by InitGame
+static ProjectileSystem projectileSystem;
+
+/**
+ * GetProjectileSystem - Returns the projectile pool used by gameplay code.
+ *
+ * State functions only receive their game object, so attack states spawn
+ * their projectiles into this shared pool, updated once per tick.
+ *
+ * Return: The shared projectile system.
+ */
+ProjectileSystem *GetProjectileSystem(void)
+{
+    return &projectileSystem;
+}
+
+/**
+ * InitProjectileSystem - Allocates the projectile pool.
+ *
+ * @system:   The projectile system to initialise.
+ * @capacity: Most projectiles in flight at once.
+ */
+void InitProjectileSystem(ProjectileSystem *system, int capacity)
+{
+    memset(system, 0, sizeof(ProjectileSystem));
+
+    system->x = (float *)malloc(sizeof(float) * capacity);
+    system->y = (float *)malloc(sizeof(float) * capacity);
+    system->vx = (float *)malloc(sizeof(float) * capacity);
+    system->vy = (float *)malloc(sizeof(float) * capacity);
+    system->life = (int32_t *)malloc(sizeof(int32_t) * capacity);
+    system->owner = (EntityHandle *)malloc(sizeof(EntityHandle) * capacity);
+    system->faction = (uint8_t *)malloc(sizeof(uint8_t) * capacity);
+    system->damage = (uint8_t *)malloc(sizeof(uint8_t) * capacity);
+
+    if (!system->x || !system->y || !system->vx || !system->vy ||
+        !system->life || !system->owner || !system->faction || !system->damage)
+    {
+        fprintf(stderr, "Failed to allocate projectiles\n");
+        exit(1);
+    }
+
+    system->capacity = capacity;
+}
+
+/**
+ * SpawnProjectile - Fires a single projectile.
+ *
+ * @system:   The projectile system.
+ * @position: Where the projectile starts.
+ * @velocity: Distance travelled per tick, clamped to PROJECTILE_MAX_SPEED.
+ * @life:     Ticks before the projectile expires.
+ * @owner:    The shooter.
+ * @faction:  Faction of the shooter, only other factions are hit.
+ * @damage:   Damage dealt on hit.
+ *
+ * Return: false if the pool is full and the projectile was dropped.
+ */
+bool SpawnProjectile(ProjectileSystem *system, Vector2 position, Vector2 velocity, int life, EntityHandle owner, uint8_t faction, int damage)
+{
+    if (system->count >= system->capacity)
+    {
+        return false;
+    }
+
+    // The broad phase margin assumes no projectile outruns PROJECTILE_MAX_SPEED
+    float speed = sqrtf(velocity.x * velocity.x + velocity.y * velocity.y);
+    if (speed > PROJECTILE_MAX_SPEED)
+    {
+        velocity.x *= PROJECTILE_MAX_SPEED / speed;
+        velocity.y *= PROJECTILE_MAX_SPEED / speed;
+    }
+
+    int i = system->count++;
+    system->x[i] = position.x;
+    system->y[i] = position.y;
+    system->vx[i] = velocity.x;
+    system->vy[i] = velocity.y;
+    system->life[i] = life;
+    system->owner[i] = owner;
+    system->faction[i] = faction;
+    system->damage[i] = (uint8_t)damage;
+
+    return true;
+}
+
+/**
+ * SpawnProjectileRing - Fires projectiles evenly spread around a circle.
+ *
+ * @system:      The projectile system.
+ * @centre:      Where the projectiles start.
+ * @count:       Number of projectiles in the ring.
+ * @speed:       Speed of every projectile (per tick).
+ * @angleOffset: Rotation of the ring in radians, varying it makes spirals.
+ * @life:        Ticks before the projectiles expire.
+ * @owner:       The shooter.
+ * @faction:     Faction of the shooter.
+ * @damage:      Damage dealt on hit.
+ */
+void SpawnProjectileRing(ProjectileSystem *system, Vector2 centre, int count, float speed, float angleOffset, int life, EntityHandle owner, uint8_t faction, int damage)
+{
+    for (int i = 0; i < count; i++)
+    {
+        float angle = angleOffset + (2.0f * PI * i) / count;
+        Vector2 velocity = {cosf(angle) * speed, sinf(angle) * speed};
+        SpawnProjectile(system, centre, velocity, life, owner, faction, damage);
+    }
+}
+
+// Grows a scratch array to hold at least count elements
+static void *GrowArray(void *array, int *capacity, int count, size_t size)
+{
+    if (count <= *capacity)
+    {
+        return array;
+    }
+
+    int newCapacity = *capacity > 0 ? *capacity : 64;
+    while (newCapacity < count)
+    {
+        newCapacity *= 2;
+    }
+
+    void *grown = realloc(array, size * newCapacity);
+    if (!grown)
+    {
+        fprintf(stderr, "Failed to grow projectile buffers\n");
+        exit(1);
+    }
+
+    *capacity = newCapacity;
+    return grown;
+}
+
+// Does the segment p -> p + v pass within radius of the centre?
+static bool SweptCircleHit(float px, float py, float vx, float vy, Vector2 centre, float radius)
+{
+    float dx = centre.x - px;
+    float dy = centre.y - py;
+    float lengthSquared = vx * vx + vy * vy;
+
+    // Closest point on the swept segment to the centre
+    float t = lengthSquared > 0.0f ? (dx * vx + dy * vy) / lengthSquared : 0.0f;
+    t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+
+    float cx = px + vx * t - centre.x;
+    float cy = py + vy * t - centre.y;
+    return cx * cx + cy * cy <= radius * radius;
+}
+
+// Records a hit, growing the hit buffer when needed
+static void AddHit(ProjectileSystem *system, int target, EntityHandle owner, int damage)
+{
+    system->hits = (ProjectileHit *)GrowArray(system->hits, &system->hitCapacity, system->hitCount + 1, sizeof(ProjectileHit));
+    system->hits[system->hitCount++] = (ProjectileHit){target, owner, damage};
+}
+
+/**
+ * UpdateProjectiles - Advances every projectile by one tick.
+ *
+ * @system:      The projectile system.
+ * @targets:     Everything projectiles can hit this tick.
+ * @targetCount: Number of targets (0 for cosmetic projectiles, e.g. on clients).
+ *
+ * Each projectile's path this tick is swept against the targets found in its
+ * broad phase cell, so fast projectiles can not tunnel through a collider.
+ * Projectiles that hit or run out of life are then recycled in one pass.
+ * Hits are left in system->hits (reset every update) for the caller to apply.
+ */
+void UpdateProjectiles(ProjectileSystem *system, const SpatialAgent *targets, int targetCount)
+{
+    system->hitCount = 0;
+
+    if (targetCount > 0)
+    {
+        // A projectile only looks in the cell it starts in, so targets are inserted
+        // into every cell within reach of a projectile radius plus a full step
+        SpatialGrid *grid = &system->broadPhase;
+        BuildSpatialGrid(grid, targets, targetCount, PROJECTILE_RADIUS + PROJECTILE_MAX_SPEED);
+
+        for (int i = 0; i < system->count; i++)
+        {
+            int firstRun = SpatialGridBucket(SpatialGridCoordinate(system->x[i]), SpatialGridCoordinate(system->y[i])) * SPATIAL_GRID_FACTIONS;
+            int ownRun = firstRun + system->faction[i] % SPATIAL_GRID_FACTIONS;
+
+            // The shooter's own faction sits in one run of the bucket and is never looked at,
+            // a hit zeroes the projectile's life and ends the search
+            for (int run = firstRun; run < firstRun + SPATIAL_GRID_FACTIONS && system->life[i] > 0; run++)
+            {
+                if (run == ownRun)
+                {
+                    continue;
+                }
+
+                for (int e = grid->runStart[run]; e < grid->runStart[run + 1]; e++)
+                {
+                    const SpatialAgent *target = &targets[grid->entries[e]];
+
+                    if (SweptCircleHit(system->x[i], system->y[i], system->vx[i], system->vy[i],
+                                       target->position, target->radius + PROJECTILE_RADIUS))
+                    {
+                        AddHit(system, target->entity, system->owner[i], system->damage[i]);
+                        system->life[i] = 0; // Recycled below
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // Integrate, a straight loop over dense arrays the compiler can vectorise
+    int count = system->count;
+    float *restrict x = system->x;
+    float *restrict y = system->y;
+    const float *restrict vx = system->vx;
+    const float *restrict vy = system->vy;
+    int32_t *restrict life = system->life;
+
+    for (int i = 0; i < count; i++)
+    {
+        x[i] += vx[i];
+        y[i] += vy[i];
+        life[i] -= 1;
+    }
+
+    // Recycle expired projectiles by moving the last live one into their slot
+    for (int i = count - 1; i >= 0; i--)
+    {
+        if (life[i] <= 0)
+        {
+            int last = --count;
+            x[i] = x[last];
+            y[i] = y[last];
+            system->vx[i] = system->vx[last];
+            system->vy[i] = system->vy[last];
+            life[i] = life[last];
+            system->owner[i] = system->owner[last];
+            system->faction[i] = system->faction[last];
+            system->damage[i] = system->damage[last];
+        }
+    }
+
+    system->count = count;
+}
+
+/**
+ * DrawProjectiles - Records every projectile as a quad in one batch.
+ *
+ * @list:   The render list of the frame.
+ * @system: The projectile system.
+ * @color:  Colour of the projectiles.
+ *
+ * The positions are copied into a single quad command, submitted straight
+ * to rlgl, so 50k projectiles cost a handful of batch flushes instead of 50k
+ * draw calls (see SubmitRenderList).
+ */
+void DrawProjectiles(RenderList *list, const ProjectileSystem *system, Color color)
+{
+    if (system->count == 0)
+    {
+        return;
+    }
+
+    Vector2 *centres = PushQuads(list, system->count, PROJECTILE_RADIUS, color);
+
+    for (int i = 0; i < system->count; i++)
+    {
+        centres[i] = (Vector2){system->x[i], system->y[i]};
+    }
+}
+
+/**
+ * ClearProjectiles - Removes every projectile.
+ *
+ * @system: The projectile system.
+ */
+void ClearProjectiles(ProjectileSystem *system)
+{
+    system->count = 0;
+    system->hitCount = 0;
+}
+
+/**
+ * FreeProjectileSystem - Frees the projectile pool.
+ *
+ * @system: The projectile system to free.
+ */
+void FreeProjectileSystem(ProjectileSystem *system)
+{
+    free(system->x);
+    free(system->y);
+    free(system->vx);
+    free(system->vy);
+    free(system->life);
+    free(system->owner);
+    free(system->faction);
+    free(system->damage);
+    FreeSpatialGrid(&system->broadPhase);
+    free(system->hits);
+    memset(system, 0, sizeof(ProjectileSystem));
+}
@@ -0,0 +1,524 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rlgl.h>
+
+#include "../include/render/render_list.h"
+
+/**
+ * InitRenderList - Allocates an empty render list.
+ *
+ * @list: The render list to initialise.
+ */
+void InitRenderList(RenderList *list)
+{
+    memset(list, 0, sizeof(RenderList));
+
+    list->commands = (RenderCommand *)malloc(sizeof(RenderCommand) * RENDER_LIST_INITIAL_COMMANDS);
+    list->order = (int *)malloc(sizeof(int) * RENDER_LIST_INITIAL_COMMANDS);
+    list->text = (char *)malloc(RENDER_LIST_INITIAL_TEXT);
+    list->points = (Vector2 *)malloc(sizeof(Vector2) * RENDER_LIST_INITIAL_POINTS);
+
+    if (!list->commands || !list->order || !list->text || !list->points)
+    {
+        fprintf(stderr, "Failed to allocate render list\n");
+        exit(1);
+    }
+
+    list->capacity = RENDER_LIST_INITIAL_COMMANDS;
+    list->orderCapacity = RENDER_LIST_INITIAL_COMMANDS;
+    list->textCapacity = RENDER_LIST_INITIAL_TEXT;
+    list->pointCapacity = RENDER_LIST_INITIAL_POINTS;
+}
+
+/**
+ * ClearRenderList - Forgets every command.
+ *
+ * @list: The render list.
+ *
+ * The memory is kept, a list recorded every frame stops allocating once it
+ * has grown to the size of a frame.
+ */
+void ClearRenderList(RenderList *list)
+{
+    list->count = 0;
+    list->textUsed = 0;
+    list->pointCount = 0;
+    list->key = 0;
+    list->sorted = false;
+}
+
+// Grows an array to hold at least count elements
+static void *GrowArray(void *array, int *capacity, int count, size_t size)
+{
+    if (count <= *capacity)
+    {
+        return array;
+    }
+
+    int grown = *capacity * 2;
+    while (grown < count)
+    {
+        grown *= 2;
+    }
+
+    void *resized = realloc(array, size * grown);
+    if (!resized)
+    {
+        fprintf(stderr, "Failed to grow render list\n");
+        exit(1);
+    }
+
+    *capacity = grown;
+    return resized;
+}
+
+// Appends a command of a type and colour, the caller fills in the rest
+static RenderCommand *PushCommand(RenderList *list, RenderCommandType type, Color color)
+{
+    list->commands = (RenderCommand *)GrowArray(list->commands, &list->capacity, list->count + 1, sizeof(RenderCommand));
+
+    RenderCommand *command = &list->commands[list->count++];
+    command->type = (uint8_t)type;
+    command->color = color;
+    command->key = list->key;
+    return command;
+}
+
+/**
+ * SetDrawOrder - Sets where the commands pushed next are drawn.
+ *
+ * @list:  The render list.
+ * @layer: Layers are drawn in order, lowest first.
+ * @y:     Within a layer, lower y is drawn first (further away). Entities
+ *         pass their feet so whoever stands in front covers the one behind.
+ *
+ * Only matters once the list is sorted, see SortRenderList.
+ */
+void SetDrawOrder(RenderList *list, RenderLayer layer, float y)
+{
+    float biased = y + RENDER_SORT_Y_BIAS;
+    uint32_t depth = biased <= 0.0f ? 0 : biased >= RENDER_SORT_Y_MAX ? RENDER_SORT_Y_MAX : (uint32_t)biased;
+
+    list->key = (uint32_t)layer << 24 | depth;
+}
+
+// Copies a string into the list's text, returns its offset
+static int PushString(RenderList *list, const char *text)
+{
+    int length = (int)strlen(text) + 1;
+    list->text = (char *)GrowArray(list->text, &list->textCapacity, list->textUsed + length, 1);
+
+    int offset = list->textUsed;
+    memcpy(list->text + offset, text, length);
+    list->textUsed += length;
+    return offset;
+}
+
+// The recorders below each take the arguments of the raylib function they
+// stand for (ClearBackground, DrawTextureRec, DrawRectangle, ...)
+
+void PushClear(RenderList *list, Color color)
+{
+    PushCommand(list, RENDER_CLEAR, color);
+}
+
+void PushSprite(RenderList *list, Texture2D texture, Rectangle source, Vector2 position, Color tint)
+{
+    RenderCommand *command = PushCommand(list, RENDER_SPRITE, tint);
+    command->sprite.texture = texture;
+    command->sprite.source = source;
+    command->sprite.position = position;
+}
+
+void PushRectangle(RenderList *list, float x, float y, float width, float height, Color color)
+{
+    PushCommand(list, RENDER_RECTANGLE, color)->rectangle = (Rectangle){x, y, width, height};
+}
+
+void PushRectangleLines(RenderList *list, float x, float y, float width, float height, Color color)
+{
+    PushCommand(list, RENDER_RECTANGLE_LINES, color)->rectangle = (Rectangle){x, y, width, height};
+}
+
+void PushCircle(RenderList *list, Vector2 centre, float radius, Color color)
+{
+    RenderCommand *command = PushCommand(list, RENDER_CIRCLE, color);
+    command->circle.centre = centre;
+    command->circle.radius = radius;
+}
+
+void PushCircleLines(RenderList *list, Vector2 centre, float radius, Color color)
+{
+    RenderCommand *command = PushCommand(list, RENDER_CIRCLE_LINES, color);
+    command->circle.centre = centre;
+    command->circle.radius = radius;
+}
+
+// Records a text command, centered or not
+static void PushTextCommand(RenderList *list, const char *text, int x, int y, int size, Color color, bool centered)
+{
+    int offset = PushString(list, text);
+
+    RenderCommand *command = PushCommand(list, RENDER_TEXT, color);
+    command->text.offset = offset;
+    command->text.x = x;
+    command->text.y = y;
+    command->text.size = size;
+    command->text.centered = centered;
+}
+
+void PushText(RenderList *list, const char *text, int x, int y, int size, Color color)
+{
+    PushTextCommand(list, text, x, y, size, color, false);
+}
+
+void PushTextCentered(RenderList *list, const char *text, int x, int y, int size, Color color)
+{
+    PushTextCommand(list, text, x, y, size, color, true);
+}
+
+/**
+ * PushQuads - Records a batch of squares of the same colour.
+ *
+ * @list:   The render list.
+ * @count:  Number of squares.
+ * @radius: Half the side of each square.
+ * @color:  Colour of the squares.
+ *
+ * Return: Where to write the count centres, valid until the next push.
+ */
+Vector2 *PushQuads(RenderList *list, int count, float radius, Color color)
+{
+    list->points = (Vector2 *)GrowArray(list->points, &list->pointCapacity, list->pointCount + count, sizeof(Vector2));
+
+    RenderCommand *command = PushCommand(list, RENDER_QUADS, color);
+    command->quads.first = list->pointCount;
+    command->quads.count = count;
+    command->quads.radius = radius;
+
+    list->pointCount += count;
+    return &list->points[command->quads.first];
+}
+
+// Submits a quad batch straight to rlgl with the default white texture, so
+// 50k quads cost a handful of batch flushes instead of 50k draw calls
+static void SubmitQuads(const Vector2 *centres, int count, float r, Color color)
+{
+    rlSetTexture(rlGetTextureIdDefault());
+
+    for (int first = 0; first < count; first += RENDER_QUAD_CHUNK)
+    {
+        int last = first + RENDER_QUAD_CHUNK < count ? first + RENDER_QUAD_CHUNK : count;
+
+        // Flush the current batch first if this chunk would not fit
+        rlCheckRenderBatchLimit((last - first) * 4);
+
+        rlBegin(RL_QUADS);
+        rlColor4ub(color.r, color.g, color.b, color.a);
+
+        for (int i = first; i < last; i++)
+        {
+            float x = centres[i].x;
+            float y = centres[i].y;
+
+            rlTexCoord2f(0.0f, 0.0f);
+            rlVertex2f(x - r, y - r);
+            rlTexCoord2f(0.0f, 1.0f);
+            rlVertex2f(x - r, y + r);
+            rlTexCoord2f(1.0f, 1.0f);
+            rlVertex2f(x + r, y + r);
+            rlTexCoord2f(1.0f, 0.0f);
+            rlVertex2f(x + r, y - r);
+        }
+
+        rlEnd();
+    }
+
+    rlSetTexture(0);
+}
+
+/**
+ * SubmitRenderList - Draws every command of a render list.
+ *
+ * @list: The render list.
+ *
+ * Must run on the thread that owns the window, between BeginDrawing and
+ * EndDrawing. The list is only read, it can be submitted again.
+ */
+void SubmitRenderList(const RenderList *list)
+{
+    for (int i = 0; i < list->count; i++)
+    {
+        const RenderCommand *command = &list->commands[list->sorted ? list->order[i] : i];
+
+        switch (command->type)
+        {
+        case RENDER_CLEAR:
+            ClearBackground(command->color);
+            break;
+        case RENDER_SPRITE:
+            DrawTextureRec(command->sprite.texture, command->sprite.source, command->sprite.position, command->color);
+            break;
+        case RENDER_RECTANGLE:
+            DrawRectangleRec(command->rectangle, command->color);
+            break;
+        case RENDER_RECTANGLE_LINES:
+            DrawRectangleLines(command->rectangle.x, command->rectangle.y, command->rectangle.width,
+                               command->rectangle.height, command->color);
+            break;
+        case RENDER_CIRCLE:
+            DrawCircleV(command->circle.centre, command->circle.radius, command->color);
+            break;
+        case RENDER_CIRCLE_LINES:
+            DrawCircleLines(command->circle.centre.x, command->circle.centre.y, command->circle.radius, command->color);
+            break;
+        case RENDER_TEXT:
+        {
+            const char *text = list->text + command->text.offset;
+            int x = command->text.centered ? command->text.x - MeasureText(text, command->text.size) / 2 : command->text.x;
+            DrawText(text, x, command->text.y, command->text.size, command->color);
+            break;
+        }
+        case RENDER_QUADS:
+            SubmitQuads(list->points + command->quads.first, command->quads.count, command->quads.radius, command->color);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/**
+ * FreeRenderList - Frees the render list.
+ *
+ * @list: The render list to free.
+ */
+void FreeRenderList(RenderList *list)
+{
+    free(list->commands);
+    free(list->order);
+    free(list->text);
+    free(list->points);
+    memset(list, 0, sizeof(RenderList));
+}
+
+/**
+ * InitRenderSorter - Allocates a sorter without any previous order.
+ *
+ * @sorter: The sorter to initialise.
+ */
+void InitRenderSorter(RenderSorter *sorter)
+{
+    memset(sorter, 0, sizeof(RenderSorter));
+
+    sorter->capacity = RENDER_LIST_INITIAL_COMMANDS;
+    sorter->order = (int *)malloc(sizeof(int) * sorter->capacity);
+    sorter->keys = (uint32_t *)malloc(sizeof(uint32_t) * sorter->capacity);
+    sorter->scratch = (int *)malloc(sizeof(int) * sorter->capacity);
+    sorter->scratchKeys = (uint32_t *)malloc(sizeof(uint32_t) * sorter->capacity);
+
+    if (!sorter->order || !sorter->keys || !sorter->scratch || !sorter->scratchKeys)
+    {
+        fprintf(stderr, "Failed to allocate render sorter\n");
+        exit(1);
+    }
+
+    sorter->count = -1;
+}
+
+// Grows the sorter's buffers to hold count commands, each one from the
+// same capacity to the same size
+static void GrowSorter(RenderSorter *sorter, int count)
+{
+    int capacity = sorter->capacity;
+
+    sorter->order = (int *)GrowArray(sorter->order, &capacity, count, sizeof(int));
+    capacity = sorter->capacity;
+    sorter->keys = (uint32_t *)GrowArray(sorter->keys, &capacity, count, sizeof(uint32_t));
+    capacity = sorter->capacity;
+    sorter->scratch = (int *)GrowArray(sorter->scratch, &capacity, count, sizeof(int));
+    capacity = sorter->capacity;
+    sorter->scratchKeys = (uint32_t *)GrowArray(sorter->scratchKeys, &capacity, count, sizeof(uint32_t));
+
+    sorter->capacity = capacity;
+}
+
+// Lower key first, the command pushed first on a tie
+static bool DrawnBefore(uint32_t key, int index, uint32_t otherKey, int otherIndex)
+{
+    return key < otherKey || (key == otherKey && index < otherIndex);
+}
+
+// Insertion sort, linear in the number of moves so nearly free on last
+// frame's order. Gives up once budget moves are spent (order and keys are
+// still a permutation then), returns whether it finished.
+static bool InsertionSort(int *order, uint32_t *keys, int count, long budget, int *moves)
+{
+    long moved = 0;
+
+    for (int i = 1; i < count; i++)
+    {
+        uint32_t key = keys[i];
+        int index = order[i];
+        int j = i;
+
+        while (j > 0 && DrawnBefore(key, index, keys[j - 1], order[j - 1]))
+        {
+            keys[j] = keys[j - 1];
+            order[j] = order[j - 1];
+            j--;
+
+            if (++moved > budget)
+            {
+                keys[j] = key;
+                order[j] = index;
+                return false;
+            }
+        }
+
+        keys[j] = key;
+        order[j] = index;
+    }
+
+    *moves = (int)moved;
+    return true;
+}
+
+// LSD radix sort, a byte per pass. Starting from push order keeps ties in
+// push order since every pass is stable. Passes where every key has the
+// same byte (the layer byte, often) are skipped.
+static void RadixSort(RenderSorter *sorter, int count)
+{
+    int histograms[4][256];
+    memset(histograms, 0, sizeof(histograms));
+
+    for (int i = 0; i < count; i++)
+    {
+        uint32_t key = sorter->keys[i];
+        histograms[0][key & 0xFF]++;
+        histograms[1][key >> 8 & 0xFF]++;
+        histograms[2][key >> 16 & 0xFF]++;
+        histograms[3][key >> 24]++;
+    }
+
+    uint32_t *keys = sorter->keys;
+    int *order = sorter->order;
+    uint32_t *keysOut = sorter->scratchKeys;
+    int *orderOut = sorter->scratch;
+
+    for (int pass = 0; pass < 4; pass++)
+    {
+        int shift = pass * 8;
+        int *histogram = histograms[pass];
+
+        if (histogram[keys[0] >> shift & 0xFF] == count)
+        {
+            continue;
+        }
+
+        // Bucket counts to bucket starts
+        int start = 0;
+        for (int digit = 0; digit < 256; digit++)
+        {
+            int size = histogram[digit];
+            histogram[digit] = start;
+            start += size;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            int slot = histogram[keys[i] >> shift & 0xFF]++;
+            keysOut[slot] = keys[i];
+            orderOut[slot] = order[i];
+        }
+
+        uint32_t *swapKeys = keys;
+        keys = keysOut;
+        keysOut = swapKeys;
+
+        int *swapOrder = order;
+        order = orderOut;
+        orderOut = swapOrder;
+    }
+
+    // Keep the result in the sorter's own arrays
+    sorter->keys = keys;
+    sorter->scratchKeys = keysOut;
+    sorter->order = order;
+    sorter->scratch = orderOut;
+}
+
+/**
+ * SortRenderList - Orders the commands of a list by key.
+ *
+ * @sorter: The sorter, holding the order of the previous list.
+ * @list:   The list, recorded and not submitted yet.
+ *
+ * Lower keys are drawn first, commands with the same key in the order they
+ * were pushed. Most frames push the same commands as the one before with
+ * slightly moved entities, so when the count matches the previous order is
+ * reused and fixed up by an insertion sort, linear in how much moved. A
+ * frame that changed too much (spawns, first frame) is radix sorted, linear
+ * in the number of commands.
+ */
+void SortRenderList(RenderSorter *sorter, RenderList *list)
+{
+    int count = list->count;
+
+    if (count > sorter->capacity)
+    {
+        GrowSorter(sorter, count);
+    }
+    list->order = (int *)GrowArray(list->order, &list->orderCapacity, count, sizeof(int));
+
+    // Last frame's order if it can apply, push order otherwise
+    if (count != sorter->count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            sorter->order[i] = i;
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        sorter->keys[i] = list->commands[sorter->order[i]].key;
+    }
+
+    int moves = 0;
+    sorter->radix = !InsertionSort(sorter->order, sorter->keys, count, (long)count * RENDER_SORT_MOVE_BUDGET, &moves);
+
+    if (sorter->radix)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            sorter->order[i] = i;
+            sorter->keys[i] = list->commands[i].key;
+        }
+
+        RadixSort(sorter, count);
+        moves = 0;
+    }
+
+    sorter->moves = moves;
+    sorter->count = count;
+
+    memcpy(list->order, sorter->order, sizeof(int) * count);
+    list->sorted = true;
+}
+
+/**
+ * FreeRenderSorter - Frees the sorter.
+ *
+ * @sorter: The sorter to free.
+ */
+void FreeRenderSorter(RenderSorter *sorter)
+{
+    free(sorter->order);
+    free(sorter->keys);
+    free(sorter->scratch);
+    free(sorter->scratchKeys);
+    memset(sorter, 0, sizeof(RenderSorter));
+}
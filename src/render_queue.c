@@ -0,0 +1,393 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <raylib.h>
+
+#include "../include/render/render_queue.h"
+
+// The render queue of the game, initialised by main
+static RenderQueue renderQueue;
+
+/**
+ * GetRenderQueue - Returns the render queue of the game.
+ *
+ * The asset cache loads textures through it, the debug overlay reads its
+ * timings.
+ *
+ * Return: The render queue.
+ */
+RenderQueue *GetRenderQueue(void)
+{
+    return &renderQueue;
+}
+
+// Runs the pending job of the simulation, with the lock held
+static void RunPendingJob(RenderQueue *queue)
+{
+    if (queue->job != NULL)
+    {
+        queue->job(queue->jobArgument);
+        queue->job = NULL;
+        pthread_cond_broadcast(&queue->changed);
+    }
+}
+
+// Keeps the newest movement and adds up the presses the simulation has not
+// seen, an action stays until a tick takes it
+static void MergeInput(InputFrame *into, InputFrame sample)
+{
+    into->commands.move = sample.commands.move;
+    if (sample.commands.action != COMMAND_NONE)
+    {
+        into->commands.action = sample.commands.action;
+    }
+    into->confirm = into->confirm || sample.confirm;
+    into->cycle = into->cycle || sample.cycle;
+    into->frameTime = sample.frameTime;
+}
+
+// Unloads the released textures no list still to be drawn may use, with the
+// lock held on the window's thread
+static void RunDueUnloads(RenderQueue *queue, uint32_t drawn)
+{
+    int kept = 0;
+
+    for (int i = 0; i < queue->unloadCount; i++)
+    {
+        if (queue->unloads[i].list <= drawn)
+        {
+            UnloadTexture(queue->unloads[i].texture);
+        }
+        else
+        {
+            queue->unloads[kept++] = queue->unloads[i];
+        }
+    }
+
+    queue->unloadCount = kept;
+}
+
+// Runs one tick into a list, sorts it and measures it
+static void SimulateTick(RenderQueue *queue, RenderList *list)
+{
+    // Textures released from here on may be drawn by this list
+    pthread_mutex_lock(&queue->lock);
+    queue->listNumbers[list - queue->lists] = ++queue->recorded;
+    pthread_mutex_unlock(&queue->lock);
+
+    ClearRenderList(list);
+
+    double start = GetTime();
+    queue->simulate(list, queue->context);
+    SortRenderList(&queue->sorter, list);
+    double elapsed = GetTime() - start;
+
+    pthread_mutex_lock(&queue->lock);
+    queue->stats.simulateTime = elapsed;
+    queue->stats.sortMoves = queue->sorter.moves;
+    queue->stats.sortRadix = queue->sorter.radix;
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// Simulation thread: takes the input, runs a tick into the free list and
+// publishes it, waiting while the previous one was not picked up yet
+static void *SimulationThread(void *argument)
+{
+    RenderQueue *queue = (RenderQueue *)argument;
+
+    pthread_mutex_lock(&queue->lock);
+
+    while (!queue->stopping)
+    {
+        SetFrameInput(queue->input);
+        queue->input.commands.action = COMMAND_NONE;
+        queue->input.confirm = false;
+        queue->input.cycle = false;
+
+        int recording = queue->recording;
+        pthread_mutex_unlock(&queue->lock);
+
+        SimulateTick(queue, &queue->lists[recording]);
+
+        pthread_mutex_lock(&queue->lock);
+
+        while (queue->ready >= 0 && !queue->stopping)
+        {
+            pthread_cond_wait(&queue->changed, &queue->lock);
+        }
+
+        if (queue->stopping)
+        {
+            break;
+        }
+
+        // The next tick records into the list neither ready nor submitted
+        queue->ready = recording;
+        for (int i = 0; i < RENDER_QUEUE_LISTS; i++)
+        {
+            if (i != queue->ready && i != queue->submitting)
+            {
+                queue->recording = i;
+                break;
+            }
+        }
+
+        pthread_cond_broadcast(&queue->changed);
+    }
+
+    queue->simulationDone = true;
+    pthread_cond_broadcast(&queue->changed);
+    pthread_mutex_unlock(&queue->lock);
+    return NULL;
+}
+
+/**
+ * InitRenderQueue - Starts the simulation.
+ *
+ * @queue:    The render queue to initialise.
+ * @simulate: Runs one tick of the game and records what it draws.
+ * @context:  Passed to simulate.
+ * @threaded: Run the simulation on its own thread. When false, RenderFrame
+ *            simulates and submits on the window's thread (web builds and
+ *            --single-thread, to compare frame times).
+ *
+ * Must be called on the window's thread, after InitWindow.
+ */
+void InitRenderQueue(RenderQueue *queue, SimulateFunction simulate, void *context, bool threaded)
+{
+    memset(queue, 0, sizeof(RenderQueue));
+
+    for (int i = 0; i < RENDER_QUEUE_LISTS; i++)
+    {
+        InitRenderList(&queue->lists[i]);
+    }
+    InitRenderSorter(&queue->sorter);
+
+    queue->recording = 0;
+    queue->ready = -1;
+    queue->submitting = -1;
+    queue->simulate = simulate;
+    queue->context = context;
+    queue->windowThread = pthread_self();
+    queue->open = true;
+    queue->input.commands = (PlayerInput){COMMAND_NONE, COMMAND_NONE}; // Zero is COMMAND_MOVE_UP
+
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->changed, NULL);
+
+    if (threaded)
+    {
+        queue->threaded = true;
+
+        if (pthread_create(&queue->simulationThread, NULL, SimulationThread, queue) != 0)
+        {
+            fprintf(stderr, "Failed to start the simulation thread, simulating on the window's thread\n");
+            queue->threaded = false;
+        }
+    }
+}
+
+/**
+ * RenderFrame - Runs one frame on the window's thread.
+ *
+ * @queue: The render queue.
+ *
+ * Samples the input raylib polled at the end of the previous frame, then
+ * submits the newest list. Threaded, it waits for the simulation to publish
+ * one, running the GL jobs it asks for meanwhile. Otherwise the tick is
+ * simulated right here first. Textures released up to the tick of the list
+ * are unloaded once it was drawn, lists go out in the order they were
+ * recorded, so nothing drawn later can still use them.
+ */
+void RenderFrame(RenderQueue *queue)
+{
+    InputFrame sample = SampleInput();
+    RenderList *list;
+
+    if (!queue->threaded)
+    {
+        SetFrameInput(sample);
+        list = &queue->lists[0];
+        SimulateTick(queue, list);
+    }
+    else
+    {
+        pthread_mutex_lock(&queue->lock);
+        MergeInput(&queue->input, sample);
+        pthread_cond_broadcast(&queue->changed);
+
+        RunPendingJob(queue);
+        while (queue->ready < 0 && !queue->simulationDone)
+        {
+            pthread_cond_wait(&queue->changed, &queue->lock);
+            RunPendingJob(queue);
+        }
+
+        if (queue->ready >= 0)
+        {
+            queue->submitting = queue->ready;
+            queue->ready = -1;
+            pthread_cond_broadcast(&queue->changed);
+        }
+
+        list = queue->submitting >= 0 ? &queue->lists[queue->submitting] : NULL;
+        pthread_mutex_unlock(&queue->lock);
+    }
+
+    double start = GetTime();
+
+    BeginDrawing();
+    if (list != NULL)
+    {
+        SubmitRenderList(list);
+    }
+    EndDrawing();
+
+    double elapsed = GetTime() - start;
+
+    // Read by the debug overlay on the simulation thread
+    pthread_mutex_lock(&queue->lock);
+    queue->stats.submitTime = elapsed;
+    queue->stats.commandCount = list != NULL ? list->count : 0;
+    if (list != NULL)
+    {
+        RunDueUnloads(queue, queue->listNumbers[list - queue->lists]);
+    }
+    pthread_mutex_unlock(&queue->lock);
+}
+
+/**
+ * GetRenderStats - Returns the timings of the last tick and frame.
+ *
+ * @queue: The render queue.
+ *
+ * Return: A copy, taken under the lock since both threads write them.
+ */
+RenderStats GetRenderStats(RenderQueue *queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    RenderStats stats = queue->stats;
+    pthread_mutex_unlock(&queue->lock);
+    return stats;
+}
+
+/**
+ * CloseRenderQueue - Stops the simulation and frees the lists.
+ *
+ * @queue: The render queue.
+ *
+ * The simulation finishes the tick it is running (its GL jobs still run
+ * here) and exits. Whatever it would have drawn is dropped, so every texture
+ * released meanwhile is unloaded, and later releases unload directly.
+ */
+void CloseRenderQueue(RenderQueue *queue)
+{
+    if (queue->threaded)
+    {
+        pthread_mutex_lock(&queue->lock);
+        queue->stopping = true;
+        pthread_cond_broadcast(&queue->changed);
+
+        RunPendingJob(queue);
+        while (!queue->simulationDone)
+        {
+            pthread_cond_wait(&queue->changed, &queue->lock);
+            RunPendingJob(queue);
+        }
+        pthread_mutex_unlock(&queue->lock);
+
+        pthread_join(queue->simulationThread, NULL);
+        queue->threaded = false;
+    }
+
+    RunDueUnloads(queue, queue->recorded);
+    free(queue->unloads);
+    queue->unloads = NULL;
+    queue->unloadCapacity = 0;
+    queue->open = false;
+
+    for (int i = 0; i < RENDER_QUEUE_LISTS; i++)
+    {
+        FreeRenderList(&queue->lists[i]);
+    }
+    FreeRenderSorter(&queue->sorter);
+
+    pthread_cond_destroy(&queue->changed);
+    pthread_mutex_destroy(&queue->lock);
+}
+
+/**
+ * RunOnRenderThread - Runs a job on the window's thread.
+ *
+ * @job:      The job, anything that needs the GL context.
+ * @argument: Passed to job.
+ *
+ * From the simulation thread the job is handed to the window's thread and
+ * this waits until it ran. On the window's thread, or while nothing runs
+ * on another thread, it runs directly.
+ */
+void RunOnRenderThread(RenderJobFunction job, void *argument)
+{
+    RenderQueue *queue = GetRenderQueue();
+
+    if (!queue->threaded || pthread_equal(pthread_self(), queue->windowThread))
+    {
+        job(argument);
+        return;
+    }
+
+    pthread_mutex_lock(&queue->lock);
+
+    queue->job = job;
+    queue->jobArgument = argument;
+    pthread_cond_broadcast(&queue->changed);
+
+    while (queue->job != NULL)
+    {
+        pthread_cond_wait(&queue->changed, &queue->lock);
+    }
+
+    pthread_mutex_unlock(&queue->lock);
+}
+
+/**
+ * UnloadTextureAfterFrame - Unloads a texture once nothing can draw it anymore.
+ *
+ * @texture: The texture, no longer used by anything recording.
+ *
+ * The list being recorded, and the ones waiting for or in submission, may
+ * still draw the texture, so it is unloaded on the window's thread after the
+ * list of the current tick was drawn (see RenderFrame). While the queue is
+ * closed nothing draws and it is unloaded right away.
+ */
+void UnloadTextureAfterFrame(Texture2D texture)
+{
+    RenderQueue *queue = GetRenderQueue();
+
+    if (!queue->open)
+    {
+        UnloadTexture(texture);
+        return;
+    }
+
+    pthread_mutex_lock(&queue->lock);
+
+    if (queue->unloadCount == queue->unloadCapacity)
+    {
+        int capacity = queue->unloadCapacity > 0 ? queue->unloadCapacity * 2 : 8;
+        PendingUnload *unloads = (PendingUnload *)realloc(queue->unloads, sizeof(PendingUnload) * capacity);
+        if (!unloads)
+        {
+            fprintf(stderr, "Failed to allocate pending texture unloads\n");
+            exit(1);
+        }
+
+        queue->unloads = unloads;
+        queue->unloadCapacity = capacity;
+    }
+
+    queue->unloads[queue->unloadCount++] = (PendingUnload){texture, queue->recorded};
+
+    pthread_mutex_unlock(&queue->lock);
+}
@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <raylib.h>
+
+#include "../include/game/scene_manager.h"
+
+// The scene manager of the game, initialised by main
+static SceneManager sceneManager;
+
+/**
+ * GetSceneManager - Returns the scene manager of the game.
+ *
+ * Scene functions only receive their scene, so they preload and switch to
+ * the next scene through this shared manager.
+ *
+ * Return: The scene manager.
+ */
+SceneManager *GetSceneManager(void)
+{
+    return &sceneManager;
+}
+
+/**
+ * InitSceneManager - Prepares a scene manager without any scene.
+ *
+ * @manager: The scene manager to initialise.
+ */
+void InitSceneManager(SceneManager *manager)
+{
+    memset(manager, 0, sizeof(SceneManager));
+    manager->requested = SCENE_NONE;
+}
+
+/**
+ * RegisterScene - Adds a scene to the manager.
+ *
+ * @manager: The scene manager.
+ * @id:      Which scene it is.
+ * @scene:   Its functions and data, nothing is prepared yet.
+ */
+void RegisterScene(SceneManager *manager, SceneId id, Scene scene)
+{
+    scene.step = 0;
+    scene.ready = false;
+    manager->scenes[id] = scene;
+}
+
+// Runs the next preload step of a scene
+static void PreloadStep(Scene *scene)
+{
+    if (scene->Preload == NULL || scene->Preload(scene))
+    {
+        scene->ready = true;
+    }
+
+    scene->step++;
+}
+
+// Frees whatever a scene prepared, it starts from scratch the next time
+static void UnloadScene(Scene *scene)
+{
+    if (scene->step > 0 && scene->Unload != NULL)
+    {
+        scene->Unload(scene);
+    }
+
+    scene->step = 0;
+    scene->ready = false;
+}
+
+/**
+ * PreloadScene - Prepares a scene between the frames of the current one.
+ *
+ * @manager: The scene manager.
+ * @id:      The scene to prepare.
+ *
+ * Any other scene prepared or being prepared is unloaded, only one scene is
+ * kept ready besides the current one (gameplay scenes share the simulation
+ * services, two of them cannot be loaded at once). Does nothing for the
+ * current scene.
+ */
+void PreloadScene(SceneManager *manager, SceneId id)
+{
+    Scene *scene = &manager->scenes[id];
+
+    if (scene == manager->current)
+    {
+        return;
+    }
+
+    for (int i = 0; i < SCENE_COUNT; i++)
+    {
+        Scene *other = &manager->scenes[i];
+
+        if (other != scene && other != manager->current && other->step > 0)
+        {
+            UnloadScene(other);
+        }
+    }
+
+    manager->preloading = scene->ready ? NULL : scene;
+}
+
+/**
+ * SwitchScene - Requests a scene to become current.
+ *
+ * @manager: The scene manager.
+ * @id:      The scene to switch to.
+ *
+ * The switch happens at the start of the next RunSceneFrame, so the current
+ * scene finishes its frame first. If the scene is not preloaded by then, its
+ * preload is finished in one go and the stall is measured.
+ */
+void SwitchScene(SceneManager *manager, SceneId id)
+{
+    if (manager->requested == SCENE_NONE)
+    {
+        manager->requestTime = GetTime();
+    }
+
+    manager->requested = id;
+    PreloadScene(manager, id);
+}
+
+// Swaps in the requested scene and unloads the previous one
+static void ApplySwitch(SceneManager *manager)
+{
+    Scene *next = &manager->scenes[manager->requested];
+    manager->requested = SCENE_NONE;
+
+    if (next == manager->current)
+    {
+        return;
+    }
+
+    // Whatever the background preload did not get to is done now
+    double start = GetTime();
+    while (!next->ready)
+    {
+        PreloadStep(next);
+    }
+    double stall = GetTime() - start;
+
+    if (manager->preloading == next)
+    {
+        manager->preloading = NULL;
+    }
+
+    Scene *previous = manager->current;
+    manager->current = next;
+
+    if (previous != NULL)
+    {
+        UnloadScene(previous);
+    }
+
+    manager->lastStall = stall;
+    manager->lastTransition = GetTime() - manager->requestTime;
+
+    printf("Scene %s -> %s in %.2f ms (%.2f ms stalled)\n", previous != NULL ? previous->name : "none", next->name,
+           manager->lastTransition * 1000.0, manager->lastStall * 1000.0);
+}
+
+/**
+ * RunSceneFrame - Runs one frame of the game.
+ *
+ * @manager: The scene manager.
+ * @list:    Where the current scene records its frame.
+ *
+ * A requested switch happens first, at the frame boundary. The current scene
+ * then updates and records its draws, and the scene being preloaded gets the next
+ * SCENE_PRELOAD_BUDGET seconds (at least one step per frame).
+ */
+void RunSceneFrame(SceneManager *manager, RenderList *list)
+{
+    if (manager->requested != SCENE_NONE)
+    {
+        ApplySwitch(manager);
+    }
+
+    if (manager->current != NULL)
+    {
+        manager->current->Update(manager->current);
+        manager->current->Draw(manager->current, list);
+    }
+
+    double start = GetTime();
+    while (manager->preloading != NULL && !manager->preloading->ready)
+    {
+        PreloadStep(manager->preloading);
+
+        if (GetTime() - start >= SCENE_PRELOAD_BUDGET)
+        {
+            break;
+        }
+    }
+
+    if (manager->preloading != NULL && manager->preloading->ready)
+    {
+        manager->preloading = NULL;
+    }
+}
+
+/**
+ * FreeSceneManager - Unloads every scene.
+ *
+ * @manager: The scene manager to free.
+ */
+void FreeSceneManager(SceneManager *manager)
+{
+    for (int i = 0; i < SCENE_COUNT; i++)
+    {
+        UnloadScene(&manager->scenes[i]);
+    }
+
+    InitSceneManager(manager);
+}
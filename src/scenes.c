@@ -0,0 +1,247 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/game/scenes.h"
+
+// Title screen, the scene ENTER starts is prepared while it shows
+typedef struct
+{
+    SceneId selected; // Level or arena
+    Texture2D playerSheet;
+} TitleScene;
+
+// A world to play in, the level or the arena
+typedef struct
+{
+    GameData settings; // Copied into a fresh world every time the scene is prepared
+    GameData *game;    // The world, built by the last preload step
+    Texture2D playerSheet;
+    Texture2D npcSheet;
+    int lives;         // Deaths before the game is over (0 = unlimited)
+    int deaths;        // Deaths of the local player so far
+    bool wasDead;      // Local player was dead last frame
+} GameplayScene;
+
+// Shown once the local player ran out of lives
+typedef struct
+{
+    Texture2D playerSheet;
+    float survived; // Seconds the player lasted, set by the gameplay scene
+} GameOverScene;
+
+static TitleScene titleScene;
+static GameplayScene gameplayScene;
+static GameplayScene arenaScene;
+static GameOverScene gameOverScene;
+
+// ---- Title ----
+
+static bool TitlePreload(Scene *scene)
+{
+    TitleScene *title = (TitleScene *)scene->data;
+    title->playerSheet = AcquireTexture(GetAssetCache(), PLAYER_SPRITE_SHEET);
+    return true;
+}
+
+static void TitleUpdate(Scene *scene)
+{
+    TitleScene *title = (TitleScene *)scene->data;
+    SceneManager *manager = GetSceneManager();
+
+    if (GetFrameInput()->cycle)
+    {
+        title->selected = title->selected == SCENE_GAMEPLAY ? SCENE_ARENA : SCENE_GAMEPLAY;
+    }
+
+    // Prepare the selected scene while the title shows (nothing to do once it is ready)
+    PreloadScene(manager, title->selected);
+
+    if (GetFrameInput()->confirm)
+    {
+        SwitchScene(manager, title->selected);
+    }
+}
+
+static void TitleDraw(Scene *scene, RenderList *list)
+{
+    TitleScene *title = (TitleScene *)scene->data;
+    SceneManager *manager = GetSceneManager();
+    bool ready = manager->scenes[title->selected].ready;
+
+    PushClear(list, DARKGREEN);
+
+    PushText(list, "Raylib Animated FSM Starter Kit!", 190, 180, 20, DARKBLUE);
+    PushSprite(list, title->playerSheet, (Rectangle){0, 384, 64, 64}, (Vector2){368, 240}, WHITE);
+
+    PushText(list, title->selected == SCENE_GAMEPLAY ? "> Level <    Arena" : "  Level    > Arena <", 270, 340, 20, LIGHTGRAY);
+    PushText(list, ready ? "[ENTER] Play   [TAB] Switch" : "Preparing...   [TAB] Switch", 250, 380, 20, ready ? LIGHTGRAY : YELLOW);
+    PushText(list, TextFormat("Last transition %.2f ms", manager->lastTransition * 1000.0), 10, SCREEN_HEIGHT - 30, 20, DARKBLUE);
+}
+
+static void TitleUnload(Scene *scene)
+{
+    TitleScene *title = (TitleScene *)scene->data;
+    ReleaseTexture(GetAssetCache(), title->playerSheet);
+}
+
+// ---- Gameplay and arena ----
+
+static bool GameplayPreload(Scene *scene)
+{
+    GameplayScene *gameplay = (GameplayScene *)scene->data;
+
+    // Sprite sheets first, one per step, then the world a bounded step at a
+    // time (InitGameStep finds the sheets in the asset cache)
+    switch (scene->step)
+    {
+    case 0:
+        gameplay->playerSheet = AcquireTexture(GetAssetCache(), PLAYER_SPRITE_SHEET);
+        return false;
+    case 1:
+        gameplay->npcSheet = AcquireTexture(GetAssetCache(), NPC_SPRITE_SHEET);
+        return false;
+    case 2:
+        gameplay->game = (GameData *)malloc(sizeof(GameData));
+        if (!gameplay->game)
+        {
+            fprintf(stderr, "Failed to allocate game data\n");
+            exit(1);
+        }
+
+        *gameplay->game = gameplay->settings;
+        break;
+    default:
+        break;
+    }
+
+    if (!InitGameStep(gameplay->game, scene->step - 2))
+    {
+        return false;
+    }
+
+    gameplay->deaths = 0;
+    gameplay->wasDead = false;
+    return true;
+}
+
+static void GameplayUpdate(Scene *scene)
+{
+    GameplayScene *gameplay = (GameplayScene *)scene->data;
+    GameData *game = gameplay->game;
+
+    UpdateGame(game);
+
+    if (gameplay->lives == 0 || game->player == NULL)
+    {
+        return;
+    }
+
+    bool dead = game->player->base.currentState == STATE_DEAD;
+
+    // The game over screen is prepared while the last death plays out, and shown once it is over
+    if (dead && !gameplay->wasDead && ++gameplay->deaths >= gameplay->lives)
+    {
+        PreloadScene(GetSceneManager(), SCENE_GAME_OVER);
+    }
+    else if (!dead && gameplay->wasDead && gameplay->deaths >= gameplay->lives)
+    {
+        gameOverScene.survived = game->tick / (float)TICKS_PER_SECOND;
+        SwitchScene(GetSceneManager(), SCENE_GAME_OVER);
+    }
+
+    gameplay->wasDead = dead;
+}
+
+static void GameplayDraw(Scene *scene, RenderList *list)
+{
+    GameplayScene *gameplay = (GameplayScene *)scene->data;
+    DrawGame(gameplay->game, list);
+}
+
+static void GameplayUnload(Scene *scene)
+{
+    GameplayScene *gameplay = (GameplayScene *)scene->data;
+
+    if (gameplay->game != NULL)
+    {
+        CloseGame(gameplay->game);
+        free(gameplay->game);
+        gameplay->game = NULL;
+    }
+
+    // Only what the preload got to
+    if (scene->step > 1)
+    {
+        ReleaseTexture(GetAssetCache(), gameplay->npcSheet);
+    }
+    ReleaseTexture(GetAssetCache(), gameplay->playerSheet);
+}
+
+// ---- Game over ----
+
+static bool GameOverPreload(Scene *scene)
+{
+    GameOverScene *gameOver = (GameOverScene *)scene->data;
+    gameOver->playerSheet = AcquireTexture(GetAssetCache(), PLAYER_SPRITE_SHEET);
+    return true;
+}
+
+static void GameOverUpdate(Scene *scene)
+{
+    (void)scene;
+    SceneManager *manager = GetSceneManager();
+
+    PreloadScene(manager, SCENE_TITLE);
+
+    if (GetFrameInput()->confirm)
+    {
+        SwitchScene(manager, SCENE_TITLE);
+    }
+}
+
+static void GameOverDraw(Scene *scene, RenderList *list)
+{
+    GameOverScene *gameOver = (GameOverScene *)scene->data;
+
+    PushClear(list, BLACK);
+
+    PushText(list, "GAME OVER", 310, 180, 30, RED);
+    PushSprite(list, gameOver->playerSheet, (Rectangle){320, 1280, 64, 64}, (Vector2){368, 240}, WHITE);
+    PushText(list, TextFormat("Survived %.1f s", gameOver->survived), 320, 340, 20, LIGHTGRAY);
+    PushText(list, "[ENTER] Title", 330, 380, 20, LIGHTGRAY);
+}
+
+static void GameOverUnload(Scene *scene)
+{
+    GameOverScene *gameOver = (GameOverScene *)scene->data;
+    ReleaseTexture(GetAssetCache(), gameOver->playerSheet);
+}
+
+/**
+ * RegisterGameScenes - Registers every scene of the game.
+ *
+ * @manager:  The scene manager.
+ * @settings: What the command line set up (network sessions, NPC count,
+ *            hash log), each gameplay world starts from a copy of it.
+ *
+ * Networked games have no lives, every peer keeps playing.
+ */
+void RegisterGameScenes(SceneManager *manager, const GameData *settings)
+{
+    bool networked = settings->lockstep.active || settings->clientServer.role != NET_ROLE_NONE;
+
+    titleScene.selected = SCENE_GAMEPLAY;
+
+    gameplayScene.settings = *settings;
+    gameplayScene.lives = networked ? 0 : GAMEPLAY_LIVES;
+
+    arenaScene.settings = *settings;
+    arenaScene.settings.npcCount = ARENA_NPC_COUNT;
+    arenaScene.lives = GAMEPLAY_LIVES;
+
+    RegisterScene(manager, SCENE_TITLE, (Scene){"Title", TitlePreload, TitleUpdate, TitleDraw, TitleUnload, &titleScene, 0, false});
+    RegisterScene(manager, SCENE_GAMEPLAY, (Scene){"Gameplay", GameplayPreload, GameplayUpdate, GameplayDraw, GameplayUnload, &gameplayScene, 0, false});
+    RegisterScene(manager, SCENE_ARENA, (Scene){"Arena", GameplayPreload, GameplayUpdate, GameplayDraw, GameplayUnload, &arenaScene, 0, false});
+    RegisterScene(manager, SCENE_GAME_OVER, (Scene){"Game Over", GameOverPreload, GameOverUpdate, GameOverDraw, GameOverUnload, &gameOverScene, 0, false});
+}
@@ -0,0 +1,392 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/utils/script_system.h"
+
+// The script system shared by gameplay code, initialised by InitGame
+static ScriptSystem scriptSystem;
+
+/**
+ * GetScriptSystem - Returns the script system used by gameplay code.
+ *
+ * Scripts only receive their frame and HandleEvent only its game object, so
+ * waits and event notifications reach the pool through this accessor.
+ *
+ * Return: The shared script system.
+ */
+ScriptSystem *GetScriptSystem(void)
+{
+    return &scriptSystem;
+}
+
+static ScriptFrame *FrameOf(const ScriptSystem *system, const GameObject *obj)
+{
+    if (system->frameOf == NULL || obj->entity < 0 || obj->entity >= system->entityCapacity ||
+        system->frameOf[obj->entity] < 0)
+    {
+        return NULL;
+    }
+
+    return &system->frames[system->frameOf[obj->entity]];
+}
+
+// Queues a frame to resume on the next tick, its wait is over
+static void MarkReady(ScriptSystem *system, ScriptFrame *frame)
+{
+    frame->wait = SCRIPT_WAIT_NONE;
+    system->ready[system->readyCount++] = (int)(frame - system->frames);
+}
+
+// Takes a frame off the steering list
+static void StopSteering(ScriptSystem *system, ScriptFrame *frame)
+{
+    if (frame->steeringSlot < 0)
+    {
+        return;
+    }
+
+    // Move the last steering frame into the hole
+    int last = system->steering[--system->steeringCount];
+    system->steering[frame->steeringSlot] = last;
+    system->frames[last].steeringSlot = frame->steeringSlot;
+    frame->steeringSlot = -1;
+}
+
+// Timer wheel delivery, the game object's script has waited long enough
+static void DeliverScriptTimer(GameObject *obj, Event event, void *context)
+{
+    (void)event;
+    ScriptSystem *system = (ScriptSystem *)context;
+    ScriptFrame *frame = FrameOf(system, obj);
+
+    if (frame != NULL && frame->wait == SCRIPT_WAIT_TICKS)
+    {
+        frame->timer = (TimerId){0, 0};
+        MarkReady(system, frame);
+    }
+}
+
+/**
+ * InitScriptSystem - Allocates the script frame pool.
+ *
+ * @system:      The script system to initialise.
+ * @capacity:    Most scripts running at once.
+ * @maxEntities: Entity indices of scripted game objects stay below this.
+ * @resume:      Called before a script resumes or steers its game object (e.g. to
+ *               wake it), may be NULL.
+ * @context:     Passed to @resume.
+ */
+void InitScriptSystem(ScriptSystem *system, int capacity, int maxEntities, ScriptResumeFunction resume, void *context)
+{
+    memset(system, 0, sizeof(ScriptSystem));
+
+    system->frames = (ScriptFrame *)malloc(sizeof(ScriptFrame) * capacity);
+    system->frameOf = (int *)malloc(sizeof(int) * maxEntities);
+    system->ready = (int *)malloc(sizeof(int) * capacity);
+    system->resuming = (int *)malloc(sizeof(int) * capacity);
+    system->steering = (int *)malloc(sizeof(int) * capacity);
+
+    if (!system->frames || !system->frameOf || !system->ready || !system->resuming || !system->steering)
+    {
+        fprintf(stderr, "Failed to allocate script frames\n");
+        exit(1);
+    }
+
+    system->capacity = capacity;
+    system->freeList = -1;
+    for (int i = capacity - 1; i >= 0; i--)
+    {
+        system->frames[i].next = system->freeList;
+        system->freeList = i;
+    }
+
+    for (int i = 0; i < maxEntities; i++)
+    {
+        system->frameOf[i] = -1;
+    }
+
+    system->entityCapacity = maxEntities;
+    system->resume = resume;
+    system->context = context;
+
+    InitTimerWheel(&system->wheel, DeliverScriptTimer, system);
+}
+
+/**
+ * StartScript - Runs a script on a game object.
+ *
+ * @system:   The script system.
+ * @obj:      The game object the script drives.
+ * @function: The script.
+ *
+ * A script already running on the game object is stopped first. The new one
+ * starts from the top on the next TickScripts.
+ *
+ * Return: false if the pool is full or the game object has no entity index.
+ */
+bool StartScript(ScriptSystem *system, GameObject *obj, ScriptFunction function)
+{
+    if (obj->entity < 0 || obj->entity >= system->entityCapacity)
+    {
+        return false;
+    }
+
+    StopScript(system, obj);
+
+    if (system->freeList < 0)
+    {
+        return false;
+    }
+
+    int index = system->freeList;
+    ScriptFrame *frame = &system->frames[index];
+    system->freeList = frame->next;
+
+    memset(frame, 0, sizeof(ScriptFrame));
+    frame->obj = obj;
+    frame->function = function;
+    frame->steeringSlot = -1;
+
+    system->frameOf[obj->entity] = index;
+    system->count++;
+
+    MarkReady(system, frame);
+    return true;
+}
+
+/**
+ * StopScript - Stops the script of a game object.
+ *
+ * @system: The script system.
+ * @obj:    The game object.
+ */
+void StopScript(ScriptSystem *system, GameObject *obj)
+{
+    ScriptFrame *frame = FrameOf(system, obj);
+
+    if (frame == NULL)
+    {
+        return;
+    }
+
+    int index = (int)(frame - system->frames);
+
+    CancelTimer(&system->wheel, &frame->timer);
+    StopSteering(system, frame);
+
+    // Drop it from the ready queue, and from the frames being resumed if TickScripts is running
+    for (int i = 0; i < system->readyCount; i++)
+    {
+        if (system->ready[i] == index)
+        {
+            system->ready[i] = system->ready[--system->readyCount];
+            break;
+        }
+    }
+
+    for (int i = 0; i < system->resumingCount; i++)
+    {
+        if (system->resuming[i] == index)
+        {
+            system->resuming[i] = -1;
+        }
+    }
+
+    system->frameOf[obj->entity] = -1;
+    frame->obj = NULL;
+    frame->next = system->freeList;
+    system->freeList = index;
+    system->count--;
+}
+
+/**
+ * MoveScriptEntity - Follows a game object to a new entity index.
+ *
+ * @system: The script system.
+ * @from:   The entity index the game object had.
+ * @to:     Its new entity index, whoever had it left the world and was stopped.
+ *
+ * Moving an index onto itself forgets it.
+ */
+void MoveScriptEntity(ScriptSystem *system, int from, int to)
+{
+    if (from < 0 || from >= system->entityCapacity || to < 0 || to >= system->entityCapacity)
+    {
+        return;
+    }
+
+    int frame = from != to ? system->frameOf[from] : -1;
+    system->frameOf[from] = -1;
+    system->frameOf[to] = frame;
+}
+
+/**
+ * HasScript - Tells whether a game object runs a script.
+ *
+ * @system: The script system.
+ * @obj:    The game object.
+ *
+ * Return: true if a script drives the game object.
+ */
+bool HasScript(const ScriptSystem *system, const GameObject *obj)
+{
+    return FrameOf(system, obj) != NULL;
+}
+
+/**
+ * ScriptWaitTicks - Suspends a script for a number of ticks (see SCRIPT_WAIT_TICKS).
+ *
+ * @frame: The script's frame.
+ * @ticks: Ticks to wait, at least one.
+ */
+void ScriptWaitTicks(ScriptFrame *frame, uint32_t ticks)
+{
+    ScriptSystem *system = GetScriptSystem();
+
+    frame->wait = SCRIPT_WAIT_TICKS;
+    frame->timer = ScheduleTimer(&system->wheel, frame->obj, EVENT_NONE, ticks > 0 ? ticks : 1);
+}
+
+/**
+ * ScriptWaitEvent - Suspends a script until its game object handles an event
+ *                   (see SCRIPT_WAIT_EVENT).
+ *
+ * @frame: The script's frame.
+ * @event: The awaited event.
+ */
+void ScriptWaitEvent(ScriptFrame *frame, Event event)
+{
+    frame->wait = SCRIPT_WAIT_EVENT;
+    frame->event = event;
+}
+
+/**
+ * ScriptMoveTo - Suspends a script while its game object walks to a point
+ *                (see SCRIPT_MOVE_TO).
+ *
+ * @frame:       The script's frame.
+ * @destination: Where to walk to.
+ */
+void ScriptMoveTo(ScriptFrame *frame, Vector2 destination)
+{
+    ScriptSystem *system = GetScriptSystem();
+
+    frame->wait = SCRIPT_WAIT_ARRIVAL;
+    frame->destination = destination;
+
+    if (frame->steeringSlot < 0)
+    {
+        frame->steeringSlot = system->steeringCount;
+        system->steering[system->steeringCount++] = (int)(frame - system->frames);
+    }
+}
+
+/**
+ * NotifyScriptEvent - Wakes a script waiting for an event.
+ *
+ * @system: The script system.
+ * @obj:    The game object handling the event.
+ * @event:  The event.
+ *
+ * Called for every handled event, so it costs one lookup when nothing waits.
+ * The script resumes on the next TickScripts rather than inside the event
+ * handler, so scripts never run re-entrantly.
+ */
+void NotifyScriptEvent(ScriptSystem *system, GameObject *obj, Event event)
+{
+    ScriptFrame *frame = FrameOf(system, obj);
+
+    if (frame != NULL && frame->wait == SCRIPT_WAIT_EVENT && frame->event == event)
+    {
+        MarkReady(system, frame);
+    }
+}
+
+/**
+ * TickScripts - Runs one tick of the script system.
+ *
+ * @system: The script system.
+ *
+ * Advances the script timers, walks every moving script's game object one
+ * more step straight toward its destination with an EVENT_MOVE carrying the
+ * direction (or stops it once it arrived) and then resumes the scripts whose
+ * wait ended, in the order they were woken. Scripts woken while resuming
+ * (e.g. by an event one script sends another) run on the next tick.
+ */
+void TickScripts(ScriptSystem *system)
+{
+    AdvanceTimerWheel(&system->wheel);
+
+    // Walk the movers, arrivals leave the steering list so iterate backwards
+    for (int i = system->steeringCount - 1; i >= 0; i--)
+    {
+        ScriptFrame *frame = &system->frames[system->steering[i]];
+        GameObject *obj = frame->obj;
+
+        if (system->resume != NULL)
+        {
+            system->resume(obj, system->context);
+        }
+
+        if (fabsf(frame->destination.x - obj->position.x) <= SCRIPT_ARRIVAL_RADIUS &&
+            fabsf(frame->destination.y - obj->position.y) <= SCRIPT_ARRIVAL_RADIUS)
+        {
+            StopSteering(system, frame);
+            HandleEvent(obj, EVENT_NONE); // Stand still at the destination
+            MarkReady(system, frame);
+        }
+        else
+        {
+            HandleMoveEvent(obj, (Vector2){frame->destination.x - obj->position.x,
+                                           frame->destination.y - obj->position.y});
+        }
+    }
+
+    // Swap the queues, frames woken from here on are queued for the next tick
+    int *resuming = system->ready;
+    system->ready = system->resuming;
+    system->resuming = resuming;
+    system->resumingCount = system->readyCount;
+    system->readyCount = 0;
+
+    for (int i = 0; i < system->resumingCount; i++)
+    {
+        if (system->resuming[i] < 0)
+        {
+            continue; // Stopped by an earlier script this tick
+        }
+
+        ScriptFrame *frame = &system->frames[system->resuming[i]];
+        GameObject *obj = frame->obj;
+
+        if (system->resume != NULL)
+        {
+            system->resume(obj, system->context);
+        }
+
+        if (frame->function(frame) == SCRIPT_DONE)
+        {
+            StopScript(system, obj);
+        }
+    }
+
+    system->resumingCount = 0;
+}
+
+/**
+ * FreeScriptSystem - Frees the frame pool.
+ *
+ * @system: The script system to free.
+ */
+void FreeScriptSystem(ScriptSystem *system)
+{
+    FreeTimerWheel(&system->wheel);
+    free(system->frames);
+    free(system->frameOf);
+    free(system->ready);
+    free(system->resuming);
+    free(system->steering);
+    memset(system, 0, sizeof(ScriptSystem));
+}
@@ -0,0 +1,401 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/utils/sleep_system.h"
+
+// The sleep system of the game's NPCs, initialised by InitGame
+static SleepSystem sleepSystem;
+
+/**
+ * GetSleepSystem - Returns the sleep system of the game's NPCs.
+ *
+ * HandleEvent only receives its game object, so an event sent to a sleeper
+ * wakes it through this accessor.
+ *
+ * Return: The shared sleep system.
+ */
+SleepSystem *GetSleepSystem(void)
+{
+    return &sleepSystem;
+}
+
+static int GridCoordinate(float value)
+{
+    return (int)floorf(value / SLEEP_GRID_CELL);
+}
+
+static int GridBucket(int cellX, int cellY)
+{
+    unsigned int hash = ((unsigned int)cellX * 73856093u) ^ ((unsigned int)cellY * 19349663u);
+    return (int)(hash & (SLEEP_GRID_BUCKETS - 1));
+}
+
+/**
+ * InitSleepSystem - Allocates the active list and sleeper grid.
+ *
+ * @system:   The sleep system to initialise.
+ * @capacity: Maximum number of objects that can be managed.
+ */
+void InitSleepSystem(SleepSystem *system, int capacity)
+{
+    memset(system, 0, sizeof(SleepSystem));
+
+    system->objects = (GameObject **)malloc(sizeof(GameObject *) * capacity);
+    system->lastPositions = (Vector2 *)malloc(sizeof(Vector2) * capacity);
+    system->active = (int *)malloc(sizeof(int) * capacity);
+    system->activeIndex = (int *)malloc(sizeof(int) * capacity);
+    system->bucketOf = (int *)malloc(sizeof(int) * capacity);
+    system->nextSleeper = (int *)malloc(sizeof(int) * capacity);
+    system->previousSleeper = (int *)malloc(sizeof(int) * capacity);
+
+    if (!system->objects || !system->lastPositions || !system->active || !system->activeIndex ||
+        !system->bucketOf || !system->nextSleeper || !system->previousSleeper)
+    {
+        fprintf(stderr, "Failed to allocate sleep system\n");
+        exit(1);
+    }
+
+    for (int i = 0; i < SLEEP_GRID_BUCKETS; i++)
+    {
+        system->buckets[i] = -1;
+    }
+
+    system->capacity = capacity;
+}
+
+/**
+ * AddToSleepSystem - Starts managing an object, it starts awake.
+ *
+ * @system: The sleep system.
+ * @obj:    The game object to manage.
+ *
+ * Return: The slot of the object, or -1 if the system is full.
+ */
+int AddToSleepSystem(SleepSystem *system, GameObject *obj)
+{
+    if (system->count >= system->capacity)
+    {
+        fprintf(stderr, "Sleep system is full\n");
+        return -1;
+    }
+
+    int slot = system->count++;
+
+    system->objects[slot] = obj;
+    system->lastPositions[slot] = obj->position;
+    system->activeIndex[slot] = system->activeCount;
+    system->active[system->activeCount++] = slot;
+
+    obj->asleep = false;
+    obj->quietTicks = 0;
+    obj->sleepSlot = slot;
+
+    return slot;
+}
+
+// Moves an awake object into the sleeper grid
+static void Sleep(SleepSystem *system, int slot)
+{
+    GameObject *obj = system->objects[slot];
+
+    // Swap remove from the active list
+    int index = system->activeIndex[slot];
+    int last = system->active[--system->activeCount];
+    system->active[index] = last;
+    system->activeIndex[last] = index;
+    system->activeIndex[slot] = -1;
+
+    // Push onto the front of its grid bucket
+    int bucket = GridBucket(GridCoordinate(obj->position.x), GridCoordinate(obj->position.y));
+    system->bucketOf[slot] = bucket;
+    system->previousSleeper[slot] = -1;
+    system->nextSleeper[slot] = system->buckets[bucket];
+    if (system->buckets[bucket] >= 0)
+    {
+        system->previousSleeper[system->buckets[bucket]] = slot;
+    }
+    system->buckets[bucket] = slot;
+
+    obj->asleep = true;
+}
+
+// Moves a sleeper back into the active list
+static void Wake(SleepSystem *system, int slot)
+{
+    GameObject *obj = system->objects[slot];
+
+    // Unlink from its grid bucket
+    int previous = system->previousSleeper[slot];
+    int next = system->nextSleeper[slot];
+    if (previous >= 0)
+    {
+        system->nextSleeper[previous] = next;
+    }
+    else
+    {
+        system->buckets[system->bucketOf[slot]] = next;
+    }
+    if (next >= 0)
+    {
+        system->previousSleeper[next] = previous;
+    }
+
+    system->activeIndex[slot] = system->activeCount;
+    system->active[system->activeCount++] = slot;
+    system->lastPositions[slot] = obj->position;
+
+    obj->asleep = false;
+    obj->quietTicks = 0;
+}
+
+/**
+ * RemoveFromSleepSystem - Stops managing an object.
+ *
+ * @system: The sleep system.
+ * @obj:    The game object to remove, does nothing if it is unmanaged.
+ *
+ * The object with the last slot takes the removed one's slot, so slots stay
+ * dense and keep matching the order the objects were added in, as long as
+ * the caller swap removes its own array the same way.
+ */
+void RemoveFromSleepSystem(SleepSystem *system, GameObject *obj)
+{
+    int slot = obj->sleepSlot;
+
+    if (slot < 0 || slot >= system->count || system->objects[slot] != obj)
+    {
+        return;
+    }
+
+    // Take it off the active list or out of its grid bucket
+    if (obj->asleep)
+    {
+        Wake(system, slot);
+    }
+
+    int index = system->activeIndex[slot];
+    int lastActive = system->active[--system->activeCount];
+    system->active[index] = lastActive;
+    system->activeIndex[lastActive] = index;
+
+    obj->asleep = false;
+    obj->sleepSlot = -1;
+
+    // Move the last slot into the hole, it is awake at this point or linked in a bucket
+    int last = --system->count;
+    if (slot == last)
+    {
+        return;
+    }
+
+    GameObject *moved = system->objects[last];
+    system->objects[slot] = moved;
+    system->lastPositions[slot] = system->lastPositions[last];
+    system->activeIndex[slot] = system->activeIndex[last];
+    moved->sleepSlot = slot;
+
+    if (moved->asleep)
+    {
+        int previous = system->previousSleeper[last];
+        int next = system->nextSleeper[last];
+
+        system->bucketOf[slot] = system->bucketOf[last];
+        system->previousSleeper[slot] = previous;
+        system->nextSleeper[slot] = next;
+
+        if (previous >= 0)
+        {
+            system->nextSleeper[previous] = slot;
+        }
+        else
+        {
+            system->buckets[system->bucketOf[slot]] = slot;
+        }
+        if (next >= 0)
+        {
+            system->previousSleeper[next] = slot;
+        }
+    }
+    else
+    {
+        system->active[system->activeIndex[slot]] = slot;
+    }
+}
+
+/**
+ * WakeGameObject - Wakes a single object.
+ *
+ * @system: The sleep system.
+ * @obj:    The game object to wake, does nothing if it is awake or unmanaged.
+ *
+ * Sleepers are not in the update or AI lists, so every event sent to an
+ * object wakes it (see HandleEventData), as do triggers entered near it.
+ */
+void WakeGameObject(SleepSystem *system, GameObject *obj)
+{
+    if (obj->asleep && obj->sleepSlot >= 0 && obj->sleepSlot < system->count && system->objects[obj->sleepSlot] == obj)
+    {
+        Wake(system, obj->sleepSlot);
+    }
+    else
+    {
+        obj->quietTicks = 0;
+    }
+}
+
+/**
+ * WakeGameObjectsNear - Wakes every sleeper within a radius of a position.
+ *
+ * @system:   The sleep system.
+ * @position: Centre of the area.
+ * @radius:   Radius of the area.
+ *
+ * Only the grid buckets overlapping the area are visited.
+ */
+void WakeGameObjectsNear(SleepSystem *system, Vector2 position, float radius)
+{
+    int minX = GridCoordinate(position.x - radius);
+    int maxX = GridCoordinate(position.x + radius);
+    int minY = GridCoordinate(position.y - radius);
+    int maxY = GridCoordinate(position.y + radius);
+    float radiusSquared = radius * radius;
+
+    for (int cellY = minY; cellY <= maxY; cellY++)
+    {
+        for (int cellX = minX; cellX <= maxX; cellX++)
+        {
+            int slot = system->buckets[GridBucket(cellX, cellY)];
+
+            while (slot >= 0)
+            {
+                int next = system->nextSleeper[slot]; // Wake unlinks the slot
+                Vector2 sleeperPosition = system->objects[slot]->position;
+
+                if (Vector2DistanceSqr(sleeperPosition, position) <= radiusSquared)
+                {
+                    Wake(system, slot);
+                }
+                slot = next;
+            }
+        }
+    }
+}
+
+/**
+ * FindSleepersNear - Collects the sleepers near any of a set of points.
+ *
+ * @system:     The sleep system.
+ * @x:          X of each point.
+ * @y:          Y of each point.
+ * @pointCount: Number of points.
+ * @radius:     How far from a point a sleeper may be.
+ * @slots:      Receives the slots of the sleepers found.
+ * @maxSlots:   Capacity of @slots.
+ *
+ * Marks the grid buckets overlapping each point's area, then lists the
+ * sleepers of every marked bucket once. Whole buckets are listed, so some
+ * sleepers lie further away than @radius (cells share buckets), but every
+ * sleeper within it is found and none twice. The grid persists between
+ * calls, the cost follows the points and the sleepers near them.
+ *
+ * Return: The number of slots written to @slots.
+ */
+int FindSleepersNear(const SleepSystem *system, const float *x, const float *y, int pointCount, float radius, int *slots, int maxSlots)
+{
+    bool marked[SLEEP_GRID_BUCKETS] = {0};
+    int found = 0;
+
+    for (int i = 0; i < pointCount; i++)
+    {
+        int minX = GridCoordinate(x[i] - radius);
+        int maxX = GridCoordinate(x[i] + radius);
+        int minY = GridCoordinate(y[i] - radius);
+        int maxY = GridCoordinate(y[i] + radius);
+
+        for (int cellY = minY; cellY <= maxY; cellY++)
+        {
+            for (int cellX = minX; cellX <= maxX; cellX++)
+            {
+                int bucket = GridBucket(cellX, cellY);
+
+                if (marked[bucket])
+                {
+                    continue;
+                }
+                marked[bucket] = true;
+
+                for (int slot = system->buckets[bucket]; slot >= 0 && found < maxSlots; slot = system->nextSleeper[slot])
+                {
+                    slots[found++] = slot;
+                }
+            }
+        }
+    }
+
+    return found;
+}
+
+/**
+ * UpdateSleepSystem - Puts quiet objects to sleep and wakes sleepers near activity.
+ *
+ * @system:     The sleep system.
+ * @wakers:     Objects that always keep their surroundings awake (the players).
+ * @wakerCount: Number of wakers.
+ *
+ * An awake object that stays in STATE_IDLE without moving (and without
+ * receiving events, see HandleEvent) for SLEEP_QUIET_TICKS is put to sleep.
+ * Sleepers near a waker or near an awake object that moved this tick are woken.
+ * The cost scales with the number of awake objects, sleepers are only touched
+ * when something comes near them.
+ */
+void UpdateSleepSystem(SleepSystem *system, GameObject **wakers, int wakerCount)
+{
+    // Walk backwards so putting an object to sleep (swap remove) never skips one
+    for (int i = system->activeCount - 1; i >= 0; i--)
+    {
+        int slot = system->active[i];
+        GameObject *obj = system->objects[slot];
+        bool moved = obj->position.x != system->lastPositions[slot].x ||
+                     obj->position.y != system->lastPositions[slot].y;
+
+        system->lastPositions[slot] = obj->position;
+
+        if (moved || obj->currentState != STATE_IDLE || obj->health <= 0)
+        {
+            obj->quietTicks = 0;
+        }
+        else if (++obj->quietTicks >= SLEEP_QUIET_TICKS)
+        {
+            Sleep(system, slot);
+            continue;
+        }
+
+        if (moved)
+        {
+            WakeGameObjectsNear(system, obj->position, SLEEP_WAKE_RADIUS);
+        }
+    }
+
+    for (int i = 0; i < wakerCount; i++)
+    {
+        WakeGameObjectsNear(system, wakers[i]->position, SLEEP_WAKE_RADIUS);
+    }
+}
+
+/**
+ * FreeSleepSystem - Frees the sleep system.
+ *
+ * @system: The sleep system to free.
+ */
+void FreeSleepSystem(SleepSystem *system)
+{
+    free(system->objects);
+    free(system->lastPositions);
+    free(system->active);
+    free(system->activeIndex);
+    free(system->bucketOf);
+    free(system->nextSleeper);
+    free(system->previousSleeper);
+    memset(system, 0, sizeof(SleepSystem));
+}
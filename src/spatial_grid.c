@@ -0,0 +1,298 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/utils/spatial_grid.h"
+
+/**
+ * SpatialGridCoordinate - Returns the grid cell containing a coordinate.
+ *
+ * @value: A world coordinate (x or y).
+ *
+ * Return: The cell index along that axis.
+ */
+int SpatialGridCoordinate(float value)
+{
+    return (int)floorf(value / SPATIAL_GRID_CELL);
+}
+
+/**
+ * SpatialGridBucket - Hashes a grid cell to a bucket.
+ *
+ * @cellX: Cell index along x.
+ * @cellY: Cell index along y.
+ *
+ * The grid is unbounded, distant cells may share a bucket, so whatever is
+ * found in a bucket still has to be tested against the actual positions.
+ *
+ * Return: The bucket of the cell.
+ */
+int SpatialGridBucket(int cellX, int cellY)
+{
+    unsigned int hash = ((unsigned int)cellX * 73856093u) ^ ((unsigned int)cellY * 19349663u);
+    return (int)(hash & (SPATIAL_GRID_BUCKETS - 1));
+}
+
+// Grows a scratch array to hold at least count elements
+static int *GrowEntries(int *array, int capacity, int count)
+{
+    if (count <= capacity)
+    {
+        return array;
+    }
+
+    int *grown = (int *)realloc(array, sizeof(int) * count);
+    if (!grown)
+    {
+        fprintf(stderr, "Failed to grow spatial grid\n");
+        exit(1);
+    }
+
+    return grown;
+}
+
+/**
+ * BuildSpatialGrid - Buckets the agents by grid cell.
+ *
+ * @grid:   The spatial grid, rebuilt from scratch.
+ * @agents: The agents to bucket.
+ * @count:  Number of agents.
+ * @margin: Extra reach added to every agent's radius. Projectiles only look in
+ *          the cell they start in, so they need a margin covering a full step,
+ *          target queries walk the cells around them and need none.
+ */
+void BuildSpatialGrid(SpatialGrid *grid, const SpatialAgent *agents, int count, float margin)
+{
+    // First pass: count the entries
+    int entryCount = 0;
+    for (int a = 0; a < count; a++)
+    {
+        float reach = agents[a].radius + margin;
+        int spanX = SpatialGridCoordinate(agents[a].position.x + reach) - SpatialGridCoordinate(agents[a].position.x - reach) + 1;
+        int spanY = SpatialGridCoordinate(agents[a].position.y + reach) - SpatialGridCoordinate(agents[a].position.y - reach) + 1;
+        entryCount += spanX * spanY;
+    }
+
+    if (entryCount > grid->entryCapacity)
+    {
+        int capacity = grid->entryCapacity > 0 ? grid->entryCapacity : 64;
+        while (capacity < entryCount)
+        {
+            capacity *= 2;
+        }
+
+        grid->entries = GrowEntries(grid->entries, grid->entryCapacity, capacity);
+        grid->entryRuns = GrowEntries(grid->entryRuns, grid->entryCapacity, capacity);
+        grid->entryAgents = GrowEntries(grid->entryAgents, grid->entryCapacity, capacity);
+        grid->entryCapacity = capacity;
+    }
+
+    // Second pass: record (run, agent) pairs and count per run
+    memset(grid->runStart, 0, sizeof(grid->runStart));
+    int e = 0;
+    for (int a = 0; a < count; a++)
+    {
+        int faction = agents[a].faction % SPATIAL_GRID_FACTIONS;
+        float reach = agents[a].radius + margin;
+        int minX = SpatialGridCoordinate(agents[a].position.x - reach);
+        int maxX = SpatialGridCoordinate(agents[a].position.x + reach);
+        int minY = SpatialGridCoordinate(agents[a].position.y - reach);
+        int maxY = SpatialGridCoordinate(agents[a].position.y + reach);
+
+        for (int cellY = minY; cellY <= maxY; cellY++)
+        {
+            for (int cellX = minX; cellX <= maxX; cellX++)
+            {
+                int run = SpatialGridBucket(cellX, cellY) * SPATIAL_GRID_FACTIONS + faction;
+                grid->entryRuns[e] = run;
+                grid->entryAgents[e] = a;
+                grid->runStart[run + 1]++;
+                e++;
+            }
+        }
+    }
+
+    // Counting sort the entries by run
+    for (int r = 0; r < SPATIAL_GRID_RUNS; r++)
+    {
+        grid->runStart[r + 1] += grid->runStart[r];
+    }
+
+    // The run counts are no longer needed, advance them as insertion cursors and shift back after
+    for (int i = 0; i < entryCount; i++)
+    {
+        grid->entries[grid->runStart[grid->entryRuns[i]]++] = grid->entryAgents[i];
+    }
+
+    memmove(&grid->runStart[1], &grid->runStart[0], sizeof(int) * SPATIAL_GRID_RUNS);
+    grid->runStart[0] = 0;
+}
+
+// Offers a candidate to a query's nearest list, kept sorted by distance then entity
+static void OfferCandidate(const SpatialAgent *agents, int candidate, float distanceSquared,
+                           int *best, float *bestDistance, int *found, int k)
+{
+    int entity = agents[candidate].entity;
+
+    // Full and not nearer than the worst kept (ties go to the lower entity, the same on every peer)
+    if (*found == k && (distanceSquared > bestDistance[k - 1] ||
+                        (distanceSquared == bestDistance[k - 1] && entity >= agents[best[k - 1]].entity)))
+    {
+        return;
+    }
+
+    // Large agents sit in several cells, hashed cells can share a bucket
+    for (int i = 0; i < *found; i++)
+    {
+        if (best[i] == candidate)
+        {
+            return;
+        }
+    }
+
+    int slot = *found < k ? (*found)++ : k - 1;
+    while (slot > 0 && (bestDistance[slot - 1] > distanceSquared ||
+                        (bestDistance[slot - 1] == distanceSquared && agents[best[slot - 1]].entity > entity)))
+    {
+        best[slot] = best[slot - 1];
+        bestDistance[slot] = bestDistance[slot - 1];
+        slot--;
+    }
+
+    best[slot] = candidate;
+    bestDistance[slot] = distanceSquared;
+}
+
+// Tests the hostile agents in a grid cell's bucket against the query, the own faction's run is never touched
+static void ScanCell(const SpatialGrid *grid, const SpatialAgent *agents, int query, int cellX, int cellY, float range,
+                     int *best, float *bestDistance, int *found, int k)
+{
+    const SpatialAgent *self = &agents[query];
+    int firstRun = SpatialGridBucket(cellX, cellY) * SPATIAL_GRID_FACTIONS;
+
+    for (int f = 0; f < SPATIAL_GRID_FACTIONS; f++)
+    {
+        if (f == self->faction % SPATIAL_GRID_FACTIONS)
+        {
+            continue;
+        }
+
+        for (int e = grid->runStart[firstRun + f]; e < grid->runStart[firstRun + f + 1]; e++)
+        {
+            int candidate = grid->entries[e];
+            const SpatialAgent *other = &agents[candidate];
+
+            float dx = other->position.x - self->position.x;
+            float dy = other->position.y - self->position.y;
+            float distanceSquared = dx * dx + dy * dy;
+
+            if (distanceSquared <= range * range)
+            {
+                OfferCandidate(agents, candidate, distanceSquared, best, bestDistance, found, k);
+            }
+        }
+    }
+}
+
+// Distance along one axis from a point offset into its cell to the cell d cells away
+static float CellGap(int d, float offset)
+{
+    if (d < 0)
+    {
+        return offset + (-d - 1) * SPATIAL_GRID_CELL;
+    }
+
+    return d > 0 ? d * SPATIAL_GRID_CELL - offset : 0.0f;
+}
+
+/**
+ * FindNearestHostiles - Finds the nearest agents of other factions.
+ *
+ * @grid:       A spatial grid built over @agents.
+ * @agents:     Every agent that can be found, and the ones asking.
+ * @queries:    Indices into @agents of the agents asking.
+ * @queryCount: Number of queries.
+ * @k:          Most agents returned per query.
+ * @range:      Agents whose centre is further away are ignored.
+ * @results:    Receives k agent indices per query, nearest first.
+ * @counts:     Receives the number of agents found per query.
+ *
+ * Each query walks rings of cells outward from its own cell. An agent sits in
+ * the cell of its centre at least, so everything not seen after ring r is more
+ * than r cells away and the walk stops as soon as the k found are nearer than
+ * that, or the rings leave the range. All queries of an AI tick are answered
+ * against one grid build.
+ */
+void FindNearestHostiles(const SpatialGrid *grid, const SpatialAgent *agents, const int *queries, int queryCount,
+                         int k, float range, int *results, int *counts)
+{
+    float *bestDistance = (float *)malloc(sizeof(float) * (k > 0 ? k : 1));
+    if (!bestDistance)
+    {
+        fprintf(stderr, "Failed to allocate nearest hostile buffer\n");
+        exit(1);
+    }
+
+    for (int q = 0; q < queryCount; q++)
+    {
+        int *best = &results[q * k];
+        int found = 0;
+
+        if (k > 0)
+        {
+            Vector2 position = agents[queries[q]].position;
+            int centreX = SpatialGridCoordinate(position.x);
+            int centreY = SpatialGridCoordinate(position.y);
+
+            // Where the query sits inside its own cell
+            float offsetX = position.x - centreX * SPATIAL_GRID_CELL;
+            float offsetY = position.y - centreY * SPATIAL_GRID_CELL;
+
+            for (int ring = 0;; ring++)
+            {
+                for (int dy = -ring; dy <= ring; dy++)
+                {
+                    // Whole rows at the top and bottom of the ring, only the ends in between
+                    int step = (dy == -ring || dy == ring) ? 1 : 2 * ring;
+                    float gapY = CellGap(dy, offsetY);
+
+                    for (int dx = -ring; dx <= ring; dx += step)
+                    {
+                        // Skip cells entirely beyond the range or the k-th nearest so far
+                        float gapX = CellGap(dx, offsetX);
+                        float limit = found == k ? bestDistance[k - 1] : range * range;
+
+                        if (gapX * gapX + gapY * gapY <= limit)
+                        {
+                            ScanCell(grid, agents, queries[q], centreX + dx, centreY + dy, range, best, bestDistance, &found, k);
+                        }
+                    }
+                }
+
+                float reached = ring * SPATIAL_GRID_CELL;
+                if (reached >= range || (found == k && bestDistance[k - 1] <= reached * reached))
+                {
+                    break;
+                }
+            }
+        }
+
+        counts[q] = found;
+    }
+
+    free(bestDistance);
+}
+
+/**
+ * FreeSpatialGrid - Frees the grid buffers.
+ *
+ * @grid: The spatial grid to free.
+ */
+void FreeSpatialGrid(SpatialGrid *grid)
+{
+    free(grid->entries);
+    free(grid->entryRuns);
+    free(grid->entryAgents);
+    memset(grid, 0, sizeof(SpatialGrid));
+}
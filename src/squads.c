@@ -0,0 +1,382 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/utils/squads.h"
+#include "../include/utils/ai_manager.h"
+
+/**
+ * InitSquadSystem - Prepares an empty squad system.
+ *
+ * @system:      The squad system to initialise.
+ * @maxEntities: Entity indices of squad members stay below this.
+ */
+void InitSquadSystem(SquadSystem *system, int maxEntities)
+{
+    memset(system, 0, sizeof(SquadSystem));
+
+    system->squadOf = (int *)malloc(sizeof(int) * maxEntities);
+    if (!system->squadOf)
+    {
+        fprintf(stderr, "Failed to allocate squads\n");
+        exit(1);
+    }
+
+    for (int i = 0; i < maxEntities; i++)
+    {
+        system->squadOf[i] = -1;
+    }
+
+    system->entityCapacity = maxEntities;
+    system->dirty = true;
+}
+
+/**
+ * SquadsNeedReform - Decides whether the squads are stale.
+ *
+ * @system:   The squad system.
+ * @tick:     The current simulation tick.
+ * @npcCount: Number of NPCs that would be grouped now (the awake NPCs).
+ *
+ * Squads are regrouped every SQUAD_REFORM_TICKS, when the set of awake NPCs
+ * grew or shrank, or when a leader can no longer lead.
+ *
+ * Return: true if FormSquads should run this tick.
+ */
+bool SquadsNeedReform(const SquadSystem *system, uint32_t tick, int npcCount)
+{
+    return system->dirty || npcCount != system->formedFrom || tick - system->formedTick >= SQUAD_REFORM_TICKS;
+}
+
+static bool IsSquadMember(const SquadSystem *system, const GameObject *obj)
+{
+    return obj->entity >= 0 && obj->entity < system->entityCapacity && system->squadOf[obj->entity] >= 0;
+}
+
+/**
+ * DisbandSquads - Forgets every squad, they are formed again on the next update.
+ *
+ * @system: The squad system.
+ *
+ * Call before members leave the world or change entity index, squads refer
+ * to their members by pointer and entity index.
+ */
+void DisbandSquads(SquadSystem *system)
+{
+    for (int s = 0; s < system->count; s++)
+    {
+        for (int m = 0; m < system->squads[s].memberCount; m++)
+        {
+            GameObject *member = system->squads[s].members[m];
+            if (member->entity >= 0 && member->entity < system->entityCapacity)
+            {
+                system->squadOf[member->entity] = -1;
+            }
+        }
+    }
+
+    system->count = 0;
+    system->dirty = true;
+}
+
+static int GridCoordinate(float value)
+{
+    return (int)floorf(value / SQUAD_RADIUS);
+}
+
+static int GridBucket(int cellX, int cellY, int faction)
+{
+    unsigned int hash = ((unsigned int)cellX * 73856093u) ^ ((unsigned int)cellY * 19349663u) ^
+                        ((unsigned int)faction * 83492791u);
+    return (int)(hash & (SQUAD_GRID_BUCKETS - 1));
+}
+
+// Grows the free lists to hold count NPCs
+static void GrowFreeLists(SquadSystem *system, int count)
+{
+    if (count <= system->freeCapacity)
+    {
+        return;
+    }
+
+    int *bucketOf = (int *)realloc(system->bucketOf, sizeof(int) * count);
+    int *nextFree = bucketOf ? (int *)realloc(system->nextFree, sizeof(int) * count) : NULL;
+    int *previousFree = nextFree ? (int *)realloc(system->previousFree, sizeof(int) * count) : NULL;
+    if (!previousFree)
+    {
+        fprintf(stderr, "Failed to grow squads\n");
+        exit(1);
+    }
+
+    system->bucketOf = bucketOf;
+    system->nextFree = nextFree;
+    system->previousFree = previousFree;
+    system->freeCapacity = count;
+}
+
+// Takes an NPC out of the free lists once it leads or joins a squad
+static void TakeFree(SquadSystem *system, int n)
+{
+    if (system->bucketOf[n] < 0)
+    {
+        return;
+    }
+
+    int previous = system->previousFree[n];
+    int next = system->nextFree[n];
+    if (previous >= 0)
+    {
+        system->nextFree[previous] = next;
+    }
+    else
+    {
+        system->buckets[system->bucketOf[n]] = next;
+    }
+    if (next >= 0)
+    {
+        system->previousFree[next] = previous;
+    }
+
+    system->bucketOf[n] = -1;
+}
+
+// Buckets every living NPC that can join a squad, pushed in reverse so each list ascends
+static void BucketFreeNPCs(SquadSystem *system, GameObject **npcs, int count)
+{
+    GrowFreeLists(system, count);
+
+    for (int b = 0; b < SQUAD_GRID_BUCKETS; b++)
+    {
+        system->buckets[b] = -1;
+    }
+
+    for (int n = count - 1; n >= 0; n--)
+    {
+        GameObject *obj = npcs[n];
+
+        if (obj->entity < 0 || obj->entity >= system->entityCapacity || obj->currentState == STATE_DEAD)
+        {
+            system->bucketOf[n] = -1;
+            continue;
+        }
+
+        int bucket = GridBucket(GridCoordinate(obj->position.x), GridCoordinate(obj->position.y), obj->faction);
+        system->bucketOf[n] = bucket;
+        system->previousFree[n] = -1;
+        system->nextFree[n] = system->buckets[bucket];
+        if (system->buckets[bucket] >= 0)
+        {
+            system->previousFree[system->buckets[bucket]] = n;
+        }
+        system->buckets[bucket] = n;
+    }
+}
+
+// Fills a squad with the lowest free NPCs of its leader's faction within
+// SQUAD_RADIUS, merging the ascending lists of the buckets around the leader
+static void Recruit(SquadSystem *system, GameObject **npcs, int s)
+{
+    Squad *squad = &system->squads[s];
+    const GameObject *leader = squad->members[0];
+
+    // The cells are SQUAD_RADIUS wide, so the 3x3 around the leader's cell cover its reach
+    int cursors[9];
+    int bucketsSeen[9];
+    int cursorCount = 0;
+    int cellX = GridCoordinate(leader->position.x);
+    int cellY = GridCoordinate(leader->position.y);
+
+    for (int y = cellY - 1; y <= cellY + 1; y++)
+    {
+        for (int x = cellX - 1; x <= cellX + 1; x++)
+        {
+            int bucket = GridBucket(x, y, leader->faction);
+            bool seen = false;
+
+            // Cells sharing a bucket share its list, it is merged once
+            for (int c = 0; c < cursorCount && !seen; c++)
+            {
+                seen = bucketsSeen[c] == bucket;
+            }
+
+            if (!seen)
+            {
+                bucketsSeen[cursorCount] = bucket;
+                cursors[cursorCount++] = system->buckets[bucket];
+            }
+        }
+    }
+
+    while (squad->memberCount < SQUAD_MAX_MEMBERS)
+    {
+        int lowest = -1;
+        for (int c = 0; c < cursorCount; c++)
+        {
+            if (cursors[c] >= 0 && (lowest < 0 || cursors[c] < cursors[lowest]))
+            {
+                lowest = c;
+            }
+        }
+
+        if (lowest < 0)
+        {
+            break;
+        }
+
+        int n = cursors[lowest];
+        cursors[lowest] = system->nextFree[n];
+
+        // Distant cells and other factions can hash into the same buckets
+        GameObject *recruit = npcs[n];
+        float dx = recruit->position.x - leader->position.x;
+        float dy = recruit->position.y - leader->position.y;
+
+        if (recruit->faction == leader->faction && dx * dx + dy * dy <= SQUAD_RADIUS * SQUAD_RADIUS)
+        {
+            squad->members[squad->memberCount++] = recruit;
+            system->squadOf[recruit->entity] = s;
+            TakeFree(system, n);
+        }
+    }
+}
+
+/**
+ * FormSquads - Groups NPCs into squads by proximity.
+ *
+ * @system: The squad system.
+ * @npcs:   The NPCs to group (normally the awake ones).
+ * @count:  Number of NPCs.
+ * @tick:   The current simulation tick.
+ *
+ * Walks the NPCs in order, every NPC not yet in a squad leads a new one and
+ * recruits the next free living NPCs of its faction within SQUAD_RADIUS
+ * until it is full.
+ * The order is the only input besides positions, so lockstep peers form the
+ * same squads. Free NPCs are kept in a grid, so a leader only looks at the
+ * ones around it and forming stays linear in crowds of thousands.
+ */
+void FormSquads(SquadSystem *system, GameObject **npcs, int count, uint32_t tick)
+{
+    DisbandSquads(system);
+
+    if (count > system->capacity)
+    {
+        Squad *squads = (Squad *)realloc(system->squads, sizeof(Squad) * count);
+        if (!squads)
+        {
+            fprintf(stderr, "Failed to grow squads\n");
+            exit(1);
+        }
+
+        system->squads = squads;
+        system->capacity = count;
+    }
+
+    BucketFreeNPCs(system, npcs, count);
+
+    for (int i = 0; i < count; i++)
+    {
+        GameObject *leader = npcs[i];
+
+        if (IsSquadMember(system, leader) || leader->entity < 0 || leader->entity >= system->entityCapacity)
+        {
+            continue;
+        }
+
+        int s = system->count++;
+        Squad *squad = &system->squads[s];
+        squad->members[0] = leader;
+        squad->memberCount = 1;
+        squad->order = COMMAND_NONE;
+        system->squadOf[leader->entity] = s;
+        TakeFree(system, i);
+
+        // The dead neither lead anyone nor get recruited
+        if (leader->currentState == STATE_DEAD)
+        {
+            continue;
+        }
+
+        Recruit(system, npcs, s);
+    }
+
+    system->formedTick = tick;
+    system->formedFrom = count;
+    system->dirty = false;
+}
+
+// Offset of a formation slot from the leader, a wedge trailing behind it
+static Vector2 FormationOffset(Vector2 facing, int slot)
+{
+    int rank = (slot + 1) / 2;
+    float side = (slot % 2 == 1) ? -1.0f : 1.0f;
+
+    // Perpendicular to the facing
+    Vector2 across = {-facing.y, facing.x};
+
+    return (Vector2){
+        (-facing.x + across.x * side) * rank * SQUAD_SPACING,
+        (-facing.y + across.y * side) * rank * SQUAD_SPACING};
+}
+
+/**
+ * SquadMemberCommand - Decides what a squad member does this tick.
+ *
+ * @squad: The member's squad, its order set by the leader this tick.
+ * @slot:  Index of the member in the squad (1 or more).
+ *
+ * Members attack when their leader attacks, otherwise they head for their slot
+ * in a wedge behind the leader and, once there, move the way the leader moves.
+ * This costs a few additions per member instead of a full PollAI.
+ *
+ * Return: The member's command.
+ */
+Command SquadMemberCommand(const Squad *squad, int slot)
+{
+    const GameObject *leader = squad->members[0];
+    const GameObject *member = squad->members[slot];
+
+    if (member->currentState == STATE_DEAD)
+    {
+        return COMMAND_NONE;
+    }
+
+    if (squad->order == COMMAND_ATTACK)
+    {
+        return COMMAND_ATTACK;
+    }
+
+    // The formation faces the way the leader moves (down while it stands still)
+    Vector2 facing = {0.0f, 1.0f};
+    if (leader->velocity.x != 0.0f || leader->velocity.y != 0.0f)
+    {
+        facing = Vector2Normalize(leader->velocity);
+    }
+
+    Vector2 offset = FormationOffset(facing, slot);
+    Vector2 toSlot = {leader->position.x + offset.x - member->position.x,
+                      leader->position.y + offset.y - member->position.y};
+
+    if (fabsf(toSlot.x) <= SQUAD_SLOT_TOLERANCE && fabsf(toSlot.y) <= SQUAD_SLOT_TOLERANCE)
+    {
+        return squad->order;
+    }
+
+    return DirectionToCommand(toSlot);
+}
+
+/**
+ * FreeSquadSystem - Frees the squad system.
+ *
+ * @system: The squad system to free.
+ */
+void FreeSquadSystem(SquadSystem *system)
+{
+    free(system->squads);
+    free(system->squadOf);
+    free(system->bucketOf);
+    free(system->nextFree);
+    free(system->previousFree);
+    memset(system, 0, sizeof(SquadSystem));
+}
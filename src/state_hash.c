@@ -0,0 +1,488 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/utils/state_hash.h"
+
+// xxHash32 primes
+#define XXH_PRIME32_1 0x9E3779B1U
+#define XXH_PRIME32_2 0x85EBCA77U
+#define XXH_PRIME32_3 0xC2B2AE3DU
+#define XXH_PRIME32_4 0x27D4EB2FU
+#define XXH_PRIME32_5 0x165667B1U
+
+// Number of 32 bit words hashed per game object (see HashGameObject)
+#define STATE_HASH_OBJECT_WORDS 11
+
+// Seed folding an entity hash with its index into the world sum
+#define STATE_HASH_FOLD_SEED 0x5EEDF01DU
+
+static uint32_t RotateLeft32(uint32_t value, int bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+static uint32_t ReadWord32(const unsigned char *bytes)
+{
+    uint32_t word;
+    memcpy(&word, bytes, sizeof(word)); // memcpy keeps unaligned reads well defined
+    return word;
+}
+
+static uint32_t XXHRound(uint32_t accumulator, uint32_t input)
+{
+    accumulator += input * XXH_PRIME32_2;
+    accumulator = RotateLeft32(accumulator, 13);
+    return accumulator * XXH_PRIME32_1;
+}
+
+/**
+ * StateHash32 - Hashes a block of memory using the xxHash32 algorithm.
+ *
+ * @data:   Pointer to the bytes to hash.
+ * @length: Number of bytes to hash.
+ * @seed:   Seed value, allows the same bytes to hash differently per entity/tick.
+ *
+ * xxHash32 processes 16 bytes per iteration with four independent accumulators,
+ * which makes it cheap enough to run over the whole world every tick in debug builds.
+ *
+ * Return: The 32 bit hash of the data.
+ */
+uint32_t StateHash32(const void *data, size_t length, uint32_t seed)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    const unsigned char *end = bytes + length;
+    uint32_t hash;
+
+    if (length >= 16)
+    {
+        const unsigned char *limit = end - 16;
+        uint32_t v1 = seed + XXH_PRIME32_1 + XXH_PRIME32_2;
+        uint32_t v2 = seed + XXH_PRIME32_2;
+        uint32_t v3 = seed;
+        uint32_t v4 = seed - XXH_PRIME32_1;
+
+        do
+        {
+            v1 = XXHRound(v1, ReadWord32(bytes));
+            v2 = XXHRound(v2, ReadWord32(bytes + 4));
+            v3 = XXHRound(v3, ReadWord32(bytes + 8));
+            v4 = XXHRound(v4, ReadWord32(bytes + 12));
+            bytes += 16;
+        } while (bytes <= limit);
+
+        hash = RotateLeft32(v1, 1) + RotateLeft32(v2, 7) + RotateLeft32(v3, 12) + RotateLeft32(v4, 18);
+    }
+    else
+    {
+        hash = seed + XXH_PRIME32_5;
+    }
+
+    hash += (uint32_t)length;
+
+    // Remaining 4 byte words
+    while (bytes + 4 <= end)
+    {
+        hash += ReadWord32(bytes) * XXH_PRIME32_3;
+        hash = RotateLeft32(hash, 17) * XXH_PRIME32_4;
+        bytes += 4;
+    }
+
+    // Remaining single bytes
+    while (bytes < end)
+    {
+        hash += (*bytes) * XXH_PRIME32_5;
+        hash = RotateLeft32(hash, 11) * XXH_PRIME32_1;
+        bytes++;
+    }
+
+    // Final avalanche
+    hash ^= hash >> 15;
+    hash *= XXH_PRIME32_2;
+    hash ^= hash >> 13;
+    hash *= XXH_PRIME32_3;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+/**
+ * HashGameObject - Hashes the simulation state of a game object.
+ *
+ * @obj:  The game object to hash.
+ * @seed: Seed value (normally the entity index in the world).
+ *
+ * Only fields that the simulation depends on are hashed (states, position,
+ * velocity, collider and health). Render only data such as the animation frame
+ * timer depends on the frame time and is deliberately left out. Floats are
+ * hashed by their bit pattern so any divergence, however small, is reported.
+ *
+ * Return: The hash of the game object.
+ */
+uint32_t HashGameObject(const GameObject *obj, uint32_t seed)
+{
+    // Pack the fields into a flat buffer so struct padding never leaks into the hash
+    uint32_t words[STATE_HASH_OBJECT_WORDS];
+    int32_t previousState = (int32_t)obj->previousState;
+    int32_t currentState = (int32_t)obj->currentState;
+    int32_t health = (int32_t)obj->health;
+    int32_t actionState = (int32_t)GetLayerState(obj, FSM_LAYER_ACTION);
+
+    memcpy(&words[0], &previousState, sizeof(uint32_t));
+    memcpy(&words[1], &currentState, sizeof(uint32_t));
+    memcpy(&words[2], &obj->position.x, sizeof(uint32_t));
+    memcpy(&words[3], &obj->position.y, sizeof(uint32_t));
+    memcpy(&words[4], &obj->velocity.x, sizeof(uint32_t));
+    memcpy(&words[5], &obj->velocity.y, sizeof(uint32_t));
+    memcpy(&words[6], &obj->collider.p.x, sizeof(uint32_t));
+    memcpy(&words[7], &obj->collider.p.y, sizeof(uint32_t));
+    memcpy(&words[8], &obj->collider.r, sizeof(uint32_t));
+    memcpy(&words[9], &health, sizeof(uint32_t));
+    memcpy(&words[10], &actionState, sizeof(uint32_t));
+
+    return StateHash32(words, sizeof(words), seed);
+}
+
+// An entity's share of the world sum, seeded by its index so swapped entities are detected
+static uint32_t FoldEntityHash(int entity, uint32_t hash)
+{
+    uint32_t pair[2] = {(uint32_t)entity, hash};
+    return StateHash32(pair, sizeof(pair), STATE_HASH_FOLD_SEED);
+}
+
+/**
+ * InitStateHasher - Prepares a state hasher and opens its log file.
+ *
+ * @hasher:   The state hasher to initialise.
+ * @logPath:  Path of the per-tick hash log, or NULL to disable logging.
+ * @capacity: Most entities the world holds.
+ */
+void InitStateHasher(StateHasher *hasher, const char *logPath, int capacity)
+{
+    hasher->log = NULL;
+    hasher->logEntities = false;
+    hasher->tick = 0;
+    hasher->worldHash = 0;
+    hasher->sum = 0;
+    hasher->count = 0;
+    hasher->capacity = capacity;
+    hasher->entityHashes = (uint32_t *)malloc(sizeof(uint32_t) * (capacity > 0 ? capacity : 1));
+
+    if (!hasher->entityHashes)
+    {
+        fprintf(stderr, "Failed to allocate state hashes\n");
+        exit(1);
+    }
+
+    if (logPath != NULL)
+    {
+        hasher->log = fopen(logPath, "w");
+        if (hasher->log == NULL)
+        {
+            fprintf(stderr, "Failed to open state hash log %s\n", logPath);
+        }
+    }
+}
+
+/**
+ * StateHashObject - Folds the current state of a game object into the world hash.
+ *
+ * @hasher: The state hasher.
+ * @obj:    The game object, hashed at its entity index.
+ *
+ * The object's previous hash is taken out of the world sum and its new one
+ * added, so only objects that may have changed need rehashing each tick.
+ * Entities past the end join the hash, entity indices stay dense.
+ */
+void StateHashObject(StateHasher *hasher, const GameObject *obj)
+{
+    int entity = obj->entity;
+    if (entity < 0 || entity >= hasher->capacity)
+    {
+        return;
+    }
+
+    // New entities join with an empty hash, replaced right below
+    while (hasher->count <= entity)
+    {
+        hasher->entityHashes[hasher->count] = 0;
+        hasher->sum += FoldEntityHash(hasher->count, 0);
+        hasher->count++;
+    }
+
+    uint32_t hash = HashGameObject(obj, 0);
+    hasher->sum += FoldEntityHash(entity, hash) - FoldEntityHash(entity, hasher->entityHashes[entity]);
+    hasher->entityHashes[entity] = hash;
+}
+
+/**
+ * MoveStateHashEntity - Removes an entity, the last one taking its index.
+ *
+ * @hasher: The state hasher.
+ * @from:   The last entity, moving into the hole (equal to to when it is the one removed).
+ * @to:     The removed entity's index.
+ *
+ * Mirrors the swap removal of RemoveGameObject, the moved entity keeps its
+ * hash and is folded in again at its new index.
+ */
+void MoveStateHashEntity(StateHasher *hasher, int from, int to)
+{
+    if (to < 0 || to >= hasher->count || from != hasher->count - 1)
+    {
+        return;
+    }
+
+    hasher->sum -= FoldEntityHash(to, hasher->entityHashes[to]);
+
+    if (from != to)
+    {
+        hasher->sum -= FoldEntityHash(from, hasher->entityHashes[from]);
+        hasher->entityHashes[to] = hasher->entityHashes[from];
+        hasher->sum += FoldEntityHash(to, hasher->entityHashes[to]);
+    }
+
+    hasher->count--;
+}
+
+/**
+ * StateHashTick - Finishes the world hash of a tick.
+ *
+ * @hasher: The state hasher, every object changed this tick folded in (see StateHashObject).
+ * @tick:   The simulation tick the state belongs to.
+ *
+ * The world hash is the sum of the folded entity hashes and the entity count,
+ * seeded by the tick, so it costs the same however large the world is. When a
+ * log is open a line is written per tick: "<tick> | <world hash> <count>".
+ * With logEntities set the entity hashes go before the '|', which is what
+ * CompareStateHashLogs uses to find the first divergent entity.
+ *
+ * Return: The world hash for this tick.
+ */
+uint32_t StateHashTick(StateHasher *hasher, uint32_t tick)
+{
+    uint32_t state[2] = {hasher->sum, (uint32_t)hasher->count};
+    uint32_t world = StateHash32(state, sizeof(state), tick);
+
+    if (hasher->log != NULL)
+    {
+        fprintf(hasher->log, "%u", tick);
+
+        if (hasher->logEntities)
+        {
+            for (int i = 0; i < hasher->count; i++)
+            {
+                fprintf(hasher->log, " %08x", hasher->entityHashes[i]);
+            }
+        }
+
+        fprintf(hasher->log, " | %08x %d\n", world, hasher->count);
+    }
+
+    hasher->tick = tick;
+    hasher->worldHash = world;
+
+    return world;
+}
+
+/**
+ * CloseStateHasher - Flushes and closes the hash log.
+ *
+ * @hasher: The state hasher to close.
+ */
+void CloseStateHasher(StateHasher *hasher)
+{
+    if (hasher->log != NULL)
+    {
+        fclose(hasher->log);
+        hasher->log = NULL;
+    }
+
+    free(hasher->entityHashes);
+    hasher->entityHashes = NULL;
+    hasher->count = 0;
+    hasher->capacity = 0;
+}
+
+// One line of a hash log
+typedef struct
+{
+    unsigned int tick;
+    unsigned int world;
+    int count;            // Entities in the world
+    int hashCount;        // Entity hashes logged on the line (0 unless logEntities was set)
+    unsigned int *hashes; // Up to maxHashes of them
+} StateHashLine;
+
+// Reads the next line of a hash log, returns false at end of file
+static bool ReadStateHashLine(FILE *file, StateHashLine *line, int maxHashes)
+{
+    if (fscanf(file, "%u", &line->tick) != 1)
+    {
+        return false;
+    }
+
+    line->hashCount = 0;
+
+    // Entity hashes up to the '|' separator
+    char token[16];
+    while (fscanf(file, "%15s", token) == 1 && strcmp(token, "|") != 0)
+    {
+        unsigned int hash = (unsigned int)strtoul(token, NULL, 16);
+        if (line->hashCount < maxHashes)
+        {
+            line->hashes[line->hashCount] = hash;
+        }
+        line->hashCount++;
+    }
+
+    if (fscanf(file, "%x %d", &line->world, &line->count) != 2)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+// Reports the first entity whose hash differs on two lines, false if neither logged entity hashes
+static bool ReportDivergentEntity(const StateHashLine *lhs, const StateHashLine *rhs, int maxHashes)
+{
+    if (lhs->hashCount == 0 || rhs->hashCount == 0)
+    {
+        return false;
+    }
+
+    int common = lhs->hashCount < rhs->hashCount ? lhs->hashCount : rhs->hashCount;
+    if (common > maxHashes)
+    {
+        common = maxHashes;
+    }
+
+    for (int i = 0; i < common; i++)
+    {
+        if (lhs->hashes[i] != rhs->hashes[i])
+        {
+            printf("First divergent entity: %d at tick %u (%08x vs %08x)\n", i, lhs->tick, lhs->hashes[i], rhs->hashes[i]);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * CompareStateHashLogs - Compares two state hash logs tick by tick.
+ *
+ * @lhsPath: Path of the first hash log (e.g. single threaded run).
+ * @rhsPath: Path of the second hash log (e.g. multi threaded or web run).
+ *
+ * Walks both logs in lockstep and reports the first tick whose world hash
+ * differs (or an entity count mismatch). Entity hashes are only logged on
+ * demand (--hash-entities) or after a lockstep desync, so the logs are then
+ * read on to the first divergent tick both logged them for, which names the
+ * first divergent entity. A log that ends early diverges at the first tick
+ * it is missing, so a truncated run never passes.
+ *
+ * Return: The first divergent tick, STATE_HASH_LOGS_MATCH if the logs are
+ *         identical or STATE_HASH_LOGS_UNREADABLE if either log could not be
+ *         opened.
+ */
+long CompareStateHashLogs(const char *lhsPath, const char *rhsPath)
+{
+    FILE *lhsFile = fopen(lhsPath, "r");
+    FILE *rhsFile = fopen(rhsPath, "r");
+
+    if (lhsFile == NULL || rhsFile == NULL)
+    {
+        fprintf(stderr, "Failed to open state hash logs %s, %s\n", lhsPath, rhsPath);
+        if (lhsFile)
+            fclose(lhsFile);
+        if (rhsFile)
+            fclose(rhsFile);
+        return STATE_HASH_LOGS_UNREADABLE;
+    }
+
+    // Scratch space for the entity hashes of a single line
+    const int maxHashes = 1 << 16;
+    StateHashLine lhs, rhs;
+    lhs.hashes = (unsigned int *)malloc(sizeof(unsigned int) * maxHashes);
+    rhs.hashes = (unsigned int *)malloc(sizeof(unsigned int) * maxHashes);
+
+    if (!lhs.hashes || !rhs.hashes)
+    {
+        fprintf(stderr, "Failed to allocate state hash buffers\n");
+        exit(1);
+    }
+
+    long divergentTick = STATE_HASH_LOGS_MATCH;
+    bool worldDiverged = false;
+    bool entityFound = false;
+    unsigned int ticksCompared = 0;
+
+    while (true)
+    {
+        bool lhsRead = ReadStateHashLine(lhsFile, &lhs, maxHashes);
+        bool rhsRead = ReadStateHashLine(rhsFile, &rhs, maxHashes);
+
+        if (!lhsRead || !rhsRead)
+        {
+            if (lhsRead != rhsRead && divergentTick == STATE_HASH_LOGS_MATCH)
+            {
+                // The shorter log is missing the tick the longer one just read
+                divergentTick = (long)(lhsRead ? lhs.tick : rhs.tick);
+                printf("State hash logs have different lengths, compared %u ticks\n", ticksCompared);
+                printf("First divergent tick: %ld (missing from %s)\n", divergentTick, lhsRead ? rhsPath : lhsPath);
+            }
+            break;
+        }
+
+        if (lhs.tick != rhs.tick)
+        {
+            if (divergentTick == STATE_HASH_LOGS_MATCH)
+            {
+                printf("State hash logs out of step: tick %u vs tick %u\n", lhs.tick, rhs.tick);
+                divergentTick = (long)(lhs.tick < rhs.tick ? lhs.tick : rhs.tick);
+            }
+            break;
+        }
+
+        if (lhs.world != rhs.world || divergentTick != STATE_HASH_LOGS_MATCH)
+        {
+            if (divergentTick == STATE_HASH_LOGS_MATCH)
+            {
+                divergentTick = (long)lhs.tick;
+                worldDiverged = true;
+                printf("First divergent tick: %u (world %08x vs %08x)\n", lhs.tick, lhs.world, rhs.world);
+
+                if (lhs.count != rhs.count)
+                {
+                    printf("Entity count differs: %d vs %d\n", lhs.count, rhs.count);
+                }
+            }
+
+            entityFound = ReportDivergentEntity(&lhs, &rhs, maxHashes);
+            if (entityFound)
+            {
+                break;
+            }
+        }
+        else
+        {
+            ticksCompared++;
+        }
+    }
+
+    if (divergentTick == STATE_HASH_LOGS_MATCH)
+    {
+        printf("State hash logs match (%u ticks)\n", ticksCompared);
+    }
+    else if (worldDiverged && !entityFound)
+    {
+        printf("No entity hashes logged after the divergence, log them with --hash-entities to find the entity\n");
+    }
+
+    free(lhs.hashes);
+    free(rhs.hashes);
+    fclose(lhsFile);
+    fclose(rhsFile);
+
+    return divergentTick;
+}
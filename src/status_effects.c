@@ -0,0 +1,270 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/utils/status_effects.h"
+#include "../include/utils/timer_wheel.h"
+
+// The status effects shared by gameplay code, initialised by InitGame
+static StatusEffects statusEffects;
+
+/**
+ * GetStatusEffects - Returns the status effects used by gameplay code.
+ *
+ * State functions only receive their game object, so effects tied to a state
+ * (such as the shield) are applied and removed through this shared instance.
+ *
+ * Return: The shared status effects.
+ */
+StatusEffects *GetStatusEffects(void)
+{
+    return &statusEffects;
+}
+
+static void ResizeStatusEffectArray(StatusEffectArray *array, int capacity)
+{
+    array->objects = (GameObject **)realloc(array->objects, sizeof(GameObject *) * capacity);
+    array->magnitude = (float *)realloc(array->magnitude, sizeof(float) * capacity);
+    array->expiry = (uint32_t *)realloc(array->expiry, sizeof(uint32_t) * capacity);
+    array->source = (EntityHandle *)realloc(array->source, sizeof(EntityHandle) * capacity);
+
+    if (!array->objects || !array->magnitude || !array->expiry || !array->source)
+    {
+        fprintf(stderr, "Failed to allocate status effects\n");
+        exit(1);
+    }
+
+    array->capacity = capacity;
+}
+
+// Removes effect i by moving the last effect of the array into its place
+static void RemoveStatusEffectAt(StatusEffectArray *array, int i)
+{
+    int last = --array->count;
+
+    array->objects[i] = array->objects[last];
+    array->magnitude[i] = array->magnitude[last];
+    array->expiry[i] = array->expiry[last];
+    array->source[i] = array->source[last];
+}
+
+/**
+ * InitStatusEffects - Allocates the per type effect arrays.
+ *
+ * @system:   The status effects to initialise.
+ * @capacity: Initial number of effects per type.
+ */
+void InitStatusEffects(StatusEffects *system, int capacity)
+{
+    memset(system, 0, sizeof(StatusEffects));
+
+    for (int type = 0; type < STATUS_TYPE_COUNT; type++)
+    {
+        ResizeStatusEffectArray(&system->effects[type], capacity > 0 ? capacity : 16);
+    }
+}
+
+/**
+ * ApplyStatusEffect - Applies a status effect to a game object.
+ *
+ * @system:    The status effects.
+ * @obj:       The affected game object.
+ * @type:      Kind of effect.
+ * @magnitude: Strength of the effect (damage for poison, scale for slow and shield).
+ * @ticks:     Duration in ticks, 0 keeps the effect until it is removed.
+ * @source:    Handle of whoever applied the effect, or an empty one.
+ *
+ * The effect ends on an absolute tick of the timer service's clock, so
+ * nothing counts down per effect and expiry is a single compare.
+ */
+void ApplyStatusEffect(StatusEffects *system, GameObject *obj, StatusType type, float magnitude, uint32_t ticks, EntityHandle source)
+{
+    StatusEffectArray *array = &system->effects[type];
+
+    if (array->count == array->capacity)
+    {
+        ResizeStatusEffectArray(array, array->capacity * 2);
+    }
+
+    int i = array->count++;
+    array->objects[i] = obj;
+    array->magnitude[i] = magnitude;
+    array->expiry[i] = ticks > 0 ? GetTimerService()->now + ticks : STATUS_PERMANENT;
+    array->source[i] = source;
+}
+
+// Movement modifier of an object from its slow and stun effects, as TickStatusEffects builds it
+static float StatusSpeedScale(const StatusEffects *system, const GameObject *obj)
+{
+    const StatusEffectArray *stun = &system->effects[STATUS_STUN];
+    for (int i = 0; i < stun->count; i++)
+    {
+        if (stun->objects[i] == obj)
+        {
+            return 0.0f;
+        }
+    }
+
+    float scale = 1.0f;
+    const StatusEffectArray *slow = &system->effects[STATUS_SLOW];
+    for (int i = 0; i < slow->count; i++)
+    {
+        if (slow->objects[i] == obj)
+        {
+            scale = fminf(scale, slow->magnitude[i]);
+        }
+    }
+
+    return scale;
+}
+
+// Damage modifier of an object from its shield effects, as TickStatusEffects builds it
+static float StatusDamageScale(const StatusEffects *system, const GameObject *obj)
+{
+    float scale = 1.0f;
+    const StatusEffectArray *shield = &system->effects[STATUS_SHIELD];
+    for (int i = 0; i < shield->count; i++)
+    {
+        if (shield->objects[i] == obj)
+        {
+            scale = fminf(scale, shield->magnitude[i]);
+        }
+    }
+
+    return scale;
+}
+
+/**
+ * RemoveStatusEffects - Removes every effect of a type from a game object.
+ *
+ * @system: The status effects.
+ * @obj:    The affected game object.
+ * @type:   Kind of effect to remove.
+ *
+ * Only the modifier the type contributes to is rebuilt, from the effects the
+ * object keeps. Dropping a slow leaves a shield's damage modifier alone, and
+ * dropping a shield leaves a slow or stun in place.
+ */
+void RemoveStatusEffects(StatusEffects *system, GameObject *obj, StatusType type)
+{
+    StatusEffectArray *array = &system->effects[type];
+
+    for (int i = array->count - 1; i >= 0; i--)
+    {
+        if (array->objects[i] == obj)
+        {
+            RemoveStatusEffectAt(array, i);
+        }
+    }
+
+    switch (type)
+    {
+    case STATUS_SLOW:
+    case STATUS_STUN:
+        obj->speedScale = StatusSpeedScale(system, obj);
+        break;
+    case STATUS_SHIELD:
+        obj->damageScale = StatusDamageScale(system, obj);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * ClearStatusEffects - Removes every effect from a game object.
+ *
+ * @system: The status effects.
+ * @obj:    The game object, normally about to be deleted.
+ */
+void ClearStatusEffects(StatusEffects *system, GameObject *obj)
+{
+    for (int type = 0; type < STATUS_TYPE_COUNT; type++)
+    {
+        RemoveStatusEffects(system, obj, type);
+    }
+}
+
+/**
+ * TickStatusEffects - Advances every status effect by one tick.
+ *
+ * @system: The status effects.
+ * @combat: Combat queue receiving the poison damage.
+ *
+ * Runs once per tick after the timer service has advanced. Effects that
+ * reached their expiry tick are removed while the modifiers of every affected
+ * object are reset, then the modifiers are rebuilt from the remaining effects,
+ * one tight loop per type. The strongest slow, stun or shield wins rather than stacking, so
+ * PlayerMove/NPCMove and the combat pass simply multiply by the modifiers.
+ */
+void TickStatusEffects(StatusEffects *system, CombatQueue *combat)
+{
+    uint32_t now = GetTimerService()->now;
+
+    // Expire finished effects and reset the modifiers of every affected object,
+    // objects that lost their last effect keep the reset values
+    for (int type = 0; type < STATUS_TYPE_COUNT; type++)
+    {
+        StatusEffectArray *array = &system->effects[type];
+
+        for (int i = array->count - 1; i >= 0; i--)
+        {
+            array->objects[i]->speedScale = 1.0f;
+            array->objects[i]->damageScale = 1.0f;
+
+            if (array->expiry[i] <= now)
+            {
+                RemoveStatusEffectAt(array, i);
+            }
+        }
+    }
+
+    // Rebuild them, one batch per type
+    StatusEffectArray *slow = &system->effects[STATUS_SLOW];
+    for (int i = 0; i < slow->count; i++)
+    {
+        slow->objects[i]->speedScale = fminf(slow->objects[i]->speedScale, slow->magnitude[i]);
+    }
+
+    StatusEffectArray *stun = &system->effects[STATUS_STUN];
+    for (int i = 0; i < stun->count; i++)
+    {
+        stun->objects[i]->speedScale = 0.0f;
+    }
+
+    StatusEffectArray *shield = &system->effects[STATUS_SHIELD];
+    for (int i = 0; i < shield->count; i++)
+    {
+        shield->objects[i]->damageScale = fminf(shield->objects[i]->damageScale, shield->magnitude[i]);
+    }
+
+    // Poison stacks, every poison deals its damage on the same ticks
+    StatusEffectArray *poison = &system->effects[STATUS_POISON];
+    if (combat != NULL && now % STATUS_POISON_INTERVAL == 0)
+    {
+        for (int i = 0; i < poison->count; i++)
+        {
+            QueueDamage(combat, poison->objects[i]->handle, poison->source[i], (int)poison->magnitude[i], DAMAGE_STATUS);
+        }
+    }
+}
+
+/**
+ * FreeStatusEffects - Frees the effect arrays.
+ *
+ * @system: The status effects to free.
+ */
+void FreeStatusEffects(StatusEffects *system)
+{
+    for (int type = 0; type < STATUS_TYPE_COUNT; type++)
+    {
+        StatusEffectArray *array = &system->effects[type];
+        free(array->objects);
+        free(array->magnitude);
+        free(array->expiry);
+        free(array->source);
+    }
+
+    memset(system, 0, sizeof(StatusEffects));
+}
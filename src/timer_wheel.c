@@ -0,0 +1,321 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/utils/timer_wheel.h"
+
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+
+// The central timer service, initialised by InitGame
+static TimerWheel timerService;
+
+/**
+ * GetTimerService - Returns the central timer service.
+ *
+ * State functions only receive their game object, so gameplay timers and
+ * cooldowns are scheduled on this shared wheel, advanced once per tick.
+ *
+ * Return: The central timer wheel.
+ */
+TimerWheel *GetTimerService(void)
+{
+    return &timerService;
+}
+
+// Adds timers [first, capacity) to the free list
+static void ReleaseRange(TimerWheel *wheel, int first)
+{
+    for (int i = wheel->capacity - 1; i >= first; i--)
+    {
+        wheel->timers[i].slot = -1;
+        wheel->timers[i].generation = 1;
+        wheel->timers[i].next = wheel->freeList;
+        wheel->freeList = i;
+    }
+}
+
+/**
+ * InitTimerWheel - Prepares an empty timer wheel.
+ *
+ * @wheel:   The timer wheel to initialise.
+ * @deliver: Delivers expired events, NULL calls HandleEvent on the target.
+ * @context: Passed to @deliver (e.g. the game data).
+ */
+void InitTimerWheel(TimerWheel *wheel, TimerDeliverFunction deliver, void *context)
+{
+    memset(wheel, 0, sizeof(TimerWheel));
+
+    wheel->timers = (Timer *)malloc(sizeof(Timer) * TIMER_WHEEL_INITIAL_CAPACITY);
+    if (!wheel->timers)
+    {
+        fprintf(stderr, "Failed to allocate timers\n");
+        exit(1);
+    }
+
+    wheel->capacity = TIMER_WHEEL_INITIAL_CAPACITY;
+    wheel->freeList = -1;
+    ReleaseRange(wheel, 0);
+
+    for (int i = 0; i < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS; i++)
+    {
+        wheel->slots[i] = -1;
+    }
+
+    wheel->deliver = deliver;
+    wheel->context = context;
+}
+
+// Links a timer into the slot matching how far away its expiry is
+static void PlaceTimer(TimerWheel *wheel, int index)
+{
+    Timer *timer = &wheel->timers[index];
+    uint32_t delta = timer->expiry - wheel->now;
+    int level = 0;
+
+    // Each level covers 256 times the range of the one below
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (1u << (TIMER_WHEEL_BITS * (level + 1))))
+    {
+        level++;
+    }
+
+    int slot = level * TIMER_WHEEL_SLOTS + (int)((timer->expiry >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK);
+
+    timer->slot = slot;
+    timer->previous = -1;
+    timer->next = wheel->slots[slot];
+    if (timer->next >= 0)
+    {
+        wheel->timers[timer->next].previous = index;
+    }
+    wheel->slots[slot] = index;
+}
+
+// Returns a timer to the free list, invalidating every TimerId pointing at it
+static void ReleaseTimer(TimerWheel *wheel, int index)
+{
+    Timer *timer = &wheel->timers[index];
+
+    timer->slot = -1;
+    timer->generation++;
+    if (timer->generation == 0)
+    {
+        timer->generation = 1; // 0 is reserved for "no timer"
+    }
+    timer->next = wheel->freeList;
+    wheel->freeList = index;
+    wheel->pending--;
+}
+
+/**
+ * ScheduleTimer - Schedules an event for a game object.
+ *
+ * @wheel:  The timer wheel.
+ * @target: Game object receiving @event, NULL for a cooldown that is only
+ *          polled with IsTimerPending.
+ * @event:  The event delivered on expiry.
+ * @ticks:  Delay in ticks, 0 is treated as 1 (the next tick).
+ *
+ * Scheduling is O(1): the timer is linked into a single slot.
+ *
+ * Return: Id of the timer, for cancelling or polling it.
+ */
+TimerId ScheduleTimer(TimerWheel *wheel, GameObject *target, Event event, uint32_t ticks)
+{
+    if (wheel->freeList < 0)
+    {
+        // Grow the pool, timers are referenced by index so they may move
+        int oldCapacity = wheel->capacity;
+        Timer *timers = (Timer *)realloc(wheel->timers, sizeof(Timer) * oldCapacity * 2);
+        if (!timers)
+        {
+            fprintf(stderr, "Failed to grow timers\n");
+            exit(1);
+        }
+
+        wheel->timers = timers;
+        wheel->capacity = oldCapacity * 2;
+        ReleaseRange(wheel, oldCapacity);
+    }
+
+    int index = wheel->freeList;
+    Timer *timer = &wheel->timers[index];
+    wheel->freeList = timer->next;
+    wheel->pending++;
+
+    timer->target = target;
+    timer->event = event;
+    timer->expiry = wheel->now + (ticks > 0 ? ticks : 1);
+    PlaceTimer(wheel, index);
+
+    return (TimerId){index, timer->generation};
+}
+
+// Unlinks a timer from its slot
+static void UnlinkTimer(TimerWheel *wheel, int index)
+{
+    Timer *timer = &wheel->timers[index];
+
+    if (timer->previous >= 0)
+    {
+        wheel->timers[timer->previous].next = timer->next;
+    }
+    else
+    {
+        wheel->slots[timer->slot] = timer->next;
+    }
+
+    if (timer->next >= 0)
+    {
+        wheel->timers[timer->next].previous = timer->previous;
+    }
+}
+
+/**
+ * IsTimerPending - Checks whether a timer is still waiting to expire.
+ *
+ * @wheel: The timer wheel.
+ * @id:    The timer to check.
+ *
+ * Return: true if the timer has neither expired nor been cancelled.
+ */
+bool IsTimerPending(const TimerWheel *wheel, TimerId id)
+{
+    return id.generation != 0 && id.index >= 0 && id.index < wheel->capacity &&
+           wheel->timers[id.index].generation == id.generation && wheel->timers[id.index].slot >= 0;
+}
+
+/**
+ * TimerRemaining - Returns the ticks left on a timer.
+ *
+ * @wheel: The timer wheel.
+ * @id:    The timer to check.
+ *
+ * Return: Ticks until expiry, 0 if the timer is not pending.
+ */
+uint32_t TimerRemaining(const TimerWheel *wheel, TimerId id)
+{
+    return IsTimerPending(wheel, id) ? wheel->timers[id.index].expiry - wheel->now : 0;
+}
+
+/**
+ * CancelTimer - Cancels a pending timer.
+ *
+ * @wheel: The timer wheel.
+ * @id:    The timer to cancel, cleared so it can not cancel a reused timer later.
+ *
+ * Return: true if the timer was pending.
+ */
+bool CancelTimer(TimerWheel *wheel, TimerId *id)
+{
+    bool pending = IsTimerPending(wheel, *id);
+
+    if (pending)
+    {
+        UnlinkTimer(wheel, id->index);
+        ReleaseTimer(wheel, id->index);
+    }
+
+    id->generation = 0;
+    return pending;
+}
+
+/**
+ * CancelTimersFor - Cancels every pending timer targeting a game object.
+ *
+ * @wheel:  The timer wheel.
+ * @target: The game object about to be deleted.
+ *
+ * Walks the whole pool, meant for deleting objects rather than per tick use.
+ */
+void CancelTimersFor(TimerWheel *wheel, GameObject *target)
+{
+    for (int i = 0; i < wheel->capacity; i++)
+    {
+        if (wheel->timers[i].slot >= 0 && wheel->timers[i].target == target)
+        {
+            UnlinkTimer(wheel, i);
+            ReleaseTimer(wheel, i);
+        }
+    }
+}
+
+// Re-places every timer of a higher level slot now that it is in range of a lower level
+static void Cascade(TimerWheel *wheel, int level)
+{
+    int slot = level * TIMER_WHEEL_SLOTS + (int)((wheel->now >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK);
+    int index = wheel->slots[slot];
+    wheel->slots[slot] = -1;
+
+    while (index >= 0)
+    {
+        int next = wheel->timers[index].next;
+        PlaceTimer(wheel, index);
+        index = next;
+    }
+}
+
+/**
+ * AdvanceTimerWheel - Advances the wheel by one tick and delivers expiries.
+ *
+ * @wheel: The timer wheel.
+ *
+ * Only the level 0 slot of the new tick is visited, plus a higher level slot
+ * every 256^level ticks whose timers are cascaded down. The cost per tick is
+ * therefore O(expiring timers), independent of how many are outstanding.
+ * Events are delivered after the timer is released, so handlers may schedule
+ * new timers (including on the same game object).
+ */
+void AdvanceTimerWheel(TimerWheel *wheel)
+{
+    wheel->now++;
+
+    // Find the highest level whose lower bits just rolled over, cascade from the top down
+    int top = 0;
+    while (top < TIMER_WHEEL_LEVELS - 1 &&
+           (wheel->now & ((1u << (TIMER_WHEEL_BITS * (top + 1))) - 1)) == 0)
+    {
+        top++;
+    }
+
+    for (int level = top; level > 0; level--)
+    {
+        Cascade(wheel, level);
+    }
+
+    // Pop timers one at a time, handlers may cancel other timers of this slot
+    // and can only schedule into later slots
+    int slot = (int)(wheel->now & TIMER_WHEEL_MASK);
+    int index;
+
+    while ((index = wheel->slots[slot]) >= 0)
+    {
+        GameObject *target = wheel->timers[index].target;
+        Event event = wheel->timers[index].event;
+
+        UnlinkTimer(wheel, index);
+        ReleaseTimer(wheel, index);
+
+        if (target != NULL)
+        {
+            if (wheel->deliver)
+            {
+                wheel->deliver(target, event, wheel->context);
+            }
+            else
+            {
+                HandleEvent(target, event);
+            }
+        }
+    }
+}
+
+/**
+ * FreeTimerWheel - Frees the timer pool.
+ *
+ * @wheel: The timer wheel to free.
+ */
+void FreeTimerWheel(TimerWheel *wheel)
+{
+    free(wheel->timers);
+    memset(wheel, 0, sizeof(TimerWheel));
+}
@@ -0,0 +1,288 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/utils/trigger_volumes.h"
+
+static int GridCoordinate(float value)
+{
+    return (int)floorf(value / TRIGGER_GRID_CELL);
+}
+
+static int GridBucket(int cellX, int cellY)
+{
+    unsigned int hash = ((unsigned int)cellX * 73856093u) ^ ((unsigned int)cellY * 19349663u);
+    return (int)(hash & (TRIGGER_GRID_BUCKETS - 1));
+}
+
+/**
+ * InitTriggerVolumes - Prepares an empty set of trigger volumes.
+ *
+ * @system:      The trigger volumes to initialise.
+ * @maxEntities: Entity indices passed to UpdateTriggerVolumes stay below this.
+ */
+void InitTriggerVolumes(TriggerVolumes *system, int maxEntities)
+{
+    memset(system, 0, sizeof(TriggerVolumes));
+
+    for (int b = 0; b < TRIGGER_GRID_BUCKETS; b++)
+    {
+        system->buckets[b] = -1;
+    }
+
+    system->occupants = (TriggerOccupant *)calloc(maxEntities, sizeof(TriggerOccupant));
+    if (!system->occupants)
+    {
+        fprintf(stderr, "Failed to allocate trigger volumes\n");
+        exit(1);
+    }
+
+    system->occupantCapacity = maxEntities;
+}
+
+// Grows an array to hold at least count elements
+static void *GrowArray(void *array, int *capacity, int count, size_t size)
+{
+    if (count <= *capacity)
+    {
+        return array;
+    }
+
+    int newCapacity = *capacity > 0 ? *capacity * 2 : 64;
+    while (newCapacity < count)
+    {
+        newCapacity *= 2;
+    }
+
+    void *grown = realloc(array, size * newCapacity);
+    if (!grown)
+    {
+        fprintf(stderr, "Failed to grow trigger volumes\n");
+        exit(1);
+    }
+
+    *capacity = newCapacity;
+    return grown;
+}
+
+// Stores a trigger and links it into every grid cell its bounds overlap
+static int AddTrigger(TriggerVolumes *system, TriggerVolume volume, c2AABB bounds)
+{
+    system->volumes = (TriggerVolume *)GrowArray(system->volumes, &system->capacity, system->count + 1, sizeof(TriggerVolume));
+    int trigger = system->count++;
+    system->volumes[trigger] = volume;
+
+    int minX = GridCoordinate(bounds.min.x);
+    int maxX = GridCoordinate(bounds.max.x);
+    int minY = GridCoordinate(bounds.min.y);
+    int maxY = GridCoordinate(bounds.max.y);
+
+    for (int cellY = minY; cellY <= maxY; cellY++)
+    {
+        for (int cellX = minX; cellX <= maxX; cellX++)
+        {
+            int nodeCapacity = system->nodeCapacity;
+            system->nodeTrigger = (int *)GrowArray(system->nodeTrigger, &nodeCapacity, system->nodeCount + 1, sizeof(int));
+            nodeCapacity = system->nodeCapacity;
+            system->nodeNext = (int *)GrowArray(system->nodeNext, &nodeCapacity, system->nodeCount + 1, sizeof(int));
+            system->nodeCapacity = nodeCapacity;
+
+            int bucket = GridBucket(cellX, cellY);
+            int node = system->nodeCount++;
+            system->nodeTrigger[node] = trigger;
+            system->nodeNext[node] = system->buckets[bucket];
+            system->buckets[bucket] = node;
+        }
+    }
+
+    return trigger;
+}
+
+/**
+ * AddTriggerBox - Adds an axis aligned box trigger.
+ *
+ * @system: The trigger volumes.
+ * @box:    The area of the trigger.
+ * @tag:    What the trigger is for (see TriggerVolume).
+ *
+ * Return: The index of the trigger.
+ */
+int AddTriggerBox(TriggerVolumes *system, c2AABB box, int tag)
+{
+    TriggerVolume volume = {0};
+    volume.shape = TRIGGER_SHAPE_BOX;
+    volume.box = box;
+    volume.tag = tag;
+
+    return AddTrigger(system, volume, box);
+}
+
+/**
+ * AddTriggerCircle - Adds a circular trigger.
+ *
+ * @system: The trigger volumes.
+ * @circle: The area of the trigger.
+ * @tag:    What the trigger is for.
+ *
+ * Return: The index of the trigger.
+ */
+int AddTriggerCircle(TriggerVolumes *system, c2Circle circle, int tag)
+{
+    TriggerVolume volume = {0};
+    volume.shape = TRIGGER_SHAPE_CIRCLE;
+    volume.circle = circle;
+    volume.tag = tag;
+
+    c2AABB bounds = {{circle.p.x - circle.r, circle.p.y - circle.r}, {circle.p.x + circle.r, circle.p.y + circle.r}};
+    return AddTrigger(system, volume, bounds);
+}
+
+static bool TriggerContains(const TriggerVolume *volume, Vector2 point)
+{
+    if (volume->shape == TRIGGER_SHAPE_BOX)
+    {
+        return point.x >= volume->box.min.x && point.x <= volume->box.max.x &&
+               point.y >= volume->box.min.y && point.y <= volume->box.max.y;
+    }
+
+    float dx = point.x - volume->circle.p.x;
+    float dy = point.y - volume->circle.p.y;
+    return dx * dx + dy * dy <= volume->circle.r * volume->circle.r;
+}
+
+static bool ContainsTrigger(const int *triggers, int count, int trigger)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (triggers[i] == trigger)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void AddTriggerEvent(TriggerVolumes *system, int trigger, GameObject *obj, TriggerEventType type)
+{
+    system->events = (TriggerEvent *)GrowArray(system->events, &system->eventCapacity, system->eventCount + 1, sizeof(TriggerEvent));
+    system->events[system->eventCount++] = (TriggerEvent){trigger, obj, type};
+}
+
+/**
+ * UpdateTriggerVolumes - Reports entities entering and leaving triggers.
+ *
+ * @system:  The trigger volumes.
+ * @objects: Entities that may have moved (e.g. players and awake NPCs).
+ * @count:   Number of entities.
+ *
+ * An entity is inside a trigger when its position is. Entities that have not
+ * moved since they were last checked are skipped, the rest only test the
+ * triggers linked into the grid cell they are in and compare the result with
+ * the triggers they were inside before. The crossings are left in
+ * system->events (reset every update), exits before enters for each entity.
+ */
+void UpdateTriggerVolumes(TriggerVolumes *system, GameObject **objects, int count)
+{
+    system->eventCount = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        GameObject *obj = objects[i];
+
+        if (obj->entity < 0 || obj->entity >= system->occupantCapacity)
+        {
+            continue;
+        }
+
+        TriggerOccupant *occupant = &system->occupants[obj->entity];
+
+        if (occupant->tracked &&
+            occupant->lastPosition.x == obj->position.x &&
+            occupant->lastPosition.y == obj->position.y)
+        {
+            continue; // Idle entities cannot have crossed anything
+        }
+
+        occupant->tracked = true;
+        occupant->lastPosition = obj->position;
+
+        // Triggers the entity is inside now
+        int inside[TRIGGER_MAX_OVERLAPS];
+        int insideCount = 0;
+
+        int bucket = GridBucket(GridCoordinate(obj->position.x), GridCoordinate(obj->position.y));
+        for (int node = system->buckets[bucket]; node >= 0; node = system->nodeNext[node])
+        {
+            int trigger = system->nodeTrigger[node];
+
+            // A trigger can be linked into a bucket more than once through hashing
+            if (insideCount < TRIGGER_MAX_OVERLAPS &&
+                TriggerContains(&system->volumes[trigger], obj->position) &&
+                !ContainsTrigger(inside, insideCount, trigger))
+            {
+                inside[insideCount++] = trigger;
+            }
+        }
+
+        for (int t = 0; t < occupant->insideCount; t++)
+        {
+            if (!ContainsTrigger(inside, insideCount, occupant->inside[t]))
+            {
+                AddTriggerEvent(system, occupant->inside[t], obj, TRIGGER_EXIT);
+            }
+        }
+
+        for (int t = 0; t < insideCount; t++)
+        {
+            if (!ContainsTrigger(occupant->inside, occupant->insideCount, inside[t]))
+            {
+                AddTriggerEvent(system, inside[t], obj, TRIGGER_ENTER);
+            }
+        }
+
+        memcpy(occupant->inside, inside, sizeof(int) * insideCount);
+        occupant->insideCount = insideCount;
+    }
+}
+
+/**
+ * MoveTriggerOccupant - Follows an entity to a new entity index.
+ *
+ * @system: The trigger volumes.
+ * @from:   The entity index the entity had.
+ * @to:     Its new entity index, whoever had it left the world.
+ *
+ * The entity keeps the triggers it is inside, so it does not enter them
+ * again. Moving an index onto itself forgets it, without exit events.
+ */
+void MoveTriggerOccupant(TriggerVolumes *system, int from, int to)
+{
+    if (from < 0 || from >= system->occupantCapacity || to < 0 || to >= system->occupantCapacity)
+    {
+        return;
+    }
+
+    TriggerOccupant occupant = system->occupants[from];
+    memset(&system->occupants[from], 0, sizeof(TriggerOccupant));
+    if (from != to)
+    {
+        system->occupants[to] = occupant;
+    }
+}
+
+/**
+ * FreeTriggerVolumes - Frees the trigger volumes.
+ *
+ * @system: The trigger volumes to free.
+ */
+void FreeTriggerVolumes(TriggerVolumes *system)
+{
+    free(system->volumes);
+    free(system->nodeTrigger);
+    free(system->nodeNext);
+    free(system->occupants);
+    free(system->events);
+    memset(system, 0, sizeof(TriggerVolumes));
+}